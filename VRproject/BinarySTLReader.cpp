@@ -0,0 +1,286 @@
+/**
+ * @file BinarySTLReader.cpp
+ * @brief Implementation of the memory-mapped binary STL fast path.
+ *
+ * Welding works in three parallel passes over the mapped triangle records:
+ *  1. hash every corner and count corners per (chunk, bucket);
+ *  2. scatter corner indices into bucket-major order;
+ *  3. weld each bucket with its own open-addressing table.
+ * Buckets never share a vertex, so no pass needs locks.
+ */
+
+#include "BinarySTLReader.h"
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QFile>
+#include <QVector>
+#include <QtConcurrent>
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkPoints.h>
+#include <vtkFloatArray.h>
+#include <vtkCellArray.h>
+#include <vtkTypeInt32Array.h>
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+// --------------------------------------- Helpers ---------------------------------------
+
+namespace {
+
+const qint64 HeaderSize = 84;           // 80-byte header + uint32 triangle count
+const qint64 RecordSize = 50;           // normal (12) + three vertices (36) + attribute (2)
+const int    BucketBits = 8;            // Top hash bits select the weld bucket
+const int    BucketCount = 1 << BucketBits;
+const qint64 ChunkCorners = 1 << 20;    // Corners handled per task in the counting passes
+
+// Raw bit pattern of one vertex; comparing bits matches vtkSTLReader's exact point merging
+struct VertexKey {
+    uint32_t x, y, z;
+};
+
+// Reads one triangle corner straight out of the mapped records
+inline VertexKey cornerKey(const uchar* records, qint64 corner)
+{
+    VertexKey key;
+    std::memcpy(&key, records + (corner / 3) * RecordSize + 12 + (corner % 3) * 12, sizeof(key));
+
+    // -0.0 and +0.0 are the same position
+    if (key.x == 0x80000000u) key.x = 0;
+    if (key.y == 0x80000000u) key.y = 0;
+    if (key.z == 0x80000000u) key.z = 0;
+    return key;
+}
+
+// 64-bit mix of the three coordinates
+inline uint64_t hashKey(const VertexKey& k)
+{
+    uint64_t h = (uint64_t(k.x) * 0x9E3779B97F4A7C15ull)
+        ^ (uint64_t(k.y) * 0xC2B2AE3D27D4EB4Full)
+        ^ (uint64_t(k.z) * 0x165667B19E3779F9ull);
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 32;
+    return h;
+}
+
+// Bucket index from the high hash bits (the weld tables use the low bits)
+inline int bucketOf(uint64_t hash)
+{
+    return int(hash >> (64 - BucketBits));
+}
+
+// Runs fn(i) for every i in [0, count) on the global thread pool
+template <typename Fn>
+void parallelFor(int count, Fn fn)
+{
+    QVector<int> indices(count);
+    std::iota(indices.begin(), indices.end(), 0);
+    QtConcurrent::blockingMap(indices, [&fn](int& i) { fn(i); });
+}
+
+// Returns the triangle count if the data is a binary STL, or -1 otherwise
+qint64 binaryTriangleCount(const uchar* data, qint64 size)
+{
+    if (size < HeaderSize)
+        return -1;
+
+    uint32_t count = 0;
+    std::memcpy(&count, data + 80, sizeof(count));
+
+    // Compare by division, so a bogus count in the header cannot overflow the product
+    const quint64 available = quint64(size - HeaderSize);
+    if (count == 0 || count > available / quint64(RecordSize))
+        return -1;
+
+    // Some exporters pad binary files, but an ASCII file starting with "solid" never matches exactly
+    const quint64 records = quint64(count) * quint64(RecordSize);
+    if (records != available && std::memcmp(data, "solid", 5) == 0)
+        return -1;
+
+    return qint64(count);
+}
+
+} // namespace
+
+// --------------------------------------- Format Check ---------------------------------------
+
+/**
+ * @brief Checks the header of a file against its size.
+ * @param fileName Path to the file.
+ * @return True if the file is a well-formed binary STL.
+ */
+// Reads only the 84-byte header to classify the file
+bool BinarySTLReader::isBinarySTL(const QString& fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QByteArray header = file.read(HeaderSize);
+    if (header.size() < HeaderSize)
+        return false;
+
+    return binaryTriangleCount(reinterpret_cast<const uchar*>(header.constData()), file.size()) > 0;
+}
+
+// --------------------------------------- Loading ---------------------------------------
+
+/**
+ * @brief Maps a binary STL file and builds welded polydata from it.
+ * @param fileName Path to the file.
+ * @return Welded mesh, or nullptr if the file is not binary STL or cannot be mapped.
+ *
+ * Coordinates are copied record by record with fixed-size memcpy calls, which compilers
+ * lower to vector loads/stores. Points and connectivity are written directly into the
+ * final VTK arrays, and the connectivity uses 32-bit storage.
+ */
+// Reads a binary STL via mmap with a parallel hash-based vertex weld
+vtkSmartPointer<vtkPolyData> BinarySTLReader::read(const QString& fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return nullptr;
+
+    const qint64 size = file.size();
+    uchar* data = file.map(0, size);
+    if (!data)
+        return nullptr;
+
+    const qint64 triangles = binaryTriangleCount(data, size);
+    const qint64 corners = triangles * 3;
+    if (triangles <= 0 || corners > std::numeric_limits<vtkTypeInt32>::max()) {
+        file.unmap(data);
+        return nullptr;
+    }
+
+    const uchar* records = data + HeaderSize;
+    const int chunks = int((corners + ChunkCorners - 1) / ChunkCorners);
+
+    // Pass 1: count corners per (chunk, bucket)
+    std::vector<qint64> counts(size_t(chunks) * BucketCount, 0);
+    parallelFor(chunks, [&](int c) {
+        qint64* row = &counts[size_t(c) * BucketCount];
+        const qint64 end = std::min(corners, (c + 1) * ChunkCorners);
+        for (qint64 k = c * ChunkCorners; k < end; ++k)
+            ++row[bucketOf(hashKey(cornerKey(records, k)))];
+    });
+
+    // Bucket-major offsets: every (bucket, chunk) pair owns a private range of `sorted`
+    std::vector<qint64> bucketStart(BucketCount + 1, 0);
+    std::vector<qint64> cursor(counts.size(), 0);
+    qint64 running = 0;
+    for (int b = 0; b < BucketCount; ++b) {
+        bucketStart[b] = running;
+        for (int c = 0; c < chunks; ++c) {
+            cursor[size_t(c) * BucketCount + b] = running;
+            running += counts[size_t(c) * BucketCount + b];
+        }
+    }
+    bucketStart[BucketCount] = running;
+    std::vector<qint64>().swap(counts);
+
+    // Pass 2: scatter corner indices into bucket order
+    std::vector<vtkTypeInt32> sorted(size_t(corners));
+    parallelFor(chunks, [&](int c) {
+        qint64* pos = &cursor[size_t(c) * BucketCount];
+        const qint64 end = std::min(corners, (c + 1) * ChunkCorners);
+        for (qint64 k = c * ChunkCorners; k < end; ++k)
+            sorted[size_t(pos[bucketOf(hashKey(cornerKey(records, k)))]++)] = vtkTypeInt32(k);
+    });
+    std::vector<qint64>().swap(cursor);
+
+    // Pass 3: weld each bucket independently, writing bucket-local ids into the connectivity
+    auto connectivity = vtkSmartPointer<vtkTypeInt32Array>::New();
+    connectivity->SetNumberOfValues(corners);
+    vtkTypeInt32* conn = connectivity->GetPointer(0);
+
+    std::vector<std::vector<VertexKey>> unique(BucketCount);
+    parallelFor(BucketCount, [&](int b) {
+        const qint64 begin = bucketStart[b];
+        const qint64 end = bucketStart[b + 1];
+        if (begin == end)
+            return;
+
+        size_t tableSize = 16;
+        while (tableSize < size_t(end - begin) * 2)
+            tableSize <<= 1;
+        std::vector<vtkTypeInt32> table(tableSize, -1);
+
+        std::vector<VertexKey>& points = unique[b];
+        points.reserve(size_t((end - begin) / 4 + 16));  // Closed meshes share each vertex ~6 times
+
+        for (qint64 i = begin; i < end; ++i) {
+            const vtkTypeInt32 corner = sorted[size_t(i)];
+            const VertexKey key = cornerKey(records, corner);
+            size_t slot = size_t(hashKey(key)) & (tableSize - 1);
+
+            for (;;) {
+                vtkTypeInt32 id = table[slot];
+                if (id < 0) {
+                    id = vtkTypeInt32(points.size());
+                    points.push_back(key);
+                    table[slot] = id;
+                    conn[corner] = id;
+                    break;
+                }
+                const VertexKey& p = points[size_t(id)];
+                if (p.x == key.x && p.y == key.y && p.z == key.z) {
+                    conn[corner] = id;
+                    break;
+                }
+                slot = (slot + 1) & (tableSize - 1);
+            }
+        }
+    });
+    file.unmap(data);
+
+    // Pass 4: concatenate per-bucket points and rebase ids to global point indices
+    std::vector<qint64> pointBase(BucketCount + 1, 0);
+    for (int b = 0; b < BucketCount; ++b)
+        pointBase[b + 1] = pointBase[b] + qint64(unique[size_t(b)].size());
+
+    auto coords = vtkSmartPointer<vtkFloatArray>::New();
+    coords->SetNumberOfComponents(3);
+    coords->SetNumberOfTuples(pointBase[BucketCount]);
+    float* xyz = coords->GetPointer(0);
+
+    parallelFor(BucketCount, [&](int b) {
+        std::vector<VertexKey>& points = unique[size_t(b)];
+        if (!points.empty())
+            std::memcpy(xyz + pointBase[b] * 3, points.data(), points.size() * sizeof(VertexKey));
+        std::vector<VertexKey>().swap(points);
+
+        const vtkTypeInt32 base = vtkTypeInt32(pointBase[b]);
+        for (qint64 i = bucketStart[b]; i < bucketStart[b + 1]; ++i)
+            conn[sorted[size_t(i)]] += base;
+    });
+    std::vector<vtkTypeInt32>().swap(sorted);
+
+    // Every cell is a triangle, so offsets are a simple stride of three
+    auto offsets = vtkSmartPointer<vtkTypeInt32Array>::New();
+    offsets->SetNumberOfValues(triangles + 1);
+    vtkTypeInt32* off = offsets->GetPointer(0);
+    for (qint64 t = 0; t <= triangles; ++t)
+        off[t] = vtkTypeInt32(t * 3);
+
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->SetData(coords);
+
+    auto polys = vtkSmartPointer<vtkCellArray>::New();
+    polys->SetData(offsets, connectivity);
+
+    auto polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->SetPoints(points);
+    polyData->SetPolys(polys);
+    return polyData;
+}
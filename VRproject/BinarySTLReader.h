@@ -0,0 +1,50 @@
+/**
+ * @file BinarySTLReader.h
+ * @brief Fast path for loading binary STL files straight from a memory-mapped file.
+ *
+ * vtkSTLReader reads through buffered I/O and merges duplicate vertices with a
+ * point locator on a single thread. This reader maps the file instead, copies the
+ * triangle corners directly into VTK arrays and welds identical vertices with a
+ * parallel hash-based pass, so peak memory stays close to one copy of the mesh.
+ */
+
+#ifndef BINARY_STL_READER_H
+#define BINARY_STL_READER_H
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QString>      // File paths
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkSmartPointer.h>  // Smart pointer management for VTK
+#include <vtkPolyData.h>      // Output mesh
+
+// --------------------------------------- BinarySTLReader Class ---------------------------------------
+/**
+ * @class BinarySTLReader
+ * @brief Reads binary STL files into welded vtkPolyData using a memory-mapped file.
+ *
+ * All functions are static and thread-safe; they only touch objects they create.
+ */
+class BinarySTLReader {
+public:
+    /**
+     * @brief Checks whether a file looks like a binary STL (size matches the triangle count).
+     * @param fileName Path to the file.
+     * @return True if the file can be read by read().
+     */
+    // Returns true if the file is a well-formed binary STL
+    static bool isBinarySTL(const QString& fileName);
+
+    /**
+     * @brief Loads a binary STL file.
+     * @param fileName Path to the file.
+     * @return Welded triangle mesh, or nullptr if the file is not binary STL (e.g. ASCII)
+     *         or cannot be mapped. Callers should then fall back to vtkSTLReader.
+     */
+    // Reads a binary STL file via mmap, welding duplicate vertices in parallel
+    static vtkSmartPointer<vtkPolyData> read(const QString& fileName);
+};
+
+#endif // BINARY_STL_READER_H
@@ -0,0 +1,262 @@
+/**
+ * @file EdgeOverlay.cpp
+ * @brief Implementation of the feature edge overlay.
+ */
+
+#include "EdgeOverlay.h"
+#include "MeshFeatures.h"
+#include "GpuEffects.h"
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkProperty.h>
+#include <vtkCellArray.h>
+#include <vtkPlaneCollection.h>
+
+// --------------------------------------- Edge Appearance ---------------------------------------
+
+namespace {
+
+// Dark grey reads on both light and dark part colours
+const double EdgeColor[3] = { 0.08, 0.08, 0.1 };
+const float  EdgeWidth = 1.5f;
+
+// Pulls the lines towards the camera so they win the depth test against their own faces
+const double LineOffsetUnits = -4.0;
+
+// Priority of the StartEvent observer: below the SectionClipper's, so its planes are already set
+const float ObserverPriority = -2.0f;
+
+} // namespace
+
+// --------------------------------------- Constructor & Destructor ---------------------------------------
+
+/**
+ * @brief Constructs the overlay and its render observer.
+ */
+// Creates the StartEvent callback
+EdgeOverlay::EdgeOverlay()
+    : enabled(false)
+    , observerTag(0)
+{
+    callback = vtkSmartPointer<vtkCallbackCommand>::New();
+    callback->SetClientData(this);
+    callback->SetCallback(&EdgeOverlay::onStartRender);
+}
+
+/**
+ * @brief Removes the edge actors and detaches from the renderer.
+ */
+// Clears the entries, then removes the observer
+EdgeOverlay::~EdgeOverlay()
+{
+    clear();
+    detach();
+}
+
+// --------------------------------------- Renderer ---------------------------------------
+
+/**
+ * @brief Adds the edge actors to a renderer and observes its frames.
+ * @param newRenderer Renderer to draw into.
+ */
+// Moves the edge actors to the renderer and adds the StartEvent observer
+void EdgeOverlay::attach(vtkRenderer* newRenderer)
+{
+    detach();
+    renderer = newRenderer;
+    if (!renderer)
+        return;
+
+    observerTag = renderer->AddObserver(vtkCommand::StartEvent, callback, ObserverPriority);
+    for (const Entry& entry : entries)
+        renderer->AddActor(entry.edges);
+}
+
+/**
+ * @brief Removes the edge actors and the observer from the current renderer.
+ */
+// Stops per-frame updates
+void EdgeOverlay::detach()
+{
+    if (renderer) {
+        if (observerTag)
+            renderer->RemoveObserver(observerTag);
+        for (const Entry& entry : entries)
+            renderer->RemoveActor(entry.edges);
+    }
+    renderer = nullptr;
+    observerTag = 0;
+}
+
+// --------------------------------------- Overlay State ---------------------------------------
+
+/**
+ * @brief Shows or hides the edges; takes effect with the next frame.
+ */
+// Sets the switch read by update()
+void EdgeOverlay::setEnabled(bool enable)
+{
+    enabled = enable;
+}
+
+/**
+ * @brief Returns true while edges are shown.
+ */
+// Overlay switch
+bool EdgeOverlay::isEnabled() const
+{
+    return enabled;
+}
+
+// --------------------------------------- Parts ---------------------------------------
+
+/**
+ * @brief Registers a part actor or refreshes its edges.
+ * @param actor Part actor.
+ * @param mesh  Loaded mesh of the part.
+ *
+ * The line cells are rebuilt only when the mesh changed, so calling this on every
+ * part change is cheap.
+ */
+// Adds or updates an entry; meshes without feature edges unregister the actor
+void EdgeOverlay::setPartEdges(vtkActor* actor, vtkPolyData* mesh)
+{
+    if (!actor)
+        return;
+
+    int index = find(actor);
+    if (index >= 0 && entries[index].mesh.Get() == mesh)
+        return;
+
+    if (!MeshFeatures::featureEdges(mesh)) {
+        remove(actor);
+        return;
+    }
+
+    if (index < 0) {
+        Entry entry;
+        entry.part = actor;
+        entry.mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+        entry.mapper->ScalarVisibilityOff();
+        entry.mapper->SetRelativeCoincidentTopologyLineOffsetParameters(0.0, LineOffsetUnits);
+
+        entry.edges = vtkSmartPointer<vtkActor>::New();
+        entry.edges->SetMapper(entry.mapper);
+        entry.edges->PickableOff();
+        entry.edges->VisibilityOff();
+        vtkProperty* property = entry.edges->GetProperty();
+        property->SetColor(EdgeColor[0], EdgeColor[1], EdgeColor[2]);
+        property->SetLineWidth(EdgeWidth);
+        property->LightingOff();
+
+        entries.append(entry);
+        index = entries.size() - 1;
+        if (renderer)
+            renderer->AddActor(entries[index].edges);
+    }
+
+    build(entries[index], mesh);
+}
+
+/**
+ * @brief Unregisters a part actor.
+ */
+// Drops one entry
+void EdgeOverlay::remove(vtkActor* actor)
+{
+    const int index = find(actor);
+    if (index < 0)
+        return;
+
+    if (renderer)
+        renderer->RemoveActor(entries[index].edges);
+    entries.remove(index);
+}
+
+/**
+ * @brief Unregisters every part actor.
+ */
+// Drops all entries
+void EdgeOverlay::clear()
+{
+    if (renderer) {
+        for (const Entry& entry : entries)
+            renderer->RemoveActor(entry.edges);
+    }
+    entries.clear();
+}
+
+// Returns the entry index for an actor
+int EdgeOverlay::find(vtkActor* actor) const
+{
+    for (int i = 0; i < entries.size(); ++i) {
+        if (entries[i].part.Get() == actor)
+            return i;
+    }
+    return -1;
+}
+
+// --------------------------------------- Per-Frame Update ---------------------------------------
+
+/**
+ * @brief Points an entry's mapper at lines over the mesh's points.
+ * @param entry Entry to rebuild.
+ * @param mesh  Mesh with stored feature edges.
+ */
+// Shares the mesh's points and edge array; nothing is copied
+void EdgeOverlay::build(Entry& entry, vtkPolyData* mesh)
+{
+    auto lines = vtkSmartPointer<vtkPolyData>::New();
+    lines->SetPoints(mesh->GetPoints());
+    lines->SetLines(MeshFeatures::featureEdges(mesh));
+
+    entry.mesh = mesh;
+    entry.mapper->SetInputData(lines);
+}
+
+/**
+ * @brief Brings every edge actor in line with its part for the coming frame.
+ *
+ * Only flags and pointers are compared and set, so a frame with hundreds of parts
+ * costs next to nothing; the matrices are recomputed by VTK as usual.
+ */
+// Visibility, transform and clipping from the part; prunes deleted actors
+void EdgeOverlay::update()
+{
+    for (int i = entries.size() - 1; i >= 0; --i) {
+        Entry& entry = entries[i];
+        if (!entry.part || !entry.mesh) {
+            if (renderer)
+                renderer->RemoveActor(entry.edges);
+            entries.remove(i);
+            continue;
+        }
+
+        vtkMapper* partMapper = entry.part->GetMapper();
+        const bool shown = enabled && entry.part->GetVisibility() && partMapper
+            && partMapper->GetInputDataObject(0, 0) == entry.mesh.Get() && !GpuEffects::isShrunk(entry.part)
+            && renderer && renderer->HasViewProp(entry.part);
+        if (entry.edges->GetVisibility() != int(shown))
+            entry.edges->SetVisibility(shown);
+        if (!shown)
+            continue;
+
+        // The part's matrix object is updated in place, so sharing it keeps the edges attached
+        vtkMatrix4x4* matrix = entry.part->GetMatrix();
+        if (entry.edges->GetUserMatrix() != matrix)
+            entry.edges->SetUserMatrix(matrix);
+
+        if (entry.mapper->GetClippingPlanes() != partMapper->GetClippingPlanes())
+            entry.mapper->SetClippingPlanes(partMapper->GetClippingPlanes());
+    }
+}
+
+/**
+ * @brief StartEvent trampoline.
+ */
+// Forwards the renderer's StartEvent to update()
+void EdgeOverlay::onStartRender(vtkObject* /*caller*/, unsigned long /*eventId*/, void* clientData, void* /*callData*/)
+{
+    static_cast<EdgeOverlay*>(clientData)->update();
+}
@@ -0,0 +1,134 @@
+/**
+ * @file EdgeOverlay.h
+ * @brief Draws the feature edges found at load time on top of the part actors.
+ *
+ * The edges come with the mesh (MeshFeatures stores them in its field data and the
+ * mesh cache keeps them), so showing them costs one line actor per part that shares
+ * the part's points, and nothing is computed when the overlay is switched on.
+ */
+
+#ifndef EDGE_OVERLAY_H
+#define EDGE_OVERLAY_H
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QVector>      // Registered actors
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkSmartPointer.h>      // Smart pointer management for VTK
+#include <vtkWeakPointer.h>       // Entries do not keep parts alive
+#include <vtkActor.h>             // Part and edge actors
+#include <vtkPolyData.h>          // Part meshes
+#include <vtkPolyDataMapper.h>    // Edge mappers
+#include <vtkRenderer.h>          // Renderer the overlay draws into
+#include <vtkCallbackCommand.h>   // StartEvent observer
+
+// --------------------------------------- EdgeOverlay Class ---------------------------------------
+/**
+ * @class EdgeOverlay
+ * @brief Keeps one edge actor per registered part actor in step with it.
+ *
+ * At the start of each frame every edge actor takes its part's transform and
+ * clipping planes, and is shown only while the overlay is enabled, the part is
+ * visible in the renderer and its mapper draws the mesh the edges belong to, as it
+ * is. So a clip or shrink (filter or shader), a coarse level of detail or evicted
+ * geometry simply hide the edges instead of showing them out of place.
+ *
+ * One overlay belongs to exactly one renderer and must only be used from the thread
+ * that renders it.
+ */
+class EdgeOverlay {
+public:
+    /**
+     * @brief Constructs a disabled overlay that is not yet attached to a renderer.
+     */
+    // Constructor: creates the render observer
+    EdgeOverlay();
+
+    /**
+     * @brief Destructor: removes the edge actors and detaches from the renderer.
+     */
+    // Destructor: clears and detaches
+    ~EdgeOverlay();
+
+    EdgeOverlay(const EdgeOverlay&) = delete;
+    EdgeOverlay& operator=(const EdgeOverlay&) = delete;
+
+    /**
+     * @brief Adds the edge actors to a renderer and follows its frames.
+     * @param renderer Renderer to draw into.
+     */
+    // Observes the renderer's StartEvent
+    void attach(vtkRenderer* renderer);
+
+    /**
+     * @brief Removes the edge actors and the observer from the renderer.
+     */
+    // Stops drawing
+    void detach();
+
+    /**
+     * @brief Shows or hides every registered part's edges.
+     */
+    // Overlay switch
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief Returns true while edges are shown.
+     */
+    // Overlay state
+    bool isEnabled() const;
+
+    /**
+     * @brief Registers a part actor or refreshes its edges.
+     * @param actor Part actor.
+     * @param mesh  Mesh the part was loaded with; without stored feature edges the
+     *              actor is unregistered.
+     */
+    // Adds, updates or removes one part's edge actor
+    void setPartEdges(vtkActor* actor, vtkPolyData* mesh);
+
+    /**
+     * @brief Unregisters a part actor and removes its edge actor.
+     */
+    // Removes one part
+    void remove(vtkActor* actor);
+
+    /**
+     * @brief Unregisters all part actors.
+     */
+    // Removes every part
+    void clear();
+
+private:
+    /**
+     * @brief One registered part actor.
+     */
+    struct Entry {
+        vtkWeakPointer<vtkActor> part;                  // Dropped automatically when the part is deleted
+        vtkWeakPointer<vtkPolyData> mesh;               // Mesh whose edges are drawn
+        vtkSmartPointer<vtkActor> edges;                // Line actor added to the renderer
+        vtkSmartPointer<vtkPolyDataMapper> mapper;      // Mapper of edges
+    };
+
+    // Builds the line actor of an entry from its mesh
+    void build(Entry& entry, vtkPolyData* mesh);
+
+    // Shows, moves and clips the edge actors (called before each render)
+    void update();
+
+    // VTK observer trampoline
+    static void onStartRender(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+
+    // Returns the index of the actor's entry, or -1
+    int find(vtkActor* actor) const;
+
+    QVector<Entry> entries;                         // Registered actors (tens to hundreds)
+    bool enabled;                                   // Overlay switch
+    vtkWeakPointer<vtkRenderer> renderer;           // Renderer holding the edge actors
+    vtkSmartPointer<vtkCallbackCommand> callback;   // StartEvent observer
+    unsigned long observerTag;                      // Tag returned by AddObserver
+};
+
+#endif // EDGE_OVERLAY_H
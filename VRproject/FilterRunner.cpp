@@ -0,0 +1,262 @@
+/**
+ * @file FilterRunner.cpp
+ * @brief Implementation of background filter jobs.
+ */
+
+#include "FilterRunner.h"
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QtConcurrent>
+
+// --------------------------------------- Constructor & Destructor ---------------------------------------
+
+/**
+ * @brief Constructs a runner with no jobs.
+ * @param parent Optional QObject parent.
+ */
+// Starts idle
+FilterRunner::FilterRunner(QObject* parent)
+    : QObject(parent)
+    , openBatch(0)
+    , nextBatch(1)
+{
+}
+
+/**
+ * @brief Cancels running jobs, then waits for their workers.
+ */
+// Waits for the workers
+FilterRunner::~FilterRunner()
+{
+    for (const Job& job : jobs)
+        job.cancel->store(true);
+    workers.waitForAll();
+}
+
+// --------------------------------------- Public Interface ---------------------------------------
+
+/**
+ * @brief Starts a job, or cancels the running one and queues a single restart.
+ * @param part Part whose settings changed.
+ */
+// Supersedes stale work
+void FilterRunner::schedule(ModelPart* part)
+{
+    if (!part)
+        return;
+
+    auto it = jobs.find(part);
+    if (it != jobs.end()) {
+        // A result held for its batch is stale now: rerun it within the same batch
+        if (it->done) {
+            const int batch = it->batch;
+            jobs.erase(it);
+            rejoin(part, batch);
+            return;
+        }
+        it->again = true;
+        it->cancel->store(true);
+        return;
+    }
+    if (start(part, openBatch) && openBatch)
+        batches[openBatch].parts << part;
+}
+
+/**
+ * @brief Opens a batch; jobs started until endBatch() are delivered together.
+ */
+// Allocates a batch id
+void FilterRunner::beginBatch()
+{
+    if (openBatch)
+        return;
+
+    openBatch = nextBatch++;
+    batches[openBatch].open = true;
+}
+
+/**
+ * @brief Closes the open batch and delivers it if its jobs are already done.
+ */
+// Stops adding jobs to the batch
+void FilterRunner::endBatch()
+{
+    if (!openBatch)
+        return;
+
+    const int batch = openBatch;
+    openBatch = 0;
+    batches[batch].open = false;
+    if (batches[batch].running == 0)
+        deliver(batch);
+}
+
+/**
+ * @brief Cancels a part's job; its result is discarded when the worker returns.
+ * @param part Part about to be deleted.
+ */
+// Drops the job
+void FilterRunner::forget(ModelPart* part)
+{
+    auto it = jobs.find(part);
+    if (it == jobs.end())
+        return;
+
+    it->cancel->store(true);
+    const int batch = it->done ? 0 : it->batch;
+    jobs.erase(it);
+
+    // The worker's result will be ignored, so it no longer holds up its batch
+    if (batch)
+        batchWorkerDone(batch);
+}
+
+/**
+ * @brief Returns true when no job is running or waiting for its batch.
+ */
+// No job entries left
+bool FilterRunner::isIdle() const
+{
+    return jobs.isEmpty();
+}
+
+// --------------------------------------- Jobs ---------------------------------------
+
+/**
+ * @brief Hands the part's pipeline to a worker.
+ * @param part  Part to filter.
+ * @param batch Batch the job belongs to, or 0.
+ * @return False if the part has nothing to filter.
+ *
+ * The job counts as a running worker of its batch; callers add new parts to the
+ * batch's part list themselves, so a rerun does not list its part twice.
+ */
+// Begins a job on the thread pool
+bool FilterRunner::start(ModelPart* part, int batch)
+{
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
+    vtkSmartPointer<vtkAlgorithm> stage = part->beginFilterJob(cancel);
+    if (!stage)
+        return false;
+
+    QFutureWatcherBase* watcher = workers.watch(this, QtConcurrent::run(&ModelPart::runFilterJob, stage, cancel),
+                                                [this, part](QFutureWatcher<vtkSmartPointer<vtkPolyData>>* finished) {
+        vtkSmartPointer<vtkPolyData> output = finished->result();
+
+        // Forgotten parts may already be deleted
+        auto it = jobs.find(part);
+        if (it == jobs.end() || it->watcher != finished)
+            return;
+
+        it->output = output;
+
+        // Batched results wait for the rest of their batch; superseded ones rerun in it first
+        if (it->batch) {
+            const int batch = it->batch;
+            if (it->again) {
+                jobs.erase(it);
+                rejoin(part, batch);
+            }
+            else {
+                it->done = true;
+            }
+            batchWorkerDone(batch);
+            return;
+        }
+
+        const Job job = it.value();
+        jobs.erase(it);
+        if (finish(part, job))
+            emit partFiltered(part);
+    });
+
+    Job job;
+    job.watcher = watcher;
+    job.cancel = cancel;
+    job.batch = batch;
+    jobs.insert(part, job);
+    if (batch)
+        ++batches[batch].running;
+    return true;
+}
+
+/**
+ * @brief Restarts a superseded batched job without leaving its batch.
+ * @param part  Part of the job (already removed from jobs).
+ * @param batch Batch the job belongs to.
+ *
+ * The batch is still waiting, so the rerun keeps it from being delivered until
+ * the part's latest settings are done too.
+ */
+// Drops the stale job's pipeline state and starts the rerun
+void FilterRunner::rejoin(ModelPart* part, int batch)
+{
+    part->finishFilterJob(nullptr);
+    start(part, batch);
+}
+
+/**
+ * @brief Shows a finished job's result, or restarts the job if the settings changed meanwhile.
+ * @param part Part of the job (already removed from jobs).
+ * @param job  The finished job.
+ * @return True if the part now shows a new result.
+ */
+// Hands the pipeline back to the part
+bool FilterRunner::finish(ModelPart* part, Job job)
+{
+    part->finishFilterJob(job.again ? nullptr : job.output);
+    if (job.again) {
+        if (start(part, openBatch) && openBatch)
+            batches[openBatch].parts << part;
+        return false;
+    }
+    return job.output != nullptr;
+}
+
+// --------------------------------------- Batches ---------------------------------------
+
+/**
+ * @brief Counts down a batch's running workers.
+ * @param batch Batch id.
+ */
+// Delivers the batch once it is closed and its last worker is done
+void FilterRunner::batchWorkerDone(int batch)
+{
+    auto it = batches.find(batch);
+    if (it == batches.end())
+        return;
+
+    if (--it->running > 0 || it->open)
+        return;
+    deliver(batch);
+}
+
+/**
+ * @brief Shows all held results of a batch in one step.
+ * @param batch Batch id.
+ *
+ * Every part is switched over before the first partFiltered(), so listeners that
+ * request a render see the whole batch in the frame they draw.
+ */
+// Finishes the batch's jobs, then emits partFiltered() for each
+void FilterRunner::deliver(int batch)
+{
+    const Batch finished = batches.take(batch);
+
+    QList<ModelPart*> filtered;
+    for (ModelPart* part : finished.parts) {
+        // Forgotten parts have no job any more (and may be deleted)
+        auto it = jobs.find(part);
+        if (it == jobs.end() || it->batch != batch || !it->done)
+            continue;
+
+        const Job job = it.value();
+        jobs.erase(it);
+        if (finish(part, job))
+            filtered << part;
+    }
+
+    for (ModelPart* part : filtered)
+        emit partFiltered(part);
+}
@@ -0,0 +1,140 @@
+/**
+ * @file FilterRunner.h
+ * @brief Background execution of ModelPart filter pipelines.
+ *
+ * Shrink and clip on multi-million-cell parts take seconds, so they run on the
+ * global Qt thread pool while the previous geometry stays on screen. The result
+ * replaces it in a single step on the GUI thread.
+ */
+
+#ifndef FILTER_RUNNER_H
+#define FILTER_RUNNER_H
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QObject>          // Base class for signals/slots
+#include <QHash>            // Running job per part
+#include <QList>            // Parts of a batch
+
+#include "ModelPart.h"      // Filter jobs
+#include "TrackedWatchers.h"    // Tracks the worker updates
+
+// --------------------------------------- FilterRunner Class ---------------------------------------
+/**
+ * @class FilterRunner
+ * @brief Runs at most one filter job per part and supersedes stale ones.
+ *
+ * When a part's settings change while its job is running, that job is cancelled
+ * and one new job for the latest settings follows, so rapid toggling never queues
+ * up work. Signals are emitted on the thread that owns the runner (the GUI thread).
+ *
+ * Jobs scheduled between beginBatch() and endBatch() run in parallel as usual, but
+ * their results are held back until the last of them is done and then shown
+ * together, so a change to many parts lands in one frame. A part rescheduled before
+ * its batch is delivered is rerun within that batch.
+ */
+class FilterRunner : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor.
+     * @param parent Optional QObject parent.
+     */
+    // Constructor: no jobs
+    explicit FilterRunner(QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor: waits for jobs still running.
+     */
+    // Destructor: waits for the workers
+    ~FilterRunner();
+
+    /**
+     * @brief Filters a part for its current settings; partFiltered() follows.
+     * @param part Part whose filter settings changed.
+     */
+    // Starts, or supersedes, the part's job
+    void schedule(ModelPart* part);
+
+    /**
+     * @brief Groups the jobs scheduled until endBatch() so their results are shown together.
+     *
+     * Batches do not nest; a second call before endBatch() is ignored.
+     */
+    // Opens a batch
+    void beginBatch();
+
+    /**
+     * @brief Closes the batch opened by beginBatch().
+     *
+     * The batch is delivered once its jobs are done, straight away if they already are.
+     */
+    // Closes the batch
+    void endBatch();
+
+    /**
+     * @brief Drops a part's job before the part is deleted.
+     * @param part Part about to be deleted.
+     */
+    // Cancels a job without delivering it
+    void forget(ModelPart* part);
+
+    /**
+     * @brief Returns true when no job is running or holding back its result.
+     */
+    // True once every scheduled part has been delivered or forgotten
+    bool isIdle() const;
+
+signals:
+    /**
+     * @brief Emitted when a part shows the result of its latest settings.
+     * @param part The filtered part.
+     */
+    void partFiltered(ModelPart* part);
+
+private:
+    /**
+     * @brief The running job of one part.
+     */
+    struct Job {
+        QFutureWatcherBase* watcher = nullptr;  // Watcher of the worker update
+        ModelPart::FilterCancel cancel;         // Set to abort the update
+        bool again = false;                     // Settings changed while running
+        int batch = 0;                          // Batch the job belongs to (0: none)
+        bool done = false;                      // Worker finished; result held for the batch
+        vtkSmartPointer<vtkPolyData> output;    // Held result
+    };
+
+    /**
+     * @brief Parts of one batch and the number of their workers still running.
+     */
+    struct Batch {
+        QList<ModelPart*> parts;    // In scheduling order
+        int running = 0;            // Workers not yet finished
+        bool open = false;          // Still between beginBatch() and endBatch()
+    };
+
+    // Starts a job for the part's current settings; false if there was nothing to run
+    bool start(ModelPart* part, int batch = 0);
+
+    // Reruns a superseded job of a batch that has not been delivered yet
+    void rejoin(ModelPart* part, int batch);
+
+    // Applies a finished job's result (or restarts it); true if partFiltered() should follow
+    bool finish(ModelPart* part, Job job);
+
+    // Marks one worker of a batch as done and delivers the batch after the last one
+    void batchWorkerDone(int batch);
+
+    // Shows every held result of a batch, then announces the parts
+    void deliver(int batch);
+
+    QHash<ModelPart*, Job> jobs;            // Running job per part
+    TrackedWatchers workers;                // Updates still running, including forgotten ones
+    QHash<int, Batch> batches;              // Batches not yet delivered
+    int openBatch;                          // Batch new jobs join (0: none)
+    int nextBatch;                          // Id of the next batch
+};
+
+#endif // FILTER_RUNNER_H
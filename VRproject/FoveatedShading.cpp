@@ -0,0 +1,403 @@
+/**
+ * @file FoveatedShading.cpp
+ * @brief Implementation of the adaptive foveated shading of the VR renderer.
+ */
+
+#include "FoveatedShading.h"
+#include "FramePacer.h"
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkRenderWindow.h>
+#include <vtkCamera.h>
+#include <vtk_glad.h>
+
+// --------------------------------------- OpenVR Includes ---------------------------------------
+
+#include <openvr.h>
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// --------------------------------------- Foveation Levels ---------------------------------------
+
+namespace {
+
+/**
+ * @brief Ring radii of one quality level, relative to half the eye image (1 reaches the edge midpoints).
+ */
+struct Rings {
+    double full;    // Inside: every pixel shaded
+    double half;    // Inside: one shade per 2x2 block; outside: one per 4x4 block
+};
+
+// Levels 1..MaxLevel; at level 1 only the corners drop to 4x4
+const Rings LevelRings[FoveatedShading::MaxLevel] = {
+    { 0.80, 1.20 },
+    { 0.65, 1.00 },
+    { 0.50, 0.85 },
+    { 0.35, 0.70 },
+};
+
+// A frame whose GPU time exceeds this share of the budget raises the level
+const double HighShare = 0.85;
+
+// Frames below this share of the budget count as headroom
+const double LowShare = 0.60;
+
+// Frames the level waits after rising, so the smoothed GPU time can follow
+const int RaiseCooldownFrames = 10;
+
+// Frames of headroom (about a second) before the level drops again
+const int LowerFrames = 90;
+
+} // namespace
+
+// --------------------------------------- Constructor & Destructor ---------------------------------------
+
+/**
+ * @brief Constructs the helper and its render observers.
+ */
+// Creates the callbacks; foveation is centred until start() reads the lenses
+FoveatedShading::FoveatedShading()
+    : startTag(0)
+    , endTag(0)
+    , images{ 0, 0 }
+    , focus{ { 0.5, 0.5 }, { 0.5, 0.5 } }
+    , builtLevel(-1)
+    , builtSize{ 0, 0 }
+    , active(false)
+    , supported(-1)
+    , headroomFrames(0)
+    , cooldownFrames(0)
+    , lastMissed(0)
+    , level(0)
+    , adaptive(false)
+    , available(false)
+{
+    startCallback = vtkSmartPointer<vtkCallbackCommand>::New();
+    startCallback->SetClientData(this);
+    startCallback->SetCallback(&FoveatedShading::onStartRender);
+
+    endCallback = vtkSmartPointer<vtkCallbackCommand>::New();
+    endCallback->SetClientData(this);
+    endCallback->SetCallback(&FoveatedShading::onEndRender);
+}
+
+/**
+ * @brief Detaches from the renderer. GL resources must already have been released.
+ */
+// Removes the observers
+FoveatedShading::~FoveatedShading()
+{
+    detach();
+}
+
+// --------------------------------------- Renderer ---------------------------------------
+
+/**
+ * @brief Observes the renderer so every eye it draws is foveated.
+ * @param newRenderer VR renderer.
+ */
+// Adds the Start/End observers
+void FoveatedShading::attach(vtkRenderer* newRenderer)
+{
+    detach();
+    renderer = newRenderer;
+    if (renderer) {
+        startTag = renderer->AddObserver(vtkCommand::StartEvent, startCallback);
+        endTag = renderer->AddObserver(vtkCommand::EndEvent, endCallback);
+    }
+}
+
+/**
+ * @brief Removes the observers from the current renderer.
+ */
+// Stops foveating
+void FoveatedShading::detach()
+{
+    if (renderer) {
+        if (startTag)
+            renderer->RemoveObserver(startTag);
+        if (endTag)
+            renderer->RemoveObserver(endTag);
+    }
+    renderer = nullptr;
+    startTag = 0;
+    endTag = 0;
+}
+
+/**
+ * @brief Centres each eye's full-density region on its projection centre.
+ *
+ * Headset lenses are not centred in the eye images; the projection's raw tangents
+ * give where the optical axis crosses each image.
+ */
+// Reads the lens centres from the HMD
+void FoveatedShading::start()
+{
+    vr::IVRSystem* system = vr::VRSystem();
+    if (!system)
+        return;
+
+    const vr::EVREye eyes[2] = { vr::Eye_Left, vr::Eye_Right };
+    for (int eye = 0; eye < 2; ++eye) {
+        float left, right, top, bottom;
+        system->GetProjectionRaw(eyes[eye], &left, &right, &top, &bottom);
+        if (right - left <= 0.0f || bottom - top <= 0.0f)
+            continue;
+
+        // OpenVR's top tangent is negative (y points down); GL rows count from the bottom
+        setFocus(eye == 0, -left / (right - left), bottom / (bottom - top));
+    }
+}
+
+/**
+ * @brief Moves the full-density region of one eye.
+ * @param leftEye True for the left eye.
+ * @param x       0 (left) to 1 (right).
+ * @param y       0 (bottom) to 1 (top).
+ */
+// Stores the centre; the images are rebuilt before the next eye is drawn
+void FoveatedShading::setFocus(bool leftEye, double x, double y)
+{
+    const int eye = leftEye ? 0 : 1;
+    focus[eye][0] = std::clamp(x, 0.0, 1.0);
+    focus[eye][1] = std::clamp(y, 0.0, 1.0);
+    builtLevel = -1;
+}
+
+// --------------------------------------- Quality Level ---------------------------------------
+
+/**
+ * @brief Switches adaptive quality.
+ * @param enabled True to let update() coarsen the periphery.
+ */
+// Turning it off drops back to full density
+void FoveatedShading::setAdaptive(bool enabled)
+{
+    adaptive.store(enabled, std::memory_order_relaxed);
+    if (!enabled)
+        level.store(0, std::memory_order_relaxed);
+    headroomFrames = 0;
+    cooldownFrames = 0;
+}
+
+/**
+ * @brief Moves the level one step with the last frame's timing.
+ * @param pacer Pacer that timed the frame.
+ *
+ * A missed vsync or a GPU time near the budget raises the level right away (then
+ * waits a few frames for the smoothed time to follow). The level only drops after
+ * a second of clear headroom, so it does not flicker between two levels.
+ */
+// Hysteresis controller on the compositor's GPU time and missed frames
+void FoveatedShading::update(const FramePacer& pacer)
+{
+    const std::uint32_t missed = pacer.getMissedFrames();
+    const bool missedNew = missed != lastMissed;
+    lastMissed = missed;
+
+    if (!adaptive.load(std::memory_order_relaxed) || !available.load(std::memory_order_relaxed))
+        return;
+
+    const double budget = pacer.getFrameBudgetMs();
+    const double gpu = pacer.getGpuMs();
+    const bool over = missedNew || (gpu >= 0.0 && gpu > HighShare * budget);
+    const bool under = !missedNew && gpu >= 0.0 && gpu < LowShare * budget;
+
+    if (cooldownFrames > 0)
+        --cooldownFrames;
+
+    const int current = level.load(std::memory_order_relaxed);
+    if (over) {
+        headroomFrames = 0;
+        if (cooldownFrames == 0 && current < MaxLevel) {
+            level.store(current + 1, std::memory_order_relaxed);
+            cooldownFrames = RaiseCooldownFrames;
+        }
+    }
+    else if (under) {
+        if (++headroomFrames >= LowerFrames && current > 0) {
+            level.store(current - 1, std::memory_order_relaxed);
+            headroomFrames = 0;
+        }
+    }
+    else {
+        headroomFrames = 0;
+    }
+}
+
+/**
+ * @brief Returns the current quality level.
+ */
+// 0 = full density
+int FoveatedShading::getLevel() const
+{
+    return level.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Builds the overlay line.
+ */
+// Shading summary
+QString FoveatedShading::summaryText() const
+{
+    if (!adaptive.load(std::memory_order_relaxed))
+        return QString("VR shading full");
+    if (!available.load(std::memory_order_relaxed))
+        return QString("VR shading adaptive | no variable rate shading on this GPU");
+    return QString("VR shading adaptive | foveation level %1/%2").arg(getLevel()).arg(MaxLevel);
+}
+
+// --------------------------------------- Rate Images ---------------------------------------
+
+/**
+ * @brief Enables the rate image of the eye about to be drawn.
+ *
+ * Support is checked here the first time, because it needs the VR context current.
+ */
+// Binds and enables the shading rate image
+void FoveatedShading::begin()
+{
+#ifdef GL_NV_shading_rate_image
+    if (supported < 0) {
+        supported = GLAD_GL_NV_shading_rate_image ? 1 : 0;
+        available.store(supported == 1, std::memory_order_relaxed);
+    }
+    if (supported != 1 || level.load(std::memory_order_relaxed) == 0 || !renderer)
+        return;
+
+    const int* size = renderer->GetRenderWindow()->GetSize();
+    if (builtLevel != level.load(std::memory_order_relaxed) || builtSize[0] != size[0] || builtSize[1] != size[1])
+        build();
+    if (!images[0] || !images[1])
+        return;
+
+    // VTK draws the eyes one after the other and marks the camera of the current one
+    const bool leftEye = renderer->GetActiveCamera()->GetLeftEye() != 0;
+    const GLenum palette[3] = {
+        GL_SHADING_RATE_1_INVOCATION_PER_PIXEL_NV,
+        GL_SHADING_RATE_1_INVOCATION_PER_2X2_PIXELS_NV,
+        GL_SHADING_RATE_1_INVOCATION_PER_4X4_PIXELS_NV,
+    };
+    glBindShadingRateImageNV(images[leftEye ? 0 : 1]);
+    glShadingRateImagePaletteNV(0, 0, 3, palette);
+    glEnable(GL_SHADING_RATE_IMAGE_NV);
+    active = true;
+#else
+    supported = 0;
+#endif
+}
+
+/**
+ * @brief Disables the rate image after an eye has been drawn.
+ */
+// Leaves the context as VTK expects it
+void FoveatedShading::end()
+{
+#ifdef GL_NV_shading_rate_image
+    if (!active)
+        return;
+    glDisable(GL_SHADING_RATE_IMAGE_NV);
+    glBindShadingRateImageNV(0);
+    active = false;
+#endif
+}
+
+/**
+ * @brief Rebuilds both eyes' rate images for the current level.
+ *
+ * Each texel covers one tile of the eye image (16x16 pixels on current GPUs) and holds
+ * a palette index: 0 full density, 1 one shade per 2x2, 2 one shade per 4x4. The
+ * images are a few kilobytes and only change with the level or the render size.
+ */
+// Fills R8UI palette indices from the foveation rings
+void FoveatedShading::build()
+{
+#ifdef GL_NV_shading_rate_image
+    releaseGraphicsResources();
+
+    const int current = level.load(std::memory_order_relaxed);
+    const int* size = renderer->GetRenderWindow()->GetSize();
+    builtLevel = current;
+    builtSize[0] = size[0];
+    builtSize[1] = size[1];
+    if (current == 0 || size[0] <= 0 || size[1] <= 0)
+        return;
+
+    GLint texel[2] = { 16, 16 };
+    glGetIntegerv(GL_SHADING_RATE_IMAGE_TEXEL_WIDTH_NV, &texel[0]);
+    glGetIntegerv(GL_SHADING_RATE_IMAGE_TEXEL_HEIGHT_NV, &texel[1]);
+    const int width = (size[0] + texel[0] - 1) / std::max(1, int(texel[0]));
+    const int height = (size[1] + texel[1] - 1) / std::max(1, int(texel[1]));
+
+    GLint previousTexture = 0;
+    GLint previousAlignment = 4;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    const Rings& rings = LevelRings[current - 1];
+    std::vector<unsigned char> rates(std::size_t(width) * std::size_t(height));
+    for (int eye = 0; eye < 2; ++eye) {
+        for (int y = 0; y < height; ++y) {
+            const double dy = ((y + 0.5) / height - focus[eye][1]) * 2.0;
+            for (int x = 0; x < width; ++x) {
+                const double dx = ((x + 0.5) / width - focus[eye][0]) * 2.0;
+                const double distance = std::sqrt(dx * dx + dy * dy);
+                rates[std::size_t(y) * width + x] = distance < rings.full ? 0 : (distance < rings.half ? 1 : 2);
+            }
+        }
+
+        // Shading rate images must have immutable storage
+        glGenTextures(1, &images[eye]);
+        glBindTexture(GL_TEXTURE_2D, images[eye]);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_R8UI, width, height);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RED_INTEGER, GL_UNSIGNED_BYTE, rates.data());
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+    glBindTexture(GL_TEXTURE_2D, GLuint(previousTexture));
+#endif
+}
+
+/**
+ * @brief Deletes the rate images.
+ */
+// Frees both textures; they are rebuilt on demand
+void FoveatedShading::releaseGraphicsResources()
+{
+    end();
+    for (unsigned int& image : images) {
+        if (image) {
+            GLuint handle = image;
+            glDeleteTextures(1, &handle);
+            image = 0;
+        }
+    }
+    builtLevel = -1;
+}
+
+// --------------------------------------- Observers ---------------------------------------
+
+/**
+ * @brief StartEvent trampoline.
+ */
+// Forwards the renderer's StartEvent to begin()
+void FoveatedShading::onStartRender(vtkObject* /*caller*/, unsigned long /*eventId*/, void* clientData, void* /*callData*/)
+{
+    static_cast<FoveatedShading*>(clientData)->begin();
+}
+
+/**
+ * @brief EndEvent trampoline.
+ */
+// Forwards the renderer's EndEvent to end()
+void FoveatedShading::onEndRender(vtkObject* /*caller*/, unsigned long /*eventId*/, void* clientData, void* /*callData*/)
+{
+    static_cast<FoveatedShading*>(clientData)->end();
+}
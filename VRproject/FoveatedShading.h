@@ -0,0 +1,166 @@
+/**
+ * @file FoveatedShading.h
+ * @brief Adaptive, foveated shading resolution for the OpenVR renderer.
+ *
+ * Headset frames are mostly limited by fill rate, and most of each eye's pixels
+ * sit in the lens periphery where the optics blur them anyway. With variable rate
+ * shading (GL_NV_shading_rate_image) the periphery is shaded once per 2x2 or 4x4
+ * pixel block while the lens centre keeps full density. How far the coarse rings
+ * reach is raised and lowered with the measured GPU frame time, so a heavy scene
+ * loses peripheral detail instead of frames.
+ */
+
+#ifndef FOVEATED_SHADING_H
+#define FOVEATED_SHADING_H
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QString>      // Overlay summary line
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkSmartPointer.h>      // Smart pointer management for VTK
+#include <vtkWeakPointer.h>       // Observed renderer
+#include <vtkRenderer.h>          // Renderer whose eyes are shaded
+#include <vtkCallbackCommand.h>   // Start/End render observers
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <atomic>       // Level and state read from the GUI thread
+#include <cstdint>      // Missed-frame counter
+
+class FramePacer;
+
+// --------------------------------------- FoveatedShading Class ---------------------------------------
+/**
+ * @class FoveatedShading
+ * @brief Applies a per-eye shading rate image to one VR renderer and adapts it to the frame time.
+ *
+ * The quality level runs from 0 (full density everywhere) to MaxLevel (only a small
+ * central disc at full density). update() raises it as soon as frames run over the
+ * GPU budget and lowers it again after a second of headroom. The foveation centre
+ * defaults to each eye's lens centre; an eye tracker can move it with setFocus().
+ *
+ * Without driver support for shading rate images the level stays at 0 and nothing
+ * is changed. One instance belongs to exactly one renderer and must only be used
+ * from the thread that renders it; only the getters and summaryText() may be called
+ * from other threads.
+ */
+class FoveatedShading {
+public:
+    /**
+     * @brief Highest quality level (the coarsest foveation).
+     */
+    static const int MaxLevel = 4;
+
+    /**
+     * @brief Constructs a helper with adaptive quality off.
+     */
+    // Constructor: creates the render observers
+    FoveatedShading();
+
+    /**
+     * @brief Destructor: detaches from the renderer.
+     */
+    // Destructor: removes the observers
+    ~FoveatedShading();
+
+    FoveatedShading(const FoveatedShading&) = delete;
+    FoveatedShading& operator=(const FoveatedShading&) = delete;
+
+    /**
+     * @brief Starts shading each eye the renderer draws with the current rate image.
+     * @param renderer VR renderer.
+     */
+    // Observes the renderer's Start and End events
+    void attach(vtkRenderer* renderer);
+
+    /**
+     * @brief Stops observing the renderer.
+     */
+    // Removes the observers
+    void detach();
+
+    /**
+     * @brief Centres the foveation on each eye's lens, as reported by the headset.
+     *
+     * Must be called after the OpenVR runtime has been initialised.
+     */
+    // Reads the per-eye projection centres
+    void start();
+
+    /**
+     * @brief Moves the full-density region of one eye.
+     * @param leftEye True for the left eye.
+     * @param x       Horizontal position, 0 (left) to 1 (right) across the eye image.
+     * @param y       Vertical position, 0 (bottom) to 1 (top).
+     */
+    // Sets the foveation centre (lens centre or tracked gaze)
+    void setFocus(bool leftEye, double x, double y);
+
+    /**
+     * @brief Turns frame-time driven foveation on or off.
+     * @param enabled False returns to full density at once.
+     */
+    // Switches adaptive quality
+    void setAdaptive(bool enabled);
+
+    /**
+     * @brief Adjusts the quality level from the last frame's timing. Call once per frame.
+     * @param pacer Pacer that timed the frame.
+     */
+    // Raises the level on overruns, lowers it after sustained headroom
+    void update(const FramePacer& pacer);
+
+    /**
+     * @brief Releases the rate images. Call while the VR context is still current.
+     */
+    // Frees GL resources
+    void releaseGraphicsResources();
+
+    /**
+     * @brief Returns the current quality level (0 = full density).
+     */
+    // Current level
+    int getLevel() const;
+
+    /**
+     * @brief Returns a one-line summary for the overlay.
+     */
+    // "VR shading" line: mode, level and support
+    QString summaryText() const;
+
+private:
+    // Binds the current eye's rate image and enables foveation (renderer StartEvent)
+    void begin();
+
+    // Disables foveation so later drawing in the context is unaffected (renderer EndEvent)
+    void end();
+
+    // Rebuilds both rate images for the current level and render size
+    void build();
+
+    // VTK observer trampolines
+    static void onStartRender(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+    static void onEndRender(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+
+    vtkWeakPointer<vtkRenderer> renderer;               // Observed renderer
+    vtkSmartPointer<vtkCallbackCommand> startCallback;  // StartEvent observer
+    vtkSmartPointer<vtkCallbackCommand> endCallback;    // EndEvent observer
+    unsigned long startTag;                             // Tags returned by AddObserver
+    unsigned long endTag;
+    unsigned int images[2];                             // GL rate image per eye (left, right), 0 if none
+    double focus[2][2];                                 // Foveation centre per eye, 0-1 across the image
+    int builtLevel;                                     // Level the images were built for (-1: none)
+    int builtSize[2];                                   // Eye size the images were built for
+    bool active;                                        // True between begin() and end()
+    int supported;                                      // -1 until checked in a live context, then 0/1
+    int headroomFrames;                                 // Consecutive frames well inside budget
+    int cooldownFrames;                                 // Frames until the level may rise again
+    std::uint32_t lastMissed;                           // Pacer missed count at the previous update
+    std::atomic<int> level;                             // Current quality level
+    std::atomic<bool> adaptive;                         // Adaptive quality requested
+    std::atomic<bool> available;                        // Driver supports shading rate images
+};
+
+#endif // FOVEATED_SHADING_H
@@ -0,0 +1,273 @@
+/**
+ * @file FramePacer.cpp
+ * @brief Implementation of the VR loop's frame pacing and missed-frame counting.
+ */
+
+#include "FramePacer.h"
+
+// --------------------------------------- OpenVR Includes ---------------------------------------
+
+#include <openvr.h>
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <algorithm>
+#include <cmath>
+
+// --------------------------------------- Pacing Constants ---------------------------------------
+
+namespace {
+
+// The compositor releases WaitGetPoses about this long before vsync; work must be done by then
+const double RunningStartMs = 3.0;
+
+// Share of a frame that work may take when the compositor's timing looks off (it rolls over early)
+const double MaxWorkShare = 0.5;
+
+// Work allowed even when a frame is already late, so queued edits keep moving
+const double MinWorkMs = 0.5;
+
+// Without a compositor a frame longer than this many periods counts as missed
+const double LateFactor = 1.5;
+
+// Frames between percentile updates
+const int PercentileInterval = 45;
+
+// Weight of the newest frame in the smoothed GPU time
+const double GpuSmoothing = 0.1;
+
+} // namespace
+
+// --------------------------------------- Constructor ---------------------------------------
+
+/**
+ * @brief Constructs a pacer for a DefaultRefreshHz display.
+ */
+// Starts with default timing and no statistics
+FramePacer::FramePacer()
+    : refreshRate(DefaultRefreshHz)
+    , missedFrames(0)
+    , percentileMs(0.0)
+    , gpuMs(-1.0)
+    , stepSeconds(1.0 / DefaultRefreshHz)
+    , accumulator(0.0)
+    , hasCompositor(false)
+    , statsBaseline(0)
+    , lateFrames(0)
+    , intervals{}
+    , intervalCount(0)
+{
+}
+
+// --------------------------------------- Frame Loop ---------------------------------------
+
+/**
+ * @brief Reads the headset refresh rate and resets every statistic.
+ */
+// Queries the HMD refresh and the compositor's counters
+void FramePacer::start()
+{
+    double hz = DefaultRefreshHz;
+    if (vr::IVRSystem* system = vr::VRSystem()) {
+        const float reported = system->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd,
+                                                                     vr::Prop_DisplayFrequency_Float);
+        if (reported > 1.0f)
+            hz = reported;
+    }
+    refreshRate.store(hz, std::memory_order_relaxed);
+    stepSeconds = 1.0 / hz;
+
+    hasCompositor = vr::VRCompositor() != nullptr;
+    statsBaseline = 0;
+    if (hasCompositor) {
+        vr::Compositor_CumulativeStats stats;
+        vr::VRCompositor()->GetCumulativeStats(&stats, sizeof(stats));
+        statsBaseline = stats.m_nNumReprojectedFrames + stats.m_nNumDroppedFrames;
+    }
+
+    lateFrames = 0;
+    intervalCount = 0;
+    accumulator = 0.0;
+    missedFrames.store(0, std::memory_order_relaxed);
+    percentileMs.store(0.0, std::memory_order_relaxed);
+    gpuMs.store(-1.0, std::memory_order_relaxed);
+
+    lastStep = lastFrameEnd = deadline = Clock::now();
+}
+
+/**
+ * @brief Sets the end of this frame's work window.
+ *
+ * The window runs until the compositor is about to release the next WaitGetPoses;
+ * past that point any further work would start the next render late.
+ */
+// Deadline = now + (time to vsync - running start), clamped
+void FramePacer::beginFrame()
+{
+    const double budgetMs = 1000.0 * stepSeconds;
+    double slackMs = budgetMs * MaxWorkShare;
+    if (hasCompositor)
+        slackMs = 1000.0 * vr::VRCompositor()->GetFrameTimeRemaining() - RunningStartMs;
+
+    slackMs = std::clamp(slackMs, MinWorkMs, budgetMs * MaxWorkShare);
+    deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                  std::chrono::duration<double, std::milli>(slackMs));
+}
+
+/**
+ * @brief Checks the work deadline.
+ */
+// True while the deadline is ahead
+bool FramePacer::hasSlack() const
+{
+    return Clock::now() < deadline;
+}
+
+/**
+ * @brief Converts the real time since the last call into whole display periods.
+ * @return Number of steps to simulate.
+ *
+ * Stepping by whole periods keeps motion in lock step with the displayed frames, so
+ * loop jitter does not show up as uneven animation.
+ */
+// Fixed-step accumulator; drops stalls beyond MaxCatchUpSteps
+int FramePacer::takeSteps()
+{
+    const Clock::time_point now = Clock::now();
+    accumulator += std::chrono::duration<double>(now - lastStep).count();
+    lastStep = now;
+
+    int steps = int(accumulator / stepSeconds);
+    if (steps > MaxCatchUpSteps) {
+        accumulator = 0.0;
+        return MaxCatchUpSteps;
+    }
+    accumulator -= steps * stepSeconds;
+    return steps;
+}
+
+/**
+ * @brief Returns the simulation step length.
+ */
+// One display period in seconds
+double FramePacer::getStepSeconds() const
+{
+    return stepSeconds;
+}
+
+/**
+ * @brief Records the frame interval and refreshes the missed-frame count.
+ */
+// Interval ring, compositor stats, periodic percentile
+void FramePacer::endFrame()
+{
+    const Clock::time_point now = Clock::now();
+    const double intervalMs = std::chrono::duration<double, std::milli>(now - lastFrameEnd).count();
+    lastFrameEnd = now;
+
+    intervals[intervalCount % int(intervals.size())] = float(intervalMs);
+    ++intervalCount;
+
+    if (hasCompositor) {
+        vr::Compositor_CumulativeStats stats;
+        vr::VRCompositor()->GetCumulativeStats(&stats, sizeof(stats));
+        missedFrames.store(stats.m_nNumReprojectedFrames + stats.m_nNumDroppedFrames - statsBaseline,
+                           std::memory_order_relaxed);
+
+        // The newest frame may still be on the GPU; the one before it has its times
+        vr::Compositor_FrameTiming timing;
+        timing.m_nSize = sizeof(timing);
+        if (vr::VRCompositor()->GetFrameTiming(&timing, 1)) {
+            const double frameGpuMs = timing.m_flPreSubmitGpuMs + timing.m_flPostSubmitGpuMs;
+            const double previous = gpuMs.load(std::memory_order_relaxed);
+            gpuMs.store(previous < 0.0 ? frameGpuMs : previous + GpuSmoothing * (frameGpuMs - previous),
+                        std::memory_order_relaxed);
+        }
+    }
+    else {
+        if (intervalMs > LateFactor * 1000.0 * stepSeconds)
+            ++lateFrames;
+        missedFrames.store(lateFrames, std::memory_order_relaxed);
+    }
+
+    if (intervalCount % PercentileInterval == 0)
+        updatePercentile();
+}
+
+/**
+ * @brief Publishes the 90th percentile of the stored intervals.
+ */
+// nth_element over a copy of the ring
+void FramePacer::updatePercentile()
+{
+    const int stored = std::min(intervalCount, int(intervals.size()));
+    if (stored == 0)
+        return;
+
+    std::array<float, 256> sorted = intervals;
+    const int rank = std::min(stored - 1, int(std::ceil(0.9 * stored)) - 1);
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.begin() + stored);
+    percentileMs.store(sorted[rank], std::memory_order_relaxed);
+}
+
+// --------------------------------------- Statistics ---------------------------------------
+
+/**
+ * @brief Returns the headset refresh rate.
+ */
+// Refresh rate in Hz
+double FramePacer::getRefreshRate() const
+{
+    return refreshRate.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the frame budget at native refresh.
+ */
+// Milliseconds per frame
+double FramePacer::getFrameBudgetMs() const
+{
+    return 1000.0 / getRefreshRate();
+}
+
+/**
+ * @brief Returns the frames missed since start().
+ */
+// Missed-frame counter
+std::uint32_t FramePacer::getMissedFrames() const
+{
+    return missedFrames.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the recent 90th-percentile frame interval.
+ */
+// p90 in milliseconds
+double FramePacer::getPercentileMs() const
+{
+    return percentileMs.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the smoothed application GPU time.
+ */
+// GPU milliseconds per frame, or -1
+double FramePacer::getGpuMs() const
+{
+    return gpuMs.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Builds the overlay line.
+ */
+// Pacing summary
+QString FramePacer::summaryText() const
+{
+    const double gpu = getGpuMs();
+    return QString("VR pacing %1 Hz | budget %2 ms | p90 %3 ms | GPU %4 ms | missed %5")
+        .arg(getRefreshRate(), 0, 'f', 0)
+        .arg(getFrameBudgetMs(), 0, 'f', 1)
+        .arg(getPercentileMs(), 0, 'f', 1)
+        .arg(gpu < 0.0 ? QString("-") : QString::number(gpu, 'f', 1))
+        .arg(getMissedFrames());
+}
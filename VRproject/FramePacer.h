@@ -0,0 +1,162 @@
+/**
+ * @file FramePacer.h
+ * @brief Frame pacing of the VR loop against the OpenVR compositor's vsync.
+ *
+ * VTK blocks in the compositor's WaitGetPoses() inside every VR render, which
+ * releases the loop shortly before the next vsync ("running start"). Work done
+ * between one submit and the next wait therefore runs in the slack of the frame
+ * that is already on its way to the headset. The pacer turns that slack into a
+ * per-frame work deadline, steps the simulation at the display rate and counts
+ * the frames the headset had to show without a new image from us.
+ */
+
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QString>      // Overlay summary line
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <array>        // Recent frame intervals
+#include <atomic>       // Statistics read from the GUI thread
+#include <chrono>       // Deadlines and intervals
+#include <cstdint>      // Frame counters
+
+// --------------------------------------- FramePacer Class ---------------------------------------
+/**
+ * @class FramePacer
+ * @brief Work deadlines, fixed simulation steps and missed-frame counting for one VR loop.
+ *
+ * Call start() once the OpenVR window is initialised, then beginFrame() after each
+ * render returns and endFrame() after the next one. Without a compositor (no
+ * headset runtime) the pacer falls back to DefaultRefreshHz and a fixed share of
+ * the frame as slack, and counts late frames from the measured intervals.
+ *
+ * All members are used from the VR thread; only the getters and summaryText()
+ * may be called from other threads.
+ */
+class FramePacer {
+public:
+    /**
+     * @brief Refresh rate assumed when the headset does not report one.
+     */
+    static constexpr double DefaultRefreshHz = 90.0;
+
+    /**
+     * @brief Most simulation steps taken in one frame; longer stalls are dropped, not replayed.
+     */
+    static const int MaxCatchUpSteps = 4;
+
+    /**
+     * @brief Constructs a pacer for a DefaultRefreshHz display.
+     */
+    // Constructor: default refresh, empty statistics
+    FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    /**
+     * @brief Reads the headset refresh rate and resets the statistics.
+     *
+     * Must be called after the OpenVR runtime has been initialised (vtkOpenVRRenderWindow::Initialize()).
+     */
+    // Queries the HMD and takes the compositor baseline
+    void start();
+
+    /**
+     * @brief Opens the work window of a frame. Call right after the previous render has submitted.
+     */
+    // Sets this frame's work deadline from the compositor's time remaining
+    void beginFrame();
+
+    /**
+     * @brief Checks whether frame work may continue without delaying the next render.
+     */
+    // True until the work deadline has passed
+    bool hasSlack() const;
+
+    /**
+     * @brief Returns how many fixed simulation steps are due this frame.
+     * @return Usually 1; 0 when the loop ran early, more after a missed frame.
+     */
+    // Advances the fixed-step accumulator by the real time since the last call
+    int takeSteps();
+
+    /**
+     * @brief Returns the length of one simulation step (one display period).
+     */
+    // Seconds per step
+    double getStepSeconds() const;
+
+    /**
+     * @brief Closes a frame after its render returned and updates the statistics.
+     */
+    // Records the frame interval and polls the compositor's frame statistics
+    void endFrame();
+
+    /**
+     * @brief Returns the headset refresh rate in Hz.
+     */
+    // Display refresh rate
+    double getRefreshRate() const;
+
+    /**
+     * @brief Returns the time one frame may take at native refresh, in milliseconds.
+     */
+    // 1000 / refresh rate
+    double getFrameBudgetMs() const;
+
+    /**
+     * @brief Returns the number of frames since start() that did not get a new image in time.
+     *
+     * With a compositor these are its reprojected and dropped frames; without one, frames
+     * that took more than one and a half periods.
+     */
+    // Missed vsyncs since start()
+    std::uint32_t getMissedFrames() const;
+
+    /**
+     * @brief Returns the 90th percentile of the recent frame intervals, in milliseconds.
+     */
+    // Refreshed every few frames
+    double getPercentileMs() const;
+
+    /**
+     * @brief Returns the smoothed GPU time of the application's frames, in milliseconds.
+     * @return -1 until the compositor has reported a frame (or without a compositor).
+     */
+    // Compositor-measured render cost before and after submit
+    double getGpuMs() const;
+
+    /**
+     * @brief Returns a one-line summary for the overlay.
+     */
+    // "VR pacing" line: refresh, budget, p90, GPU time and missed frames
+    QString summaryText() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Recomputes the published percentile from the stored intervals
+    void updatePercentile();
+
+    std::atomic<double> refreshRate;            // Headset refresh rate (Hz)
+    std::atomic<std::uint32_t> missedFrames;    // Published missed-frame count
+    std::atomic<double> percentileMs;           // Published p90 frame interval
+    std::atomic<double> gpuMs;                  // Smoothed application GPU time (-1: unknown)
+    double stepSeconds;                         // One display period
+    double accumulator;                         // Real time not yet simulated (seconds)
+    Clock::time_point lastStep;                 // Time of the last takeSteps() call
+    Clock::time_point deadline;                 // End of this frame's work window
+    Clock::time_point lastFrameEnd;             // Time of the last endFrame() call
+    bool hasCompositor;                         // False without an OpenVR compositor
+    std::uint32_t statsBaseline;                // Compositor missed frames at start()
+    std::uint32_t lateFrames;                   // Late frames measured without a compositor
+    std::array<float, 256> intervals;           // Recent frame intervals (ms), a ring
+    int intervalCount;                          // Intervals recorded since start()
+};
+
+#endif // FRAME_PACER_H
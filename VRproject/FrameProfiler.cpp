@@ -0,0 +1,430 @@
+/**
+ * @file FrameProfiler.cpp
+ * @brief Implementation of the render-loop instrumentation.
+ */
+
+#include "FrameProfiler.h"
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QFile>
+#include <QMutexLocker>
+#include <QTextStream>
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkActor.h>
+#include <vtkActorCollection.h>
+#include <vtkMapper.h>
+#include <vtkPolyData.h>
+#include <vtkTextProperty.h>
+#include <vtkOpenGLRenderTimer.h>
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <algorithm>
+
+// --------------------------------------- Static Data ---------------------------------------
+
+thread_local int64_t FrameProfiler::filterNanos = 0;
+
+namespace {
+
+// Start time of the filter currently executing on this thread (VTK runs filters one at a time)
+thread_local std::chrono::steady_clock::time_point algorithmStart;
+
+// Shared observer for all watched filters
+vtkSmartPointer<vtkCallbackCommand>& algorithmCallback()
+{
+    static vtkSmartPointer<vtkCallbackCommand> callback;
+    return callback;
+}
+
+const int OverlayIntervalMs = 250;  // Overlay text refresh period
+const double SummaryWindowMs = 1000.0;  // Frames averaged by summaryText()
+
+} // namespace
+
+// --------------------------------------- Constructor & Destructor ---------------------------------------
+
+/**
+ * @brief Constructs an idle profiler.
+ * @param traceCapacity Number of frames kept in the rolling trace.
+ */
+// Allocates the trace and creates the render observers and overlay
+FrameProfiler::FrameProfiler(int traceCapacity)
+    : capacity(traceCapacity > 0 ? traceCapacity : 1)
+    , frameCount(0)
+    , created(Clock::now())
+    , inFrame(false)
+    , lastFilterNanos(0)
+    , activeTimer(-1)
+    , startTag(0)
+    , endTag(0)
+{
+    records.resize(capacity);
+
+    for (GpuTimer& gpu : gpuTimers)
+        gpu.timer.reset(new vtkOpenGLRenderTimer);
+
+    startCallback = vtkSmartPointer<vtkCallbackCommand>::New();
+    startCallback->SetClientData(this);
+    startCallback->SetCallback(&FrameProfiler::onStartRender);
+
+    endCallback = vtkSmartPointer<vtkCallbackCommand>::New();
+    endCallback->SetClientData(this);
+    endCallback->SetCallback(&FrameProfiler::onEndRender);
+
+    overlay = vtkSmartPointer<vtkTextActor>::New();
+    overlay->SetDisplayPosition(10, 10);
+    overlay->GetTextProperty()->SetFontFamilyToCourier();
+    overlay->GetTextProperty()->SetFontSize(14);
+    overlay->GetTextProperty()->SetColor(1.0, 1.0, 1.0);
+    overlay->SetVisibility(0);
+}
+
+/**
+ * @brief Removes the observers; GPU queries must have been released already.
+ */
+// Detaches from the renderer
+FrameProfiler::~FrameProfiler()
+{
+    detach();
+}
+
+// --------------------------------------- Renderer ---------------------------------------
+
+/**
+ * @brief Times every render of a renderer.
+ * @param newRenderer Renderer to observe.
+ */
+// Adds StartEvent/EndEvent observers
+void FrameProfiler::attach(vtkRenderer* newRenderer)
+{
+    detach();
+    renderer = newRenderer;
+    if (!renderer)
+        return;
+
+    // Higher priority so the frame starts before other StartEvent observers (e.g. LOD selection)
+    startTag = renderer->AddObserver(vtkCommand::StartEvent, startCallback, 10.0f);
+    endTag = renderer->AddObserver(vtkCommand::EndEvent, endCallback);
+}
+
+/**
+ * @brief Stops observing the renderer.
+ */
+// Removes observers and the overlay
+void FrameProfiler::detach()
+{
+    if (renderer) {
+        if (startTag) renderer->RemoveObserver(startTag);
+        if (endTag) renderer->RemoveObserver(endTag);
+        renderer->RemoveViewProp(overlay);
+    }
+    renderer = nullptr;
+    startTag = endTag = 0;
+}
+
+// --------------------------------------- Frame Timing ---------------------------------------
+
+/**
+ * @brief Starts timing a frame and, if a query is free, a GPU timer.
+ */
+// Records the CPU start time and starts a GPU timer query
+void FrameProfiler::beginFrame()
+{
+    collectGpuResults();
+
+    frameStart = Clock::now();
+    inFrame = true;
+
+    activeTimer = -1;
+    for (int i = 0; i < GpuTimerCount; ++i) {
+        if (!gpuTimers[i].pending) {
+            gpuTimers[i].timer->Reset();
+            gpuTimers[i].timer->Start();
+            activeTimer = i;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Finishes the frame and stores its record.
+ * @param measured Renderer whose props and triangles are counted.
+ * @param views    Number of times the scene was drawn this frame.
+ */
+// Stops timers, counts the scene and appends the record to the trace
+void FrameProfiler::endFrame(vtkRenderer* measured, int views)
+{
+    if (!inFrame)
+        return;
+    inFrame = false;
+
+    const Clock::time_point now = Clock::now();
+
+    FrameRecord record;
+    record.frame = frameCount;
+    record.timestampMs = std::chrono::duration<double, std::milli>(frameStart - created).count();
+    record.cpuMs = std::chrono::duration<double, std::milli>(now - frameStart).count();
+    record.filterMs = double(filterNanos - lastFilterNanos) * 1.0e-6;
+    lastFilterNanos = filterNanos;
+
+    if (activeTimer >= 0) {
+        gpuTimers[activeTimer].timer->Stop();
+        gpuTimers[activeTimer].frame = frameCount;
+        gpuTimers[activeTimer].pending = true;
+        activeTimer = -1;
+    }
+
+    if (measured) {
+        // VTK does not expose GL draw counts; each rendered prop issues at least one draw
+        record.drawCalls = measured->GetNumberOfPropsRendered() * views;
+
+        vtkActorCollection* actors = measured->GetActors();
+        vtkCollectionSimpleIterator it;
+        actors->InitTraversal(it);
+        while (vtkActor* actor = actors->GetNextActor(it)) {
+            if (!actor->GetVisibility() || !actor->GetMapper())
+                continue;
+            if (vtkPolyData* polyData = vtkPolyData::SafeDownCast(actor->GetMapper()->GetInput()))
+                record.triangles += polyData->GetNumberOfPolys() * views;
+        }
+    }
+
+    {
+        QMutexLocker lock(&mutex);
+        records[int(frameCount % uint64_t(capacity))] = record;
+        ++frameCount;
+    }
+
+    if (overlay->GetVisibility()
+        && std::chrono::duration_cast<std::chrono::milliseconds>(now - lastOverlayUpdate).count() >= OverlayIntervalMs) {
+        lastOverlayUpdate = now;
+        updateOverlay();
+    }
+}
+
+/**
+ * @brief Writes finished GPU timer results into the records they belong to.
+ */
+// Polls timer queries without blocking
+void FrameProfiler::collectGpuResults()
+{
+    for (GpuTimer& gpu : gpuTimers) {
+        if (!gpu.pending || !gpu.timer->Ready())
+            continue;
+
+        const double ms = double(gpu.timer->GetElapsedMilliseconds());
+        gpu.pending = false;
+
+        QMutexLocker lock(&mutex);
+        FrameRecord& record = records[int(gpu.frame % uint64_t(capacity))];
+        if (record.frame == gpu.frame)
+            record.gpuMs = ms;
+    }
+}
+
+/**
+ * @brief Releases the timer queries; call with the GL context current.
+ */
+// Frees the GPU timer queries
+void FrameProfiler::releaseGraphicsResources()
+{
+    for (GpuTimer& gpu : gpuTimers) {
+        gpu.timer->ReleaseGraphicsResources();
+        gpu.pending = false;
+    }
+    activeTimer = -1;
+}
+
+// Renderer StartEvent: begins a frame and keeps the overlay in the scene
+void FrameProfiler::onStartRender(vtkObject*, unsigned long, void* clientData, void*)
+{
+    auto* self = static_cast<FrameProfiler*>(clientData);
+
+    // Owners may remove every view prop, so re-add the overlay when it is shown
+    if (self->renderer && self->overlay->GetVisibility() && !self->renderer->HasViewProp(self->overlay))
+        self->renderer->AddViewProp(self->overlay);
+
+    self->beginFrame();
+}
+
+// Renderer EndEvent: ends the frame
+void FrameProfiler::onEndRender(vtkObject*, unsigned long, void* clientData, void*)
+{
+    auto* self = static_cast<FrameProfiler*>(clientData);
+    self->endFrame(self->renderer);
+}
+
+// --------------------------------------- Filter Timing ---------------------------------------
+
+/**
+ * @brief Observes a filter so its execution time is accumulated.
+ * @param algorithm Filter to watch.
+ */
+// Adds the shared StartEvent/EndEvent observer to a filter
+void FrameProfiler::watchAlgorithm(vtkAlgorithm* algorithm)
+{
+    if (!algorithm)
+        return;
+
+    vtkSmartPointer<vtkCallbackCommand>& callback = algorithmCallback();
+    if (!callback) {
+        callback = vtkSmartPointer<vtkCallbackCommand>::New();
+        callback->SetCallback(&FrameProfiler::onAlgorithmEvent);
+    }
+
+    algorithm->AddObserver(vtkCommand::StartEvent, callback);
+    algorithm->AddObserver(vtkCommand::EndEvent, callback);
+}
+
+// Accumulates the time between a filter's StartEvent and EndEvent
+void FrameProfiler::onAlgorithmEvent(vtkObject*, unsigned long eventId, void*, void*)
+{
+    if (eventId == vtkCommand::StartEvent) {
+        algorithmStart = Clock::now();
+    }
+    else if (eventId == vtkCommand::EndEvent) {
+        filterNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - algorithmStart).count();
+    }
+}
+
+// --------------------------------------- Overlay ---------------------------------------
+
+/**
+ * @brief Shows or hides the overlay.
+ */
+// Sets overlay visibility; the text is refreshed on the next frame
+void FrameProfiler::setOverlayVisible(bool visible)
+{
+    overlay->SetVisibility(visible ? 1 : 0);
+    lastOverlayUpdate = Clock::time_point();
+    if (renderer && !visible)
+        renderer->RemoveViewProp(overlay);
+}
+
+/**
+ * @brief Returns true while the overlay is shown.
+ */
+// Returns overlay visibility
+bool FrameProfiler::isOverlayVisible() const
+{
+    return overlay->GetVisibility() != 0;
+}
+
+/**
+ * @brief Sets a callback that supplies extra overlay lines.
+ */
+// Stores the extra-text provider
+void FrameProfiler::setOverlayExtra(std::function<QString()> provider)
+{
+    overlayExtra = std::move(provider);
+}
+
+// Rebuilds the overlay text from the recent trace
+void FrameProfiler::updateOverlay()
+{
+    QString text = summaryText("Desktop");
+    if (overlayExtra) {
+        const QString extra = overlayExtra();
+        if (!extra.isEmpty())
+            text += "\n" + extra;
+    }
+    overlay->SetInput(text.toUtf8().constData());
+}
+
+// --------------------------------------- Trace Access ---------------------------------------
+
+/**
+ * @brief Averages the frames recorded during the last second.
+ * @param label Line prefix.
+ * @return Formatted summary, or "<label>: no frames" if nothing was recorded.
+ */
+// Formats fps, CPU/GPU/filter time, draws and triangles
+QString FrameProfiler::summaryText(const QString& label) const
+{
+    QMutexLocker lock(&mutex);
+    if (frameCount == 0)
+        return label + ": no frames";
+
+    const uint64_t stored = std::min<uint64_t>(frameCount, uint64_t(capacity));
+    const FrameRecord& newest = records[int((frameCount - 1) % uint64_t(capacity))];
+
+    int frames = 0, gpuFrames = 0;
+    double cpu = 0.0, gpu = 0.0, filters = 0.0, oldest = newest.timestampMs;
+    for (uint64_t i = 0; i < stored; ++i) {
+        const FrameRecord& record = records[int((frameCount - 1 - i) % uint64_t(capacity))];
+        if (newest.timestampMs - record.timestampMs > SummaryWindowMs)
+            break;
+        ++frames;
+        cpu += record.cpuMs;
+        filters += record.filterMs;
+        oldest = record.timestampMs;
+        if (record.gpuMs >= 0.0) {
+            gpu += record.gpuMs;
+            ++gpuFrames;
+        }
+    }
+
+    const double span = newest.timestampMs - oldest;
+    const double fps = span > 0.0 ? (frames - 1) * 1000.0 / span : 0.0;
+
+    return QString("%1 %2 fps | CPU %3 ms | GPU %4 ms | filters %5 ms | %6 draws | %7k tris")
+        .arg(label, -8)
+        .arg(fps, 5, 'f', 1)
+        .arg(cpu / frames, 6, 'f', 2)
+        .arg(gpuFrames ? QString::number(gpu / gpuFrames, 'f', 2) : QString("  n/a"), 6)
+        .arg(filters / frames, 6, 'f', 2)
+        .arg(newest.drawCalls)
+        .arg(double(newest.triangles) / 1000.0, 0, 'f', 1);
+}
+
+/**
+ * @brief Copies the trace, oldest frame first.
+ */
+// Unrolls the ring buffer under the lock
+QVector<FrameProfiler::FrameRecord> FrameProfiler::trace() const
+{
+    QMutexLocker lock(&mutex);
+
+    const uint64_t stored = std::min<uint64_t>(frameCount, uint64_t(capacity));
+    QVector<FrameRecord> out;
+    out.reserve(int(stored));
+    for (uint64_t i = frameCount - stored; i < frameCount; ++i)
+        out << records[int(i % uint64_t(capacity))];
+    return out;
+}
+
+/**
+ * @brief Writes traces to a CSV file.
+ * @param fileName Output path.
+ * @param sources  (label, trace) pairs.
+ * @return False if the file could not be written.
+ */
+// One row per frame, GPU time left empty when it never arrived
+bool FrameProfiler::exportCsv(const QString& fileName, const QList<QPair<QString, QVector<FrameRecord>>>& sources)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate))
+        return false;
+
+    QTextStream out(&file);
+    out << "source,frame,timestamp_ms,cpu_ms,gpu_ms,filter_ms,draw_calls,triangles\n";
+
+    for (const QPair<QString, QVector<FrameRecord>>& source : sources) {
+        for (const FrameRecord& record : source.second) {
+            out << source.first << ','
+                << record.frame << ','
+                << QString::number(record.timestampMs, 'f', 3) << ','
+                << QString::number(record.cpuMs, 'f', 3) << ','
+                << (record.gpuMs >= 0.0 ? QString::number(record.gpuMs, 'f', 3) : QString()) << ','
+                << QString::number(record.filterMs, 'f', 3) << ','
+                << record.drawCalls << ','
+                << record.triangles << '\n';
+        }
+    }
+
+    return out.status() == QTextStream::Ok;
+}
@@ -0,0 +1,219 @@
+/**
+ * @file FrameProfiler.h
+ * @brief Per-frame timing and scene statistics for the desktop and VR render loops.
+ *
+ * Records CPU frame time, GPU frame time (OpenGL timer queries), draw calls,
+ * triangles and VTK filter execution time into a rolling trace that can be shown
+ * as an on-screen overlay or exported to CSV.
+ */
+
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QString>      // Overlay text and CSV paths
+#include <QVector>      // Trace copies
+#include <QList>        // CSV export sources
+#include <QPair>        // (label, trace) pairs
+#include <QMutex>       // Guards the trace against readers on other threads
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkSmartPointer.h>      // Smart pointer management for VTK
+#include <vtkWeakPointer.h>       // Observed renderer
+#include <vtkRenderer.h>          // Renderer being measured
+#include <vtkAlgorithm.h>         // Filters whose execution time is tracked
+#include <vtkTextActor.h>         // Overlay
+#include <vtkCallbackCommand.h>   // Render event observers
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <array>        // GPU timer pool
+#include <chrono>       // CPU timing
+#include <cstdint>      // Fixed-width counters
+#include <functional>   // Extra overlay text
+#include <memory>       // GPU timer ownership
+
+class vtkOpenGLRenderTimer;
+
+// --------------------------------------- FrameProfiler Class ---------------------------------------
+/**
+ * @class FrameProfiler
+ * @brief Measures one render loop (desktop or VR) and keeps a rolling trace.
+ *
+ * beginFrame()/endFrame() must be called on the render thread with the GL context
+ * current. For the desktop view, attach() does this from the renderer's own events;
+ * the VR loop calls them around each iteration. trace() and summaryText() may be
+ * called from any thread.
+ *
+ * GPU results arrive a few frames late (timer queries are polled, never waited on),
+ * so a record's gpuMs is filled in retroactively and is -1 until then.
+ */
+class FrameProfiler {
+public:
+    /**
+     * @brief Measurements for one frame.
+     */
+    struct FrameRecord {
+        uint64_t frame = 0;         // Frame number since the profiler was created
+        double   timestampMs = 0.0; // Start of the frame (ms since the profiler was created)
+        double   cpuMs = 0.0;       // CPU time from beginFrame() to endFrame()
+        double   gpuMs = -1.0;      // GPU time for the frame's commands (-1 until available)
+        double   filterMs = 0.0;    // VTK filter time on this thread since the previous frame
+        int      drawCalls = 0;     // Props rendered (one or more GL draws each)
+        int64_t  triangles = 0;     // Triangles submitted by visible actors
+    };
+
+    /**
+     * @brief Constructs an idle profiler.
+     * @param capacity Number of frames kept in the rolling trace.
+     */
+    // Constructor: sets up trace storage and event callbacks
+    explicit FrameProfiler(int capacity = 3600);
+
+    /**
+     * @brief Destructor: detaches from the renderer. GPU queries must already be released.
+     */
+    // Destructor: removes observers
+    ~FrameProfiler();
+
+    FrameProfiler(const FrameProfiler&) = delete;
+    FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+    /**
+     * @brief Measures every render of a renderer via its StartEvent/EndEvent.
+     * @param renderer Renderer to observe (desktop view).
+     */
+    // Times each render of the given renderer
+    void attach(vtkRenderer* renderer);
+
+    /**
+     * @brief Stops observing the renderer and removes the overlay from it.
+     */
+    // Removes observers and overlay
+    void detach();
+
+    /**
+     * @brief Starts timing a frame (render thread, GL context current).
+     */
+    // Marks the start of a frame
+    void beginFrame();
+
+    /**
+     * @brief Finishes the frame started by beginFrame() and stores its record.
+     * @param renderer Renderer whose props are counted.
+     * @param views    Number of times the scene was drawn this frame (2 for stereo VR).
+     */
+    // Marks the end of a frame and records its statistics
+    void endFrame(vtkRenderer* renderer, int views = 1);
+
+    /**
+     * @brief Releases the GL timer queries (render thread, GL context current).
+     */
+    // Frees GPU timer queries
+    void releaseGraphicsResources();
+
+    /**
+     * @brief Shows or hides the text overlay in the attached renderer.
+     */
+    // Toggles the on-screen statistics
+    void setOverlayVisible(bool visible);
+
+    /**
+     * @brief Returns true while the overlay is shown.
+     */
+    // Returns overlay visibility
+    bool isOverlayVisible() const;
+
+    /**
+     * @brief Adds extra lines to the overlay (e.g. another loop's summary).
+     * @param provider Called on the render thread whenever the overlay refreshes.
+     */
+    // Sets a callback providing additional overlay text
+    void setOverlayExtra(std::function<QString()> provider);
+
+    /**
+     * @brief Returns a one-line summary averaged over the last second of frames.
+     * @param label Prefix for the line, e.g. "Desktop".
+     */
+    // Formats averaged statistics (thread-safe)
+    QString summaryText(const QString& label) const;
+
+    /**
+     * @brief Returns a copy of the rolling trace, oldest frame first (thread-safe).
+     */
+    // Copies the trace
+    QVector<FrameRecord> trace() const;
+
+    /**
+     * @brief Tracks the execution time of a VTK filter.
+     * @param algorithm Filter to observe; its StartEvent/EndEvent time is added to the
+     *                  frame that is current when it finishes.
+     *
+     * Time is accumulated per thread, so each profiler only sees filters that ran on
+     * its own render thread. Filters may be watched before any profiler exists.
+     */
+    // Adds execution-time observers to a filter
+    static void watchAlgorithm(vtkAlgorithm* algorithm);
+
+    /**
+     * @brief Writes traces to a CSV file.
+     * @param fileName Output path.
+     * @param sources  (label, trace) pairs; the label fills the "source" column.
+     * @return True on success.
+     */
+    // Exports one or more traces as CSV
+    static bool exportCsv(const QString& fileName, const QList<QPair<QString, QVector<FrameRecord>>>& sources);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Polls in-flight GPU timers and writes finished results into their records
+    void collectGpuResults();
+
+    // Rebuilds the overlay text (at most a few times per second)
+    void updateOverlay();
+
+    // Renderer StartEvent/EndEvent trampolines
+    static void onStartRender(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+    static void onEndRender(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+
+    // Filter StartEvent/EndEvent handler
+    static void onAlgorithmEvent(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+
+    static const int GpuTimerCount = 4;     // Frames of GPU latency tolerated before a result is dropped
+
+    // One GPU timer query and the frame it measures
+    struct GpuTimer {
+        std::unique_ptr<vtkOpenGLRenderTimer> timer;
+        uint64_t frame = 0;
+        bool     pending = false;
+    };
+
+    mutable QMutex mutex;                   // Guards records
+    QVector<FrameRecord> records;           // Ring buffer of frames
+    int capacity;                           // Size of the ring
+    uint64_t frameCount;                    // Frames recorded so far
+
+    Clock::time_point created;              // Time origin for timestamps
+    Clock::time_point frameStart;           // Start of the current frame
+    bool inFrame;                           // True between beginFrame() and endFrame()
+    int64_t lastFilterNanos;                // Filter accumulator value at the previous endFrame()
+    std::array<GpuTimer, GpuTimerCount> gpuTimers;  // Pool of timer queries
+    int activeTimer;                        // Timer started in beginFrame(), or -1
+
+    vtkWeakPointer<vtkRenderer> renderer;           // Observed renderer (desktop)
+    vtkSmartPointer<vtkCallbackCommand> startCallback;
+    vtkSmartPointer<vtkCallbackCommand> endCallback;
+    unsigned long startTag;
+    unsigned long endTag;
+
+    vtkSmartPointer<vtkTextActor> overlay;          // Statistics text
+    std::function<QString()> overlayExtra;          // Additional overlay lines
+    Clock::time_point lastOverlayUpdate;            // Throttles overlay text updates
+
+    static thread_local int64_t filterNanos;        // Total filter time on the calling thread
+};
+
+#endif // FRAME_PROFILER_H
@@ -0,0 +1,148 @@
+/**
+ * @file GpuEffects.cpp
+ * @brief Implementation of the shrink geometry shader and explode placement.
+ */
+
+#include "GpuEffects.h"
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkSmartPointer.h>
+#include <vtkShaderProperty.h>
+#include <vtkUniforms.h>
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <cstring>
+
+// --------------------------------------- Shader Source ---------------------------------------
+
+namespace {
+
+// Uniform holding the shrink factor
+const char* const FactorUniform = "shrinkFactor";
+
+// Geometry shader in the layout of VTK's polydata templates: the mapper fills in the
+// tags, forwarding every vertex output it uses (normals, colours, clip distances...)
+// from the i-th input corner. Clip-space positions are a linear image of the model
+// positions, so shrinking them towards the centroid is exact.
+const char* const ShrinkShader = R"(//VTK::System::Dec
+
+//VTK::PositionVC::Dec
+//VTK::PrimID::Dec
+//VTK::Color::Dec
+//VTK::Normal::Dec
+//VTK::Light::Dec
+//VTK::TCoord::Dec
+//VTK::Picking::Dec
+//VTK::DepthPeeling::Dec
+//VTK::Clip::Dec
+//VTK::Output::Dec
+//VTK::Coincident::Dec
+//VTK::Edges::Dec
+//VTK::CustomUniforms::Dec
+
+layout(triangles) in;
+layout(triangle_strip, max_vertices = 3) out;
+
+void main()
+{
+  vec4 centroid = (gl_in[0].gl_Position + gl_in[1].gl_Position + gl_in[2].gl_Position) / 3.0;
+
+  for (int i = 0; i < 3; i++)
+  {
+    //VTK::PrimID::Impl
+    //VTK::Clip::Impl
+    //VTK::Color::Impl
+    //VTK::Normal::Impl
+    //VTK::Light::Impl
+    //VTK::TCoord::Impl
+    //VTK::DepthPeeling::Impl
+    //VTK::Picking::Impl
+    //VTK::Edges::Impl
+    //VTK::PositionVC::Impl
+
+    gl_Position = centroid + shrinkFactor * (gl_in[i].gl_Position - centroid);
+    EmitVertex();
+  }
+  EndPrimitive();
+}
+)";
+
+} // namespace
+
+// --------------------------------------- Shrink ---------------------------------------
+
+/**
+ * @brief Shrinks every triangle of an actor towards its centroid.
+ * @param actor  Target actor.
+ * @param factor Corner distance kept; 1 or more removes the shader.
+ */
+// Sets the code once, then only the uniform
+void GpuEffects::setShrink(vtkActor* actor, double factor)
+{
+    if (!actor)
+        return;
+    if (factor >= 1.0) {
+        clearShrink(actor);
+        return;
+    }
+
+    vtkShaderProperty* shaders = actor->GetShaderProperty();
+    if (!isShrunk(actor))
+        shaders->SetGeometryShaderCode(ShrinkShader);
+    shaders->GetGeometryCustomUniforms()->SetUniformf(FactorUniform, float(factor > 0.0 ? factor : 0.0));
+}
+
+/**
+ * @brief Removes the shrink shader; other shader code on the actor is left alone.
+ */
+// Clears the geometry stage if it is ours
+void GpuEffects::clearShrink(vtkActor* actor)
+{
+    if (!isShrunk(actor))
+        return;
+
+    vtkShaderProperty* shaders = actor->GetShaderProperty();
+    shaders->SetGeometryShaderCode(nullptr);
+    shaders->GetGeometryCustomUniforms()->RemoveUniform(FactorUniform);
+}
+
+/**
+ * @brief Returns true if the actor is drawn through the shrink shader.
+ */
+// Compares the geometry stage with ShrinkShader
+bool GpuEffects::isShrunk(vtkActor* actor)
+{
+    if (!actor)
+        return false;
+
+    const char* code = actor->GetShaderProperty()->GetGeometryShaderCode();
+    return code && std::strcmp(code, ShrinkShader) == 0;
+}
+
+// --------------------------------------- Explode ---------------------------------------
+
+/**
+ * @brief Moves an actor by a world-space offset on top of its user matrix.
+ * @param actor  Target actor.
+ * @param world  Actor's user matrix, or nullptr for identity.
+ * @param offset Offset in world coordinates.
+ */
+// Position = inverse linear part of the user matrix applied to the offset
+void GpuEffects::setWorldOffset(vtkActor* actor, vtkMatrix4x4* world, const double offset[3])
+{
+    if (!actor)
+        return;
+
+    const double direction[4] = { offset[0], offset[1], offset[2], 0.0 };
+    double position[4] = { offset[0], offset[1], offset[2], 0.0 };
+    if (world) {
+        auto inverse = vtkSmartPointer<vtkMatrix4x4>::New();
+        vtkMatrix4x4::Invert(world, inverse);
+        inverse->MultiplyPoint(direction, position);
+    }
+
+    // SetPosition() only marks the actor modified when the value changes
+    actor->SetPosition(position[0], position[1], position[2]);
+}
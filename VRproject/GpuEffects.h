@@ -0,0 +1,70 @@
+/**
+ * @file GpuEffects.h
+ * @brief Shrink and explode applied while drawing, without running any filter.
+ *
+ * vtkShrinkPolyData gives every triangle its own three points, so a shrunk part
+ * holds one vertex per corner instead of the welded mesh and each new factor means
+ * another pass over all of them. On the GPU the same effect is a geometry shader
+ * that pulls each triangle's corners towards its centroid as it is drawn from the
+ * existing buffers; changing the factor only changes a uniform. Exploding moves a
+ * whole part, which is the actor's position and so a matrix uniform as well.
+ */
+
+#ifndef GPU_EFFECTS_H
+#define GPU_EFFECTS_H
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkActor.h>             // Actors carrying the shader
+#include <vtkMatrix4x4.h>         // World transforms for explode offsets
+
+// --------------------------------------- GpuEffects Class ---------------------------------------
+/**
+ * @class GpuEffects
+ * @brief Installs the shrink geometry shader on actors and places exploded parts.
+ *
+ * The shader is set on the actor's shader property, so every mapper the actor
+ * draws with (levels of detail included) is shrunk. Instanced and merged batches
+ * draw through their own actors and do not see it; callers keep shrunk parts out
+ * of those. All functions are static and must be called on the thread that
+ * renders the actor.
+ */
+class GpuEffects {
+public:
+    /**
+     * @brief Shrinks every triangle of an actor towards its centroid.
+     * @param actor  Target actor.
+     * @param factor Corner distance kept, in (0, 1]; 1 or more removes the shader.
+     *
+     * The first call compiles a new shader program for the actor; later calls with
+     * another factor only update the uniform.
+     */
+    // Installs the geometry shader or updates its factor
+    static void setShrink(vtkActor* actor, double factor);
+
+    /**
+     * @brief Removes the shrink shader from an actor.
+     */
+    // Drops the geometry shader code
+    static void clearShrink(vtkActor* actor);
+
+    /**
+     * @brief Returns true if the actor is drawn through the shrink shader.
+     */
+    // Checks the actor's geometry shader code
+    static bool isShrunk(vtkActor* actor);
+
+    /**
+     * @brief Moves an actor by a world-space offset on top of its user matrix.
+     * @param actor  Target actor.
+     * @param world  Actor's user matrix, or nullptr for identity.
+     * @param offset Offset in world coordinates.
+     *
+     * vtkProp3D applies the position before the user matrix, so the offset is
+     * carried back into the part's own frame first.
+     */
+    // Sets the actor position that shows the offset in world space
+    static void setWorldOffset(vtkActor* actor, vtkMatrix4x4* world, const double offset[3]);
+};
+
+#endif // GPU_EFFECTS_H
@@ -0,0 +1,822 @@
+/**
+ * @file InstanceBatcher.cpp
+ * @brief Implementation of instanced drawing for parts that share a mesh.
+ */
+
+#include "InstanceBatcher.h"
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkPoints.h>
+#include <vtkPointData.h>
+#include <vtkDoubleArray.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkBitArray.h>
+#include <vtkTransform.h>
+#include <vtkMatrix4x4.h>
+#include <vtkProperty.h>
+#include <vtkMath.h>
+#include <vtkPolyDataMapper.h>
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <algorithm>
+#include <cmath>
+
+// --------------------------------------- Batch Size ---------------------------------------
+
+namespace {
+
+// A batch is re-uploaded whenever one member changes, so batches are kept moderate
+const int MaxBatchMembers = 512;
+const vtkIdType MaxBatchCells = 500000;
+
+// True if two matrices hold the same values
+bool sameMatrix(vtkMatrix4x4* a, vtkMatrix4x4* b)
+{
+    for (int i = 0; i < 16; ++i) {
+        if (a->GetData()[i] != b->GetData()[i])
+            return false;
+    }
+    return true;
+}
+
+// Adds up the point arrays a transformed copy owns (the cells are passed through)
+qint64 ownedBytes(vtkPolyData* copy, vtkPolyData* source)
+{
+    auto shared = [source](vtkAbstractArray* array) {
+        if (source->GetPoints() && source->GetPoints()->GetData() == array)
+            return true;
+        vtkPointData* sourceData = source->GetPointData();
+        for (int i = 0; i < sourceData->GetNumberOfArrays(); ++i) {
+            if (sourceData->GetAbstractArray(i) == array)
+                return true;
+        }
+        return false;
+    };
+
+    qint64 kib = 0;
+    if (copy->GetPoints() && !shared(copy->GetPoints()->GetData()))
+        kib += copy->GetPoints()->GetData()->GetActualMemorySize();
+    vtkPointData* pointData = copy->GetPointData();
+    for (int i = 0; i < pointData->GetNumberOfArrays(); ++i) {
+        vtkAbstractArray* array = pointData->GetAbstractArray(i);
+        if (!shared(array))
+            kib += array->GetActualMemorySize();
+    }
+    return kib * 1024;
+}
+
+} // namespace
+
+// --------------------------------------- Constructor & Destructor ---------------------------------------
+
+/**
+ * @brief Constructs the batcher and its render observer.
+ */
+// Creates the StartEvent callback
+InstanceBatcher::InstanceBatcher()
+    : minimumInstances(4)
+    , openBatch(-1)
+    , nextBatch(0)
+    , merging(false)
+    , copyBytes(0)
+    , bvh(nullptr)
+    , observerTag(0)
+{
+    callback = vtkSmartPointer<vtkCallbackCommand>::New();
+    callback->SetClientData(this);
+    callback->SetCallback(&InstanceBatcher::onStartRender);
+}
+
+/**
+ * @brief Removes the batcher's props and observer from the renderer.
+ */
+// Detaches from the renderer
+InstanceBatcher::~InstanceBatcher()
+{
+    detach();
+}
+
+// --------------------------------------- Renderer ---------------------------------------
+
+/**
+ * @brief Adds every registered actor (or its group actor) to a renderer.
+ * @param newRenderer Renderer to fill.
+ */
+// Fills the renderer and observes its StartEvent
+void InstanceBatcher::attach(vtkRenderer* newRenderer)
+{
+    detach();
+    renderer = newRenderer;
+    if (!renderer)
+        return;
+
+    observerTag = renderer->AddObserver(vtkCommand::StartEvent, callback);
+
+    for (auto it = memberOf.constBegin(); it != memberOf.constEnd(); ++it) {
+        if (!isInstanced(it.key()) && !isMerged(it.key()))
+            show(it.key());
+    }
+    for (const Group& group : groups) {
+        if (group.actor)
+            renderer->AddActor(group.actor);
+    }
+    for (const Batch& batch : batches)
+        renderer->AddActor(batch.actor);
+}
+
+/**
+ * @brief Removes the batcher's props and observer from the current renderer.
+ */
+// Empties the renderer of everything the batcher added
+void InstanceBatcher::detach()
+{
+    if (renderer) {
+        for (auto it = memberOf.constBegin(); it != memberOf.constEnd(); ++it)
+            renderer->RemoveActor(it.key());
+        for (const Group& group : groups) {
+            if (group.actor)
+                renderer->RemoveActor(group.actor);
+        }
+        for (const Batch& batch : batches)
+            renderer->RemoveActor(batch.actor);
+        if (observerTag)
+            renderer->RemoveObserver(observerTag);
+    }
+    renderer = nullptr;
+    observerTag = 0;
+}
+
+/**
+ * @brief Sets the group size at which instancing starts.
+ * @param count Minimum number of actors sharing a mesh (at least 2).
+ */
+// Applies the new threshold to every group
+void InstanceBatcher::setMinimumInstances(int count)
+{
+    minimumInstances = std::max(2, count);
+
+    const QList<vtkPolyData*> keys = groups.keys();
+    for (vtkPolyData* key : keys)
+        updateGrouping(key);
+}
+
+/**
+ * @brief Sets the bounds hierarchy the group and batch props are culled through.
+ * @param newBvh Culling index, or nullptr to stop indexing.
+ */
+// Moves the existing group and batch props to the new index
+void InstanceBatcher::setBVH(SceneBVH* newBvh)
+{
+    for (const Group& group : groups) {
+        if (group.actor)
+            unindex(group.actor);
+    }
+    for (const Batch& batch : batches)
+        unindex(batch.actor);
+
+    bvh = newBvh;
+    for (const Group& group : groups) {
+        if (group.actor)
+            index(group.actor);
+    }
+    for (const Batch& batch : batches)
+        index(batch.actor);
+}
+
+// --------------------------------------- Registration ---------------------------------------
+
+/**
+ * @brief Registers an actor, instanced with the other users of its mesh if possible.
+ * @param actor  Part actor.
+ * @param shared Shared mesh, or nullptr to draw the actor directly.
+ */
+// Adds the actor to its group (or straight to the renderer)
+void InstanceBatcher::add(vtkActor* actor, vtkPolyData* shared)
+{
+    if (!actor)
+        return;
+
+    if (memberOf.contains(actor)) {
+        setSharedGeometry(actor, shared);
+        updateInstance(actor);
+        return;
+    }
+
+    memberOf.insert(actor, shared);
+    if (!shared) {
+        show(actor);
+        updateMerge(actor);
+        return;
+    }
+
+    Group& group = groups[shared];
+    if (!group.source)
+        group.source = shared;
+    group.positions.insert(actor, group.members.size());
+    group.members.append(actor);
+
+    // Drawn directly until the group is large enough (updateGrouping() may take it out again)
+    if (!group.actor)
+        show(actor);
+
+    updateGrouping(shared);
+    dirty.insert(shared);
+    updateMerge(actor);
+}
+
+/**
+ * @brief Unregisters an actor.
+ * @param actor Registered actor.
+ */
+// Swap-removes the actor from its group and the renderer
+void InstanceBatcher::remove(vtkActor* actor)
+{
+    auto found = memberOf.find(actor);
+    if (found == memberOf.end())
+        return;
+
+    vtkPolyData* shared = found.value();
+    memberOf.erase(found);
+    hide(actor);
+    mergeable.remove(actor);
+    if (isMerged(actor))
+        unmerge(actor);
+
+    if (!shared)
+        return;
+
+    auto groupIt = groups.find(shared);
+    if (groupIt == groups.end())
+        return;
+
+    Group& group = groupIt.value();
+    const int index = group.positions.take(actor);
+    const int last = group.members.size() - 1;
+    if (index != last) {
+        group.members[index] = group.members[last];
+        group.positions[group.members[index]] = index;
+    }
+    group.members.removeLast();
+
+    if (group.members.isEmpty()) {
+        uninstance(group);
+        groups.erase(groupIt);
+        dirty.remove(shared);
+        return;
+    }
+
+    updateGrouping(shared);
+    dirty.insert(shared);
+}
+
+/**
+ * @brief Moves an actor to the group of another mesh.
+ * @param actor  Registered actor.
+ * @param shared New shared mesh, or nullptr.
+ */
+// Re-registers the actor if its mesh changed
+void InstanceBatcher::setSharedGeometry(vtkActor* actor, vtkPolyData* shared)
+{
+    auto found = memberOf.constFind(actor);
+    if (found == memberOf.constEnd() || found.value() == shared)
+        return;
+
+    vtkSmartPointer<vtkActor> keep = actor;
+    remove(actor);
+    add(actor, shared);
+}
+
+/**
+ * @brief Flags an actor's instance data as stale.
+ * @param actor Registered actor.
+ */
+// Queues a rebuild of the actor's group or batch
+void InstanceBatcher::updateInstance(vtkActor* actor)
+{
+    vtkPolyData* shared = memberOf.value(actor, nullptr);
+    if (shared && isInstanced(actor))
+        dirty.insert(shared);
+
+    // Opacity or mapper changes can make a merged actor unmergeable (and back)
+    updateMerge(actor);
+    auto batch = mergedIn.constFind(actor);
+    if (batch != mergedIn.constEnd())
+        dirtyBatches.insert(batch.value());
+}
+
+/**
+ * @brief Unregisters every actor.
+ */
+// Empties the renderer and drops all groups
+void InstanceBatcher::clear()
+{
+    for (auto it = memberOf.constBegin(); it != memberOf.constEnd(); ++it)
+        hide(it.key());
+    for (const Group& group : groups) {
+        if (group.actor && renderer)
+            renderer->RemoveActor(group.actor);
+        if (group.actor)
+            unindex(group.actor);
+    }
+    for (const Batch& batch : batches) {
+        if (renderer)
+            renderer->RemoveActor(batch.actor);
+        unindex(batch.actor);
+    }
+
+    memberOf.clear();
+    groups.clear();
+    dirty.clear();
+    batches.clear();
+    mergedIn.clear();
+    mergeable.clear();
+    dirtyBatches.clear();
+    openBatch = -1;
+    copyBytes = 0;
+}
+
+/**
+ * @brief Returns true if the actor is drawn by its group actor.
+ */
+// Looks up the actor's group
+bool InstanceBatcher::isInstanced(vtkActor* actor) const
+{
+    vtkPolyData* shared = memberOf.value(actor, nullptr);
+    if (!shared)
+        return false;
+
+    auto group = groups.constFind(shared);
+    return group != groups.constEnd() && group.value().actor;
+}
+
+/**
+ * @brief Switches merging of directly drawn actors.
+ * @param enabled True to merge the mergeable actors.
+ */
+// Merges or unmerges every registered actor
+void InstanceBatcher::setMerging(bool enabled)
+{
+    if (merging == enabled)
+        return;
+
+    merging = enabled;
+    const QList<vtkActor*> actors = memberOf.keys();
+    for (vtkActor* actor : actors)
+        updateMerge(actor);
+}
+
+/**
+ * @brief Allows or forbids merging an actor.
+ * @param actor   Registered actor.
+ * @param allowed True if the actor may be merged.
+ */
+// Records the flag and applies it
+void InstanceBatcher::setMergeable(vtkActor* actor, bool allowed)
+{
+    if (!actor)
+        return;
+
+    if (allowed)
+        mergeable.insert(actor);
+    else
+        mergeable.remove(actor);
+    updateMerge(actor);
+}
+
+/**
+ * @brief Returns true if the actor is drawn by a merged batch.
+ */
+// Looks up the actor's batch
+bool InstanceBatcher::isMerged(vtkActor* actor) const
+{
+    return mergedIn.contains(actor);
+}
+
+// Sum kept by the per-frame update
+qint64 InstanceBatcher::mergedBytes() const
+{
+    return copyBytes;
+}
+
+// --------------------------------------- Grouping ---------------------------------------
+
+// Instances a group that reached the threshold, or returns a small one to direct drawing
+void InstanceBatcher::updateGrouping(vtkPolyData* key)
+{
+    auto found = groups.find(key);
+    if (found == groups.end())
+        return;
+
+    Group& group = found.value();
+    const bool wanted = group.members.size() >= minimumInstances;
+
+    if (wanted && !group.actor)
+        instance(group);
+    else if (!wanted && group.actor)
+        uninstance(group);
+}
+
+// Builds the glyph mapper over the shared mesh and swaps it in for the members
+void InstanceBatcher::instance(Group& group)
+{
+    group.instances = vtkSmartPointer<vtkPolyData>::New();
+
+    group.mapper = vtkSmartPointer<vtkGlyph3DMapper>::New();
+    group.mapper->SetSourceData(group.source);
+    group.mapper->SetInputData(group.instances);
+
+    // Per-instance transform: point position, quaternion orientation and per-axis scale
+    group.mapper->SetOrientationModeToQuaternion();
+    group.mapper->SetOrientationArray("Orientation");
+    group.mapper->SetScaling(true);
+    group.mapper->SetScaleModeToScaleByVectorComponents();
+    group.mapper->SetScaleArray("Scale");
+
+    // Per-instance colour (partColor) and visibility
+    group.mapper->SetScalarModeToUsePointFieldData();
+    group.mapper->SelectColorArray("Colors");
+    group.mapper->SetColorModeToDirectScalars();
+    group.mapper->ScalarVisibilityOn();
+    group.mapper->SetMasking(true);
+    group.mapper->SetMaskArray("Mask");
+
+    // Shading and texture follow the first member; colours come from the scalars
+    vtkActor* first = group.members.first();
+    group.actor = vtkSmartPointer<vtkActor>::New();
+    group.actor->SetMapper(group.mapper);
+    group.actor->GetProperty()->DeepCopy(first->GetProperty());
+    group.actor->SetTexture(first->GetTexture());
+    group.actor->PickableOff();     // Picks go to the members
+
+    rebuild(group);
+    index(group.actor);
+
+    for (const vtkSmartPointer<vtkActor>& member : group.members) {
+        if (isMerged(member))
+            unmerge(member);
+        hide(member);
+    }
+    if (renderer)
+        renderer->AddActor(group.actor);
+}
+
+// Drops the group actor and shows the members individually again
+void InstanceBatcher::uninstance(Group& group)
+{
+    if (!group.actor)
+        return;
+
+    if (renderer)
+        renderer->RemoveActor(group.actor);
+    unindex(group.actor);
+    group.actor = nullptr;
+    group.mapper = nullptr;
+    group.instances = nullptr;
+
+    for (const vtkSmartPointer<vtkActor>& member : group.members) {
+        if (memberOf.contains(member)) {
+            show(member);
+            updateMerge(member);
+        }
+    }
+}
+
+// Decomposes each member's matrix into position, orientation and scale
+void InstanceBatcher::rebuild(Group& group)
+{
+    if (!group.instances)
+        return;
+
+    const vtkIdType count = group.members.size();
+
+    // Shading changes (e.g. PBR under an environment) follow the first member
+    if (group.actor && count > 0) {
+        vtkProperty* shading = group.members.first()->GetProperty();
+        if (shading->GetMTime() > group.actor->GetProperty()->GetMTime())
+            group.actor->GetProperty()->DeepCopy(shading);
+    }
+
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataTypeToDouble();
+    points->SetNumberOfPoints(count);
+
+    auto orientation = vtkSmartPointer<vtkDoubleArray>::New();
+    orientation->SetName("Orientation");
+    orientation->SetNumberOfComponents(4);
+    orientation->SetNumberOfTuples(count);
+
+    auto scale = vtkSmartPointer<vtkDoubleArray>::New();
+    scale->SetName("Scale");
+    scale->SetNumberOfComponents(3);
+    scale->SetNumberOfTuples(count);
+
+    auto colors = vtkSmartPointer<vtkUnsignedCharArray>::New();
+    colors->SetName("Colors");
+    colors->SetNumberOfComponents(4);
+    colors->SetNumberOfTuples(count);
+
+    auto mask = vtkSmartPointer<vtkBitArray>::New();
+    mask->SetName("Mask");
+    mask->SetNumberOfComponents(1);
+    mask->SetNumberOfTuples(count);
+
+    auto transform = vtkSmartPointer<vtkTransform>::New();
+    for (vtkIdType i = 0; i < count; ++i) {
+        vtkActor* member = group.members[i];
+
+        // The actor matrix includes the user matrix (assembly placement) and interactive rotation
+        transform->SetMatrix(member->GetMatrix());
+
+        double position[3], factors[3], wxyz[4];
+        transform->GetPosition(position);
+        transform->GetScale(factors);
+        transform->GetOrientationWXYZ(wxyz);
+
+        const double half = vtkMath::RadiansFromDegrees(wxyz[0]) * 0.5;
+        double axis[3] = { wxyz[1], wxyz[2], wxyz[3] };
+        if (vtkMath::Normalize(axis) == 0.0)
+            axis[0] = 1.0;
+        const double s = std::sin(half);
+
+        points->SetPoint(i, position);
+        orientation->SetTuple4(i, std::cos(half), axis[0] * s, axis[1] * s, axis[2] * s);
+        scale->SetTuple(i, factors);
+
+        double rgb[3];
+        member->GetProperty()->GetColor(rgb);
+        colors->SetTuple4(i, rgb[0] * 255.0, rgb[1] * 255.0, rgb[2] * 255.0,
+            member->GetProperty()->GetOpacity() * 255.0);
+
+        mask->SetValue(i, member->GetVisibility() ? 1 : 0);
+    }
+
+    group.instances->SetPoints(points);
+    vtkPointData* pointData = group.instances->GetPointData();
+    pointData->Initialize();
+    pointData->AddArray(orientation);
+    pointData->AddArray(scale);
+    pointData->SetScalars(colors);
+    pointData->AddArray(mask);
+    group.instances->Modified();
+}
+
+// --------------------------------------- Merged Batches ---------------------------------------
+
+/**
+ * @brief Checks whether an actor can be drawn through a batch.
+ * @param actor Actor to check.
+ *
+ * Batches are opaque and untextured, so translucent parts keep their depth sorting
+ * and textured parts their texture.
+ */
+// Needs an opaque, untextured actor with a polydata mapper and input
+bool InstanceBatcher::canMerge(vtkActor* actor)
+{
+    auto* mapper = vtkPolyDataMapper::SafeDownCast(actor->GetMapper());
+    return mapper && mapper->GetInput() && !actor->GetTexture() && actor->GetProperty()->GetOpacity() >= 1.0;
+}
+
+// Merges actors that are drawn directly and allowed to, unmerges the rest
+void InstanceBatcher::updateMerge(vtkActor* actor)
+{
+    const bool wanted = merging && mergeable.contains(actor) && memberOf.contains(actor)
+        && !isInstanced(actor) && canMerge(actor);
+    const bool merged = isMerged(actor);
+
+    if (wanted && !merged) {
+        hide(actor);
+        merge(actor);
+    }
+    else if (!wanted && merged) {
+        unmerge(actor);
+        if (memberOf.contains(actor) && !isInstanced(actor))
+            show(actor);
+    }
+}
+
+/**
+ * @brief Adds an actor to the open batch, starting a new batch when it is full.
+ * @param actor Actor to merge; it must already be out of the renderer.
+ */
+// Appends a world-space copy of the actor's mesh as a new block
+void InstanceBatcher::merge(vtkActor* actor)
+{
+    vtkPolyData* mesh = vtkPolyDataMapper::SafeDownCast(actor->GetMapper())->GetInput();
+
+    auto open = batches.find(openBatch);
+    if (open == batches.end() || open.value().members.size() >= MaxBatchMembers
+        || open.value().cells + mesh->GetNumberOfCells() > MaxBatchCells) {
+        openBatch = nextBatch++;
+        Batch& batch = batches[openBatch];
+        batch.blocks = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+        batch.attributes = vtkSmartPointer<vtkCompositeDataDisplayAttributes>::New();
+        batch.mapper = vtkSmartPointer<vtkCompositePolyDataMapper>::New();
+        batch.mapper->SetInputDataObject(batch.blocks);
+        batch.mapper->SetCompositeDataDisplayAttributes(batch.attributes);
+        batch.mapper->ScalarVisibilityOff();    // Colours come from the block attributes
+
+        // Shading follows the first member, like an instanced group
+        batch.actor = vtkSmartPointer<vtkActor>::New();
+        batch.actor->SetMapper(batch.mapper);
+        batch.actor->GetProperty()->DeepCopy(actor->GetProperty());
+        batch.actor->PickableOff();     // Picks go to the members
+        if (renderer)
+            renderer->AddActor(batch.actor);
+        open = batches.find(openBatch);
+    }
+
+    Batch& batch = open.value();
+    auto transform = vtkSmartPointer<vtkTransform>::New();
+    transform->SetMatrix(actor->GetMatrix());
+    auto copy = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
+    copy->SetTransform(transform);
+    copy->SetInputData(mesh);
+
+    auto matrix = vtkSmartPointer<vtkMatrix4x4>::New();
+    matrix->DeepCopy(actor->GetMatrix());
+
+    batch.positions.insert(actor, batch.members.size());
+    batch.members.append(actor);
+    batch.copies.append(copy);
+    batch.matrices.append(matrix);
+    batch.cells += mesh->GetNumberOfCells();
+    batch.blocks->SetNumberOfBlocks(batch.members.size());
+    batch.blocks->SetBlock(batch.members.size() - 1, copy->GetOutput());
+
+    mergedIn.insert(actor, openBatch);
+    dirtyBatches.insert(openBatch);
+}
+
+/**
+ * @brief Swap-removes an actor from its batch; an emptied batch is dropped.
+ * @param actor Merged actor.
+ */
+// Removes the actor's block and attributes
+void InstanceBatcher::unmerge(vtkActor* actor)
+{
+    const int id = mergedIn.take(actor);
+    auto found = batches.find(id);
+    if (found == batches.end())
+        return;
+
+    Batch& batch = found.value();
+    const int index = batch.positions.take(actor);
+    vtkPolyData* block = batch.copies[index]->GetOutput();
+    batch.attributes->RemoveBlockColor(block);
+    batch.attributes->RemoveBlockVisibility(block);
+    if (vtkPolyData* mesh = vtkPolyData::SafeDownCast(batch.copies[index]->GetInput()))
+        batch.cells -= mesh->GetNumberOfCells();
+
+    const int last = batch.members.size() - 1;
+    if (index != last) {
+        batch.members[index] = batch.members[last];
+        batch.copies[index] = batch.copies[last];
+        batch.matrices[index] = batch.matrices[last];
+        batch.positions[batch.members[index]] = index;
+        batch.blocks->SetBlock(index, batch.copies[index]->GetOutput());
+    }
+    batch.members.removeLast();
+    batch.copies.removeLast();
+    batch.matrices.removeLast();
+    batch.blocks->SetNumberOfBlocks(batch.members.size());
+
+    if (batch.members.isEmpty()) {
+        if (renderer)
+            renderer->RemoveActor(batch.actor);
+        unindex(batch.actor);
+        copyBytes -= batch.bytes;
+        batches.erase(found);
+        dirtyBatches.remove(id);
+        if (openBatch == id)
+            openBatch = -1;
+        return;
+    }
+
+    // Refill this batch before starting new ones
+    openBatch = id;
+    dirtyBatches.insert(id);
+}
+
+/**
+ * @brief Brings a batch up to date with its members.
+ * @param batch Batch to refresh.
+ *
+ * Only members whose matrix or mesh changed are copied again; colour and visibility
+ * changes only touch the display attributes.
+ */
+// Re-copies moved or edited members and refreshes their colours
+void InstanceBatcher::rebuild(Batch& batch)
+{
+    if (batch.members.isEmpty())
+        return;
+
+    vtkProperty* shading = batch.members.first()->GetProperty();
+    if (shading->GetMTime() > batch.actor->GetProperty()->GetMTime())
+        batch.actor->GetProperty()->DeepCopy(shading);
+
+    for (int i = 0; i < batch.members.size(); ++i) {
+        vtkActor* member = batch.members[i];
+        vtkTransformPolyDataFilter* copy = batch.copies[i];
+
+        // Filtered geometry replaces the mapper input; the transform filter follows it
+        auto* mapper = vtkPolyDataMapper::SafeDownCast(member->GetMapper());
+        if (mapper && mapper->GetInput() && copy->GetInput() != mapper->GetInput()) {
+            if (vtkPolyData* previous = vtkPolyData::SafeDownCast(copy->GetInput()))
+                batch.cells -= previous->GetNumberOfCells();
+            batch.cells += mapper->GetInput()->GetNumberOfCells();
+            copy->SetInputData(mapper->GetInput());
+        }
+
+        vtkMatrix4x4* current = member->GetMatrix();
+        if (!sameMatrix(current, batch.matrices[i])) {
+            batch.matrices[i]->DeepCopy(current);
+            static_cast<vtkTransform*>(copy->GetTransform())->SetMatrix(current);
+        }
+        copy->Update();
+
+        double rgb[3];
+        member->GetProperty()->GetColor(rgb);
+        batch.attributes->SetBlockColor(copy->GetOutput(), rgb);
+        batch.attributes->SetBlockVisibility(copy->GetOutput(), member->GetVisibility() != 0);
+    }
+
+    batch.attributes->Modified();
+    batch.blocks->Modified();
+
+    batch.bytes = 0;
+    for (const vtkSmartPointer<vtkTransformPolyDataFilter>& copy : batch.copies) {
+        if (vtkPolyData* source = vtkPolyData::SafeDownCast(copy->GetInput()))
+            batch.bytes += ownedBytes(copy->GetOutput(), source);
+    }
+}
+
+// --------------------------------------- Per-Frame Update ---------------------------------------
+
+// Rebuilds the instance arrays of every stale group and batch
+void InstanceBatcher::update()
+{
+    for (vtkPolyData* key : dirty) {
+        auto found = groups.find(key);
+        if (found == groups.end())
+            continue;
+        rebuild(found.value());
+
+        // Members moved: the group's bounds follow (this runs before the renderer culls)
+        if (found.value().actor)
+            index(found.value().actor);
+    }
+    dirty.clear();
+
+    for (int id : dirtyBatches) {
+        auto found = batches.find(id);
+        if (found == batches.end())
+            continue;
+        copyBytes -= found.value().bytes;
+        rebuild(found.value());
+        copyBytes += found.value().bytes;
+
+        // New batches enter the index here, once their blocks have bounds
+        index(found.value().actor);
+    }
+    dirtyBatches.clear();
+}
+
+// Renderer StartEvent: refreshes stale instances
+void InstanceBatcher::onStartRender(vtkObject*, unsigned long, void* clientData, void*)
+{
+    static_cast<InstanceBatcher*>(clientData)->update();
+}
+
+// --------------------------------------- Renderer Membership ---------------------------------------
+
+// Adds an actor to the renderer (no-op while detached or if already present)
+void InstanceBatcher::show(vtkActor* actor)
+{
+    if (renderer)
+        renderer->AddActor(actor);
+}
+
+// Removes an actor from the renderer
+void InstanceBatcher::hide(vtkActor* actor)
+{
+    if (renderer)
+        renderer->RemoveActor(actor);
+}
+
+// --------------------------------------- Culling Index ---------------------------------------
+
+// Adds a prop to the BVH, or refits it if it is already indexed
+void InstanceBatcher::index(vtkActor* prop)
+{
+    if (bvh && prop)
+        bvh->insert(prop);
+}
+
+// Drops a prop from the BVH
+void InstanceBatcher::unindex(vtkActor* prop)
+{
+    if (bvh && prop)
+        bvh->remove(prop);
+}
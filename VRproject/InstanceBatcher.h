@@ -0,0 +1,268 @@
+/**
+ * @file InstanceBatcher.h
+ * @brief Draws part actors that share one mesh through a single instanced glyph mapper.
+ *
+ * Assemblies repeat the same STL many times (fasteners, brackets, battery cells).
+ * Actors registered with the same shared mesh form a group; once a group is large
+ * enough its members leave the renderer and one vtkGlyph3DMapper actor draws them
+ * all, with each member's transform, colour and visibility as per-instance data.
+ *
+ * Optionally, the remaining directly drawn actors are merged as well: their meshes
+ * are copied to world space into a few composite batches, so a renderer (or each
+ * eye of a stereo renderer) traverses one prop per batch instead of one per part.
+ */
+
+#ifndef INSTANCE_BATCHER_H
+#define INSTANCE_BATCHER_H
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QHash>        // Actor -> group and shared mesh -> group lookups
+#include <QSet>         // Groups waiting for a rebuild
+#include <QVector>      // Group members
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkSmartPointer.h>      // Smart pointer management for VTK
+#include <vtkWeakPointer.h>       // Observed renderer
+#include <vtkActor.h>             // Member and group actors
+#include <vtkPolyData.h>          // Shared meshes and instance points
+#include <vtkGlyph3DMapper.h>     // Instanced drawing
+#include <vtkCompositePolyDataMapper.h>          // Merged batches
+#include <vtkCompositeDataDisplayAttributes.h>   // Per-part colour and visibility in a batch
+#include <vtkMultiBlockDataSet.h>                // One block per merged part
+#include <vtkTransformPolyDataFilter.h>          // World-space copies of merged parts
+#include <vtkMatrix4x4.h>                        // Matrix a merged copy was made with
+#include <vtkRenderer.h>          // Renderer the batcher fills
+#include <vtkCallbackCommand.h>   // StartEvent observer
+
+#include "SceneBVH.h"             // Culling index the group props are kept in
+
+// --------------------------------------- InstanceBatcher Class ---------------------------------------
+/**
+ * @class InstanceBatcher
+ * @brief Owns the renderer membership of part actors and instances repeated meshes.
+ *
+ * Callers add and remove part actors through the batcher instead of the renderer.
+ * Actors without a shared mesh (e.g. filtered parts) are simply added to the renderer.
+ * Instanced and merged members stay pickable: they keep their own mapper and
+ * visibility, they are just not in the renderer's prop list.
+ *
+ * One batcher belongs to exactly one renderer and must only be used from the thread
+ * that renders it.
+ */
+class InstanceBatcher {
+public:
+    /**
+     * @brief Constructs a batcher that is not yet attached to a renderer.
+     */
+    // Constructor: creates the render observer
+    InstanceBatcher();
+
+    /**
+     * @brief Destructor: detaches from the renderer.
+     */
+    // Destructor: removes the observer
+    ~InstanceBatcher();
+
+    InstanceBatcher(const InstanceBatcher&) = delete;
+    InstanceBatcher& operator=(const InstanceBatcher&) = delete;
+
+    /**
+     * @brief Puts the registered actors (or their group actors) into a renderer.
+     * @param renderer Renderer to fill; instance data is refreshed at its StartEvent.
+     */
+    // Adds the props and the StartEvent observer to a renderer
+    void attach(vtkRenderer* renderer);
+
+    /**
+     * @brief Removes every prop the batcher added and stops observing the renderer.
+     */
+    // Takes the props out of the renderer
+    void detach();
+
+    /**
+     * @brief Sets how many actors must share a mesh before they are instanced.
+     */
+    // Group size threshold (default 4)
+    void setMinimumInstances(int count);
+
+    /**
+     * @brief Keeps the batcher's own props in a bounds hierarchy.
+     * @param bvh Index the renderer culls with (must outlive the batcher), or nullptr.
+     *
+     * Members hidden behind a group or batch prop are never rendered themselves, so the
+     * culler has to see that prop, with bounds spanning all its members, instead.
+     */
+    // Sets the culling index for group and batch props
+    void setBVH(SceneBVH* bvh);
+
+    /**
+     * @brief Registers an actor.
+     * @param actor  Part actor.
+     * @param shared Mesh shared by identical parts (also the glyph source), or nullptr to draw the actor directly.
+     */
+    // Adds an actor to the scene, instanced if possible
+    void add(vtkActor* actor, vtkPolyData* shared);
+
+    /**
+     * @brief Unregisters an actor and removes it (or its instance) from the scene.
+     */
+    // Removes an actor
+    void remove(vtkActor* actor);
+
+    /**
+     * @brief Moves an actor to another group, e.g. after a filter was switched on or off.
+     * @param actor  Registered actor.
+     * @param shared New shared mesh, or nullptr to draw the actor directly.
+     */
+    // Regroups an actor
+    void setSharedGeometry(vtkActor* actor, vtkPolyData* shared);
+
+    /**
+     * @brief Marks an actor's transform, colour or visibility as changed.
+     *
+     * Its group's instance data is rebuilt once, at the start of the next frame.
+     */
+    // Flags an actor's instance as stale
+    void updateInstance(vtkActor* actor);
+
+    /**
+     * @brief Unregisters every actor and removes all props from the renderer.
+     */
+    // Removes all actors
+    void clear();
+
+    /**
+     * @brief Returns true if the actor is currently drawn by a group actor.
+     */
+    // Checks whether an actor is instanced
+    bool isInstanced(vtkActor* actor) const;
+
+    /**
+     * @brief Turns merging of the directly drawn, mergeable actors on or off.
+     *
+     * Merged parts are re-copied whenever their transform or mesh changes, so merging
+     * suits static scenes; callers turn it off while the parts are animated. A batch
+     * is culled and sorted as a whole, and every part in it is drawn at full detail.
+     */
+    // Switches merged batches (off by default)
+    void setMerging(bool enabled);
+
+    /**
+     * @brief Marks whether an actor may be merged.
+     * @param actor   Registered actor.
+     * @param allowed False for actors that need their own mapper (LOD levels, section planes).
+     *
+     * Translucent or textured actors and actors without a polydata mapper are never merged.
+     */
+    // Allows or forbids merging one actor
+    void setMergeable(vtkActor* actor, bool allowed);
+
+    /**
+     * @brief Returns true if the actor is currently drawn by a merged batch.
+     */
+    // Checks whether an actor is merged
+    bool isMerged(vtkActor* actor) const;
+
+    /**
+     * @brief Returns the system memory held by the world-space copies of merged actors.
+     *
+     * Only arrays the copies own are counted (transformed points and normals); the
+     * cells are shared with the members' meshes. Updated after each rebuild, so a copy
+     * of an evicted mesh drops out once the member's new input has been picked up.
+     */
+    // Bytes of the merged copies
+    qint64 mergedBytes() const;
+
+private:
+    /**
+     * @brief Actors sharing one mesh.
+     */
+    struct Group {
+        vtkSmartPointer<vtkPolyData> source;            // Shared mesh drawn for every instance
+        QVector<vtkSmartPointer<vtkActor>> members;     // Registered actors
+        QHash<vtkActor*, int> positions;                // Member -> index in members
+        vtkSmartPointer<vtkPolyData> instances;         // One point per member with transform/colour/mask arrays
+        vtkSmartPointer<vtkGlyph3DMapper> mapper;       // Instanced mapper (null while not instanced)
+        vtkSmartPointer<vtkActor> actor;                // Draws the whole group (null while not instanced)
+    };
+
+    /**
+     * @brief Directly drawn actors merged into one composite mapper.
+     */
+    struct Batch {
+        QVector<vtkSmartPointer<vtkActor>> members;                 // Merged actors
+        QHash<vtkActor*, int> positions;                            // Member -> index in members
+        QVector<vtkSmartPointer<vtkTransformPolyDataFilter>> copies; // World-space copy per member
+        QVector<vtkSmartPointer<vtkMatrix4x4>> matrices;            // Actor matrix each copy was made with
+        vtkIdType cells = 0;                                        // Cells of all members
+        qint64 bytes = 0;                                           // Memory owned by the copies
+        vtkSmartPointer<vtkMultiBlockDataSet> blocks;               // The copies, one block each
+        vtkSmartPointer<vtkCompositeDataDisplayAttributes> attributes; // Member colours and visibility
+        vtkSmartPointer<vtkCompositePolyDataMapper> mapper;         // Draws the batch
+        vtkSmartPointer<vtkActor> actor;                            // Batch prop in the renderer
+    };
+
+    // Switches a group between direct and instanced drawing after its size changed
+    void updateGrouping(vtkPolyData* key);
+
+    // Merges or unmerges an actor to match the merging state
+    void updateMerge(vtkActor* actor);
+
+    // Adds an actor to a batch with room (creating one if needed)
+    void merge(vtkActor* actor);
+
+    // Takes an actor out of its batch (it is not shown again here)
+    void unmerge(vtkActor* actor);
+
+    // Refreshes a batch's copies, colours and visibility
+    static void rebuild(Batch& batch);
+
+    // True if the actor can be drawn by a batch at all
+    static bool canMerge(vtkActor* actor);
+
+    // Creates the glyph mapper and actor for a group
+    void instance(Group& group);
+
+    // Returns the members to the renderer and drops the group actor
+    void uninstance(Group& group);
+
+    // Writes every member's transform, colour and visibility into the instance arrays
+    static void rebuild(Group& group);
+
+    // Rebuilds stale groups (called before each render)
+    void update();
+
+    // VTK observer trampoline
+    static void onStartRender(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+
+    // Renderer membership helpers (no-ops while detached)
+    void show(vtkActor* actor);
+    void hide(vtkActor* actor);
+
+    // Culling index helpers (no-ops without a BVH)
+    void index(vtkActor* prop);
+    void unindex(vtkActor* prop);
+
+    QHash<vtkPolyData*, Group> groups;                  // Shared mesh -> group
+    QHash<vtkActor*, vtkPolyData*> memberOf;            // Actor -> shared mesh (nullptr: drawn directly)
+    QSet<vtkPolyData*> dirty;                           // Groups whose instance data is stale
+    int minimumInstances;                               // Group size at which instancing starts
+
+    QHash<int, Batch> batches;                          // Batch id -> merged actors
+    QHash<vtkActor*, int> mergedIn;                     // Merged actor -> batch id
+    QSet<vtkActor*> mergeable;                          // Actors allowed to merge
+    QSet<int> dirtyBatches;                             // Batches whose copies or colours are stale
+    int openBatch;                                      // Batch receiving new members (-1: none)
+    int nextBatch;                                      // Next batch id
+    bool merging;                                       // Merging switched on
+    qint64 copyBytes;                                   // Memory owned by all batch copies
+
+    vtkWeakPointer<vtkRenderer> renderer;               // Filled renderer
+    SceneBVH* bvh;                                      // Culling index for group and batch props (not owned)
+    vtkSmartPointer<vtkCallbackCommand> callback;       // StartEvent observer
+    unsigned long observerTag;                          // Tag returned by AddObserver
+};
+
+#endif // INSTANCE_BATCHER_H
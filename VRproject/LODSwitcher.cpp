@@ -0,0 +1,269 @@
+/**
+ * @file LODSwitcher.cpp
+ * @brief Implementation of screen-coverage based level-of-detail selection.
+ */
+
+#include "LODSwitcher.h"
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkCamera.h>
+#include <vtkMath.h>
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <cmath>
+
+// --------------------------------------- Thresholds ---------------------------------------
+
+namespace {
+
+// Coverage (fraction of viewport height) below which the next coarser level is used
+const double CoverageThresholds[] = { 0.35, 0.12, 0.04 };
+const int    ThresholdCount = int(sizeof(CoverageThresholds) / sizeof(CoverageThresholds[0]));
+
+// Relative band around each threshold that must be crossed before switching, to stop flicker
+const double Hysteresis = 0.15;
+
+} // namespace
+
+// --------------------------------------- Constructor & Destructor ---------------------------------------
+
+/**
+ * @brief Constructs the switcher and its render observer.
+ */
+// Creates the StartEvent callback
+LODSwitcher::LODSwitcher()
+    : observerTag(0)
+{
+    callback = vtkSmartPointer<vtkCallbackCommand>::New();
+    callback->SetClientData(this);
+    callback->SetCallback(&LODSwitcher::onStartRender);
+}
+
+/**
+ * @brief Detaches from the renderer. Registered actors keep their current mappers.
+ */
+// Removes the observer
+LODSwitcher::~LODSwitcher()
+{
+    detach();
+}
+
+// --------------------------------------- Renderer ---------------------------------------
+
+/**
+ * @brief Observes the renderer so levels are chosen at the start of each frame.
+ * @param newRenderer Renderer to observe.
+ */
+// Adds the StartEvent observer to a renderer
+void LODSwitcher::attach(vtkRenderer* newRenderer)
+{
+    detach();
+    renderer = newRenderer;
+    if (renderer)
+        observerTag = renderer->AddObserver(vtkCommand::StartEvent, callback);
+}
+
+/**
+ * @brief Removes the observer from the current renderer.
+ */
+// Stops per-frame selection
+void LODSwitcher::detach()
+{
+    if (renderer && observerTag)
+        renderer->RemoveObserver(observerTag);
+    renderer = nullptr;
+    observerTag = 0;
+}
+
+// --------------------------------------- Registration ---------------------------------------
+
+/**
+ * @brief Registers or replaces the detail levels of an actor.
+ * @param actor  Actor whose mapper is swapped.
+ * @param levels Mappers from full resolution to coarsest.
+ */
+// Sets the mapper chain; fewer than two levels unregisters the actor
+void LODSwitcher::setLevels(vtkActor* actor, const QVector<vtkSmartPointer<vtkMapper>>& levels)
+{
+    if (!actor)
+        return;
+
+    if (levels.size() < 2) {
+        remove(actor);
+        return;
+    }
+
+    const Entry* existing = find(actor);
+    if (existing && existing->levels == levels)
+        return;
+
+    Entry entry;
+    entry.actor = actor;
+    entry.levels = levels;
+    entry.current = 0;
+    entries.insert(actor, entry);    // Replaces the old chain (or a stale entry at this address)
+
+    actor->SetMapper(levels.first());
+}
+
+/**
+ * @brief Returns the registered mappers of an actor.
+ */
+// Looks up the mapper chain
+QVector<vtkSmartPointer<vtkMapper>> LODSwitcher::levels(vtkActor* actor) const
+{
+    const Entry* entry = find(actor);
+    return entry ? entry->levels : QVector<vtkSmartPointer<vtkMapper>>();
+}
+
+/**
+ * @brief Returns the full-resolution mapper of an actor.
+ */
+// Level 0 when registered, otherwise the actor's own mapper
+vtkMapper* LODSwitcher::fullMapper(vtkActor* actor) const
+{
+    if (!actor)
+        return nullptr;
+
+    const Entry* entry = find(actor);
+    return entry ? entry->levels.first().Get() : actor->GetMapper();
+}
+
+/**
+ * @brief Unregisters an actor and restores its full-resolution mapper.
+ */
+// Drops one entry
+void LODSwitcher::remove(vtkActor* actor)
+{
+    const Entry* entry = find(actor);
+    if (!entry) {
+        entries.remove(actor);      // Drops a stale entry, if any
+        return;
+    }
+
+    if (actor->GetMapper() != entry->levels.first())
+        actor->SetMapper(entry->levels.first());
+    entries.remove(actor);
+}
+
+/**
+ * @brief Unregisters every actor.
+ */
+// Drops all entries, restoring full detail on live actors
+void LODSwitcher::clear()
+{
+    for (Entry& entry : entries) {
+        if (entry.actor && entry.actor->GetMapper() != entry.levels.first())
+            entry.actor->SetMapper(entry.levels.first());
+    }
+    entries.clear();
+}
+
+// Hash lookup; the weak pointer tells a live entry from one of a deleted actor
+const LODSwitcher::Entry* LODSwitcher::find(vtkActor* actor) const
+{
+    auto it = entries.constFind(actor);
+    if (it == entries.constEnd() || it->actor.Get() != actor)
+        return nullptr;
+    return &it.value();
+}
+
+// --------------------------------------- Selection ---------------------------------------
+
+/**
+ * @brief Picks a level for the given coverage.
+ * @param coverage     Fraction of the viewport height covered.
+ * @param currentLevel Level used in the previous frame.
+ * @param levelCount   Number of available levels.
+ * @return Level to use this frame.
+ *
+ * A switch only happens once coverage moves past the threshold between the
+ * current level and its neighbour by more than the hysteresis band.
+ */
+// Thresholded level selection with hysteresis
+int LODSwitcher::selectLevel(double coverage, int currentLevel, int levelCount)
+{
+    int level = 0;
+    while (level + 1 < levelCount && level < ThresholdCount && coverage < CoverageThresholds[level])
+        ++level;
+
+    if (level > currentLevel && coverage > CoverageThresholds[currentLevel] * (1.0 - Hysteresis))
+        return currentLevel;
+    if (level < currentLevel && coverage < CoverageThresholds[currentLevel - 1] * (1.0 + Hysteresis))
+        return currentLevel;
+
+    return level;
+}
+
+/**
+ * @brief Estimates the fraction of the viewport height covered by an actor.
+ * @param renderer Renderer providing the active camera.
+ * @param actor    Actor to measure (world-space bounds, including its user matrix).
+ * @return Projected diameter of the bounding sphere over the viewport height.
+ */
+// Bounding-sphere projection for perspective and parallel cameras
+double LODSwitcher::screenCoverage(vtkRenderer* renderer, vtkActor* actor)
+{
+    vtkCamera* camera = renderer ? renderer->GetActiveCamera() : nullptr;
+    const double* bounds = actor ? actor->GetBounds() : nullptr;
+    if (!camera || !bounds || !vtkMath::AreBoundsInitialized(bounds))
+        return 1.0;
+
+    const double center[3] = {
+        0.5 * (bounds[0] + bounds[1]),
+        0.5 * (bounds[2] + bounds[3]),
+        0.5 * (bounds[4] + bounds[5]),
+    };
+    const double radius = 0.5 * std::sqrt(
+        (bounds[1] - bounds[0]) * (bounds[1] - bounds[0]) +
+        (bounds[3] - bounds[2]) * (bounds[3] - bounds[2]) +
+        (bounds[5] - bounds[4]) * (bounds[5] - bounds[4]));
+
+    if (camera->GetParallelProjection())
+        return camera->GetParallelScale() > 0.0 ? radius / camera->GetParallelScale() : 1.0;
+
+    double position[3];
+    camera->GetPosition(position);
+    const double distance = std::sqrt(vtkMath::Distance2BetweenPoints(position, center));
+    if (distance <= radius)
+        return 1.0e6;
+
+    const double halfAngle = vtkMath::RadiansFromDegrees(camera->GetViewAngle() * 0.5);
+    return radius / (distance * std::tan(halfAngle));
+}
+
+/**
+ * @brief Selects the level of every registered actor for the coming frame.
+ */
+// Swaps mappers where the level changed; prunes actors that were deleted
+void LODSwitcher::update()
+{
+    if (!renderer)
+        return;
+
+    for (auto it = entries.begin(); it != entries.end();) {
+        Entry& entry = it.value();
+        if (!entry.actor) {
+            it = entries.erase(it);
+            continue;
+        }
+        ++it;
+        if (!entry.actor->GetVisibility())
+            continue;
+
+        const double coverage = screenCoverage(renderer, entry.actor);
+        const int level = selectLevel(coverage, entry.current, entry.levels.size());
+        if (level != entry.current || entry.actor->GetMapper() != entry.levels[level]) {
+            entry.current = level;
+            entry.actor->SetMapper(entry.levels[level]);
+        }
+    }
+}
+
+// Forwards the renderer's StartEvent to update()
+void LODSwitcher::onStartRender(vtkObject*, unsigned long, void* clientData, void*)
+{
+    static_cast<LODSwitcher*>(clientData)->update();
+}
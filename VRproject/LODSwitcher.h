@@ -0,0 +1,143 @@
+/**
+ * @file LODSwitcher.h
+ * @brief Screen-coverage based level-of-detail selection for part actors.
+ *
+ * Each registered actor has a list of mappers, full resolution first. Before every
+ * render the switcher estimates how much of the viewport each actor covers and
+ * gives it the coarsest mapper that still looks right at that size.
+ */
+
+#ifndef LOD_SWITCHER_H
+#define LOD_SWITCHER_H
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QVector>      // Per-actor mapper lists
+#include <QHash>        // Entries by actor
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkSmartPointer.h>      // Smart pointer management for VTK
+#include <vtkWeakPointer.h>       // Entries do not keep actors alive
+#include <vtkActor.h>             // Actors whose mapper is swapped
+#include <vtkMapper.h>            // Per-level mappers
+#include <vtkRenderer.h>          // Renderer the switcher observes
+#include <vtkCallbackCommand.h>   // StartEvent observer
+
+// --------------------------------------- LODSwitcher Class ---------------------------------------
+/**
+ * @class LODSwitcher
+ * @brief Swaps actor mappers between detail levels based on projected screen size.
+ *
+ * Works like vtkLODProp3D, but selects on screen coverage instead of the previous
+ * frame's render time, which is unstable in VR. One switcher belongs to exactly one
+ * renderer and must only be used from the thread that renders it.
+ */
+class LODSwitcher {
+public:
+    /**
+     * @brief Constructs a switcher that is not yet attached to a renderer.
+     */
+    // Constructor: creates the render observer
+    LODSwitcher();
+
+    /**
+     * @brief Destructor: detaches from the renderer.
+     */
+    // Destructor: removes the observer
+    ~LODSwitcher();
+
+    LODSwitcher(const LODSwitcher&) = delete;
+    LODSwitcher& operator=(const LODSwitcher&) = delete;
+
+    /**
+     * @brief Starts selecting levels each time the renderer begins a frame.
+     * @param renderer Renderer whose active camera drives the selection.
+     */
+    // Observes the renderer's StartEvent
+    void attach(vtkRenderer* renderer);
+
+    /**
+     * @brief Stops observing the renderer.
+     */
+    // Removes the StartEvent observer
+    void detach();
+
+    /**
+     * @brief Registers (or replaces) the detail levels of an actor.
+     * @param actor  Actor whose mapper is swapped.
+     * @param levels Mappers from full resolution to coarsest. Fewer than two levels
+     *               removes the actor and restores its full-resolution mapper.
+     *
+     * Passing the same mappers again is a no-op, so callers can re-sync freely.
+     */
+    // Sets the mapper chain for an actor
+    void setLevels(vtkActor* actor, const QVector<vtkSmartPointer<vtkMapper>>& levels);
+
+    /**
+     * @brief Returns the registered mappers of an actor (empty if not registered).
+     */
+    // Returns the mapper chain for an actor
+    QVector<vtkSmartPointer<vtkMapper>> levels(vtkActor* actor) const;
+
+    /**
+     * @brief Returns the full-resolution mapper of an actor.
+     * @return Level 0 if the actor is registered, otherwise its current mapper.
+     */
+    // Returns the mapper that shows the actor at full detail
+    vtkMapper* fullMapper(vtkActor* actor) const;
+
+    /**
+     * @brief Unregisters an actor and restores its full-resolution mapper.
+     */
+    // Removes one actor
+    void remove(vtkActor* actor);
+
+    /**
+     * @brief Unregisters all actors, restoring their full-resolution mappers.
+     */
+    // Removes every actor
+    void clear();
+
+    /**
+     * @brief Picks a level for the given coverage, with hysteresis around each threshold.
+     * @param coverage     Projected size as a fraction of the viewport height.
+     * @param currentLevel Level used in the previous frame.
+     * @param levelCount   Number of available levels.
+     */
+    // Maps screen coverage to a detail level
+    static int selectLevel(double coverage, int currentLevel, int levelCount);
+
+    /**
+     * @brief Estimates the fraction of the viewport height covered by an actor.
+     * @return Projected bounding-sphere diameter over viewport height (large if the camera is inside).
+     */
+    // Projects the actor's bounding sphere through the active camera
+    static double screenCoverage(vtkRenderer* renderer, vtkActor* actor);
+
+private:
+    /**
+     * @brief One registered actor.
+     */
+    struct Entry {
+        vtkWeakPointer<vtkActor> actor;                 // Dropped automatically when the part is deleted
+        QVector<vtkSmartPointer<vtkMapper>> levels;     // Full resolution first
+        int current = 0;                                // Level used in the last frame
+    };
+
+    // Selects a level for every registered actor (called before each render)
+    void update();
+
+    // VTK observer trampoline
+    static void onStartRender(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+
+    // Returns the actor's entry, or nullptr (an entry left by a deleted actor at the same address does not match)
+    const Entry* find(vtkActor* actor) const;
+
+    QHash<vtkActor*, Entry> entries;                // Registered actors by address
+    vtkWeakPointer<vtkRenderer> renderer;           // Observed renderer
+    vtkSmartPointer<vtkCallbackCommand> callback;   // StartEvent observer
+    unsigned long observerTag;                      // Tag returned by AddObserver
+};
+
+#endif // LOD_SWITCHER_H
@@ -0,0 +1,358 @@
+/**
+ * @file MemoryBudget.cpp
+ * @brief Implementation of memory accounting, eviction and reload.
+ */
+
+#include "MemoryBudget.h"
+#include "PartLoader.h"
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QtConcurrent>
+#include <QSet>
+#include <QDebug>
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkPoints.h>
+#include <vtkPointData.h>
+#include <vtkCellData.h>
+#include <vtkCellArray.h>
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <algorithm>
+
+// --------------------------------------- Budget Defaults ---------------------------------------
+
+namespace {
+
+const qint64 MiB = 1024 * 1024;
+
+// Defaults for a typical workstation; setBudget() overrides them
+const qint64 DefaultCpuBudget = 4096 * MiB;
+const qint64 DefaultGpuBudget = 2048 * MiB;
+
+// A part must be out of sight this long before it is evicted, so a quick turn of the
+// camera does not reload everything behind it
+const qint64 EvictDelayMs = 2000;
+
+// Appends the arrays of a mesh (points, cells, point and cell attributes)
+void appendArrays(vtkPolyData* mesh, QSet<vtkAbstractArray*>& arrays)
+{
+    if (vtkPoints* points = mesh->GetPoints())
+        arrays.insert(points->GetData());
+
+    for (vtkCellArray* cells : { mesh->GetVerts(), mesh->GetLines(), mesh->GetPolys(), mesh->GetStrips() }) {
+        if (cells && cells->GetNumberOfCells() > 0) {
+            arrays.insert(cells->GetOffsetsArray());
+            arrays.insert(cells->GetConnectivityArray());
+        }
+    }
+
+    for (vtkDataSetAttributes* attributes : { static_cast<vtkDataSetAttributes*>(mesh->GetPointData()),
+                                              static_cast<vtkDataSetAttributes*>(mesh->GetCellData()) }) {
+        for (int i = 0; i < attributes->GetNumberOfArrays(); ++i)
+            arrays.insert(attributes->GetAbstractArray(i));
+    }
+    arrays.remove(nullptr);
+}
+
+} // namespace
+
+// --------------------------------------- Constructor ---------------------------------------
+
+/**
+ * @brief Constructs a manager with the default budgets.
+ * @param culling Desktop bounds hierarchy.
+ * @param parent  Optional QObject parent.
+ */
+// Starts with no tracked parts
+MemoryBudget::MemoryBudget(SceneBVH* culling, QObject* parent)
+    : QObject(parent)
+    , bvh(culling)
+    , partList(nullptr)
+    , evicted(0)
+    , extraBytes(0)
+{
+    budget.cpuBytes = DefaultCpuBudget;
+    budget.gpuBytes = DefaultGpuBudget;
+    clock.start();
+}
+
+// --------------------------------------- Public Interface ---------------------------------------
+
+/**
+ * @brief Sets the tree used to find resident twins.
+ * @param list Part tree, or nullptr.
+ */
+// Stores the part tree
+void MemoryBudget::setPartList(ModelPartList* list)
+{
+    partList = list;
+}
+
+/**
+ * @brief Sets the budgets.
+ * @param cpuBytes System memory budget.
+ * @param gpuBytes GPU memory budget.
+ */
+// Stores the thresholds; the next update() applies them
+void MemoryBudget::setBudget(qint64 cpuBytes, qint64 gpuBytes)
+{
+    budget.cpuBytes = cpuBytes;
+    budget.gpuBytes = gpuBytes;
+}
+
+/**
+ * @brief Returns the budgets.
+ */
+// Thresholds as a Usage
+MemoryBudget::Usage MemoryBudget::getBudget() const
+{
+    return budget;
+}
+
+/**
+ * @brief Tracks a part, counting it as seen now.
+ * @param part Part with geometry.
+ */
+// Adds an entry once
+void MemoryBudget::track(ModelPart* part)
+{
+    if (!part || parts.contains(part))
+        return;
+
+    Entry entry;
+    entry.lastSeenMs = clock.elapsed();
+    parts.insert(part, entry);
+}
+
+/**
+ * @brief Stops tracking a part; a reload still running for it is discarded.
+ * @param part Part about to be deleted.
+ */
+// Drops the entry and the part's place in a reload
+void MemoryBudget::forget(ModelPart* part)
+{
+    if (!parts.remove(part))
+        return;
+
+    for (auto it = reloads.begin(); it != reloads.end(); ++it)
+        it->removeAll(part);
+}
+
+/**
+ * @brief Returns the totals of the last update().
+ */
+// Session-wide usage
+MemoryBudget::Usage MemoryBudget::getTotal() const
+{
+    return total;
+}
+
+/**
+ * @brief Returns one part's usage from the last update().
+ * @param part Tracked part.
+ */
+// Per-part usage (zero if untracked)
+MemoryBudget::Usage MemoryBudget::getUsage(ModelPart* part) const
+{
+    return parts.value(part).usage;
+}
+
+/**
+ * @brief Formats the totals for the frame statistics overlay.
+ */
+// One overlay line
+QString MemoryBudget::summaryText() const
+{
+    return QString("Memory   CPU %1 / %2 MiB | GPU ~%3 / %4 MiB | %5 evicted")
+        .arg(total.cpuBytes / MiB)
+        .arg(budget.cpuBytes / MiB)
+        .arg(total.gpuBytes / MiB)
+        .arg(budget.gpuBytes / MiB)
+        .arg(evicted);
+}
+
+// --------------------------------------- Budget Check ---------------------------------------
+
+/**
+ * @brief Measures, evicts and reloads.
+ * @param evictCulled True if culled parts may be evicted.
+ *
+ * Eviction frees an array only when it drops the last tracked holder, so twins that
+ * share a mesh are freed together and the count is not overestimated.
+ */
+// Periodic check run from a GUI timer
+void MemoryBudget::update(bool evictCulled, qint64 extraCpuBytes)
+{
+    const qint64 now = clock.elapsed();
+    extraBytes = extraCpuBytes;
+
+    for (auto it = parts.begin(); it != parts.end(); ++it) {
+        ModelPart* part = it.key();
+        vtkActor* actor = part->getActor();
+        if (actor && part->visible() && !(evictCulled && bvh && bvh->isCulled(actor)))
+            it->lastSeenMs = now;
+    }
+
+    QHash<vtkAbstractArray*, ArrayRef> arrays;
+    QHash<ModelPart*, QVector<vtkAbstractArray*>> partArrays;
+    measure(arrays, partArrays);
+
+    // Copies kept for re-enabling a filter go first
+    if (overBudget()) {
+        for (auto it = parts.begin(); it != parts.end(); ++it)
+            it.key()->releaseBypassedOutputs();
+        measure(arrays, partArrays);
+    }
+
+    if (overBudget()) {
+        QVector<ModelPart*> candidates;
+        for (auto it = parts.begin(); it != parts.end(); ++it) {
+            if (!it.key()->isGeometryEvicted() && !it.key()->getSourceFile().isEmpty()
+                && now - it->lastSeenMs >= EvictDelayMs)
+                candidates << it.key();
+        }
+
+        // Longest out of sight first
+        std::sort(candidates.begin(), candidates.end(), [this](ModelPart* a, ModelPart* b) {
+            return parts.value(a).lastSeenMs < parts.value(b).lastSeenMs;
+        });
+
+        for (ModelPart* part : candidates) {
+            if (!overBudget())
+                break;
+
+            const Usage usage = parts.value(part).usage;
+            if (!part->evictGeometry())
+                continue;
+
+            for (vtkAbstractArray* array : partArrays.value(part)) {
+                ArrayRef& ref = arrays[array];
+                if (--ref.holders == 0)
+                    total.cpuBytes -= ref.bytes;
+            }
+            total.gpuBytes -= usage.gpuBytes;
+            ++evicted;
+            emit geometryEvicted(part);
+        }
+    }
+
+    // Parts back in view get their geometry again
+    for (auto it = parts.begin(); it != parts.end(); ++it) {
+        if (it.key()->isGeometryEvicted() && !it->reloading && it->lastSeenMs == now) {
+            it->reloading = true;
+            reload(it.key());
+        }
+    }
+}
+
+/**
+ * @brief Measures every tracked part.
+ * @param arrays     Receives each resident array with its size and holder count.
+ * @param partArrays Receives the arrays of each part.
+ */
+// Recomputes usage and totals
+void MemoryBudget::measure(QHash<vtkAbstractArray*, ArrayRef>& arrays, QHash<ModelPart*, QVector<vtkAbstractArray*>>& partArrays)
+{
+    arrays.clear();
+    partArrays.clear();
+    total = Usage();
+    total.cpuBytes = extraBytes;
+    evicted = 0;
+
+    QVector<vtkPolyData*> meshes;
+    QSet<vtkAbstractArray*> held;
+    for (auto it = parts.begin(); it != parts.end(); ++it) {
+        ModelPart* part = it.key();
+        if (part->isGeometryEvicted())
+            ++evicted;
+
+        meshes.clear();
+        held.clear();
+        part->collectResidentMeshes(meshes);
+        for (vtkPolyData* mesh : meshes)
+            appendArrays(mesh, held);
+
+        Usage usage;
+        QVector<vtkAbstractArray*>& list = partArrays[part];
+        list.reserve(held.size());
+        for (vtkAbstractArray* array : held) {
+            ArrayRef& ref = arrays[array];
+            if (ref.holders++ == 0) {
+                ref.bytes = qint64(array->GetActualMemorySize()) * 1024;
+                total.cpuBytes += ref.bytes;
+            }
+            usage.cpuBytes += ref.bytes;
+            list << array;
+        }
+
+        usage.gpuBytes = part->estimateGpuBytes();
+        total.gpuBytes += usage.gpuBytes;
+        it->usage = usage;
+    }
+}
+
+/**
+ * @brief Checks the totals against the budgets.
+ */
+// True if either budget is exceeded
+bool MemoryBudget::overBudget() const
+{
+    return total.cpuBytes > budget.cpuBytes || total.gpuBytes > budget.gpuBytes;
+}
+
+// --------------------------------------- Reloading ---------------------------------------
+
+/**
+ * @brief Gives an evicted part its geometry back.
+ * @param part Evicted part.
+ *
+ * A resident twin (same content fingerprint) shares its mesh, which keeps the parts
+ * instanced together; it is found through the part list's index in O(copies). Otherwise the file goes through PartLoader::loadFile(), which maps the
+ * mesh cache; parts waiting for the same file share one load.
+ */
+// Starts or joins a reload
+void MemoryBudget::reload(ModelPart* part)
+{
+    const QString fileName = part->getSourceFile();
+
+    const QList<ModelPart*> twins = partList ? partList->findAllByFingerprint(partList->fingerprintOf(part))
+                                             : QList<ModelPart*>();
+    for (ModelPart* twin : twins) {
+        if (twin != part && twin->getPolyData() && !twin->isGeometryEvicted()) {
+            part->restoreGeometry(twin->getPolyData(), twin->getLODData());
+            parts[part].reloading = false;
+            emit geometryRestored(part);
+            return;
+        }
+    }
+
+    QList<ModelPart*>& waiting = reloads[fileName];
+    waiting << part;
+    if (waiting.size() > 1)
+        return;
+
+    workers.watch(this, QtConcurrent::run(&PartLoader::loadFile, fileName),
+                  [this, fileName](QFutureWatcher<PartLoader::Result>* watcher) {
+        PartLoader::Result result = watcher->result();
+
+        // Parts stay evicted (and are not retried) if the file is gone
+        const QList<ModelPart*> waiting = reloads.take(fileName);
+        if (!result.polyData) {
+            qWarning() << "Could not reload evicted geometry from" << fileName;
+            return;
+        }
+
+        for (ModelPart* part : waiting) {
+            auto it = parts.find(part);
+            if (it == parts.end() || !part->isGeometryEvicted())
+                continue;
+            it->reloading = false;
+            part->restoreGeometry(result.polyData, result.levels);
+            emit geometryRestored(part);
+        }
+    });
+}
@@ -0,0 +1,178 @@
+/**
+ * @file MemoryBudget.h
+ * @brief Session-wide memory accounting with geometry eviction and reload.
+ *
+ * Parts share mesh arrays (twins, snapshots, pipeline outputs), so usage is counted
+ * per VTK array rather than per mesh. Over budget, the geometry of hidden or
+ * off-screen parts is dropped and reloaded from the mesh cache, which is a memory
+ * mapping, once the part comes back into view.
+ */
+
+#ifndef MEMORY_BUDGET_H
+#define MEMORY_BUDGET_H
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QObject>          // Base class for signals/slots
+#include <QHash>            // Tracked parts and pending reloads
+#include <QList>            // Parts waiting for a reload
+#include <QString>          // Source files and summary text
+#include <QElapsedTimer>    // Time since a part was last seen
+
+#include "ModelPart.h"      // Tracked parts
+#include "ModelPartList.h"  // Fingerprint index for resident twins
+#include "SceneBVH.h"       // Culling state of the on-screen actors
+#include "TrackedWatchers.h"    // Tracks the worker reloads
+
+// --------------------------------------- MemoryBudget Class ---------------------------------------
+/**
+ * @class MemoryBudget
+ * @brief Keeps the geometry of the loaded parts within a CPU and a GPU budget.
+ *
+ * update() is called periodically on the GUI thread. It measures every tracked part,
+ * releases cached outputs of disabled filters when over budget, and then evicts the
+ * parts that have been out of sight longest until usage fits. Evicted parts that are
+ * visible again are reloaded on the thread pool. Parts without a source file are
+ * measured but never evicted.
+ */
+class MemoryBudget : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Bytes held in system memory and (estimated) in GPU buffers.
+     */
+    struct Usage {
+        qint64 cpuBytes = 0;    // Unique VTK array bytes
+        qint64 gpuBytes = 0;    // Vertex and index buffer estimate
+    };
+
+    /**
+     * @brief Constructor.
+     * @param bvh    Desktop bounds hierarchy, queried for culled parts.
+     * @param parent Optional QObject parent.
+     */
+    // Constructor: default budgets
+    explicit MemoryBudget(SceneBVH* bvh, QObject* parent = nullptr);
+
+    /**
+     * @brief Sets the tree whose fingerprint index finds resident twins on reload.
+     * @param list Part tree (not owned), or nullptr to always reload from the file.
+     */
+    // Stores the part tree
+    void setPartList(ModelPartList* list);
+
+    /**
+     * @brief Sets the budgets eviction keeps usage under.
+     * @param cpuBytes System memory for mesh arrays.
+     * @param gpuBytes GPU memory for vertex and index buffers.
+     */
+    // Changes both budgets
+    void setBudget(qint64 cpuBytes, qint64 gpuBytes);
+
+    /**
+     * @brief Returns the budgets as a Usage.
+     */
+    // Current budgets
+    Usage getBudget() const;
+
+    /**
+     * @brief Starts accounting for a part; repeated calls are ignored.
+     * @param part Part with geometry.
+     */
+    // Adds a part
+    void track(ModelPart* part);
+
+    /**
+     * @brief Stops accounting for a part before it is deleted.
+     * @param part Part about to be deleted.
+     */
+    // Removes a part and its pending reload
+    void forget(ModelPart* part);
+
+    /**
+     * @brief Measures the parts, evicts over budget and reloads parts back in view.
+     * @param evictCulled True if parts outside the desktop frustum count as out of
+     *                    sight; pass false while another view (VR) may show them.
+     * @param extraCpuBytes Memory held for the parts outside their own meshes, such as
+     *                      the world-space copies of merged VR batches. It counts
+     *                      towards the CPU budget and is freed with the evicted parts.
+     */
+    // Periodic budget check
+    void update(bool evictCulled, qint64 extraCpuBytes = 0);
+
+    /**
+     * @brief Returns the total usage measured by the last update().
+     */
+    // Session totals
+    Usage getTotal() const;
+
+    /**
+     * @brief Returns a part's usage measured by the last update().
+     * @param part Tracked part.
+     *
+     * Arrays shared with other parts are counted for each of them here, but only
+     * once in getTotal().
+     */
+    // Per-part usage
+    Usage getUsage(ModelPart* part) const;
+
+    /**
+     * @brief Returns a one-line summary for the frame statistics overlay.
+     */
+    // "Memory ..." overlay line
+    QString summaryText() const;
+
+signals:
+    /**
+     * @brief Emitted after a part's geometry was evicted.
+     * @param part The part, now showing an empty placeholder.
+     */
+    void geometryEvicted(ModelPart* part);
+
+    /**
+     * @brief Emitted after an evicted part got its geometry back.
+     * @param part The reloaded part.
+     */
+    void geometryRestored(ModelPart* part);
+
+private:
+    /**
+     * @brief Accounting state of one part.
+     */
+    struct Entry {
+        qint64 lastSeenMs = 0;      // Last update() the part was visible and in view
+        Usage usage;                // Measured by the last update()
+        bool reloading = false;     // Reload requested (or failed)
+    };
+
+    /**
+     * @brief One VTK array and the number of tracked parts holding it.
+     */
+    struct ArrayRef {
+        qint64 bytes = 0;
+        int holders = 0;
+    };
+
+    // Rebuilds usage, totals and array ownership from the tracked parts
+    void measure(QHash<vtkAbstractArray*, ArrayRef>& arrays, QHash<ModelPart*, QVector<vtkAbstractArray*>>& partArrays);
+
+    // Returns true while either budget is exceeded
+    bool overBudget() const;
+
+    // Shares a resident twin's mesh, or loads the source file on the thread pool
+    void reload(ModelPart* part);
+
+    QHash<ModelPart*, Entry> parts;                 // Tracked parts
+    QHash<QString, QList<ModelPart*>> reloads;      // Source file -> parts waiting for it
+    TrackedWatchers workers;                        // Reloads still running (waited for on destruction)
+    SceneBVH* bvh;                                  // Desktop culling state (not owned)
+    ModelPartList* partList;                        // Fingerprint index of the tree (not owned)
+    Usage budget;                                   // Eviction thresholds
+    Usage total;                                    // Last measured totals
+    int evicted;                                    // Parts currently evicted
+    qint64 extraBytes;                              // Held outside the parts' meshes (last update())
+    QElapsedTimer clock;                            // Time base for lastSeenMs
+};
+
+#endif // MEMORY_BUDGET_H
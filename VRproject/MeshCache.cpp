@@ -0,0 +1,523 @@
+/**
+ * @file MeshCache.cpp
+ * @brief Implementation of the memory-mappable mesh cache.
+ *
+ * File layout (all sections start on a 4 KiB boundary):
+ *  - page 0:     Header (source key, bounds, one MeshSection per detail level)
+ *  then for each level, full mesh first:
+ *  - points:     float[numPoints * 3]
+ *  - normals:    float[numPoints * 3]
+ *  - indices:    int32[numTriangles * 3]
+ *  - offsets:    int32[numTriangles + 1] (cell offsets, as vtkCellArray stores them)
+ *  then, if the full mesh has feature edges:
+ *  - edges:      int32[edgeCount * 2] (point index pairs of the full mesh)
+ */
+
+#include "MeshCache.h"
+#include "MeshFeatures.h"
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QDebug>
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkPoints.h>
+#include <vtkPointData.h>
+#include <vtkFieldData.h>
+#include <vtkFloatArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkCellArray.h>
+#include <vtkTypeInt32Array.h>
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+// --------------------------------------- Helpers ---------------------------------------
+
+namespace {
+
+const char     Magic[8] = { 'V', 'R', 'M', 'E', 'S', 'H', '\0', '\0' };
+const uint32_t Version = 3;
+const qint64   PageSize = 4096;
+const int      MaxLevels = 4;   // Full mesh + up to three decimated levels
+
+// Location of one mesh (full or decimated) inside the file; offsets are bytes from the start
+struct MeshSection {
+    int64_t numPoints;
+    int64_t numTriangles;
+    int64_t pointsOffset;
+    int64_t normalsOffset;
+    int64_t indicesOffset;
+    int64_t cellOffsetsOffset;
+};
+
+// Fixed-size header stored in the first page
+struct Header {
+    char        magic[8];
+    uint32_t    version;
+    uint32_t    levelCount;         // Number of valid entries in sections
+    uint64_t    pathHash;           // FNV-1a of the absolute source path
+    int64_t     sourceSize;         // Source file size in bytes
+    int64_t     sourceModified;     // Source modification time (ms since epoch)
+    int64_t     fileSize;
+    double      bounds[6];          // xmin, xmax, ymin, ymax, zmin, zmax (full mesh)
+    MeshSection sections[MaxLevels];
+    int64_t     edgeCount;          // Feature edges of the full mesh (0: none stored)
+    int64_t     edgesOffset;
+};
+static_assert(sizeof(Header) <= PageSize, "MeshCache header must fit in the first page");
+
+// A mesh flattened into the on-disk array layout
+struct PackedMesh {
+    std::vector<float>   points;
+    std::vector<float>   normals;
+    std::vector<int32_t> indices;
+    std::vector<int32_t> cellOffsets;
+    std::vector<int32_t> edges;         // Feature edge pairs (full mesh only)
+};
+
+// Rounds a byte count up to the next page boundary
+inline qint64 alignToPage(qint64 bytes)
+{
+    return (bytes + PageSize - 1) / PageSize * PageSize;
+}
+
+// Stable path hash (qHash is seeded per process, so it cannot be stored)
+uint64_t pathHash(const QString& path)
+{
+    uint64_t h = 1469598103934665603ull;
+    const QByteArray bytes = path.toUtf8();
+    for (char c : bytes) {
+        h ^= uint8_t(c);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// Keeps a cache file open and mapped while VTK arrays point into it
+struct MappedFile {
+    explicit MappedFile(const QString& name) : file(name) {}
+    ~MappedFile() { if (data) file.unmap(data); }
+
+    QFile  file;
+    uchar* data = nullptr;
+};
+
+// VTK's free callback only receives the array pointer, so mappings are looked up by address
+QMutex& registryMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+QHash<void*, std::shared_ptr<MappedFile>>& registry()
+{
+    static QHash<void*, std::shared_ptr<MappedFile>> mappings;
+    return mappings;
+}
+
+// Called by VTK when a wrapped array is released; unmaps the file after the last one
+void releaseMappedArray(void* ptr)
+{
+    std::shared_ptr<MappedFile> holder;
+    {
+        QMutexLocker lock(&registryMutex());
+        holder = registry().take(ptr);
+    }
+    // holder is released here, outside the lock
+}
+
+// Wraps a section of the mapping as a VTK array without copying
+template <typename ArrayT>
+vtkSmartPointer<ArrayT> wrapMapped(const std::shared_ptr<MappedFile>& holder, qint64 offset,
+                                   vtkIdType values, int components)
+{
+    auto array = vtkSmartPointer<ArrayT>::New();
+    array->SetNumberOfComponents(components);
+    if (values == 0)
+        return array;
+
+    auto* ptr = reinterpret_cast<typename ArrayT::ValueType*>(holder->data + offset);
+    {
+        QMutexLocker lock(&registryMutex());
+        registry().insert(ptr, holder);
+    }
+    array->SetArrayFreeFunction(&releaseMappedArray);
+    array->SetArray(ptr, values, 0, vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+    return array;
+}
+
+// Returns true if a section of the given size lies inside the file on a page boundary
+bool sectionFits(int64_t offset, int64_t bytes, int64_t fileSize)
+{
+    return offset >= PageSize && offset % PageSize == 0 && bytes >= 0 && offset + bytes <= fileSize;
+}
+
+// Checks that a mesh section's counts are sane and its arrays lie inside the file (sizes only)
+bool meshSectionIsValid(const MeshSection& section, int64_t fileSize)
+{
+    if (section.numPoints <= 0 || section.numTriangles <= 0)
+        return false;
+    if (section.numPoints > std::numeric_limits<int32_t>::max()
+        || section.numTriangles * 3 > std::numeric_limits<int32_t>::max())
+        return false;
+
+    const int64_t vectorBytes = section.numPoints * 3 * int64_t(sizeof(float));
+    return sectionFits(section.pointsOffset, vectorBytes, fileSize)
+        && sectionFits(section.normalsOffset, vectorBytes, fileSize)
+        && sectionFits(section.indicesOffset, section.numTriangles * 3 * int64_t(sizeof(int32_t)), fileSize)
+        && sectionFits(section.cellOffsetsOffset, (section.numTriangles + 1) * int64_t(sizeof(int32_t)), fileSize);
+}
+
+// Checks the header against the source file key and the actual cache size
+bool headerIsValid(const Header& header, uint64_t key, qint64 sourceSize, qint64 sourceModified, qint64 fileSize)
+{
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version)
+        return false;
+    if (header.pathHash != key || header.sourceSize != sourceSize || header.sourceModified != sourceModified)
+        return false;
+    if (header.fileSize != fileSize || header.levelCount < 1 || header.levelCount > uint32_t(MaxLevels))
+        return false;
+
+    for (uint32_t level = 0; level < header.levelCount; ++level)
+        if (!meshSectionIsValid(header.sections[level], fileSize))
+            return false;
+
+    if (header.edgeCount < 0 || header.edgeCount > header.sections[0].numTriangles * 3)
+        return false;
+    return header.edgeCount == 0
+        || sectionFits(header.edgesOffset, header.edgeCount * 2 * int64_t(sizeof(int32_t)), fileSize);
+}
+
+// Returns true if every value is a valid point index
+bool indicesInRange(const int32_t* values, int64_t count, int64_t numPoints)
+{
+    for (int64_t i = 0; i < count; ++i)
+        if (values[i] < 0 || values[i] >= numPoints)
+            return false;
+    return true;
+}
+
+// Checks the mapped index, offset and edge arrays: one linear pass before VTK trusts them
+bool contentsAreValid(const uchar* data, const Header& header)
+{
+    for (uint32_t level = 0; level < header.levelCount; ++level) {
+        const MeshSection& section = header.sections[level];
+        const auto* indices = reinterpret_cast<const int32_t*>(data + section.indicesOffset);
+        if (!indicesInRange(indices, section.numTriangles * 3, section.numPoints))
+            return false;
+
+        // Triangles only, so the cell offsets are exactly 0, 3, 6, ...
+        const auto* offsets = reinterpret_cast<const int32_t*>(data + section.cellOffsetsOffset);
+        for (int64_t c = 0; c <= section.numTriangles; ++c)
+            if (offsets[c] != c * 3)
+                return false;
+    }
+
+    const auto* edges = reinterpret_cast<const int32_t*>(data + header.edgesOffset);
+    return header.edgeCount == 0 || indicesInRange(edges, header.edgeCount * 2, header.sections[0].numPoints);
+}
+
+// Builds polydata whose arrays point into one mapped section
+vtkSmartPointer<vtkPolyData> wrapSection(const std::shared_ptr<MappedFile>& holder, const MeshSection& section)
+{
+    const vtkIdType numPoints = vtkIdType(section.numPoints);
+    const vtkIdType numTriangles = vtkIdType(section.numTriangles);
+
+    auto pointData = wrapMapped<vtkFloatArray>(holder, section.pointsOffset, numPoints * 3, 3);
+    auto normals = wrapMapped<vtkFloatArray>(holder, section.normalsOffset, numPoints * 3, 3);
+    auto indices = wrapMapped<vtkTypeInt32Array>(holder, section.indicesOffset, numTriangles * 3, 1);
+    auto cellOffsets = wrapMapped<vtkTypeInt32Array>(holder, section.cellOffsetsOffset, numTriangles + 1, 1);
+    normals->SetName("Normals");
+
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->SetData(pointData);
+
+    auto polys = vtkSmartPointer<vtkCellArray>::New();
+    polys->SetData(cellOffsets, indices);
+
+    auto polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->SetPoints(points);
+    polyData->SetPolys(polys);
+    polyData->GetPointData()->SetNormals(normals);
+    return polyData;
+}
+
+// Writes a section and pads it to the next page boundary
+bool writeSection(QSaveFile& out, const void* data, qint64 bytes)
+{
+    if (bytes > 0 && out.write(static_cast<const char*>(data), bytes) != bytes)
+        return false;
+
+    const qint64 padding = alignToPage(bytes) - bytes;
+    if (padding > 0) {
+        const QByteArray zeros(int(padding), '\0');
+        if (out.write(zeros) != padding)
+            return false;
+    }
+    return true;
+}
+
+// Copies a 3-component array into floats; only reads, so it is safe alongside rendering
+void copyVectors(vtkDataArray* source, std::vector<float>& out)
+{
+    const vtkIdType count = source->GetNumberOfTuples();
+    out.resize(size_t(count) * 3);
+
+    vtkFloatArray* floats = vtkFloatArray::FastDownCast(source);
+    if (floats && floats->GetNumberOfComponents() == 3) {
+        std::memcpy(out.data(), floats->GetPointer(0), out.size() * sizeof(float));
+        return;
+    }
+
+    for (vtkIdType i = 0; i < count; ++i)
+        for (int c = 0; c < 3; ++c)
+            out[size_t(i) * 3 + c] = float(source->GetComponent(i, c));
+}
+
+// Flattens a triangle mesh with point normals; returns false if it cannot be stored
+bool packMesh(vtkPolyData* polyData, PackedMesh& packed)
+{
+    if (!polyData || !polyData->GetPoints())
+        return false;
+
+    vtkDataArray* normals = polyData->GetPointData()->GetNormals();
+    vtkCellArray* polys = polyData->GetPolys();
+    const vtkIdType numPoints = polyData->GetNumberOfPoints();
+    if (!normals || !polys || numPoints == 0 || numPoints > std::numeric_limits<int32_t>::max()
+        || normals->GetNumberOfTuples() != numPoints)
+        return false;
+
+    // Flatten the polygons into a triangle index buffer (loader output is all triangles)
+    vtkDataArray* offsetArray = polys->GetOffsetsArray();
+    vtkDataArray* connArray = polys->GetConnectivityArray();
+    const vtkIdType numTriangles = polys->GetNumberOfCells();
+    if (numTriangles == 0 || numTriangles * 3 > std::numeric_limits<int32_t>::max())
+        return false;
+
+    packed.indices.resize(size_t(numTriangles) * 3);
+    packed.cellOffsets.resize(size_t(numTriangles) + 1);
+    for (vtkIdType c = 0; c < numTriangles; ++c) {
+        const vtkIdType begin = vtkIdType(offsetArray->GetComponent(c, 0));
+        if (vtkIdType(offsetArray->GetComponent(c + 1, 0)) - begin != 3)
+            return false;
+        for (int k = 0; k < 3; ++k)
+            packed.indices[size_t(c) * 3 + k] = int32_t(connArray->GetComponent(begin + k, 0));
+        packed.cellOffsets[size_t(c)] = int32_t(c * 3);
+    }
+    packed.cellOffsets[size_t(numTriangles)] = int32_t(numTriangles * 3);
+
+    copyVectors(polyData->GetPoints()->GetData(), packed.points);
+    copyVectors(normals, packed.normals);
+    return true;
+}
+
+// Copies the feature edges stored on a mesh, if any
+void packEdges(vtkPolyData* polyData, PackedMesh& packed)
+{
+    auto* pairs = vtkTypeInt32Array::SafeDownCast(
+        polyData->GetFieldData()->GetAbstractArray(MeshFeatures::EdgeArrayName));
+    if (!pairs || pairs->GetNumberOfComponents() != 1 || pairs->GetNumberOfValues() % 2 != 0)
+        return;
+
+    const vtkTypeInt32* values = pairs->GetPointer(0);
+    packed.edges.assign(values, values + pairs->GetNumberOfValues());
+}
+
+} // namespace
+
+// --------------------------------------- Cache Location ---------------------------------------
+
+/**
+ * @brief Lists the places a cache for the given STL may live.
+ * @param stlFileName Path to the source STL file.
+ * @return Next-to-source path first, then the per-user cache directory.
+ */
+// Returns candidate cache paths for an STL file
+QStringList MeshCache::cachePaths(const QString& stlFileName)
+{
+    const QString source = QFileInfo(stlFileName).absoluteFilePath();
+
+    QStringList paths;
+    paths << source + ".vrcache";
+
+    const QString userCache = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!userCache.isEmpty())
+        paths << QDir(userCache).filePath(QString("meshcache/%1.vrcache").arg(pathHash(source), 16, 16, QChar('0')));
+
+    return paths;
+}
+
+// --------------------------------------- Loading ---------------------------------------
+
+/**
+ * @brief Maps a valid cache entry and wraps its sections as VTK arrays.
+ * @param stlFileName Path to the source STL file.
+ * @return Meshes backed by the mapped file; entry.mesh is nullptr if no up-to-date cache exists.
+ */
+// Looks for a fresh cache file and maps it
+MeshCache::Entry MeshCache::load(const QString& stlFileName)
+{
+    const QFileInfo info(stlFileName);
+    if (!info.exists())
+        return Entry();
+
+    const uint64_t key = pathHash(info.absoluteFilePath());
+    const qint64 sourceSize = info.size();
+    const qint64 sourceModified = info.lastModified().toMSecsSinceEpoch();
+
+    for (const QString& path : cachePaths(stlFileName)) {
+        auto holder = std::make_shared<MappedFile>(path);
+        if (!holder->file.open(QIODevice::ReadOnly))
+            continue;
+
+        Header header;
+        if (holder->file.read(reinterpret_cast<char*>(&header), sizeof(header)) != qint64(sizeof(header)))
+            continue;
+        if (!headerIsValid(header, key, sourceSize, sourceModified, holder->file.size()))
+            continue;
+
+        // Private mapping: pages are shared with the page cache until something writes to them
+        holder->data = holder->file.map(0, header.fileSize, QFileDevice::MapPrivateOption);
+        if (!holder->data || !contentsAreValid(holder->data, header))
+            continue;
+
+        Entry entry;
+        entry.mesh = wrapSection(holder, header.sections[0]);
+        for (uint32_t level = 1; level < header.levelCount; ++level)
+            entry.levels << wrapSection(holder, header.sections[level]);
+
+        // Bounds are kept as field data so consumers can skip a full pass over the points
+        auto bounds = vtkSmartPointer<vtkDoubleArray>::New();
+        bounds->SetName("CachedBounds");
+        bounds->SetNumberOfValues(6);
+        for (int i = 0; i < 6; ++i)
+            bounds->SetValue(i, header.bounds[i]);
+        entry.mesh->GetFieldData()->AddArray(bounds);
+
+        // Feature edges go back where MeshFeatures put them
+        if (header.edgeCount > 0) {
+            auto edges = wrapMapped<vtkTypeInt32Array>(holder, header.edgesOffset, vtkIdType(header.edgeCount * 2), 1);
+            edges->SetName(MeshFeatures::EdgeArrayName);
+            entry.mesh->GetFieldData()->AddArray(edges);
+        }
+
+        return entry;
+    }
+
+    return Entry();
+}
+
+// --------------------------------------- Writing ---------------------------------------
+
+/**
+ * @brief Writes the processed meshes to the first writable cache location.
+ * @param stlFileName Path to the source STL file.
+ * @param entry       Full mesh and decimated levels, all triangle meshes with point normals.
+ * @return True on success; false if the mesh is unsuitable or no location is writable.
+ *
+ * QSaveFile writes to a temporary file and renames it over the old entry, so a
+ * reader never sees a half-written cache. On Windows the rename fails while the
+ * old entry is still mapped by an open part; the next load simply retries.
+ */
+// Serialises points, normals, indices and bounds of every level into page-aligned sections
+bool MeshCache::write(const QString& stlFileName, const Entry& entry)
+{
+    std::vector<PackedMesh> meshes(1);
+    if (!packMesh(entry.mesh, meshes[0]))
+        return false;
+    packEdges(entry.mesh, meshes[0]);
+
+    for (const vtkSmartPointer<vtkPolyData>& level : entry.levels) {
+        if (int(meshes.size()) == MaxLevels)
+            break;
+        PackedMesh packed;
+        if (packMesh(level, packed))
+            meshes.push_back(std::move(packed));
+    }
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+
+    // Bounds from the copied points, so the shared polydata's cached state is never touched
+    const std::vector<float>& full = meshes[0].points;
+    header.bounds[0] = header.bounds[2] = header.bounds[4] = std::numeric_limits<double>::max();
+    header.bounds[1] = header.bounds[3] = header.bounds[5] = -std::numeric_limits<double>::max();
+    for (size_t i = 0; i < full.size(); i += 3) {
+        for (int c = 0; c < 3; ++c) {
+            header.bounds[2 * c] = std::min(header.bounds[2 * c], double(full[i + c]));
+            header.bounds[2 * c + 1] = std::max(header.bounds[2 * c + 1], double(full[i + c]));
+        }
+    }
+
+    const QFileInfo info(stlFileName);
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.levelCount = uint32_t(meshes.size());
+    header.pathHash = pathHash(info.absoluteFilePath());
+    header.sourceSize = info.size();
+    header.sourceModified = info.lastModified().toMSecsSinceEpoch();
+
+    int64_t offset = PageSize;
+    for (size_t level = 0; level < meshes.size(); ++level) {
+        const PackedMesh& mesh = meshes[level];
+        MeshSection& section = header.sections[level];
+        section.numPoints = int64_t(mesh.points.size() / 3);
+        section.numTriangles = int64_t(mesh.indices.size() / 3);
+        section.pointsOffset = offset;
+        offset += alignToPage(qint64(mesh.points.size() * sizeof(float)));
+        section.normalsOffset = offset;
+        offset += alignToPage(qint64(mesh.normals.size() * sizeof(float)));
+        section.indicesOffset = offset;
+        offset += alignToPage(qint64(mesh.indices.size() * sizeof(int32_t)));
+        section.cellOffsetsOffset = offset;
+        offset += alignToPage(qint64(mesh.cellOffsets.size() * sizeof(int32_t)));
+    }
+    header.edgeCount = int64_t(meshes[0].edges.size() / 2);
+    header.edgesOffset = header.edgeCount > 0 ? offset : 0;
+    offset += alignToPage(qint64(meshes[0].edges.size() * sizeof(int32_t)));
+    header.fileSize = offset;
+
+    for (const QString& path : cachePaths(stlFileName)) {
+        QDir().mkpath(QFileInfo(path).absolutePath());
+
+        QSaveFile out(path);
+        if (!out.open(QIODevice::WriteOnly))
+            continue;
+
+        bool ok = writeSection(out, &header, sizeof(header));
+        for (size_t level = 0; ok && level < meshes.size(); ++level) {
+            const PackedMesh& mesh = meshes[level];
+            ok = writeSection(out, mesh.points.data(), qint64(mesh.points.size() * sizeof(float)))
+                && writeSection(out, mesh.normals.data(), qint64(mesh.normals.size() * sizeof(float)))
+                && writeSection(out, mesh.indices.data(), qint64(mesh.indices.size() * sizeof(int32_t)))
+                && writeSection(out, mesh.cellOffsets.data(), qint64(mesh.cellOffsets.size() * sizeof(int32_t)));
+        }
+        if (ok && !meshes[0].edges.empty())
+            ok = writeSection(out, meshes[0].edges.data(), qint64(meshes[0].edges.size() * sizeof(int32_t)));
+
+        if (ok && out.commit())
+            return true;
+
+        out.cancelWriting();
+    }
+
+    qWarning() << "Could not write mesh cache for" << stlFileName;
+    return false;
+}
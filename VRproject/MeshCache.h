@@ -0,0 +1,75 @@
+/**
+ * @file MeshCache.h
+ * @brief On-disk cache of processed part meshes for near-instant reopening.
+ *
+ * Each STL gets a companion `.vrcache` file holding the welded vertices, normals,
+ * a 32-bit triangle index buffer, the feature edges and the bounds, plus up to
+ * three decimated levels of detail in the same layout. Sections are page-aligned so the
+ * file can be memory-mapped and its arrays handed to VTK without any parsing.
+ */
+
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QString>      // File paths
+#include <QStringList>  // Candidate cache locations
+#include <QVector>      // Level-of-detail meshes
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkSmartPointer.h>  // Smart pointer management for VTK
+#include <vtkPolyData.h>      // Cached mesh data
+
+// --------------------------------------- MeshCache Class ---------------------------------------
+/**
+ * @class MeshCache
+ * @brief Reads and writes the memory-mappable mesh cache.
+ *
+ * A cache entry is valid only if the source file's absolute path, size and
+ * modification time all match the values stored in its header. The cache is
+ * written next to the STL when that directory is writable, otherwise into the
+ * per-user cache directory. All functions are static and thread-safe.
+ */
+class MeshCache {
+public:
+    /**
+     * @brief Contents of one cache file.
+     */
+    struct Entry {
+        vtkSmartPointer<vtkPolyData> mesh;                  // Full-resolution mesh, nullptr on a miss
+        QVector<vtkSmartPointer<vtkPolyData>> levels;       // Decimated levels, finest first (may be empty)
+    };
+
+    /**
+     * @brief Loads the cache for an STL file if it exists and is up to date.
+     * @param stlFileName Path to the source STL file.
+     * @return Meshes whose arrays point straight into the mapped cache file; entry.mesh
+     *         is nullptr if there is no valid cache. The mapping stays alive until VTK
+     *         releases the last array that uses it.
+     *
+     * Index, cell offset and feature edge values are checked once on load, so a
+     * corrupted cache is skipped instead of indexing past the point arrays.
+     */
+    // Maps a fresh cache entry and wraps it as polydata (zero-copy)
+    static Entry load(const QString& stlFileName);
+
+    /**
+     * @brief Writes (or replaces) the cache for an STL file.
+     * @param stlFileName Path to the source STL file.
+     * @param entry       Triangle meshes with point normals, as produced by the loader.
+     * @return True if the cache was written.
+     *
+     * Only reads from the meshes, so it may run on a worker thread while the GUI
+     * thread renders them.
+     */
+    // Serialises processed meshes into the page-aligned cache format
+    static bool write(const QString& stlFileName, const Entry& entry);
+
+private:
+    // Returns the cache file locations checked for an STL, in order of preference
+    static QStringList cachePaths(const QString& stlFileName);
+};
+
+#endif // MESH_CACHE_H
@@ -0,0 +1,425 @@
+/**
+ * @file MeshFeatures.cpp
+ * @brief Implementation of the parallel normals and feature edge pass.
+ *
+ * The pass works in four stages, the expensive ones split into chunks on the
+ * global Qt thread pool:
+ *  1. face normals, area-weighted and unit (parallel over faces);
+ *  2. vertex -> corner adjacency as offset lists (one linear serial pass);
+ *  3. per vertex: cluster the incident faces by the split angle, and classify
+ *     the edges to higher-numbered neighbours (parallel over vertices);
+ *  4. per vertex: write one output point and normal per cluster and rewrite the
+ *     triangle indices (parallel over vertices).
+ * Every vertex owns its corners, its output points and its edges, so no stage
+ * needs locks.
+ */
+
+#include "MeshFeatures.h"
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QVector>
+#include <QtConcurrent>
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkPoints.h>
+#include <vtkPointData.h>
+#include <vtkFieldData.h>
+#include <vtkFloatArray.h>
+#include <vtkMath.h>
+#include <vtkTypeInt32Array.h>
+#include <vtkTypeInt64Array.h>
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+// --------------------------------------- Helpers ---------------------------------------
+
+namespace {
+
+const qint64 ChunkFaces = qint64(1) << 18;      // Faces per task in the face normal pass
+const qint64 ChunkVertices = qint64(1) << 16;   // Vertices per task in the vertex passes
+
+// Runs fn(i) for i in [0, count) on the global thread pool and waits for all of them
+template <typename Fn>
+void parallelFor(int count, Fn fn)
+{
+    QVector<int> indices(count);
+    std::iota(indices.begin(), indices.end(), 0);
+    QtConcurrent::blockingMap(indices, [&fn](int& i) { fn(i); });
+}
+
+// Number of chunks needed to cover count items
+inline int chunkCount(qint64 count, qint64 chunk)
+{
+    return int((count + chunk - 1) / chunk);
+}
+
+inline float dot3(const float* a, const float* b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// Triangle connectivity as int32, either borrowed from the cell array or converted
+struct TriangleIndices {
+    const vtkTypeInt32* ids = nullptr;
+    std::vector<vtkTypeInt32> owned;
+};
+
+// Points as packed floats, either borrowed from the points array or converted
+struct PointCoords {
+    const float* xyz = nullptr;
+    std::vector<float> owned;
+};
+
+// Returns false unless every cell is a triangle and the index range fits in int32
+bool readTriangles(vtkPolyData* mesh, TriangleIndices& out)
+{
+    vtkCellArray* polys = mesh->GetPolys();
+    const vtkIdType triangles = polys ? polys->GetNumberOfCells() : 0;
+    if (triangles == 0 || triangles * 3 > std::numeric_limits<vtkTypeInt32>::max()
+        || polys->GetNumberOfConnectivityIds() != triangles * 3
+        || mesh->GetNumberOfVerts() + mesh->GetNumberOfLines() + mesh->GetNumberOfStrips() != 0)
+        return false;
+
+    // Equal totals do not rule out a quad next to a line-like polygon, so check the offsets
+    vtkDataArray* offsets = polys->GetOffsetsArray();
+    if (auto* offsets32 = vtkTypeInt32Array::FastDownCast(offsets)) {
+        const vtkTypeInt32* o = offsets32->GetPointer(0);
+        for (vtkIdType c = 0; c < triangles; ++c)
+            if (o[c + 1] - o[c] != 3)
+                return false;
+    }
+    else if (auto* offsets64 = vtkTypeInt64Array::FastDownCast(offsets)) {
+        const vtkTypeInt64* o = offsets64->GetPointer(0);
+        for (vtkIdType c = 0; c < triangles; ++c)
+            if (o[c + 1] - o[c] != 3)
+                return false;
+    }
+    else {
+        return false;
+    }
+
+    vtkDataArray* connectivity = polys->GetConnectivityArray();
+    if (auto* conn32 = vtkTypeInt32Array::FastDownCast(connectivity)) {
+        out.ids = conn32->GetPointer(0);
+        return true;
+    }
+
+    auto* conn64 = vtkTypeInt64Array::FastDownCast(connectivity);
+    if (!conn64)
+        return false;
+    const vtkTypeInt64* source = conn64->GetPointer(0);
+    out.owned.assign(source, source + triangles * 3);
+    out.ids = out.owned.data();
+    return true;
+}
+
+// Returns the points as packed xyz floats
+void readPoints(vtkPoints* points, PointCoords& out)
+{
+    vtkDataArray* data = points->GetData();
+    vtkFloatArray* floats = vtkFloatArray::FastDownCast(data);
+    if (floats && floats->GetNumberOfComponents() == 3) {
+        out.xyz = floats->GetPointer(0);
+        return;
+    }
+
+    const vtkIdType count = data->GetNumberOfTuples();
+    out.owned.resize(size_t(count) * 3);
+    for (vtkIdType i = 0; i < count; ++i)
+        for (int c = 0; c < 3; ++c)
+            out.owned[size_t(i) * 3 + c] = float(data->GetComponent(i, c));
+    out.xyz = out.owned.data();
+}
+
+} // namespace
+
+// --------------------------------------- Normals ---------------------------------------
+
+/**
+ * @brief Computes point normals, splitting vertices along creases, and the feature edges.
+ * @param mesh        Welded triangle mesh (point normals, if any, are ignored).
+ * @param splitAngle  Crease angle in degrees.
+ * @param withEdges   False to skip the edge extraction.
+ * @return New mesh, or nullptr for unsupported input.
+ *
+ * The faces around a vertex are clustered greedily: a face joins the first
+ * cluster whose seed face lies within the split angle, and each cluster becomes
+ * one output vertex with the area-weighted normal of its faces. An edge is a
+ * feature edge if it has one face (boundary), more than two (non-manifold) or two
+ * faces meeting at more than the split angle. Zero-area faces take the vertex's
+ * first cluster and are left out of the edge test, so slivers from the exporter
+ * neither split vertices nor draw spurious lines.
+ */
+// Four-stage pass; only reads the input, so it may run alongside rendering
+vtkSmartPointer<vtkPolyData> MeshFeatures::computeNormals(vtkPolyData* mesh, double splitAngle, bool withEdges)
+{
+    if (!mesh || !mesh->GetPoints())
+        return nullptr;
+
+    const vtkIdType numPoints = mesh->GetNumberOfPoints();
+    TriangleIndices triangles;
+    if (numPoints == 0 || numPoints > std::numeric_limits<vtkTypeInt32>::max() || !readTriangles(mesh, triangles))
+        return nullptr;
+
+    PointCoords coords;
+    readPoints(mesh->GetPoints(), coords);
+
+    const vtkTypeInt32* tri = triangles.ids;
+    const float* xyz = coords.xyz;
+    const qint64 faces = mesh->GetPolys()->GetNumberOfCells();
+    const qint64 corners = faces * 3;
+    const qint64 vertices = qint64(numPoints);
+    const float cosSplit = float(std::cos(vtkMath::RadiansFromDegrees(splitAngle)));
+
+    for (qint64 k = 0; k < corners; ++k)
+        if (tri[k] < 0 || tri[k] >= vertices)
+            return nullptr;
+
+    // Stage 1: area-weighted (cross product) and unit face normals; zero for degenerate faces
+    std::vector<float> weighted(size_t(faces) * 3);
+    std::vector<float> unit(size_t(faces) * 3);
+    parallelFor(chunkCount(faces, ChunkFaces), [&](int c) {
+        const qint64 end = std::min(faces, (c + 1) * ChunkFaces);
+        for (qint64 f = c * ChunkFaces; f < end; ++f) {
+            const float* a = xyz + size_t(tri[f * 3]) * 3;
+            const float* b = xyz + size_t(tri[f * 3 + 1]) * 3;
+            const float* d = xyz + size_t(tri[f * 3 + 2]) * 3;
+            const float u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+            const float v[3] = { d[0] - a[0], d[1] - a[1], d[2] - a[2] };
+            float* n = &weighted[size_t(f) * 3];
+            n[0] = u[1] * v[2] - u[2] * v[1];
+            n[1] = u[2] * v[0] - u[0] * v[2];
+            n[2] = u[0] * v[1] - u[1] * v[0];
+
+            const float length = std::sqrt(dot3(n, n));
+            float* m = &unit[size_t(f) * 3];
+            const float scale = length > 0.0f ? 1.0f / length : 0.0f;
+            m[0] = n[0] * scale;
+            m[1] = n[1] * scale;
+            m[2] = n[2] * scale;
+        }
+    });
+
+    // Stage 2: corners grouped by vertex (counting sort, so corners stay in face order)
+    std::vector<vtkTypeInt32> cornerStart(size_t(vertices) + 1, 0);
+    for (qint64 k = 0; k < corners; ++k)
+        ++cornerStart[size_t(tri[k]) + 1];
+    for (qint64 v = 0; v < vertices; ++v)
+        cornerStart[size_t(v) + 1] += cornerStart[size_t(v)];
+
+    std::vector<vtkTypeInt32> vertexCorners(size_t(corners));
+    {
+        std::vector<vtkTypeInt32> cursor(cornerStart.begin(), cornerStart.end() - 1);
+        for (qint64 k = 0; k < corners; ++k)
+            vertexCorners[size_t(cursor[size_t(tri[k])]++)] = vtkTypeInt32(k);
+    }
+
+    // Stage 3: cluster each vertex's faces and collect its feature edges (as input vertex pairs)
+    const int vertexChunks = chunkCount(vertices, ChunkVertices);
+    std::vector<vtkTypeInt32> cornerCluster(size_t(corners), 0);
+    std::vector<vtkTypeInt32> clusterCount(size_t(vertices), 0);
+    std::vector<std::vector<vtkTypeInt32>> chunkEdges(size_t(vertexChunks));
+
+    parallelFor(vertexChunks, [&](int c) {
+        std::vector<vtkTypeInt32> seeds;                        // Seed face of each cluster
+        std::vector<std::pair<vtkTypeInt32, vtkTypeInt32>> spokes;  // (neighbour, face) pairs
+        std::vector<vtkTypeInt32>& edges = chunkEdges[size_t(c)];
+
+        const qint64 end = std::min(vertices, (c + 1) * ChunkVertices);
+        for (qint64 v = c * ChunkVertices; v < end; ++v) {
+            const vtkTypeInt32 first = cornerStart[size_t(v)];
+            const vtkTypeInt32 last = cornerStart[size_t(v) + 1];
+
+            seeds.clear();
+            for (vtkTypeInt32 i = first; i < last; ++i) {
+                const vtkTypeInt32 k = vertexCorners[size_t(i)];
+                const float* n = &unit[size_t(k / 3) * 3];
+                if (dot3(n, n) == 0.0f)
+                    continue;
+
+                size_t cluster = 0;
+                while (cluster < seeds.size() && dot3(n, &unit[size_t(seeds[cluster]) * 3]) < cosSplit)
+                    ++cluster;
+                if (cluster == seeds.size())
+                    seeds.push_back(k / 3);
+                cornerCluster[size_t(k)] = vtkTypeInt32(cluster);
+            }
+
+            // Degenerate corners keep cluster 0; a vertex with only those still gets one point
+            clusterCount[size_t(v)] = std::max<vtkTypeInt32>(1, vtkTypeInt32(seeds.size()));
+
+            if (!withEdges)
+                continue;
+
+            spokes.clear();
+            for (vtkTypeInt32 i = first; i < last; ++i) {
+                const vtkTypeInt32 k = vertexCorners[size_t(i)];
+                const vtkTypeInt32 f = k / 3;
+                const float* n = &unit[size_t(f) * 3];
+                if (dot3(n, n) == 0.0f)
+                    continue;
+                for (int j = 0; j < 3; ++j) {
+                    const vtkTypeInt32 w = tri[size_t(f) * 3 + j];
+                    if (w > v)
+                        spokes.emplace_back(w, f);
+                }
+            }
+            std::sort(spokes.begin(), spokes.end());
+
+            for (size_t i = 0; i < spokes.size();) {
+                size_t j = i + 1;
+                while (j < spokes.size() && spokes[j].first == spokes[i].first)
+                    ++j;
+
+                bool feature = j - i != 2;
+                if (!feature)
+                    feature = dot3(&unit[size_t(spokes[i].second) * 3], &unit[size_t(spokes[i + 1].second) * 3])
+                              < cosSplit;
+                if (feature) {
+                    edges.push_back(vtkTypeInt32(v));
+                    edges.push_back(spokes[i].first);
+                }
+                i = j;
+            }
+        }
+    });
+    std::vector<float>().swap(unit);
+
+    // Output point base of every input vertex
+    std::vector<vtkTypeInt32> pointBase(size_t(vertices) + 1, 0);
+    for (qint64 v = 0; v < vertices; ++v) {
+        const qint64 next = qint64(pointBase[size_t(v)]) + clusterCount[size_t(v)];
+        if (next > std::numeric_limits<vtkTypeInt32>::max())
+            return nullptr;
+        pointBase[size_t(v) + 1] = vtkTypeInt32(next);
+    }
+    std::vector<vtkTypeInt32>().swap(clusterCount);
+    const vtkIdType outPoints = pointBase[size_t(vertices)];
+
+    // Stage 4: output points, normals and triangle indices
+    auto pointArray = vtkSmartPointer<vtkFloatArray>::New();
+    pointArray->SetNumberOfComponents(3);
+    pointArray->SetNumberOfTuples(outPoints);
+    auto normals = vtkSmartPointer<vtkFloatArray>::New();
+    normals->SetName("Normals");
+    normals->SetNumberOfComponents(3);
+    normals->SetNumberOfTuples(outPoints);
+    auto connectivity = vtkSmartPointer<vtkTypeInt32Array>::New();
+    connectivity->SetNumberOfValues(corners);
+    auto offsets = vtkSmartPointer<vtkTypeInt32Array>::New();
+    offsets->SetNumberOfValues(faces + 1);
+
+    float* outXyz = pointArray->GetPointer(0);
+    float* outNormals = normals->GetPointer(0);
+    vtkTypeInt32* conn = connectivity->GetPointer(0);
+    vtkTypeInt32* cellOffsets = offsets->GetPointer(0);
+
+    parallelFor(vertexChunks, [&](int c) {
+        const qint64 end = std::min(vertices, (c + 1) * ChunkVertices);
+        for (qint64 v = c * ChunkVertices; v < end; ++v) {
+            const vtkTypeInt32 base = pointBase[size_t(v)];
+            const vtkTypeInt32 count = pointBase[size_t(v) + 1] - base;
+            std::fill(outNormals + size_t(base) * 3, outNormals + size_t(base + count) * 3, 0.0f);
+
+            for (vtkTypeInt32 i = cornerStart[size_t(v)]; i < cornerStart[size_t(v) + 1]; ++i) {
+                const vtkTypeInt32 k = vertexCorners[size_t(i)];
+                const vtkTypeInt32 id = base + cornerCluster[size_t(k)];
+                const float* n = &weighted[size_t(k / 3) * 3];
+                float* sum = outNormals + size_t(id) * 3;
+                sum[0] += n[0];
+                sum[1] += n[1];
+                sum[2] += n[2];
+                conn[k] = id;
+            }
+
+            for (vtkTypeInt32 id = base; id < base + count; ++id) {
+                float* n = outNormals + size_t(id) * 3;
+                const float length = std::sqrt(dot3(n, n));
+                if (length > 0.0f) {
+                    n[0] /= length;
+                    n[1] /= length;
+                    n[2] /= length;
+                }
+                std::memcpy(outXyz + size_t(id) * 3, xyz + size_t(v) * 3, 3 * sizeof(float));
+            }
+        }
+
+        // Offsets are independent of the vertices; spread them over the same chunks
+        const qint64 perChunk = (faces + vertexChunks) / vertexChunks;
+        const qint64 endFace = std::min(faces + 1, (c + 1) * perChunk);
+        for (qint64 f = c * perChunk; f < endFace; ++f)
+            cellOffsets[f] = vtkTypeInt32(f * 3);
+    });
+
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->SetData(pointArray);
+    auto polys = vtkSmartPointer<vtkCellArray>::New();
+    polys->SetData(offsets, connectivity);
+
+    auto result = vtkSmartPointer<vtkPolyData>::New();
+    result->SetPoints(points);
+    result->SetPolys(polys);
+    result->GetPointData()->SetNormals(normals);
+
+    if (!withEdges)
+        return result;
+
+    // Concatenate the chunks' edges, mapping input vertices to their first output point
+    std::vector<qint64> edgeBase(size_t(vertexChunks) + 1, 0);
+    for (int c = 0; c < vertexChunks; ++c)
+        edgeBase[size_t(c) + 1] = edgeBase[size_t(c)] + qint64(chunkEdges[size_t(c)].size());
+
+    auto edges = vtkSmartPointer<vtkTypeInt32Array>::New();
+    edges->SetName(EdgeArrayName);
+    edges->SetNumberOfValues(edgeBase[size_t(vertexChunks)]);
+    vtkTypeInt32* edgeIds = edges->GetPointer(0);
+
+    parallelFor(vertexChunks, [&](int c) {
+        std::vector<vtkTypeInt32>& chunk = chunkEdges[size_t(c)];
+        vtkTypeInt32* out = edgeIds + edgeBase[size_t(c)];
+        for (size_t i = 0; i < chunk.size(); ++i)
+            out[i] = pointBase[size_t(chunk[i])];
+        std::vector<vtkTypeInt32>().swap(chunk);
+    });
+
+    result->GetFieldData()->AddArray(edges);
+    return result;
+}
+
+// --------------------------------------- Feature Edges ---------------------------------------
+
+/**
+ * @brief Returns the feature edges stored on a mesh as line cells over its points.
+ * @param mesh Mesh produced by computeNormals() or loaded from the mesh cache.
+ * @return Lines sharing the stored array, or nullptr if the mesh has none.
+ *
+ * Every line has two points, so the fixed-size form of vtkCellArray::SetData()
+ * takes the pair array as its connectivity and only adds an offsets array.
+ */
+// Zero-copy view of the "FeatureEdges" field data array
+vtkSmartPointer<vtkCellArray> MeshFeatures::featureEdges(vtkPolyData* mesh)
+{
+    if (!mesh)
+        return nullptr;
+
+    auto* pairs = vtkTypeInt32Array::SafeDownCast(mesh->GetFieldData()->GetAbstractArray(EdgeArrayName));
+    if (!pairs || pairs->GetNumberOfComponents() != 1 || pairs->GetNumberOfValues() < 2
+        || pairs->GetNumberOfValues() % 2 != 0)
+        return nullptr;
+
+    auto lines = vtkSmartPointer<vtkCellArray>::New();
+    if (!lines->SetData(2, pairs))
+        return nullptr;
+    return lines;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file MeshFeatures.h
+ * @brief Parallel split-angle normals and feature edges for loaded triangle meshes.
+ *
+ * STL files carry one normal per facet, so a welded mesh either shades faceted or
+ * smears its creases. This pass gives every vertex the average normal of the faces
+ * around it that lie within the split angle of each other, duplicating the vertex
+ * along creases, and records the crease, boundary and non-manifold edges it found
+ * on the way as line pairs for an edge overlay. It runs once at load time on the
+ * global Qt thread pool; the results are stored in the mesh cache.
+ */
+
+#ifndef MESH_FEATURES_H
+#define MESH_FEATURES_H
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkSmartPointer.h>  // Smart pointer management for VTK
+#include <vtkPolyData.h>      // Processed meshes
+#include <vtkCellArray.h>     // Feature edges as line cells
+
+// --------------------------------------- MeshFeatures Class ---------------------------------------
+/**
+ * @class MeshFeatures
+ * @brief Computes split-angle point normals and feature edges of welded triangle meshes.
+ *
+ * The edges are kept on the mesh as a vtkTypeInt32Array named EdgeArrayName in
+ * its field data, holding consecutive point index pairs of the output mesh.
+ * That way they travel with the mesh through sharing, snapshots, eviction and the
+ * mesh cache without any extra plumbing. All functions are static and thread-safe;
+ * they only read their input.
+ */
+class MeshFeatures {
+public:
+    /**
+     * @brief Angle between face normals above which an edge is a crease, in degrees.
+     *
+     * Same as vtkPolyDataNormals' default feature angle.
+     */
+    static constexpr double DefaultSplitAngle = 30.0;
+
+    /**
+     * @brief Name of the field data array holding the feature edges.
+     */
+    static constexpr const char* EdgeArrayName = "FeatureEdges";
+
+    /**
+     * @brief Computes point normals, splitting vertices along creases, and the feature edges.
+     * @param mesh        Welded triangle mesh (point normals, if any, are ignored).
+     * @param splitAngle  Crease angle in degrees.
+     * @param withEdges   False to skip the edge extraction, e.g. for decimated levels.
+     * @return A new mesh with "Normals" point data and, if requested, the feature edges;
+     *         nullptr if the input is not a pure triangle mesh of a supported size.
+     */
+    // Parallel corner normals, vertex splitting and edge classification
+    static vtkSmartPointer<vtkPolyData> computeNormals(vtkPolyData* mesh, double splitAngle = DefaultSplitAngle,
+                                                       bool withEdges = true);
+
+    /**
+     * @brief Returns the feature edges stored on a mesh as line cells over its points.
+     * @param mesh Mesh produced by computeNormals() or loaded from the mesh cache.
+     * @return Lines sharing the stored array (no copy), or nullptr if the mesh has none.
+     */
+    // Wraps the field data array as a vtkCellArray
+    static vtkSmartPointer<vtkCellArray> featureEdges(vtkPolyData* mesh);
+};
+
+#endif // MESH_FEATURES_H
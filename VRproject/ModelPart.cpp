@@ -7,6 +7,10 @@
 // --------------------------------------- Includes ---------------------------------------
 
 #include "ModelPart.h"
+#include "BinarySTLReader.h"
+#include "FrameProfiler.h"
+#include "MeshFeatures.h"
+#include "GpuEffects.h"
 #include <QDebug>
 
 // VTK headers for rendering, filters, and geometry processing
@@ -20,10 +24,76 @@
 #include <vtkShrinkPolyData.h>
 #include <vtkProperty.h>
 #include <vtkClipClosedSurface.h>
-#include <vtkClipDataSet.h>
-#include <vtkShrinkFilter.h>
-#include <vtkGeometryFilter.h>
 #include <vtkPlaneCollection.h>
+#include <vtkPointData.h>
+#include <vtkCellData.h>
+#include <vtkPoints.h>
+#include <vtkCellArray.h>
+#include <vtkTrivialProducer.h>
+#include <vtkQuadricClustering.h>
+#include <QHash>
+#include <algorithm>
+#include <cmath>
+
+// --------------------------------------- Static Members ---------------------------------------
+
+// Empty until the GUI installs a background runner; the bench tool filters synchronously
+std::function<void(ModelPart*)> ModelPart::filterScheduler;
+
+// The bench tool measures the filter pipeline; the GUI opts into the shader
+bool ModelPart::gpuEffects = false;
+
+// --------------------------------------- Presentation Cache ---------------------------------------
+
+namespace {
+
+// Role bits recorded for ModelPart::takeChangedRoles()
+const quint8 DisplayChanged = 0x1;
+const quint8 BackgroundChanged = 0x2;
+
+// One shared BackgroundRole value per colour; a tree rarely uses more than a few dozen (GUI thread)
+QVariant backgroundFor(const QColor& color)
+{
+    static QHash<QRgb, QVariant> brushes;
+    if (!color.isValid())
+        return QVariant();
+
+    auto found = brushes.constFind(color.rgba());
+    if (found == brushes.constEnd())
+        found = brushes.insert(color.rgba(), QVariant::fromValue(QBrush(color)));
+    return found.value();
+}
+
+// ForegroundRole is the same for every row
+const QVariant& foreground()
+{
+    static const QVariant black = QVariant::fromValue(QBrush(Qt::black));
+    return black;
+}
+
+// Polydata with its own points and cell array objects over the mesh's data arrays.
+// Identical parts share one mesh, and filters and pipeline requests build traversal,
+// link and information state on their input; a private view per consumer keeps
+// those lazy writes from racing when jobs on the same mesh run side by side.
+vtkSmartPointer<vtkPolyData> privateView(vtkPolyData* mesh)
+{
+    auto view = vtkSmartPointer<vtkPolyData>::New();
+    if (vtkPoints* meshPoints = mesh->GetPoints()) {
+        auto points = vtkSmartPointer<vtkPoints>::New();
+        points->SetData(meshPoints->GetData());
+        view->SetPoints(points);
+    }
+    if (vtkCellArray* meshPolys = mesh->GetPolys()) {
+        auto polys = vtkSmartPointer<vtkCellArray>::New();
+        polys->SetData(meshPolys->GetOffsetsArray(), meshPolys->GetConnectivityArray());
+        view->SetPolys(polys);
+    }
+    view->GetPointData()->PassData(mesh->GetPointData());
+    view->GetCellData()->PassData(mesh->GetCellData());
+    return view;
+}
+
+} // namespace
 
 // --------------------------------------- Constructor & Destructor ---------------------------------------
 /**
@@ -36,32 +106,33 @@
 
 // Constructs a new ModelPart with optional parent and default values
 ModelPart::ModelPart(const QList<QVariant>& data, ModelPart* parent)
-    : m_itemData(data), m_parentItem(parent), isVisible(true)
+    : m_itemData(data), m_parentItem(parent), m_row(0), m_fetchedCount(0), m_fetchRequested(false), m_changedRoles(0), isVisible(true)
 {
     partColor = QColor(255, 255, 255); // Default white color
+    m_background = backgroundFor(partColor);
     clipEnabled = false;
     shrinkEnabled = false;
     shrinkFactor = 0.8;
-    clipOrigin[0] = clipOrigin[1] = clipOrigin[2] = 0.0;
-    clipNormal[0] = -1.0; clipNormal[1] = 0.0; clipNormal[2] = 0.0;
+    clipSpec << SectionPlane{ { 0.0, 0.0, 0.0 }, { -1.0, 0.0, 0.0 } };
+    clearSectionOnUpdate = false;
+    explodeOffset[0] = explodeOffset[1] = explodeOffset[2] = 0.0;
+    filterJobRunning = false;
+    jobClearsSection = false;
+    geometryEvicted = false;
 }
 
 /**
  * @brief Destroys this ModelPart and all its children.
  *
- * Recursively deletes child items and releases the VTK actor if allocated.
+ * Recursively deletes child items. The actors are smart pointers, so renderers (or
+ * queued VR commands) that still reference them keep them alive until they let go.
  */
 
-// Destroys the ModelPart and all its children, deletes actor if present
+// Destroys the ModelPart and all its children
 ModelPart::~ModelPart()
 {
     qDeleteAll(m_childItems);
     m_childItems.clear();
-
-    if (actor) {
-        actor->Delete();
-        actor = nullptr;
-    }
 }
 
 // --------------------------------------- Tree Methods ---------------------------------------
@@ -76,6 +147,7 @@ ModelPart::~ModelPart()
 void ModelPart::appendChild(ModelPart* item)
 {
     item->m_parentItem = this;
+    item->m_row = m_childItems.size();
     m_childItems.append(item);
 }
 
@@ -129,14 +201,14 @@ ModelPart* ModelPart::parentItem()
 /**
  * @brief Determines this part’s index within its parent.
  * @return Zero‐based row index, or 0 if no parent.
+ *
+ * The row is cached and kept current by the parent whenever siblings are removed.
  */
 
-// Returns the index of this item under its parent
+// Returns the index of this item under its parent (O(1))
 int ModelPart::row() const
 {
-    if (m_parentItem)
-        return m_parentItem->m_childItems.indexOf(const_cast<ModelPart*>(this));
-    return 0;
+    return m_parentItem ? m_row : 0;
 }
 
 /**
@@ -147,8 +219,78 @@ int ModelPart::row() const
 // Removes a child from the given row index
 void ModelPart::removeChild(int row)
 {
-    if (row >= 0 && row < m_childItems.size())
-        m_childItems.removeAt(row);
+    removeChildren(row, 1);
+}
+
+/**
+ * @brief Removes a contiguous range of children.
+ * @param row   First row to remove.
+ * @param count Number of rows to remove.
+ */
+
+// Erases the range and renumbers the siblings after it
+void ModelPart::removeChildren(int row, int count)
+{
+    if (row < 0 || count <= 0 || row + count > m_childItems.size())
+        return;
+
+    m_childItems.erase(m_childItems.begin() + row, m_childItems.begin() + row + count);
+    for (int i = row; i < m_childItems.size(); ++i)
+        m_childItems[i]->m_row = i;
+
+    if (m_fetchedCount > row)
+        m_fetchedCount = std::max(row, m_fetchedCount - count);
+}
+
+/**
+ * @brief Returns the number of children exposed to the tree model.
+ */
+
+// Returns the fetched child count
+int ModelPart::fetchedChildCount() const
+{
+    return m_fetchedCount;
+}
+
+/**
+ * @brief Records how many children are exposed to the tree model.
+ * @param count Number of children the model reports.
+ */
+
+// Updates the fetched child count
+void ModelPart::setFetchedChildCount(int count)
+{
+    m_fetchedCount = std::clamp(count, 0, int(m_childItems.size()));
+}
+
+/**
+ * @brief Returns true once the view has fetched this node's children.
+ */
+
+// Returns the fetch flag
+bool ModelPart::childrenRequested() const
+{
+    return m_fetchRequested;
+}
+
+/**
+ * @brief Marks the children as requested by the view.
+ */
+
+// Sets the fetch flag
+void ModelPart::markChildrenRequested()
+{
+    m_fetchRequested = true;
+}
+
+/**
+ * @brief Returns true if this node is a sub-assembly.
+ */
+
+// A node with children and no mesh of its own
+bool ModelPart::isAssembly() const
+{
+    return !originalData && !m_childItems.isEmpty();
 }
 
 // --------------------------------------- Data & Property Access ---------------------------------------
@@ -157,6 +299,9 @@ void ModelPart::removeChild(int row)
  * @param column Zero‐based column index.
  * @param role   Qt::ItemDataRole specifying display/background/foreground.
  * @return QVariant containing the data or styling brush, or an invalid QVariant if out‐of‐range.
+ *
+ * Views call this for every visible cell and role on each repaint, so every role is
+ * a lookup of a prepared value: the brushes are built once per colour in setColor().
  */
 
 // Returns data for a given column and role (used by Qt tree view)
@@ -165,18 +310,33 @@ QVariant ModelPart::data(int column, int role) const
     if (column < 0 || column >= m_itemData.size())
         return QVariant();
 
-    if (role == Qt::DisplayRole)
+    switch (role) {
+    case Qt::DisplayRole:
         return m_itemData.at(column);
-
-    if (role == Qt::BackgroundRole && partColor.isValid()) {
-        qDebug() << "Applying background color to row" << row() << "Color:" << partColor;
-        return QBrush(partColor);
+    case Qt::BackgroundRole:
+        return m_background;
+    case Qt::ForegroundRole:
+        return foreground();
+    default:
+        return QVariant();
     }
+}
 
-    if (role == Qt::ForegroundRole)
-        return QBrush(Qt::black);
+/**
+ * @brief Returns the roles whose data changed since the last call, and forgets them.
+ * @return Roles for QAbstractItemModel::dataChanged(); empty if nothing shown changed.
+ */
 
-    return QVariant();
+// Reads and clears the changed-role bits
+QList<int> ModelPart::takeChangedRoles()
+{
+    QList<int> roles;
+    if (m_changedRoles & DisplayChanged)
+        roles << Qt::DisplayRole;
+    if (m_changedRoles & BackgroundChanged)
+        roles << Qt::BackgroundRole;
+    m_changedRoles = 0;
+    return roles;
 }
 
 /**
@@ -188,9 +348,10 @@ QVariant ModelPart::data(int column, int role) const
 // Sets the data in the specified column
 void ModelPart::set(int column, const QVariant& value)
 {
-    if (column < 0 || column >= m_itemData.size())
+    if (column < 0 || column >= m_itemData.size() || m_itemData.at(column) == value)
         return;
     m_itemData.replace(column, value);
+    m_changedRoles |= DisplayChanged;
 }
 
 /**
@@ -204,6 +365,103 @@ void ModelPart::setName(const QString& newName)
     set(0, newName);
 }
 
+/**
+ * @brief Records the file this part was loaded from.
+ * @param fileName Full path of the source file.
+ */
+
+// Sets the source file path
+void ModelPart::setSourceFile(const QString& fileName)
+{
+    sourceFile = fileName;
+}
+
+/**
+ * @brief Returns the file this part was loaded from.
+ * @return Full path, or an empty string for sub-assemblies.
+ */
+
+// Returns the source file path
+QString ModelPart::getSourceFile() const
+{
+    return sourceFile;
+}
+
+// --------------------------------------- Assembly Transforms ---------------------------------------
+/**
+ * @brief Sets this node's transform relative to its parent.
+ * @param matrix Local transform; copied, nullptr means identity.
+ */
+
+// Stores the local transform and refreshes the subtree's actors
+void ModelPart::setLocalTransform(vtkMatrix4x4* matrix)
+{
+    if (matrix && !matrix->IsIdentity()) {
+        if (!localTransform)
+            localTransform = vtkSmartPointer<vtkMatrix4x4>::New();
+        localTransform->DeepCopy(matrix);
+    }
+    else {
+        localTransform = nullptr;
+    }
+
+    updateWorldTransform();
+}
+
+/**
+ * @brief Returns the transform relative to the parent.
+ * @return Local matrix, or nullptr for identity.
+ */
+
+// Returns the local transform
+vtkMatrix4x4* ModelPart::getLocalTransform() const
+{
+    return localTransform;
+}
+
+/**
+ * @brief Accumulates the local transforms from the root down to this node.
+ * @return World matrix, or nullptr if all transforms on the path are identity.
+ */
+
+// Walks up the parents, multiplying parent * child
+vtkSmartPointer<vtkMatrix4x4> ModelPart::getWorldTransform() const
+{
+    vtkSmartPointer<vtkMatrix4x4> world;
+
+    for (const ModelPart* node = this; node; node = node->m_parentItem) {
+        if (!node->localTransform)
+            continue;
+
+        if (!world) {
+            world = vtkSmartPointer<vtkMatrix4x4>::New();
+            world->DeepCopy(node->localTransform);
+        }
+        else {
+            vtkMatrix4x4::Multiply4x4(node->localTransform, world, world);
+        }
+    }
+
+    return world;
+}
+
+/**
+ * @brief Reapplies the world transform to the actors of this node and its descendants.
+ */
+
+// Sets each on-screen actor's user matrix from its world transform
+void ModelPart::updateWorldTransform()
+{
+    if (actor) {
+        vtkSmartPointer<vtkMatrix4x4> world = getWorldTransform();
+        actor->SetUserMatrix(world);
+        GpuEffects::setWorldOffset(actor, world, explodeOffset);
+    }
+
+    for (ModelPart* childItem : m_childItems)
+        childItem->updateWorldTransform();
+}
+
 /**
  * @brief Returns the current colour of this part.
  * @return QColor representing the part’s colour.
@@ -223,6 +481,10 @@ QColor ModelPart::getColor() const
 // Sets the background color and updates the actor's visual color
 void ModelPart::setColor(const QColor& color)
 {
+    if (color != partColor) {
+        m_background = backgroundFor(color);
+        m_changedRoles |= BackgroundChanged;
+    }
     partColor = color;
     if (actor)
         actor->GetProperty()->SetColor(color.redF(), color.greenF(), color.blueF());
@@ -239,13 +501,8 @@ void ModelPart::setVisible(bool visible)
     isVisible = visible;
     set(1, visible ? "true" : "false");
 
-    if (actor) {
+    if (actor)
         actor->SetVisibility(visible ? 1 : 0);
-        qDebug() << "Actor visibility set to" << visible;
-    }
-    else {
-        qDebug() << "Actor is null!";
-    }
 }
 
 /**
@@ -271,6 +528,25 @@ bool ModelPart::visible() const
 // Loads an STL file and initializes the VTK pipeline
 void ModelPart::loadSTL(QString fileName)
 {
+    setPolyData(readSTL(fileName));
+}
+
+/**
+ * @brief Parses an STL file into a standalone polydata object.
+ * @param fileName Path to the STL file.
+ * @return The parsed mesh, or nullptr if loading failed or the mesh is empty.
+ *
+ * Binary files go through BinarySTLReader's memory-mapped fast path. ASCII files
+ * (or anything it rejects) fall back to vtkSTLReader, whose output is shallow-copied
+ * so the mesh outlives the reader without duplicating the point and cell arrays.
+ */
+
+// Reads an STL file into polydata; safe to run on worker threads
+vtkSmartPointer<vtkPolyData> ModelPart::readSTL(const QString& fileName)
+{
+    if (auto fast = BinarySTLReader::read(fileName))
+        return fast;
+
     auto reader = vtkSmartPointer<vtkSTLReader>::New();
     reader->SetFileName(fileName.toStdString().c_str());
     reader->Update();
@@ -278,24 +554,237 @@ void ModelPart::loadSTL(QString fileName)
     auto polyData = reader->GetOutput();
     if (!polyData || polyData->GetNumberOfPoints() == 0 || polyData->GetNumberOfCells() == 0) {
         qWarning() << "STL load failed or empty: " << fileName;
+        return nullptr;
+    }
+
+    auto result = vtkSmartPointer<vtkPolyData>::New();
+    result->ShallowCopy(polyData);
+    return result;
+}
+
+/**
+ * @brief Computes point normals for a mesh outside the rendering pipeline.
+ * @param polyData     Mesh without normals.
+ * @param featureEdges True to also extract the feature edges for the edge overlay.
+ * @return New polydata with point normals, or nullptr if polyData is null.
+ *
+ * Triangle meshes go through the parallel MeshFeatures pass, which splits vertices
+ * at the same feature angle the pipeline's normals stage uses. Anything else falls
+ * back to vtkPolyDataNormals. Either way setPolyData() can skip its normals stage
+ * for meshes prepared on a worker thread.
+ */
+
+// Computes normals (and feature edges) on a standalone mesh; safe to run on worker threads
+vtkSmartPointer<vtkPolyData> ModelPart::computeNormals(vtkSmartPointer<vtkPolyData> polyData, bool featureEdges)
+{
+    if (!polyData)
+        return nullptr;
+
+    if (auto result = MeshFeatures::computeNormals(polyData, MeshFeatures::DefaultSplitAngle, featureEdges))
+        return result;
+
+    auto normals = vtkSmartPointer<vtkPolyDataNormals>::New();
+    normals->SetInputData(polyData);
+    normals->ComputePointNormalsOn();
+    normals->Update();
+
+    auto result = vtkSmartPointer<vtkPolyData>::New();
+    result->ShallowCopy(normals->GetOutput());
+    return result;
+}
+
+/**
+ * @brief Builds decimated levels of detail for a mesh outside the rendering pipeline.
+ * @param polyData Full-resolution mesh with normals.
+ * @return Up to three coarser meshes with point normals, finest first; empty for small meshes.
+ *
+ * Uses vertex clustering (vtkQuadricClustering), which runs in linear time and
+ * keeps the silhouette well at the sizes the coarse levels are shown at. Each level
+ * targets roughly a quarter of the previous triangle count; levels that do not
+ * reduce the mesh noticeably are dropped.
+ */
+
+// Generates decimated LOD meshes; safe to run on worker threads
+QVector<vtkSmartPointer<vtkPolyData>> ModelPart::generateLODs(vtkSmartPointer<vtkPolyData> polyData)
+{
+    QVector<vtkSmartPointer<vtkPolyData>> levels;
+    if (!polyData || !polyData->GetPoints() || !polyData->GetPolys())
+        return levels;
+
+    const vtkIdType fullTriangles = polyData->GetNumberOfPolys();
+    if (fullTriangles < 20000)
+        return levels;
+
+    // The filters' traversal and bounds caching must not race with the GUI pipeline
+    vtkSmartPointer<vtkPolyData> input = privateView(polyData);
+
+    vtkIdType previous = fullTriangles;
+    for (int level = 1; level <= 3; ++level) {
+        const double target = double(fullTriangles) / std::pow(4.0, level);
+        const int divisions = std::max(8, std::min(512, int(std::sqrt(target))));
+
+        auto clustering = vtkSmartPointer<vtkQuadricClustering>::New();
+        clustering->SetInputData(input);
+        clustering->SetNumberOfDivisions(divisions, divisions, divisions);
+        clustering->AutoAdjustNumberOfDivisionsOn();
+        clustering->CopyCellDataOff();
+        clustering->Update();
+
+        vtkPolyData* output = clustering->GetOutput();
+        const vtkIdType triangles = output ? output->GetNumberOfPolys() : 0;
+        if (triangles == 0 || triangles > previous * 7 / 10)
+            continue;
+
+        auto decimated = vtkSmartPointer<vtkPolyData>::New();
+        decimated->ShallowCopy(output);
+        levels << computeNormals(decimated, false);
+        previous = triangles;
+    }
+
+    return levels;
+}
+
+/**
+ * @brief Sets up mapper and actor for geometry loaded by readSTL().
+ * @param polyData The loaded mesh; nullptr leaves the part without an actor.
+ */
+
+// Builds the mapper/actor for already-loaded geometry (GUI thread)
+void ModelPart::setPolyData(vtkSmartPointer<vtkPolyData> polyData)
+{
+    if (!polyData) {
         actor = nullptr;
         return;
     }
 
-    originalData = vtkSmartPointer<vtkPolyData>::New();
-    originalData->DeepCopy(polyData);
+    originalData = polyData;
+
+    // Persistent pipeline: source -> normals -> shrink -> clip -> mapper.
+    // Stages are wired up in updateFilters(); none of them copies the mesh.
+    sourceStage = vtkSmartPointer<vtkTrivialProducer>::New();
+    sourceStage->SetOutput(originalData);
+
+    // The stages read a view of their own, so twins can be filtered at the same time
+    filterSource = vtkSmartPointer<vtkTrivialProducer>::New();
+    filterSource->SetOutput(privateView(originalData));
 
-    file = reader;
-    currentFilter = reader;
+    // Background jobs are aborted from the stages' progress reports
+    cancelCallback = vtkSmartPointer<vtkCallbackCommand>::New();
+    cancelCallback->SetCallback(&ModelPart::onFilterProgress);
+
+    setupNormalsStage();
+
+    shrinkFilter = vtkSmartPointer<vtkShrinkPolyData>::New();
+
+    clipPlanes = vtkSmartPointer<vtkPlaneCollection>::New();
+
+    clipFilter = vtkSmartPointer<vtkClipClosedSurface>::New();
+    clipFilter->SetClippingPlanes(clipPlanes);
+    clipFilter->GenerateFacesOn();
+
+    // Report filter execution time to the frame profiler
+    FrameProfiler::watchAlgorithm(shrinkFilter);
+    FrameProfiler::watchAlgorithm(clipFilter);
+    shrinkFilter->AddObserver(vtkCommand::ProgressEvent, cancelCallback);
+    clipFilter->AddObserver(vtkCommand::ProgressEvent, cancelCallback);
 
     mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-    mapper->SetInputData(originalData);
 
     actor = vtkSmartPointer<vtkActor>::New();
     actor->SetMapper(mapper);
     actor->GetProperty()->SetColor(partColor.redF(), partColor.greenF(), partColor.blueF());
+    actor->SetVisibility(isVisible ? 1 : 0);    // Parts hidden before their mesh arrived stay hidden
+
+    // The first mesh is shown straight away; only later setting changes run in the background
+    wireFilters();
+    vtkAlgorithm* unfiltered = originalNormalsFilter ? static_cast<vtkAlgorithm*>(originalNormalsFilter) : sourceStage.Get();
+    const bool deferStages = filterScheduler && currentFilter != unfiltered;
+    if (deferStages) {
+        // Clip or shrink set before the mesh arrived (a restored session): show the
+        // unfiltered mesh and leave the stages to the scheduler, off the GUI thread.
+        // The normals run here, before the job snapshots the mapper input.
+        unfiltered->Update();
+        mapper->SetInputConnection(unfiltered->GetOutputPort());
+    } else {
+        mapper->SetInputConnection(currentFilter->GetOutputPort());
+    }
+    applyGpuShrink();
+    updateWorldTransform();
 
-    updateFilters();
+    if (deferStages)
+        filterScheduler(this);
+}
+
+/**
+ * @brief Adds a normals stage behind the source when the mesh has no point normals.
+ *
+ * Meshes from the loader or the mesh cache already carry normals, so the stage is
+ * only built for meshes handed in directly (loadSTL()).
+ */
+
+// (Re)creates or drops the normals stage for originalData
+void ModelPart::setupNormalsStage()
+{
+    if (originalData->GetPointData()->GetNormals()) {
+        originalNormalsFilter = nullptr;
+        return;
+    }
+
+    originalNormalsFilter = vtkSmartPointer<vtkPolyDataNormals>::New();
+    originalNormalsFilter->SetInputConnection(filterSource->GetOutputPort());
+    originalNormalsFilter->ComputePointNormalsOn();
+    FrameProfiler::watchAlgorithm(originalNormalsFilter);
+    originalNormalsFilter->AddObserver(vtkCommand::ProgressEvent, cancelCallback);
+}
+
+/**
+ * @brief Stores decimated levels of detail and builds a desktop mapper for each.
+ * @param levels Meshes from generateLODs() or the mesh cache, finest first.
+ */
+
+// Keeps the LOD meshes and their on-screen mappers (GUI thread)
+void ModelPart::setLODs(const QVector<vtkSmartPointer<vtkPolyData>>& levels)
+{
+    lodData = levels;
+    lodMappers.clear();
+
+    for (const vtkSmartPointer<vtkPolyData>& level : lodData) {
+        auto lodMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+        lodMapper->SetInputData(level);
+        lodMappers << lodMapper;
+    }
+}
+
+/**
+ * @brief Returns the desktop mapper chain for LOD switching.
+ * @return Full-resolution mapper followed by the LOD mappers, or an empty list if the
+ *         part has no levels or a filter is active (the levels show unfiltered geometry).
+ */
+
+// Returns the on-screen mappers, full resolution first
+QVector<vtkSmartPointer<vtkMapper>> ModelPart::getLODMappers() const
+{
+    QVector<vtkSmartPointer<vtkMapper>> levels;
+    if (!mapper || lodMappers.isEmpty() || clipEnabled || shrinkEnabled)
+        return levels;
+
+    levels << vtkSmartPointer<vtkMapper>(mapper.Get());
+    for (const vtkSmartPointer<vtkPolyDataMapper>& lodMapper : lodMappers)
+        levels << vtkSmartPointer<vtkMapper>(lodMapper.Get());
+    return levels;
+}
+
+/**
+ * @brief Returns the LOD meshes for the VR renderer, which builds its own mappers.
+ * @return Decimated meshes, or an empty list under the same conditions as getLODMappers().
+ */
+
+// Returns the decimated meshes when LOD switching applies
+QVector<vtkSmartPointer<vtkPolyData>> ModelPart::getLODData() const
+{
+    if (!mapper || clipEnabled || shrinkEnabled)
+        return QVector<vtkSmartPointer<vtkPolyData>>();
+    return lodData;
 }
 
 // --------------------------------------- VTK Actor Access ---------------------------------------
@@ -329,40 +818,104 @@ vtkAlgorithm* ModelPart::getSource() const
 // Returns the output port of the last-applied VTK filter
 vtkAlgorithmOutput* ModelPart::getOutputPort() const
 {
+    if (!sourceStage)
+        return nullptr;
     if (clipEnabled && clipFilter)
         return clipFilter->GetOutputPort();
     if (shrinkEnabled && shrinkFilter)
         return shrinkFilter->GetOutputPort();
-    return originalNormalsFilter->GetOutputPort();
+    if (originalNormalsFilter)
+        return originalNormalsFilter->GetOutputPort();
+    return sourceStage->GetOutputPort();
 }
 
 /**
- * @brief Creates and returns a copy of the actor for VR or off‐screen rendering.
- * @return Smart pointer to a new vtkActor configured like the on‐screen actor, or nullptr on failure.
+ * @brief Returns the cached VR actor, creating it on first use.
+ * @return Smart pointer to the VR actor, or nullptr if no mesh is loaded.
+ *
+ * The actor is built once per part from a snapshot of the filtered output, so no
+ * geometry is copied. After creation it is only modified by the VR thread.
  */
 
-// Creates and returns a duplicate actor for VR rendering
+// Returns the VR actor, building it once
 vtkSmartPointer<vtkActor> ModelPart::getVRActor()
 {
     if (!mapper || !actor)
         return nullptr;
 
-    auto vrMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-    vrMapper->SetInputConnection(mapper->GetInputConnection(0, 0));
+    if (!vrActor) {
+        vrMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+        vrMapper->SetInputData(getOutputSnapshot());
 
-    auto vrActor = vtkSmartPointer<vtkActor>::New();
-    vrActor->SetMapper(vrMapper);
-    vrActor->SetProperty(actor->GetProperty());
-    vrActor->SetVisibility(isVisible ? 1 : 0);
-    vrActor->SetUserMatrix(actor->GetUserMatrix());
+        vrActor = vtkSmartPointer<vtkActor>::New();
+        vrActor->SetMapper(vrMapper);
+        vrActor->GetProperty()->DeepCopy(actor->GetProperty());
+        vrActor->SetVisibility(isVisible ? 1 : 0);
 
-    if (actor->GetTexture()) {
-        vrActor->SetTexture(actor->GetTexture());
+        if (actor->GetTexture()) {
+            vrActor->SetTexture(actor->GetTexture());
+        }
     }
 
     return vrActor;
 }
 
+/**
+ * @brief Returns true if the VR actor exists.
+ */
+
+// Lets callers release the VR actor without creating it first
+bool ModelPart::hasVRActor() const
+{
+    return vrActor != nullptr;
+}
+
+/**
+ * @brief Returns the loaded mesh.
+ */
+
+// Returns originalData (shared between identical parts)
+vtkSmartPointer<vtkPolyData> ModelPart::getPolyData() const
+{
+    return originalData;
+}
+
+/**
+ * @brief Returns the mesh for instanced drawing, or nullptr while the part shows other geometry.
+ */
+
+// The mapper shows originalData itself when no stage sits between them
+vtkPolyData* ModelPart::getSharedGeometry() const
+{
+    if (!originalData || !actor || originalNormalsFilter || clipEnabled || shrinkEnabled || !sectionPlanes.isEmpty())
+        return nullptr;
+    return originalData;
+}
+
+/**
+ * @brief Updates the pipeline and returns a shallow copy of the current output.
+ * @return Polydata sharing the output arrays, or nullptr if no mesh is loaded.
+ */
+
+// Returns a thread-safe snapshot of the filtered geometry
+vtkSmartPointer<vtkPolyData> ModelPart::getOutputSnapshot()
+{
+    // A background job result (or the geometry kept on screen during one) is already a snapshot
+    if (shownOutput)
+        return shownOutput;
+    if (!currentFilter)
+        return nullptr;
+
+    currentFilter->Update();
+    vtkPolyData* output = vtkPolyData::SafeDownCast(currentFilter->GetOutputDataObject(0));
+    if (!output)
+        return nullptr;
+
+    auto snapshot = vtkSmartPointer<vtkPolyData>::New();
+    snapshot->ShallowCopy(output);
+    return snapshot;
+}
+
 // --------------------------------------- Filter Application ---------------------------------------
 /**
  * @brief Enables or disables the clip filter and updates the pipeline.
@@ -376,14 +929,72 @@ void ModelPart::applyClipFilter(bool enable, double origin[3], double normal[3])
 {
     clipEnabled = enable;
     if (enable) {
+        SectionPlane plane;
         for (int i = 0; i < 3; i++) {
-            clipOrigin[i] = origin[i];
-            clipNormal[i] = normal[i];
+            plane.origin[i] = origin[i];
+            plane.normal[i] = normal[i];
         }
+        clipSpec = SectionPlaneList{ plane };
     }
     updateFilters();
 }
 
+/**
+ * @brief Replaces the GPU section planes.
+ * @param planes Planes in world coordinates.
+ */
+
+// Stores the section planes; the pipeline is not touched
+void ModelPart::setSectionPlanes(const SectionPlaneList& planes)
+{
+    sectionPlanes = planes;
+}
+
+/**
+ * @brief Returns the GPU section planes.
+ */
+
+// Returns the section planes
+const SectionPlaneList& ModelPart::getSectionPlanes() const
+{
+    return sectionPlanes;
+}
+
+/**
+ * @brief Checks for section planes.
+ */
+
+// Returns true while the part has its own section planes
+bool ModelPart::hasSectionPlanes() const
+{
+    return !sectionPlanes.isEmpty();
+}
+
+/**
+ * @brief Bakes the section planes (and the given scene planes) into the clip filter.
+ * @param scenePlanes Scene-wide planes to include.
+ *
+ * The GPU planes are in world coordinates while the pipeline works on the loaded
+ * mesh, so the planes are moved by the inverse of the actor's current matrix. They
+ * keep cutting the old geometry until the clipped mesh is shown.
+ */
+
+// Runs the exact capped clip with the current section
+void ModelPart::bakeSectionPlanes(const SectionPlaneList& scenePlanes)
+{
+    SectionPlaneList planes = sectionPlanes + scenePlanes;
+    if (planes.isEmpty() || !actor)
+        return;
+
+    auto toModel = vtkSmartPointer<vtkMatrix4x4>::New();
+    vtkMatrix4x4::Invert(actor->GetMatrix(), toModel);
+
+    clipSpec = SectionClipper::transformed(planes, toModel);
+    clipEnabled = true;
+    clearSectionOnUpdate = true;
+    updateFilters();
+}
+
 /**
  * @brief Enables or disables the shrink filter and sets its factor.
  * @param enable True to enable shrinking; false to disable.
@@ -395,55 +1006,224 @@ void ModelPart::applyShrinkFilter(bool enable, double factor)
 {
     shrinkEnabled = enable;
     shrinkFactor = factor;
+
+    // The shader leaves the pipeline as it is: only the uniform (or the shader) changes
+    if (gpuEffects && actor) {
+        applyGpuShrink();
+        return;
+    }
     updateFilters();
 }
 
 /**
- * @brief Rebuilds the VTK pipeline based on current filter settings.
+ * @brief Reconnects the persistent pipeline for the current filter settings.
  *
- * Applies shrink and clip filters in sequence, updates the mapper,
- * and reassigns it to the actor.
+ * Without a filter scheduler the mapper is connected to the last stage and the
+ * pipeline executes on the next render. With one, the part is handed over and the
+ * mapper keeps the current geometry until the background job has finished.
  */
 
-// Rebuilds the filter pipeline with currently active filters
+// Applies the current filter settings, synchronously or through the scheduler
 void ModelPart::updateFilters()
 {
-    if (!originalData || !mapper) return;
+    if (!originalData || !mapper || !sourceStage) return;
 
-    auto processedData = vtkSmartPointer<vtkPolyData>::New();
-    processedData->DeepCopy(originalData);
+    if (filterScheduler) {
+        filterScheduler(this);
+        return;
+    }
 
-    if (shrinkEnabled) {
-        if (!shrinkFilter) shrinkFilter = vtkSmartPointer<vtkShrinkFilter>::New();
-        shrinkFilter->SetInputData(processedData);
-        shrinkFilter->SetShrinkFactor(shrinkFactor);
-        shrinkFilter->Update();
+    wireFilters();
+    shownOutput = nullptr;
+    mapper->SetInputConnection(currentFilter->GetOutputPort());
+    if (actor) actor->SetMapper(mapper);
+    applyGpuShrink();
 
-        auto geometryFilter = vtkSmartPointer<vtkGeometryFilter>::New();
-        geometryFilter->SetInputConnection(shrinkFilter->GetOutputPort());
-        geometryFilter->Update();
-        processedData->DeepCopy(geometryFilter->GetOutput());
+    if (clearSectionOnUpdate) {
+        sectionPlanes.clear();
+        clearSectionOnUpdate = false;
+    }
+}
+
+/**
+ * @brief Connects the enabled stages for the current filter settings.
+ *
+ * Each enabled stage takes the previous stage's output port; disabled stages are
+ * skipped. VTK's setters only mark a stage modified when a value actually changes,
+ * so toggling clip leaves the normals and shrink outputs cached, and changing the
+ * shrink factor re-executes shrink and clip only.
+ */
+
+// Rewires the filter stages and sets currentFilter
+void ModelPart::wireFilters()
+{
+
+    // Without any stage the mapper shows originalData itself; the stages start from
+    // the part's private view (the normals stage is absent when the mesh has normals)
+    vtkAlgorithm* last = sourceStage;
+    vtkAlgorithmOutput* port = filterSource->GetOutputPort();
+    if (originalNormalsFilter) {
+        last = originalNormalsFilter;
+        port = originalNormalsFilter->GetOutputPort();
+    }
+
+    if (shrinkEnabled && !gpuEffects) {
+        shrinkFilter->SetInputConnection(port);
+        shrinkFilter->SetShrinkFactor(shrinkFactor);
+        last = shrinkFilter;
+        port = shrinkFilter->GetOutputPort();
     }
 
     if (clipEnabled) {
-        auto clipper = vtkSmartPointer<vtkClipClosedSurface>::New();
-        auto plane = vtkSmartPointer<vtkPlane>::New();
-        plane->SetOrigin(clipOrigin);
-        plane->SetNormal(clipNormal);
-        auto planes = vtkSmartPointer<vtkPlaneCollection>::New();
-        planes->AddItem(plane);
-
-        clipper->SetInputData(processedData);
-        clipper->SetClippingPlanes(planes);
-        clipper->GenerateFacesOn();
-        clipper->Update();
-
-        processedData->DeepCopy(clipper->GetOutput());
+        clipFilter->SetInputConnection(port);
+        SectionClipper::assign(clipPlanes, clipSpec);
+        last = clipFilter;
+        port = clipFilter->GetOutputPort();
+    }
+
+    currentFilter = last;
+}
+
+// --------------------------------------- Background Filtering ---------------------------------------
+/**
+ * @brief Installs the function that runs filter updates in the background.
+ * @param scheduler Receives each part whose filter settings changed.
+ */
+
+// Sets the scheduler shared by all parts
+void ModelPart::setFilterScheduler(std::function<void(ModelPart*)> scheduler)
+{
+    filterScheduler = std::move(scheduler);
+}
+
+/**
+ * @brief Hands the pipeline to a background job.
+ * @param cancel Flag the stages poll while they execute.
+ * @return Stage to execute, or nullptr if a job is running or nothing is loaded.
+ *
+ * The mapper is switched to a shallow copy of its current input first, so rendering
+ * never pulls on the pipeline while the worker executes it.
+ */
+
+// Detaches the mapper and wires the stages for a job
+vtkSmartPointer<vtkAlgorithm> ModelPart::beginFilterJob(const FilterCancel& cancel)
+{
+    if (filterJobRunning || !originalData || !mapper || !sourceStage)
+        return nullptr;
+
+    if (!shownOutput) {
+        shownOutput = vtkSmartPointer<vtkPolyData>::New();
+        if (vtkPolyData* current = mapper->GetInput())
+            shownOutput->ShallowCopy(current);
+        mapper->SetInputData(shownOutput);
+    }
+
+    filterCancel = cancel;
+    cancelCallback->SetClientData(cancel.get());
+
+    wireFilters();
+    jobClearsSection = clearSectionOnUpdate;
+    clearSectionOnUpdate = false;
+    filterJobRunning = true;
+
+    // With every stage off the worker only touches the private view, never the shared mesh
+    return currentFilter == sourceStage ? static_cast<vtkAlgorithm*>(filterSource.Get()) : currentFilter.Get();
+}
+
+/**
+ * @brief Executes a job's stages. Runs on the thread pool.
+ * @param stage  Last stage of the pipeline.
+ * @param cancel Set by the GUI thread to abort.
+ * @return Shallow copy of the output, or nullptr if the job was cancelled.
+ */
+
+// Pipeline update off the GUI thread
+vtkSmartPointer<vtkPolyData> ModelPart::runFilterJob(vtkSmartPointer<vtkAlgorithm> stage, FilterCancel cancel)
+{
+    if (!stage || cancel->load())
+        return nullptr;
+
+    stage->Update();
+    if (cancel->load())
+        return nullptr;
+
+    vtkPolyData* output = vtkPolyData::SafeDownCast(stage->GetOutputDataObject(0));
+    if (!output)
+        return nullptr;
+
+    auto snapshot = vtkSmartPointer<vtkPolyData>::New();
+    snapshot->ShallowCopy(output);
+    return snapshot;
+}
+
+/**
+ * @brief Shows a job's result and returns the pipeline to the GUI thread.
+ * @param output Job result; nullptr leaves the previous geometry on screen.
+ *
+ * Aborted stages hold partial output that VTK considers up to date, so they are
+ * marked modified to execute again on the next job.
+ */
+
+// Swaps the mapper input in one step
+void ModelPart::finishFilterJob(vtkSmartPointer<vtkPolyData> output)
+{
+    filterJobRunning = false;
+    cancelCallback->SetClientData(nullptr);
+
+    if (!output) {
+        for (vtkAlgorithm* stage : { static_cast<vtkAlgorithm*>(originalNormalsFilter.Get()),
+                                     static_cast<vtkAlgorithm*>(shrinkFilter.Get()),
+                                     static_cast<vtkAlgorithm*>(clipFilter.Get()) }) {
+            if (stage && stage->GetAbortExecute()) {
+                stage->SetAbortExecute(0);
+                stage->Modified();
+            }
+        }
+        clearSectionOnUpdate = clearSectionOnUpdate || jobClearsSection;
+        jobClearsSection = false;
+        return;
     }
 
-    mapper->SetInputData(processedData);
-    mapper->Update();
+    // Unfiltered parts go back to drawing the shared mesh (instancing and edges key on it)
+    if (currentFilter == sourceStage) {
+        shownOutput = nullptr;
+        mapper->SetInputConnection(sourceStage->GetOutputPort());
+    }
+    else {
+        shownOutput = output;
+        mapper->SetInputData(output);
+    }
     if (actor) actor->SetMapper(mapper);
+    applyGpuShrink();
+
+    if (jobClearsSection)
+        sectionPlanes.clear();
+    jobClearsSection = false;
+}
+
+/**
+ * @brief Checks for a running background job.
+ */
+
+// True while a job owns the pipeline
+bool ModelPart::isFilterJobRunning() const
+{
+    return filterJobRunning;
+}
+
+/**
+ * @brief Aborts the reporting stage once its job's cancel flag is set.
+ * @param caller     Stage reporting progress.
+ * @param eventId    ProgressEvent.
+ * @param clientData The job's std::atomic<bool> cancel flag (nullptr outside jobs).
+ */
+
+// Cancels a running stage (job thread)
+void ModelPart::onFilterProgress(vtkObject* caller, unsigned long /*eventId*/, void* clientData, void* /*callData*/)
+{
+    auto* cancel = static_cast<std::atomic<bool>*>(clientData);
+    if (cancel && cancel->load())
+        static_cast<vtkAlgorithm*>(caller)->SetAbortExecute(1);
 }
 
 // --------------------------------------- Filter Status ---------------------------------------
@@ -466,3 +1246,282 @@ bool ModelPart::isClipFilterEnabled() const {
 bool ModelPart::isShrinkFilterEnabled() const {
     return shrinkEnabled;
 }
+
+/**
+ * @brief Returns the clip planes.
+ */
+
+// Clip planes in model coordinates
+const SectionPlaneList& ModelPart::getClipPlanes() const
+{
+    return clipSpec;
+}
+
+/**
+ * @brief Returns the shrink factor.
+ */
+
+// Shrink factor
+double ModelPart::getShrinkFactor() const
+{
+    return shrinkFactor;
+}
+
+/**
+ * @brief Sets clip and shrink together.
+ * @param clip       True to enable the capped clip.
+ * @param clipPlanes Clip planes; the current ones are kept if empty.
+ * @param shrink     True to enable shrinking.
+ * @param factor     Shrink factor.
+ */
+
+// One updateFilters() for both settings (a no-op until the part has geometry)
+void ModelPart::setFilterSettings(bool clip, const SectionPlaneList& clipPlanes, bool shrink, double factor)
+{
+    clipEnabled = clip;
+    if (!clipPlanes.isEmpty())
+        clipSpec = clipPlanes;
+    shrinkEnabled = shrink;
+    shrinkFactor = factor;
+    updateFilters();
+}
+
+// --------------------------------------- GPU Effects ---------------------------------------
+/**
+ * @brief Chooses where every part's shrink effect runs.
+ * @param enabled True for the geometry shader.
+ */
+
+// Sets the backend flag read by wireFilters() and applyShrinkFilter()
+void ModelPart::setGpuEffects(bool enabled)
+{
+    gpuEffects = enabled;
+}
+
+/**
+ * @brief Returns true if shrinking runs in a geometry shader.
+ */
+
+// Current backend
+bool ModelPart::gpuEffectsEnabled()
+{
+    return gpuEffects;
+}
+
+/**
+ * @brief Returns true if the part is shrunk by the shader.
+ */
+
+// Shrink on and the GPU backend selected
+bool ModelPart::isShrinkOnGpu() const
+{
+    return shrinkEnabled && gpuEffects;
+}
+
+/**
+ * @brief Installs or removes the actor's shrink shader.
+ *
+ * Called whenever the mapper input changes, so the pipeline's own shrink stage and
+ * the shader never both apply: after a backend switch the shader only goes on once
+ * the unshrunk geometry is shown.
+ */
+
+// Shader factor follows shrinkFactor while isShrinkOnGpu()
+void ModelPart::applyGpuShrink()
+{
+    if (actor)
+        GpuEffects::setShrink(actor, isShrinkOnGpu() ? shrinkFactor : 1.0);
+}
+
+/**
+ * @brief Moves the part by a world-space offset.
+ * @param offset Offset in world coordinates.
+ */
+
+// Stores the offset and repositions the actor under its current user matrix
+void ModelPart::setExplodeOffset(const double offset[3])
+{
+    for (int i = 0; i < 3; ++i)
+        explodeOffset[i] = offset[i];
+
+    if (actor)
+        GpuEffects::setWorldOffset(actor, actor->GetUserMatrix(), explodeOffset);
+}
+
+/**
+ * @brief Returns the explode offset.
+ */
+
+// Copies the offset out
+void ModelPart::getExplodeOffset(double offset[3]) const
+{
+    for (int i = 0; i < 3; ++i)
+        offset[i] = explodeOffset[i];
+}
+
+/**
+ * @brief Returns the world transform followed by the explode offset.
+ */
+
+// T(explodeOffset) * world, or nullptr when both are identity
+vtkSmartPointer<vtkMatrix4x4> ModelPart::getDisplayTransform() const
+{
+    vtkSmartPointer<vtkMatrix4x4> world = getWorldTransform();
+    if (explodeOffset[0] == 0.0 && explodeOffset[1] == 0.0 && explodeOffset[2] == 0.0)
+        return world;
+
+    auto display = vtkSmartPointer<vtkMatrix4x4>::New();
+    if (world)
+        display->DeepCopy(world);
+    for (int i = 0; i < 3; ++i)
+        display->SetElement(i, 3, display->GetElement(i, 3) + explodeOffset[i]);
+    return display;
+}
+
+// --------------------------------------- Memory Management ---------------------------------------
+/**
+ * @brief Lists the meshes held by the part.
+ * @param meshes Receives the loaded mesh, stage outputs, shown output and LOD meshes.
+ *
+ * Stage outputs are skipped while a background job writes them.
+ */
+
+// Collects resident meshes for MemoryBudget
+void ModelPart::collectResidentMeshes(QVector<vtkPolyData*>& meshes) const
+{
+    if (originalData)
+        meshes << originalData;
+    if (shownOutput)
+        meshes << shownOutput;
+
+    if (!filterJobRunning) {
+        for (vtkAlgorithm* stage : { static_cast<vtkAlgorithm*>(originalNormalsFilter.Get()),
+                                     static_cast<vtkAlgorithm*>(shrinkFilter.Get()),
+                                     static_cast<vtkAlgorithm*>(clipFilter.Get()) }) {
+            if (vtkPolyData* output = stage ? vtkPolyData::SafeDownCast(stage->GetOutputDataObject(0)) : nullptr)
+                meshes << output;
+        }
+    }
+
+    for (const vtkSmartPointer<vtkPolyData>& level : lodData)
+        meshes << level;
+}
+
+/**
+ * @brief Estimates the GPU buffers of the part's mappers.
+ * @return Bytes for float positions and normals plus 32-bit triangle indices.
+ *
+ * An upper bound: LOD buffers are only created once a level has been drawn. The VR
+ * copies live in the VR context and are assumed to match the desktop ones.
+ */
+
+// Vertex and index bytes per mapper input
+qint64 ModelPart::estimateGpuBytes() const
+{
+    auto meshBytes = [](vtkPolyData* mesh) -> qint64 {
+        if (!mesh)
+            return 0;
+        return qint64(mesh->GetNumberOfPoints()) * qint64(6 * sizeof(float))
+            + qint64(mesh->GetNumberOfCells()) * qint64(3 * sizeof(quint32));
+    };
+
+    qint64 bytes = mapper ? meshBytes(mapper->GetInput()) : 0;
+    for (const vtkSmartPointer<vtkPolyData>& level : lodData)
+        bytes += meshBytes(level);
+
+    return vrActor ? 2 * bytes : bytes;
+}
+
+/**
+ * @brief Releases the outputs of disabled shrink and clip stages.
+ */
+
+// Frees copies kept for re-enabling a filter
+void ModelPart::releaseBypassedOutputs()
+{
+    if (filterJobRunning)
+        return;
+
+    if (!shrinkEnabled && shrinkFilter && shrinkFilter->GetOutputDataObject(0))
+        shrinkFilter->GetOutputDataObject(0)->ReleaseData();
+    if (!clipEnabled && clipFilter && clipFilter->GetOutputDataObject(0))
+        clipFilter->GetOutputDataObject(0)->ReleaseData();
+}
+
+/**
+ * @brief Replaces the part's geometry by an empty mesh with the same bounds.
+ * @return True if the part was evicted.
+ *
+ * The placeholder holds the eight corners of the bounding box and no cells, so the
+ * actor keeps its bounds (for culling and framing) but draws nothing. Arrays still
+ * used elsewhere (a twin part, the VR thread) are freed once those let go as well.
+ */
+
+// Drops originalData, the stage outputs and the LOD meshes
+bool ModelPart::evictGeometry()
+{
+    if (!originalData || !actor || !mapper || !sourceStage || sourceFile.isEmpty() || filterJobRunning)
+        return false;
+
+    double bounds[6];
+    mapper->GetBounds(bounds);
+
+    auto placeholder = vtkSmartPointer<vtkPolyData>::New();
+    if (bounds[0] <= bounds[1]) {
+        auto corners = vtkSmartPointer<vtkPoints>::New();
+        for (int i = 0; i < 8; ++i)
+            corners->InsertNextPoint(bounds[i & 1], bounds[2 + ((i >> 1) & 1)], bounds[4 + ((i >> 2) & 1)]);
+        placeholder->SetPoints(corners);
+    }
+
+    shownOutput = placeholder;
+    mapper->SetInputData(placeholder);
+    actor->SetMapper(mapper);
+
+    for (vtkAlgorithm* stage : { static_cast<vtkAlgorithm*>(originalNormalsFilter.Get()),
+                                 static_cast<vtkAlgorithm*>(shrinkFilter.Get()),
+                                 static_cast<vtkAlgorithm*>(clipFilter.Get()) }) {
+        if (stage && stage->GetOutputDataObject(0))
+            stage->GetOutputDataObject(0)->ReleaseData();
+    }
+
+    sourceStage->SetOutput(vtkSmartPointer<vtkPolyData>::New());
+    filterSource->SetOutput(vtkSmartPointer<vtkPolyData>::New());
+    originalData = nullptr;
+    setLODs(QVector<vtkSmartPointer<vtkPolyData>>());
+    geometryEvicted = true;
+    return true;
+}
+
+/**
+ * @brief Rebuilds the pipeline of an evicted part around new geometry.
+ * @param polyData Reloaded mesh.
+ * @param levels   Reloaded LOD meshes.
+ *
+ * The placeholder stays on screen until updateFilters() shows the filtered result.
+ */
+
+// Reattaches geometry to the existing actor
+void ModelPart::restoreGeometry(vtkSmartPointer<vtkPolyData> polyData, const QVector<vtkSmartPointer<vtkPolyData>>& levels)
+{
+    if (!polyData || !geometryEvicted || !sourceStage)
+        return;
+
+    originalData = polyData;
+    sourceStage->SetOutput(originalData);
+    filterSource->SetOutput(privateView(originalData));
+    setupNormalsStage();
+    setLODs(levels);
+    geometryEvicted = false;
+    updateFilters();
+}
+
+/**
+ * @brief Returns true while the geometry is evicted.
+ */
+
+// True while only the placeholder is shown
+bool ModelPart::isGeometryEvicted() const
+{
+    return geometryEvicted;
+}
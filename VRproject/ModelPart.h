@@ -16,20 +16,32 @@
 #include <QVariant>       // For storing heterogeneous tree data
 #include <QColor>         // For storing/displaying part color
 #include <QBrush>         // For use with Qt display roles (e.g., tree view background)
+#include <QVector>        // For level-of-detail meshes and mappers
 
 // --------------------------------------- VTK Headers ---------------------------------------
 
 #include <vtkSmartPointer.h>      // Smart pointer wrapper for VTK objects
-#include <vtkSTLReader.h>         // Reads .stl mesh files
 #include <vtkPolyDataMapper.h>    // Maps polygonal data to graphics primitives
 #include <vtkActor.h>             // Represents an object in the scene
 #include <vtkAlgorithm.h>         // Base class for all VTK pipeline components
-#include <vtkClipDataSet.h>       // Clips mesh geometry with a plane
-#include <vtkShrinkFilter.h>      // Shrinks cells in the mesh
+#include <vtkClipClosedSurface.h> // Clips closed meshes with a plane and caps the cut
+#include <vtkShrinkPolyData.h>    // Shrinks cells in the mesh
 #include <vtkPlane.h>             // Defines clipping planes
+#include <vtkPlaneCollection.h>   // Holds the clip planes
 #include <vtkPolyData.h>          // Stores polygonal mesh data
 #include <vtkGeometryFilter.h>    // Converts non-poly data to polygonal form
 #include <vtkPolyDataNormals.h>   // Computes surface normals for shading
+#include <vtkTrivialProducer.h>   // Feeds loaded polydata into the pipeline
+#include <vtkMatrix4x4.h>         // Sub-assembly transforms
+#include <vtkCallbackCommand.h>   // Cancels background filter jobs
+
+// --------------------------------------- Standard Headers ---------------------------------------
+
+#include <atomic>       // Cancel flags shared with filter jobs
+#include <functional>   // Background filter scheduler
+#include <memory>       // Shared cancel flags
+
+#include "SectionClipper.h"       // Section plane lists
 
 /**
  * @class ModelPart
@@ -119,6 +131,59 @@ public:
     // Removes the child at the specified row
     void removeChild(int row);
 
+    /**
+     * @brief Removes a contiguous range of children (not deleted).
+     * @param row   First row to remove.
+     * @param count Number of rows.
+     *
+     * Renumbers the remaining siblings once, so removing many rows stays linear.
+     */
+
+    // Removes several children at once
+    void removeChildren(int row, int count);
+
+    /**
+     * @brief Returns how many children have been exposed to the tree model.
+     *
+     * Children beyond this count exist but have not been fetched by the view yet
+     * (see ModelPartList::canFetchMore()).
+     */
+
+    // Returns the number of children visible to the model
+    int fetchedChildCount() const;
+
+    /**
+     * @brief Records how many children are exposed to the tree model.
+     * @param count New fetched count (clamped to childCount()).
+     */
+
+    // Sets the number of children visible to the model
+    void setFetchedChildCount(int count);
+
+    /**
+     * @brief Returns true once the view has asked for this node's children.
+     */
+
+    // Returns true if children have been fetched at least once
+    bool childrenRequested() const;
+
+    /**
+     * @brief Marks this node's children as requested by the view.
+     *
+     * From then on new children are inserted into the view as soon as they are added,
+     * provided all earlier children have been fetched.
+     */
+
+    // Sets the fetch flag
+    void markChildrenRequested();
+
+    /**
+     * @brief Returns true if this node groups other parts instead of holding geometry.
+     */
+
+    // Returns true for sub-assemblies (children but no mesh)
+    bool isAssembly() const;
+
     ///@}
 
     /// @name Data Handling
@@ -144,6 +209,17 @@ public:
     // Sets the value for a specific column
     void set(int column, const QVariant& value);
 
+    /**
+     * @brief Returns the roles whose data changed since the last call, and forgets them.
+     * @return Roles to pass to QAbstractItemModel::dataChanged(); empty if nothing shown changed.
+     *
+     * set() and setColor() record what they changed, so the model can tell views to
+     * repaint only those roles, or nothing at all after a geometry-only change.
+     */
+
+    // Reads and clears the changed-role bits
+    QList<int> takeChangedRoles();
+
     /**
      * @brief Sets the display name of this part (column 0).
      * @param newName New name string.
@@ -152,6 +228,57 @@ public:
     // Sets the display name of this part (column 0)
     void setName(const QString& newName);
 
+    /**
+     * @brief Sets the file this part was loaded from.
+     * @param fileName Full path (empty for sub-assemblies and generated parts).
+     */
+
+    // Records the source file path
+    void setSourceFile(const QString& fileName);
+
+    /**
+     * @brief Returns the file this part was loaded from, or an empty string.
+     */
+
+    // Returns the source file path
+    QString getSourceFile() const;
+
+    // --------------------------------------- Assembly Transforms ---------------------------------------
+
+    /**
+     * @brief Sets this node's transform relative to its parent.
+     * @param matrix Local transform (copied); nullptr resets it to identity.
+     *
+     * Updates the world transform of the on-screen actors in this subtree.
+     * VR actors are owned by the VR thread and must be updated with
+     * VRRenderThread::setActorTransform() using getWorldTransform().
+     */
+
+    // Sets the transform relative to the parent node
+    void setLocalTransform(vtkMatrix4x4* matrix);
+
+    /**
+     * @brief Returns this node's transform relative to its parent, or nullptr for identity.
+     */
+
+    // Returns the local transform
+    vtkMatrix4x4* getLocalTransform() const;
+
+    /**
+     * @brief Returns the product of all local transforms from the root down to this node.
+     * @return World transform, or nullptr if every transform on the path is identity.
+     */
+
+    // Returns the accumulated parent-to-world transform
+    vtkSmartPointer<vtkMatrix4x4> getWorldTransform() const;
+
+    /**
+     * @brief Reapplies the world transform to this node's actor and all descendants.
+     */
+
+    // Pushes world transforms down the subtree
+    void updateWorldTransform();
+
     // --------------------------------------- Visual Properties ---------------------------------------
      
     ///@}
@@ -222,13 +349,56 @@ public:
     vtkAlgorithmOutput* getOutputPort() const;
 
     /**
-     * @brief Creates and returns a separate actor for VR rendering.
-     * @return Smart pointer to a new vtkActor configured like the on-screen actor.
+     * @brief Returns the cached actor used for VR rendering.
+     * @return Smart pointer to the VR actor, created on first call, or nullptr if no mesh is loaded.
+     *
+     * The VR actor has its own mapper (GPU buffers belong to one OpenGL context) fed by a
+     * shallow snapshot of the filtered output, so no mesh data is copied. Once handed to
+     * VRRenderThread it is owned by the VR thread; later changes go through its command queue.
      */
 
-    // Returns a separate actor for VR rendering
+    // Returns the cached actor for VR rendering
     vtkSmartPointer<vtkActor> getVRActor();
 
+    /**
+     * @brief Returns true once getVRActor() has created the VR actor.
+     */
+
+    // Checks for a VR actor without creating one
+    bool hasVRActor() const;
+
+    /**
+     * @brief Brings the filter pipeline up to date and returns a shallow copy of its output.
+     * @return Polydata sharing the output arrays, or nullptr if no mesh is loaded.
+     *
+     * Filters allocate fresh arrays each time they execute, so the snapshot stays valid
+     * (and unchanged) while other threads read it.
+     */
+
+    // Returns an immutable snapshot of the filtered geometry
+    vtkSmartPointer<vtkPolyData> getOutputSnapshot();
+
+    /**
+     * @brief Returns the unfiltered mesh given to setPolyData().
+     *
+     * Identical parts are given the same polydata, so it can be passed straight to
+     * setPolyData() of another copy.
+     */
+
+    // Returns the loaded mesh
+    vtkSmartPointer<vtkPolyData> getPolyData() const;
+
+    /**
+     * @brief Returns the mesh this part can be instanced with, or nullptr.
+     *
+     * Non-null only while the part renders its loaded mesh unmodified (no shrink or
+     * clip filter, no section planes and no normals stage), so every part returning the
+     * same pointer draws identical geometry.
+     */
+
+    // Returns the instancing key and glyph source
+    vtkPolyData* getSharedGeometry() const;
+
 
     // --------------------------------------- STL Loading ---------------------------------------
     ///@}
@@ -246,6 +416,83 @@ public:
         // Loads an STL file and sets up the rendering pipeline
     void loadSTL(QString fileName);
 
+    /**
+     * @brief Parses an STL file into polydata without touching any ModelPart.
+     * @param fileName Path to the STL file.
+     * @return The parsed mesh, or nullptr if the file is missing or empty.
+     *
+     * Only uses objects it creates itself, so it is safe to call from worker threads.
+     */
+
+    // Reads an STL file into polydata (thread-safe)
+    static vtkSmartPointer<vtkPolyData> readSTL(const QString& fileName);
+
+    /**
+     * @brief Computes point normals for a mesh without touching any ModelPart.
+     * @param polyData     Mesh returned by readSTL().
+     * @param featureEdges True to also store the feature edges (see MeshFeatures).
+     * @return Copy of the mesh with point normals, or nullptr if polyData is null.
+     *
+     * Safe to call from worker threads. setPolyData() skips its own normals stage
+     * for meshes that already have point normals.
+     */
+
+    // Computes point normals outside the pipeline (thread-safe)
+    static vtkSmartPointer<vtkPolyData> computeNormals(vtkSmartPointer<vtkPolyData> polyData,
+                                                       bool featureEdges = true);
+
+    /**
+     * @brief Builds the mapper and actor for geometry that has already been loaded.
+     * @param polyData Mesh returned by readSTL().
+     *
+     * Must be called on the GUI thread. If clip or shrink is already enabled and a
+     * filter scheduler is installed, the unfiltered mesh is shown until the scheduled
+     * job delivers the filtered one.
+     */
+
+    // Sets up the rendering pipeline for loaded polydata
+    void setPolyData(vtkSmartPointer<vtkPolyData> polyData);
+
+    // --------------------------------------- Level of Detail ---------------------------------------
+    ///@}
+
+    /// @name Level of Detail
+    ///@{
+    /**
+     * @brief Builds up to three decimated versions of a mesh without touching any ModelPart.
+     * @param polyData Full-resolution mesh (with normals).
+     * @return Coarser meshes with point normals, finest first; empty for small meshes.
+     *
+     * Safe to call from worker threads.
+     */
+
+    // Generates decimated LOD meshes (thread-safe)
+    static QVector<vtkSmartPointer<vtkPolyData>> generateLODs(vtkSmartPointer<vtkPolyData> polyData);
+
+    /**
+     * @brief Stores the decimated levels and builds on-screen mappers for them.
+     * @param levels Meshes from generateLODs() or the mesh cache.
+     */
+
+    // Sets the LOD meshes for this part
+    void setLODs(const QVector<vtkSmartPointer<vtkPolyData>>& levels);
+
+    /**
+     * @brief Returns the on-screen mapper chain for an LODSwitcher.
+     * @return Full-resolution mapper first, then the LOD mappers; empty while a
+     *         filter is active or no levels exist.
+     */
+
+    // Returns the desktop LOD mappers
+    QVector<vtkSmartPointer<vtkMapper>> getLODMappers() const;
+
+    /**
+     * @brief Returns the LOD meshes for the VR thread (empty when getLODMappers() is).
+     */
+
+    // Returns the LOD meshes for VR
+    QVector<vtkSmartPointer<vtkPolyData>> getLODData() const;
+
     // --------------------------------------- Filter Handling ---------------------------------------
    ///@}
 
@@ -287,72 +534,328 @@ public:
     bool isShrinkFilterEnabled() const;
 
     /**
-    * @brief Rebuilds the VTK pipeline based on current filter settings.
+     * @brief Returns the clip filter's planes (model coordinates), kept while clipping is off.
+     */
+
+    // Returns the clip planes
+    const SectionPlaneList& getClipPlanes() const;
+
+    /**
+     * @brief Returns the shrink factor, kept while shrinking is off.
+     */
+
+    // Returns the shrink factor
+    double getShrinkFactor() const;
+
+    /**
+     * @brief Sets both filters at once, e.g. from a saved session, with one pipeline update.
+     * @param clip         True to enable the capped clip.
+     * @param clipPlanes   Clip planes (model coordinates); ignored if empty.
+     * @param shrink       True to enable shrinking.
+     * @param factor       Shrink factor.
+     *
+     * May be called before the part has geometry; the settings then apply when it arrives.
+     */
+
+    // Restores clip and shrink settings
+    void setFilterSettings(bool clip, const SectionPlaneList& clipPlanes, bool shrink, double factor);
+
+    // --------------------------------------- GPU Effects ---------------------------------------
+
+    /**
+     * @brief Chooses where every part's shrink effect runs.
+     * @param enabled True to shrink in a geometry shader (see GpuEffects), false for vtkShrinkPolyData.
+     *
+     * Parts pick the new backend up with their next updateFilters(). On the GPU a new
+     * shrink factor only updates a shader uniform, so it can follow a slider.
+     */
+
+    // Switches the shrink backend for all parts
+    static void setGpuEffects(bool enabled);
+
+    /**
+     * @brief Returns true if shrinking runs in a geometry shader.
+     */
+
+    // Current shrink backend
+    static bool gpuEffectsEnabled();
+
+    /**
+     * @brief Returns true if the part is shrunk by the shader rather than by the pipeline.
+     *
+     * The VR actor must then be given the same shader (VRRenderThread::setActorShrink()),
+     * as its geometry snapshots are not shrunk.
+     */
+
+    // True while shrink is on and runs on the GPU
+    bool isShrinkOnGpu() const;
+
+    /**
+     * @brief Moves the part by a world-space offset, e.g. to explode an assembly.
+     * @param offset Offset in world coordinates; zero puts the part back.
+     *
+     * Kept through transform changes and applied as the actor's position, so only
+     * the actor matrix changes. The VR actor takes getDisplayTransform().
+     */
+
+    // Sets the explode offset of the on-screen actor
+    void setExplodeOffset(const double offset[3]);
+
+    /**
+     * @brief Returns the explode offset in world coordinates.
+     */
+
+    // Current explode offset
+    void getExplodeOffset(double offset[3]) const;
+
+    /**
+     * @brief Returns the world transform followed by the explode offset.
+     * @return Matrix to place the VR actor with, or nullptr if both are identity.
+     */
+
+    // World transform with the explode translation applied last
+    vtkSmartPointer<vtkMatrix4x4> getDisplayTransform() const;
+
+    /**
+     * @brief Replaces the part's GPU section planes.
+     * @param planes Planes in world coordinates (at most SectionClipper::MaxPlanes are used).
+     *
+     * Section planes do not touch the pipeline; a SectionClipper applies them to the
+     * part's actors, so they can be moved every frame.
+     */
+
+    // Sets the interactive section planes
+    void setSectionPlanes(const SectionPlaneList& planes);
+
+    /**
+     * @brief Returns the part's GPU section planes (world coordinates).
+     */
+
+    // Returns the interactive section planes
+    const SectionPlaneList& getSectionPlanes() const;
+
+    /**
+     * @brief Checks whether the part has its own section planes.
+     */
+
+    // Returns true while section planes are set
+    bool hasSectionPlanes() const;
+
+    /**
+     * @brief Turns the section planes into geometry with the exact closed-surface clip.
+     * @param scenePlanes Scene-wide planes (world coordinates) to bake in as well.
+     *
+     * The planes are moved into the part's model frame and given to the capped clip
+     * filter, replacing any earlier clip; the part's own section planes are then
+     * cleared. Use this when the cut mesh itself is needed, e.g. for export.
+     */
+
+    // Replaces the GPU section with a CPU-clipped, capped mesh
+    void bakeSectionPlanes(const SectionPlaneList& scenePlanes = SectionPlaneList());
+
+    /**
+    * @brief Reconnects the persistent VTK pipeline for the current filter settings.
+    *
+    * The chain source -> normals -> shrink -> clip -> mapper is built once in
+    * setPolyData(). Disabled stages are bypassed rather than destroyed, and only
+    * stages whose inputs or parameters changed re-execute on the next render.
     *
-    * Applies shrink and clip filters in sequence, updates the mapper,
-    * and reassigns it to the actor.
+    * With a filter scheduler installed the part is handed to it instead, and the
+    * pipeline executes as a background job (see beginFilterJob()).
     */
 
     // Updates the filter chain based on active filters
     void updateFilters();
 
-    // --------------------------------------- Original Data Backup ---------------------------------------
+    // --------------------------------------- Background Filtering ---------------------------------------
     ///@}
 
-    /// @name Original Data Backup
+    /// @name Background Filtering
     ///@{
     /**
-     * @brief Checks if original (unfiltered) polydata exists.
-     * @return True if original data is stored; false otherwise.
+     * @brief Flag a filter job polls; setting it aborts the running VTK filter.
      */
+    using FilterCancel = std::shared_ptr<std::atomic<bool>>;
+
+    /**
+     * @brief Installs the function that takes over updateFilters() for every part.
+     * @param scheduler Called on the GUI thread with the part whose settings changed;
+     *                  an empty function makes filtering synchronous again.
+     */
+
+    // Routes filter updates to a background runner
+    static void setFilterScheduler(std::function<void(ModelPart*)> scheduler);
+
+    /**
+     * @brief Prepares a background run of the pipeline for the current settings.
+     * @param cancel Flag that aborts the job once set.
+     * @return Last pipeline stage, to be passed to runFilterJob(); nullptr if a job is
+     *         already running or no mesh is loaded.
+     *
+     * The mapper is switched to a snapshot of what it shows now, so the geometry on
+     * screen stays put while the pipeline executes. Until finishFilterJob() the
+     * pipeline belongs to the job and must not be touched on the GUI thread.
+     */
+
+    // Starts a filter job (GUI thread)
+    vtkSmartPointer<vtkAlgorithm> beginFilterJob(const FilterCancel& cancel);
+
+    /**
+     * @brief Executes the pipeline up to a stage. Runs on a worker thread.
+     * @param stage  Stage returned by beginFilterJob().
+     * @param cancel The job's cancel flag.
+     * @return Snapshot of the stage's output, or nullptr if the job was cancelled.
+     */
+
+    // Runs a filter job (thread-safe)
+    static vtkSmartPointer<vtkPolyData> runFilterJob(vtkSmartPointer<vtkAlgorithm> stage, FilterCancel cancel);
+
+    /**
+     * @brief Shows the output of a finished job and gives the pipeline back.
+     * @param output Result of runFilterJob(); nullptr for a cancelled job, which keeps
+     *               the old geometry on screen.
+     */
+
+    // Swaps in a filter job's result (GUI thread)
+    void finishFilterJob(vtkSmartPointer<vtkPolyData> output);
+
+    /**
+     * @brief Returns true between beginFilterJob() and finishFilterJob().
+     */
+
+    // Checks for a running filter job
+    bool isFilterJobRunning() const;
+
+    // --------------------------------------- Memory Management ---------------------------------------
+    ///@}
+
+    /// @name Memory Management
+    ///@{
+    /**
+     * @brief Lists the meshes this part keeps in memory.
+     * @param meshes Receives the loaded mesh, cached stage outputs, the shown output and
+     *               the LOD meshes. Meshes share arrays, so callers count arrays, not meshes.
+     */
+
+    // Appends the resident meshes (see MemoryBudget)
+    void collectResidentMeshes(QVector<vtkPolyData*>& meshes) const;
+
+    /**
+     * @brief Estimates the GPU buffer bytes of the part's desktop and VR mappers.
+     * @return Vertex (position and normal) and index bytes of every mapper with input.
+     */
+
+    // Rough VBO/IBO size
+    qint64 estimateGpuBytes() const;
+
+    /**
+     * @brief Releases the outputs of pipeline stages that are bypassed.
+     *
+     * Turning a filter off keeps its output cached for a quick return; under memory
+     * pressure that copy is the first thing dropped.
+     */
+
+    // Drops cached outputs of disabled filters
+    void releaseBypassedOutputs();
+
+    /**
+     * @brief Drops the part's geometry, keeping its actor, settings and bounds.
+     * @return True if the geometry was evicted; parts without a source file, or with a
+     *         running filter job, keep theirs.
+     *
+     * The actor shows an empty mesh spanning the old bounds, so culling still sees the
+     * part and it can be reloaded once it comes into view.
+     */
+
+    // Evicts the meshes to the mesh cache
+    bool evictGeometry();
 
-    // Checks if original (unfiltered) polydata exists
-    bool hasOriginalData() const;
-    
     /**
-     * @brief Stores a deep copy of the current dataset as original data.
+     * @brief Gives an evicted part its geometry back.
+     * @param polyData Reloaded mesh (from the mesh cache, or shared with a twin part).
+     * @param levels   Reloaded LOD meshes.
+     *
+     * The pipeline is rebuilt around the existing actor with the part's current filter
+     * settings.
      */
 
-    // Stores the original polydata before any filtering
-    void storeOriginalData();
+    // Reloads evicted geometry
+    void restoreGeometry(vtkSmartPointer<vtkPolyData> polyData, const QVector<vtkSmartPointer<vtkPolyData>>& levels);
 
     /**
-     * @brief Retrieves the stored original polydata.
-     * @return Smart pointer to the vtkPolyData.
+     * @brief Returns true while the part's geometry is evicted.
      */
 
-    // Returns the original polydata
-    vtkSmartPointer<vtkPolyData> getOriginalPolyData() const;
+    // True between evictGeometry() and restoreGeometry()
+    bool isGeometryEvicted() const;
 
     ///@}
 
 private:
 
+    // Connects the enabled stages and sets currentFilter (mapper untouched)
+    void wireFilters();
+
+    // Creates the normals stage if originalData has no normals
+    void setupNormalsStage();
+
+    // Installs or removes the shrink shader on the on-screen actor to match the settings
+    void applyGpuShrink();
+
+    // Aborts a stage when its job's cancel flag is set (runs on the job's thread)
+    static void onFilterProgress(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+
     // --------------------------------------- Member Variables ---------------------------------------
 
     QList<ModelPart*>              m_childItems;     // List of children
     QList<QVariant>                m_itemData;       // Column data (e.g., name, visibility)
     ModelPart* m_parentItem;     // Parent in tree hierarchy
+    int                            m_row;            // Index under the parent (kept in sync by the parent)
+    int                            m_fetchedCount;   // Children exposed to the tree model
+    bool                           m_fetchRequested; // True once the view fetched children
+    quint8                         m_changedRoles;   // Roles changed since takeChangedRoles() (bit set)
+    QVariant                       m_background;     // Shared BackgroundRole value for partColor
+    QString                        sourceFile;       // File the mesh was loaded from
+    vtkSmartPointer<vtkMatrix4x4>  localTransform;   // Transform relative to parent (nullptr = identity)
     QColor                         partColor;        // Tree background color
     bool                           isVisible;        // Visibility state
 
     // VTK pipeline components
-    vtkSmartPointer<vtkSTLReader>         file;             // Reads STL file
     vtkSmartPointer<vtkPolyDataMapper>    mapper;           // Maps geometry to graphics primitives
     vtkSmartPointer<vtkActor>             actor;            // Represents object in scene
+    vtkSmartPointer<vtkPolyDataMapper>    vrMapper;         // VR mapper fed by pipeline output snapshots
+    vtkSmartPointer<vtkActor>             vrActor;          // Cached actor for the VR renderer
     vtkSmartPointer<vtkAlgorithm>         currentFilter;    // Most recent filter in pipeline
 
     vtkSmartPointer<vtkPolyData>          originalData;     // Cached original mesh
-    vtkSmartPointer<vtkPolyDataNormals>   originalNormalsFilter; // Computes normals
+    vtkSmartPointer<vtkTrivialProducer>   sourceStage;      // Pipeline source for originalData
+    vtkSmartPointer<vtkTrivialProducer>   filterSource;     // Private view of originalData feeding the filter stages
+    vtkSmartPointer<vtkPolyDataNormals>   originalNormalsFilter; // Computes normals (null if the mesh has them)
+
+    vtkSmartPointer<vtkShrinkPolyData>    shrinkFilter;     // Shrink filter
+    vtkSmartPointer<vtkClipClosedSurface> clipFilter;       // Clip filter (capped)
+    vtkSmartPointer<vtkPlaneCollection>   clipPlanes;       // Planes used by clipFilter
 
-    vtkSmartPointer<vtkClipDataSet>       clipFilter;       // Clip filter
-    vtkSmartPointer<vtkShrinkFilter>      shrinkFilter;     // Shrink filter
+    QVector<vtkSmartPointer<vtkPolyData>>       lodData;    // Decimated meshes, finest first
+    QVector<vtkSmartPointer<vtkPolyDataMapper>> lodMappers; // On-screen mappers for lodData
 
     bool  clipEnabled;                                      // True if clip is active
     bool  shrinkEnabled;                                    // True if shrink is active
     double shrinkFactor;                                    // Shrink intensity
-    double clipOrigin[3];                                   // Plane origin for clip
-    double clipNormal[3];                                   // Plane normal for clip
+    SectionPlaneList clipSpec;                              // Planes for clip (model coordinates)
+    SectionPlaneList sectionPlanes;                         // GPU section planes (world coordinates)
+    bool  clearSectionOnUpdate;                             // Baked section planes are dropped once the clip shows
+    double explodeOffset[3];                                // Explode translation (world coordinates)
+
+    vtkSmartPointer<vtkPolyData>          shownOutput;      // Mapper input while detached from the pipeline (nullptr: connected)
+    vtkSmartPointer<vtkCallbackCommand>   cancelCallback;   // ProgressEvent observer of the stages
+    FilterCancel                          filterCancel;     // Cancel flag of the current/last job
+    bool  filterJobRunning;                                 // True while a job owns the pipeline
+    bool  jobClearsSection;                                 // The running job bakes the section planes
+    bool  geometryEvicted;                                  // Geometry dropped by the memory budget
+
+    static std::function<void(ModelPart*)> filterScheduler; // Takes over updateFilters() when set
+    static bool gpuEffects;                                 // Shrink runs in a geometry shader
 };
 
 #endif // VIEWER_MODELPART_H
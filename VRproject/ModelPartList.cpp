@@ -9,6 +9,88 @@
 #include "ModelPartList.h"
 #include "ModelPart.h"
 
+#include <QFile>
+#include <QSet>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+// --------------------------------------- Helpers ---------------------------------------
+
+namespace {
+
+// Multipliers of the 64-bit content hash (the xxHash64 primes)
+const uint64_t HashPrime1 = 0x9E3779B185EBCA87ull;
+const uint64_t HashPrime2 = 0xC2B2AE3D27D4EB4Full;
+const uint64_t HashPrime3 = 0x165667B19E3779F9ull;
+
+// Rotates a 64-bit word left
+inline uint64_t rotl(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// Streams bytes into four independent lanes, so the multiplies of a 32-byte stripe overlap
+class ContentHash {
+public:
+    ContentHash() : lanes{ HashPrime1 + HashPrime2, HashPrime2, 0, 0 - HashPrime1 }, pending(0), total(0) {}
+
+    // Adds bytes; whole stripes go straight to the lanes, the rest waits for the next call
+    void add(const uchar* data, qint64 size)
+    {
+        total += uint64_t(size);
+        if (pending > 0) {
+            const qint64 take = std::min<qint64>(size, StripeSize - pending);
+            std::memcpy(buffer + pending, data, size_t(take));
+            pending += int(take);
+            data += take;
+            size -= take;
+            if (pending < StripeSize)
+                return;
+            stripe(buffer);
+            pending = 0;
+        }
+        for (; size >= StripeSize; data += StripeSize, size -= StripeSize)
+            stripe(data);
+        std::memcpy(buffer, data, size_t(size));
+        pending = int(size);
+    }
+
+    // Folds the lanes and the trailing bytes into one value
+    uint64_t result() const
+    {
+        uint64_t h = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+        h ^= total * HashPrime3;
+        for (int i = 0; i < pending; ++i)
+            h = rotl(h ^ (buffer[i] * HashPrime3), 11) * HashPrime1;
+        h ^= h >> 33;
+        h *= HashPrime2;
+        h ^= h >> 29;
+        h *= HashPrime3;
+        return h ^ (h >> 32);
+    }
+
+private:
+    static const int StripeSize = 32;
+
+    void stripe(const uchar* data)
+    {
+        for (int lane = 0; lane < 4; ++lane) {
+            const uint64_t word = qFromLittleEndian<quint64>(data + lane * 8);
+            lanes[lane] = rotl(lanes[lane] + word * HashPrime2, 31) * HashPrime1;
+        }
+    }
+
+    uint64_t lanes[4];
+    uchar buffer[StripeSize];
+    int pending;
+    uint64_t total;
+};
+
+} // namespace
+
 // --------------------------------------- Constructor & Destructor ---------------------------------------
 
 // Constructs the model with a root item (column headers)
@@ -17,6 +99,7 @@ ModelPartList::ModelPartList(const QString& data, QObject* parent)
 {
     // The root item stores headers for the columns ("Part", "Visible")
     rootItem = new ModelPart({ QString("Part"), QString("Visible") });
+    rootItem->markChildrenRequested();  // Top-level rows are shown as they are added
 }
 
 // Destructor: deletes the root item (which owns all children)
@@ -37,11 +120,11 @@ QVariant ModelPartList::data(const QModelIndex& index, int role) const {
     if (!index.isValid())
         return QVariant();
 
-    if (role != Qt::DisplayRole)
+    if (role != Qt::DisplayRole && role != Qt::BackgroundRole && role != Qt::ForegroundRole)
         return QVariant();
 
     ModelPart* item = static_cast<ModelPart*>(index.internalPointer());
-    return item->data(index.column());
+    return item->data(index.column(), role);
 }
 
 // Returns the item flags for the given index (read-only)
@@ -58,12 +141,12 @@ QVariant ModelPartList::headerData(int section, Qt::Orientation orientation, int
     return QVariant();
 }
 
-// Returns a QModelIndex pointing to a given row/column (child of root)
+// Returns a QModelIndex pointing to a given row/column under any parent
 QModelIndex ModelPartList::index(int row, int column, const QModelIndex& parent) const {
     if (!hasIndex(row, column, parent))
         return QModelIndex();
 
-    ModelPart* parentItem = rootItem; // Flat model: all items are children of root
+    ModelPart* parentItem = getItem(parent);
     ModelPart* childItem = parentItem->child(row);
     if (childItem)
         return createIndex(row, column, childItem);
@@ -71,9 +154,17 @@ QModelIndex ModelPartList::index(int row, int column, const QModelIndex& parent)
     return QModelIndex();
 }
 
-// Returns the parent of a given index  unused for flat model
-QModelIndex ModelPartList::parent(const QModelIndex& /*index*/) const {
-    return QModelIndex();  // Flat model: no parent
+// Returns the parent of a given index; rows are cached, so this is O(1)
+QModelIndex ModelPartList::parent(const QModelIndex& index) const {
+    if (!index.isValid())
+        return QModelIndex();
+
+    ModelPart* childItem = static_cast<ModelPart*>(index.internalPointer());
+    ModelPart* parentItem = childItem ? childItem->parentItem() : nullptr;
+    if (!parentItem || parentItem == rootItem)
+        return QModelIndex();
+
+    return createIndex(parentItem->row(), 0, parentItem);
 }
 
 // Returns the number of children under the given parent
@@ -87,7 +178,38 @@ int ModelPartList::rowCount(const QModelIndex& parent) const {
     else
         parentItem = static_cast<ModelPart*>(parent.internalPointer());
 
-    return parentItem->childCount();
+    return parentItem->fetchedChildCount();
+}
+
+// Reports children that exist but have not been fetched, so the view shows an expander
+bool ModelPartList::hasChildren(const QModelIndex& parent) const {
+    if (parent.column() > 0)
+        return false;
+    return getItem(parent)->childCount() > 0;
+}
+
+// True while some children are still hidden from the view
+bool ModelPartList::canFetchMore(const QModelIndex& parent) const {
+    if (parent.column() > 0)
+        return false;
+
+    ModelPart* parentItem = getItem(parent);
+    return parentItem->fetchedChildCount() < parentItem->childCount();
+}
+
+// Exposes up to FetchBatchSize more children of the parent
+void ModelPartList::fetchMore(const QModelIndex& parent) {
+    ModelPart* parentItem = getItem(parent);
+    parentItem->markChildrenRequested();
+
+    int first = parentItem->fetchedChildCount();
+    int last = std::min(parentItem->childCount(), first + FetchBatchSize) - 1;
+    if (last < first)
+        return;
+
+    beginInsertRows(parent, first, last);
+    parentItem->setFetchedChildCount(last + 1);
+    endInsertRows();
 }
 
 // --------------------------------------- Custom Functions ---------------------------------------
@@ -99,14 +221,63 @@ ModelPart* ModelPartList::getRootItem() {
 
 // Appends a new child to the root with given data
 QModelIndex ModelPartList::appendChild(const QList<QVariant>& data) {
-    int newRow = rootItem->childCount();
-    beginInsertRows(QModelIndex(), newRow, newRow);
+    return appendChild(QModelIndex(), data);
+}
 
-    ModelPart* childPart = new ModelPart(data, rootItem);
-    rootItem->appendChild(childPart);
+// Appends a new child under the part at the given index
+QModelIndex ModelPartList::appendChild(const QModelIndex& parent, const QList<QVariant>& data) {
+    return indexOf(appendPart(getItem(parent), data));
+}
 
-    endInsertRows();
-    return createIndex(newRow, 0, childPart);
+// Appends a new child under any part. The row is inserted into the view straight
+// away if the view knows the parent and either the parent has no children yet (so
+// it gets an expander) or all earlier children are fetched; otherwise the row
+// waits for fetchMore().
+ModelPart* ModelPartList::appendPart(ModelPart* parentItem, const QList<QVariant>& data) {
+    if (!parentItem)
+        parentItem = rootItem;
+
+    int newRow = parentItem->childCount();
+    ModelPart* childPart = new ModelPart(data, parentItem);
+
+    if (parentItem == rootItem) {
+        QString name = childPart->data(0).toString();
+        namesIndex.insert(name, childPart);
+        indexedNames.insert(childPart, name);
+    }
+
+    QModelIndex parent = indexOf(parentItem);
+    bool parentKnown = parentItem == rootItem || parent.isValid();
+    bool visible = parentKnown && (newRow == 0 ||
+        (parentItem->childrenRequested() && parentItem->fetchedChildCount() == newRow));
+
+    if (!visible) {
+        parentItem->appendChild(childPart);
+    }
+    else {
+        beginInsertRows(parent, newRow, newRow);
+        parentItem->appendChild(childPart);
+        parentItem->setFetchedChildCount(newRow + 1);
+        endInsertRows();
+    }
+
+    emit partAdded(childPart);
+    return childPart;
+}
+
+// Returns the index of a part if its row (and every ancestor's row) is fetched
+QModelIndex ModelPartList::indexOf(ModelPart* part) const {
+    if (!part || part == rootItem)
+        return QModelIndex();
+
+    ModelPart* parentItem = part->parentItem();
+    if (!parentItem || part->row() >= parentItem->fetchedChildCount())
+        return QModelIndex();
+
+    if (parentItem != rootItem && !indexOf(parentItem).isValid())
+        return QModelIndex();
+
+    return createIndex(part->row(), 0, part);
 }
 
 // Removes a single row (convenience function)
@@ -116,15 +287,69 @@ bool ModelPartList::removeRow(int row, const QModelIndex& parent) {
 
 // Removes one or more rows starting from `row` under the given parent
 bool ModelPartList::removeRows(int row, int count, const QModelIndex& parent) {
-    ModelPart* parentItem = getItem(parent);
-    if (!parentItem || row < 0 || row + count > parentItem->childCount())
+    return removeChildRange(getItem(parent), row, count);
+}
+
+// Removes many parts: nested selections collapse into their top-most part, and each
+// run of adjacent siblings goes in one range
+int ModelPartList::removeParts(const QList<ModelPart*>& parts) {
+    QSet<ModelPart*> selected(parts.begin(), parts.end());
+    selected.remove(nullptr);
+    selected.remove(rootItem);
+
+    QHash<ModelPart*, QVector<int>> rowsByParent;
+    for (ModelPart* part : selected) {
+        bool nested = false;
+        for (ModelPart* ancestor = part->parentItem(); ancestor && ancestor != rootItem && !nested; ancestor = ancestor->parentItem())
+            nested = selected.contains(ancestor);
+        if (!nested && part->parentItem())
+            rowsByParent[part->parentItem()] << part->row();
+    }
+
+    int removed = 0;
+    for (auto it = rowsByParent.begin(); it != rowsByParent.end(); ++it) {
+        QVector<int>& rows = it.value();
+        std::sort(rows.begin(), rows.end());
+
+        // Last run first, so the rows of the runs before it stay valid
+        int end = rows.size();
+        while (end > 0) {
+            int start = end - 1;
+            while (start > 0 && rows[start - 1] == rows[start] - 1)
+                --start;
+            if (removeChildRange(it.key(), rows[start], end - start))
+                removed += end - start;
+            end = start;
+        }
+    }
+    return removed;
+}
+
+// Removes `count` children of parentItem starting at `row`, with one row-removal notification
+bool ModelPartList::removeChildRange(ModelPart* parentItem, int row, int count) {
+    if (!parentItem || row < 0 || count <= 0 || row + count > parentItem->childCount())
         return false;
 
-    beginRemoveRows(parent, row, row + count - 1);
-    for (int i = 0; i < count; ++i) {
-        parentItem->removeChild(row);  // Always remove at same index
+    const QModelIndex parent = indexOf(parentItem);
+
+    // Scene listeners release the subtrees' actors while the parts still exist
+    QList<ModelPart*> removed;
+    for (int i = row; i < row + count; ++i) {
+        removed << parentItem->child(i);
+        emit partAboutToBeRemoved(parentItem->child(i));
+        unindex(parentItem->child(i));
     }
-    endRemoveRows();
+
+    // Rows beyond the fetched count are unknown to the view
+    int visibleCount = std::max(0, std::min(row + count, parentItem->fetchedChildCount()) - row);
+    if (visibleCount > 0)
+        beginRemoveRows(parent, row, row + visibleCount - 1);
+    parentItem->removeChildren(row, count);
+    if (visibleCount > 0)
+        endRemoveRows();
+
+    // removeChildren() only detaches the parts
+    qDeleteAll(removed);
     return true;
 }
 
@@ -137,3 +362,131 @@ ModelPart* ModelPartList::getItem(const QModelIndex& index) const {
     }
     return rootItem;
 }
+
+// --------------------------------------- Duplicate Detection ---------------------------------------
+
+// Renames a part, moving its name-index entry and notifying views
+void ModelPartList::setPartName(ModelPart* part, const QString& name) {
+    if (!part || part == rootItem)
+        return;
+
+    auto indexed = indexedNames.find(part);
+    if (indexed != indexedNames.end()) {
+        namesIndex.remove(indexed.value(), part);
+        namesIndex.insert(name, part);
+        indexed.value() = name;
+    }
+
+    part->setName(name);
+
+    const QList<int> roles = part->takeChangedRoles();
+    QModelIndex index = indexOf(part);
+    if (index.isValid() && !roles.isEmpty())
+        emit dataChanged(index, index, roles);
+}
+
+// Stores the source path and (re)indexes the fingerprint; computes it if not given
+void ModelPartList::setPartFile(ModelPart* part, const QString& fileName, const QByteArray& fingerprint) {
+    if (!part || part == rootItem)
+        return;
+
+    part->setSourceFile(fileName);
+
+    auto indexed = indexedContent.find(part);
+    if (indexed != indexedContent.end()) {
+        contentIndex.remove(indexed.value(), part);
+        indexedContent.erase(indexed);
+    }
+
+    QByteArray key = fingerprint.isEmpty() ? ModelPartList::fingerprint(fileName) : fingerprint;
+    if (key.isEmpty())
+        return;
+
+    contentIndex.insert(key, part);
+    indexedContent.insert(part, key);
+}
+
+// Looks up a top-level part by name
+ModelPart* ModelPartList::findTopLevelByName(const QString& name) const {
+    return namesIndex.value(name, nullptr);
+}
+
+// Looks up a part by content fingerprint
+ModelPart* ModelPartList::findByFingerprint(const QByteArray& fingerprint) const {
+    return fingerprint.isEmpty() ? nullptr : contentIndex.value(fingerprint, nullptr);
+}
+
+// Looks up all copies of a file; O(copies)
+QList<ModelPart*> ModelPartList::findAllByFingerprint(const QByteArray& fingerprint) const {
+    return fingerprint.isEmpty() ? QList<ModelPart*>() : contentIndex.values(fingerprint);
+}
+
+// Returns the part's indexed fingerprint
+QByteArray ModelPartList::fingerprintOf(ModelPart* part) const {
+    return indexedContent.value(part);
+}
+
+// Hashes every byte of the file, so equal keys mean equal content (a binary STL's size
+// only depends on its triangle count, and exporters write the same header). The file is
+// mapped where possible; the hash runs at memory bandwidth, well ahead of parsing.
+QByteArray ModelPartList::fingerprint(const QString& fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+
+    const qint64 size = file.size();
+    ContentHash hash;
+    if (uchar* mapped = size > 0 ? file.map(0, size) : nullptr) {
+        hash.add(mapped, size);
+        file.unmap(mapped);
+    }
+    else {
+        QByteArray chunk;
+        while (!(chunk = file.read(FingerprintChunkSize)).isEmpty())
+            hash.add(reinterpret_cast<const uchar*>(chunk.constData()), chunk.size());
+    }
+
+    QByteArray key(16, '\0');
+    qToLittleEndian<quint64>(quint64(size), reinterpret_cast<uchar*>(key.data()));
+    qToLittleEndian<quint64>(hash.result(), reinterpret_cast<uchar*>(key.data()) + 8);
+    return key;
+}
+
+// Drops index entries for a part and all of its descendants
+void ModelPartList::unindex(ModelPart* part) {
+    if (!part)
+        return;
+
+    auto name = indexedNames.find(part);
+    if (name != indexedNames.end()) {
+        namesIndex.remove(name.value(), part);
+        indexedNames.erase(name);
+    }
+
+    auto content = indexedContent.find(part);
+    if (content != indexedContent.end()) {
+        contentIndex.remove(content.value(), part);
+        indexedContent.erase(content);
+    }
+
+    for (int i = 0; i < part->childCount(); ++i)
+        unindex(part->child(i));
+}
+
+// --------------------------------------- Scene Change Notification ---------------------------------------
+
+// Repaints the roles of the part's row that changed (if any, and if the view has it) and tells scene listeners to re-sync it
+void ModelPartList::notifyPartChanged(ModelPart* part) {
+    if (!part || part == rootItem)
+        return;
+
+    // Geometry-only changes (filters, eviction) leave the row as it is
+    const QList<int> roles = part->takeChangedRoles();
+    if (!roles.isEmpty()) {
+        QModelIndex index = indexOf(part);
+        if (index.isValid())
+            emit dataChanged(index, index.siblingAtColumn(columnCount() - 1), roles);
+    }
+
+    emit partChanged(part);
+}
@@ -20,6 +20,9 @@
 #include <QVariant>            // Flexible container for different data types
 #include <QString>
 #include <QList>
+#include <QHash>               // Name and fingerprint indexes
+#include <QMultiHash>
+#include <QByteArray>          // Content fingerprints
 
 class ModelPart;  // Forward declaration
 
@@ -58,9 +61,18 @@ public:
     // Returns the parent index of a child (only used in nested models)
     QModelIndex parent(const QModelIndex& index) const override;
 
-    // Returns number of child items for a given parent
+    // Returns number of child items for a given parent (only rows fetched so far)
     int rowCount(const QModelIndex& parent = QModelIndex()) const override;
 
+    // Returns true if the parent has children, fetched or not
+    bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+
+    // Returns true if the parent has children not yet exposed to the view
+    bool canFetchMore(const QModelIndex& parent) const override;
+
+    // Exposes the next batch of unfetched children
+    void fetchMore(const QModelIndex& parent) override;
+
     // --------------------------------------- Custom API ---------------------------------------
 
     // Returns pointer to the root item
@@ -69,8 +81,15 @@ public:
     // Appends a child item directly under the root
     QModelIndex appendChild(const QList<QVariant>& data);
 
-    // Appends a child under a specified parent (unused in flat model)
-    QModelIndex appendChild(QModelIndex& parent, const QList<QVariant>& data);
+    // Appends a child under a specified parent (e.g. a sub-assembly); the index is
+    // invalid if the view has not fetched the new row yet
+    QModelIndex appendChild(const QModelIndex& parent, const QList<QVariant>& data);
+
+    // Appends a child under any part, including parts the view has not fetched
+    ModelPart* appendPart(ModelPart* parent, const QList<QVariant>& data);
+
+    // Returns the index of a part (invalid for the root or rows not fetched yet)
+    QModelIndex indexOf(ModelPart* part) const;
 
     // Removes multiple child rows under a parent
     bool removeRows(int row, int count, const QModelIndex& parent = QModelIndex()) override;
@@ -78,10 +97,69 @@ public:
     // Removes a single row under a parent
     bool removeRow(int row, const QModelIndex& parent = QModelIndex());
 
+    // Removes many parts at once (e.g. a selection) with one row range per run of
+    // adjacent siblings; returns the number of subtrees removed
+    int removeParts(const QList<ModelPart*>& parts);
+
     // Converts a QModelIndex into its corresponding ModelPart*
     ModelPart* getItem(const QModelIndex& index) const;
 
+    // --------------------------------------- Duplicate Detection ---------------------------------------
+
+    // Renames a part and keeps the name index in sync (use instead of ModelPart::setName)
+    void setPartName(ModelPart* part, const QString& name);
+
+    // Records the file a part was loaded from and indexes its content fingerprint
+    void setPartFile(ModelPart* part, const QString& fileName, const QByteArray& fingerprint = QByteArray());
+
+    // Returns a top-level part with the given name, or nullptr (O(1))
+    ModelPart* findTopLevelByName(const QString& name) const;
+
+    // Returns any part whose file has the given fingerprint, or nullptr (O(1))
+    ModelPart* findByFingerprint(const QByteArray& fingerprint) const;
+
+    // Returns every part whose file has the given fingerprint (identical copies)
+    QList<ModelPart*> findAllByFingerprint(const QByteArray& fingerprint) const;
+
+    // Returns the fingerprint a part is indexed under (empty if none)
+    QByteArray fingerprintOf(ModelPart* part) const;
+
+    // Computes a content fingerprint of a file (size plus a fast 64-bit hash of every byte)
+    static QByteArray fingerprint(const QString& fileName);
+
+    // --------------------------------------- Scene Change Notification ---------------------------------------
+
+    // Announces that a part's geometry, visibility, colour or filters changed
+    void notifyPartChanged(ModelPart* part);
+
+signals:
+    // Emitted after a part is appended anywhere in the tree (fetched by the view or not)
+    void partAdded(ModelPart* part);
+
+    // Emitted for each removed row before the subtree is deleted (once per subtree root)
+    void partAboutToBeRemoved(ModelPart* part);
+
+    // Emitted by notifyPartChanged()
+    void partChanged(ModelPart* part);
+
 private:
+    // Removes a subtree's entries from the name and fingerprint indexes
+    void unindex(ModelPart* part);
+
+    // Removes adjacent children of any part, fetched by the view or not
+    bool removeChildRange(ModelPart* parentItem, int row, int count);
+
+    // Children exposed per fetchMore() call
+    static const int FetchBatchSize = 256;
+
+    // Bytes hashed per read when a file cannot be memory-mapped
+    static const int FingerprintChunkSize = 1 << 20;
+
+    QMultiHash<QString, ModelPart*> namesIndex;         // Top-level parts by display name
+    QHash<ModelPart*, QString> indexedNames;            // Name each top-level part is indexed under
+    QMultiHash<QByteArray, ModelPart*> contentIndex;    // Parts by file fingerprint (any depth)
+    QHash<ModelPart*, QByteArray> indexedContent;       // Fingerprint each part is indexed under
+
     // Root of the tree (not shown in UI)
     ModelPart* rootItem;
 };
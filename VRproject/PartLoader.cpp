@@ -0,0 +1,199 @@
+/**
+ * @file PartLoader.cpp
+ * @brief Implementation of the background STL loading pipeline.
+ */
+
+#include "PartLoader.h"
+#include "ModelPart.h"
+#include "MeshCache.h"
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QtConcurrent>
+#include <QFileInfo>
+
+// --------------------------------------- Constructor & Destructor ---------------------------------------
+
+/**
+ * @brief Constructs the loader and connects the future watcher.
+ * @param parent Optional QObject parent.
+ */
+// Connects watcher signals to the GUI-side handlers
+PartLoader::PartLoader(QObject* parent)
+    : QObject(parent)
+    , completed(0)
+    , cancelled(false)
+{
+    connect(&watcher, &QFutureWatcher<Result>::resultReadyAt, this, &PartLoader::onResultReady);
+    connect(&watcher, &QFutureWatcher<Result>::finished, this, &PartLoader::onBatchFinished);
+}
+
+/**
+ * @brief Cancels any running batch and waits for the worker threads to return.
+ */
+// Cancels the batch, then waits for it and the cache rebuilds
+PartLoader::~PartLoader()
+{
+    pendingFiles.clear();
+    watcher.cancel();
+    watcher.waitForFinished();
+    cacheBuilds.waitForAll();
+}
+
+// --------------------------------------- Public Interface ---------------------------------------
+
+/**
+ * @brief Starts loading the files, or queues them behind the running batch.
+ * @param fileNames Full paths of the STL files to load.
+ */
+// Starts or queues a batch of files
+void PartLoader::load(const QStringList& fileNames)
+{
+    if (fileNames.isEmpty())
+        return;
+
+    if (isLoading()) {
+        pendingFiles << fileNames;
+        return;
+    }
+
+    startBatch(fileNames);
+}
+
+/**
+ * @brief Returns true while a batch is running.
+ */
+// Returns true while the watcher has work in flight
+bool PartLoader::isLoading() const
+{
+    return watcher.isRunning();
+}
+
+/**
+ * @brief Loads one STL file on the calling thread.
+ * @param fileName Full path of the STL file.
+ * @return Result holding the polydata with normals, or nullptr polydata on failure.
+ */
+// Runs on a worker thread: only touches objects it creates
+PartLoader::Result PartLoader::loadFile(const QString& fileName)
+{
+    Result result;
+    result.fileName = fileName;
+
+    MeshCache::Entry cached = MeshCache::load(fileName);
+    result.polyData = cached.mesh;
+    result.levels = cached.levels;
+    result.fromCache = result.polyData != nullptr;
+
+    if (!result.fromCache)
+        result.polyData = ModelPart::computeNormals(ModelPart::readSTL(fileName));
+
+    return result;
+}
+
+/**
+ * @brief Generates LOD levels for a freshly parsed mesh and stores everything in the mesh cache.
+ * @param fileName Full path of the STL file.
+ * @param polyData Parsed mesh with normals; only read.
+ * @return The generated levels.
+ */
+// Runs on a worker thread: decimation and cache writing stay off the GUI thread
+PartLoader::Levels PartLoader::buildCache(const QString& fileName, vtkSmartPointer<vtkPolyData> polyData)
+{
+    MeshCache::Entry entry;
+    entry.mesh = polyData;
+    entry.levels = ModelPart::generateLODs(polyData);
+    MeshCache::write(fileName, entry);
+    return entry.levels;
+}
+
+/**
+ * @brief Cancels the running batch and clears any pending files.
+ */
+// Stops scheduling further files; results already in flight are ignored
+void PartLoader::cancel()
+{
+    cancelled = true;
+    pendingFiles.clear();
+    watcher.cancel();
+}
+
+// --------------------------------------- Private Helpers ---------------------------------------
+
+/**
+ * @brief Starts a concurrent map of loadFile() over the batch.
+ * @param fileNames Files to load.
+ */
+// Schedules the batch on the global thread pool
+void PartLoader::startBatch(const QStringList& fileNames)
+{
+    currentBatch = fileNames;
+    completed = 0;
+    cancelled = false;
+
+    emit progressChanged(0, currentBatch.size(), QString());
+    watcher.setFuture(QtConcurrent::mapped(currentBatch, &PartLoader::loadFile));
+}
+
+/**
+ * @brief Forwards one finished file to the GUI (runs on the GUI thread).
+ * @param index Index of the result within the current batch.
+ */
+// Emits the loaded part and advances the progress count
+void PartLoader::onResultReady(int index)
+{
+    if (cancelled)
+        return;
+
+    Result result = watcher.resultAt(index);
+    ++completed;
+
+    if (result.polyData) {
+        // Missing or stale cache: rebuild it in the background; the part is shown meanwhile
+        if (!result.fromCache)
+            scheduleCacheBuild(result);
+        emit partLoaded(result.fileName, result.polyData);
+        if (!result.levels.isEmpty())
+            emit lodsReady(result.fileName, result.levels);
+    }
+    else {
+        emit partFailed(result.fileName);
+    }
+
+    emit progressChanged(completed, currentBatch.size(), QFileInfo(result.fileName).fileName());
+}
+
+/**
+ * @brief Runs buildCache() for a freshly parsed file on the thread pool.
+ * @param result Parsed result; its polydata is only read by the worker.
+ */
+// Starts a background cache rebuild and reports its LODs when done
+void PartLoader::scheduleCacheBuild(const Result& result)
+{
+    const QString fileName = result.fileName;
+
+    cacheBuilds.watch(this, QtConcurrent::run(&PartLoader::buildCache, fileName, result.polyData),
+                      [this, fileName](QFutureWatcher<Levels>* build) {
+        Levels levels = build->result();
+        if (!levels.isEmpty())
+            emit lodsReady(fileName, levels);
+    });
+}
+
+/**
+ * @brief Called when the concurrent map completes or is cancelled.
+ */
+// Starts the next queued batch or reports completion
+void PartLoader::onBatchFinished()
+{
+    // cancel() clears the pending list, so anything left was queued afterwards
+    if (!pendingFiles.isEmpty()) {
+        QStringList next = pendingFiles;
+        pendingFiles.clear();
+        startBatch(next);
+        return;
+    }
+
+    currentBatch.clear();
+    emit finished(cancelled);
+}
@@ -0,0 +1,173 @@
+/**
+ * @file PartLoader.h
+ * @brief Background STL loading pipeline for the model tree.
+ *
+ * Parses STL files on the global Qt thread pool and hands the finished
+ * polydata back to the GUI thread one part at a time, so the main window
+ * can add tree rows and actors while the rest of the batch is still loading.
+ */
+
+#ifndef PART_LOADER_H
+#define PART_LOADER_H
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QObject>          // Base class for signals/slots
+#include <QString>          // File paths
+#include <QStringList>      // Batches of file paths
+#include <QFutureWatcher>   // Tracks progress/results of the concurrent map
+#include <QVector>          // Level-of-detail meshes
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkSmartPointer.h>  // Smart pointer management for VTK
+#include <vtkPolyData.h>      // Loaded mesh data
+
+#include "TrackedWatchers.h"  // Outstanding cache builds
+
+// --------------------------------------- PartLoader Class ---------------------------------------
+/**
+ * @class PartLoader
+ * @brief Loads batches of STL files concurrently and reports each part as it completes.
+ *
+ * Only the parsing runs on worker threads. All signals are emitted on the thread
+ * that owns the PartLoader (the GUI thread), so receivers may touch the tree model
+ * and renderer directly.
+ */
+class PartLoader : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Decimated levels of detail of one part, finest first.
+     */
+    using Levels = QVector<vtkSmartPointer<vtkPolyData>>;
+
+    /**
+     * @brief Result of loading a single file on a worker thread.
+     */
+    struct Result {
+        QString fileName;                       // Full path of the source file
+        vtkSmartPointer<vtkPolyData> polyData;  // Parsed mesh, nullptr on failure
+        Levels levels;                          // LOD meshes (cache hits only)
+        bool fromCache = false;                 // True if polyData was mapped from the mesh cache
+    };
+
+    /**
+     * @brief Constructor.
+     * @param parent Optional QObject parent.
+     */
+    // Constructor: connects the internal future watcher
+    explicit PartLoader(QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor: cancels and waits for any batch or cache write still running.
+     */
+    // Destructor: cancels outstanding work
+    ~PartLoader();
+
+    /**
+     * @brief Queues a batch of files for loading.
+     * @param fileNames Full paths of the STL files to load.
+     *
+     * If a batch is already running the files are appended to a pending list and
+     * started as soon as the current batch finishes.
+     */
+    // Starts (or queues) loading of the given files
+    void load(const QStringList& fileNames);
+
+    /**
+     * @brief Returns true while a batch is being loaded.
+     */
+    // Returns true while loading is in progress
+    bool isLoading() const;
+
+    /**
+     * @brief Loads one STL file, preferring an up-to-date mesh cache. Safe to call from any thread.
+     * @param fileName Full path of the STL file.
+     * @return Result holding the polydata with normals (nullptr if the file failed to load).
+     *
+     * On a cache miss the STL is parsed and its normals computed here, on the worker.
+     */
+    // Worker function run on the thread pool
+    static Result loadFile(const QString& fileName);
+
+    /**
+     * @brief Generates the LOD levels of a parsed mesh and writes the mesh cache. Safe to call from any thread.
+     * @param fileName Full path of the STL file.
+     * @param polyData Mesh returned by loadFile().
+     * @return The generated levels (empty for small meshes).
+     */
+    // Background cache rebuild run on the thread pool
+    static Levels buildCache(const QString& fileName, vtkSmartPointer<vtkPolyData> polyData);
+
+public slots:
+    /**
+     * @brief Cancels the running batch and drops any pending files.
+     *
+     * Files already being parsed finish, but their results are discarded.
+     */
+    // Cancels the current batch
+    void cancel();
+
+signals:
+    /**
+     * @brief Emitted on the GUI thread each time a file has been parsed successfully.
+     * @param fileName Full path of the source file.
+     * @param polyData Parsed mesh ready to hand to ModelPart::setPolyData().
+     */
+    void partLoaded(const QString& fileName, vtkSmartPointer<vtkPolyData> polyData);
+
+    /**
+     * @brief Emitted when a file could not be parsed.
+     * @param fileName Full path of the source file.
+     */
+    void partFailed(const QString& fileName);
+
+    /**
+     * @brief Emitted when the LOD levels of a loaded part are available.
+     * @param fileName Full path of the source file.
+     * @param levels   Decimated meshes for ModelPart::setLODs().
+     *
+     * Comes straight after partLoaded() on a cache hit, or once the background
+     * cache rebuild has finished on a miss.
+     */
+    void lodsReady(const QString& fileName, const PartLoader::Levels& levels);
+
+    /**
+     * @brief Emitted when a file starts being tracked or finishes.
+     * @param done  Number of files completed in the current batch.
+     * @param total Number of files in the current batch.
+     * @param fileName Name of the most recently completed file (empty at batch start).
+     */
+    void progressChanged(int done, int total, const QString& fileName);
+
+    /**
+     * @brief Emitted once the batch (and any pending files) has finished or been cancelled.
+     * @param cancelled True if the batch was cancelled by the user.
+     */
+    void finished(bool cancelled);
+
+private slots:
+    // Forwards a single finished result to the GUI
+    void onResultReady(int index);
+
+    // Handles completion of the concurrent map
+    void onBatchFinished();
+
+private:
+    // Starts loading the given batch on the thread pool
+    void startBatch(const QStringList& fileNames);
+
+    // Rebuilds the mesh cache (with LODs) for a parsed file in the background
+    void scheduleCacheBuild(const Result& result);
+
+    QFutureWatcher<Result> watcher;   // Watches the QtConcurrent::mapped future
+    TrackedWatchers cacheBuilds;      // Mesh cache rebuilds still in flight (waited for on destruction)
+    QStringList currentBatch;         // Files in the running batch
+    QStringList pendingFiles;         // Files queued while a batch was running
+    int completed;                    // Number of files finished in the current batch
+    bool cancelled;                   // True once cancel() was requested
+};
+
+#endif // PART_LOADER_H
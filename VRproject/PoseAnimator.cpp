@@ -0,0 +1,276 @@
+/**
+ * @file PoseAnimator.cpp
+ * @brief Implementation of transform-only pose animation.
+ */
+
+#include "PoseAnimator.h"
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkMath.h>
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <algorithm>
+#include <cmath>
+
+// --------------------------------------- Limits ---------------------------------------
+
+namespace {
+
+// Longest step integrated at once, so a stalled frame does not make parts jump
+const double MaxStepSeconds = 0.1;
+
+} // namespace
+
+// --------------------------------------- Constructor ---------------------------------------
+
+/**
+ * @brief Constructs an animator with zero velocity.
+ */
+// Starts stationary
+PoseAnimator::PoseAnimator()
+{
+    std::fill(angularVelocity, angularVelocity + 3, 0.0);
+    std::fill(linearVelocity, linearVelocity + 3, 0.0);
+}
+
+// --------------------------------------- Registration ---------------------------------------
+
+/**
+ * @brief Registers an actor; its current user matrix becomes the base of an identity pose.
+ * @param actor Actor to animate.
+ */
+// Adds an actor without moving it
+void PoseAnimator::add(vtkActor* actor)
+{
+    if (!actor)
+        return;
+
+    auto it = indices.constFind(actor);
+    if (it != indices.constEnd() && bindings[it.value()].actor.Get() == actor)
+        return;
+    if (it != indices.constEnd())
+        removeAt(it.value());   // Stale entry of a destroyed actor at the same address
+
+    Pose pose = { { 1.0, 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 } };
+    poses.push_back(pose);
+
+    Binding binding;
+    binding.key = actor;
+    binding.actor = actor;
+    binding.matrix = vtkSmartPointer<vtkMatrix4x4>::New();
+    vtkMatrix4x4::Identity(binding.base);
+    bindings.push_back(binding);
+
+    Binding& added = bindings.back();
+    rebase(added);
+    added.matrix->DeepCopy(added.base);
+
+    indices.insert(actor, int(poses.size()) - 1);
+}
+
+/**
+ * @brief Unregisters an actor. Its user matrix keeps the last written pose.
+ * @param actor Animated actor.
+ */
+// Removes an actor
+void PoseAnimator::remove(vtkActor* actor)
+{
+    auto it = indices.constFind(actor);
+    if (it != indices.constEnd())
+        removeAt(it.value());
+}
+
+/**
+ * @brief Unregisters every actor.
+ */
+// Removes all actors
+void PoseAnimator::clear()
+{
+    poses.clear();
+    bindings.clear();
+    indices.clear();
+    moved.clear();
+}
+
+/**
+ * @brief Checks whether an actor is registered.
+ * @param actor Actor to look up.
+ * @return True if it is animated.
+ */
+// Registration check
+bool PoseAnimator::contains(vtkActor* actor) const
+{
+    auto it = indices.constFind(actor);
+    return it != indices.constEnd() && bindings[it.value()].actor.Get() == actor;
+}
+
+/**
+ * @brief Re-applies a registered actor's pose under its current user matrix.
+ * @param actor Animated actor.
+ */
+// Rebases and rewrites one pose
+void PoseAnimator::reapply(vtkActor* actor)
+{
+    auto it = indices.constFind(actor);
+    if (it == indices.constEnd() || bindings[it.value()].actor.Get() != actor)
+        return;
+
+    rebase(bindings[it.value()]);
+    write(it.value());
+}
+
+/**
+ * @brief Removes an entry while keeping the arrays dense.
+ * @param index Entry to remove.
+ */
+// Swap-with-last removal
+void PoseAnimator::removeAt(int index)
+{
+    const int last = int(poses.size()) - 1;
+
+    indices.remove(bindings[index].key);
+    if (index != last) {
+        poses[index] = poses[last];
+        bindings[index] = bindings[last];
+        indices.insert(bindings[index].key, index);
+    }
+    poses.pop_back();
+    bindings.pop_back();
+}
+
+// --------------------------------------- Velocity ---------------------------------------
+
+/**
+ * @brief Sets the spin shared by every actor.
+ * @param x,y,z Degrees per second around the part's X, Y and Z axes.
+ */
+// Stores the angular velocity
+void PoseAnimator::setAngularVelocity(double x, double y, double z)
+{
+    angularVelocity[0] = x;
+    angularVelocity[1] = y;
+    angularVelocity[2] = z;
+}
+
+/**
+ * @brief Sets the drift shared by every actor.
+ * @param x,y,z Model units per second along the part's axes.
+ */
+// Stores the linear velocity
+void PoseAnimator::setLinearVelocity(double x, double y, double z)
+{
+    linearVelocity[0] = x;
+    linearVelocity[1] = y;
+    linearVelocity[2] = z;
+}
+
+/**
+ * @brief Checks whether advancing would move anything.
+ * @return True if either velocity is non-zero.
+ */
+// True while the velocity is non-zero
+bool PoseAnimator::isMoving() const
+{
+    for (int i = 0; i < 3; ++i) {
+        if (angularVelocity[i] != 0.0 || linearVelocity[i] != 0.0)
+            return true;
+    }
+    return false;
+}
+
+// --------------------------------------- Integration ---------------------------------------
+
+/**
+ * @brief Advances every pose by the elapsed time and writes base * pose to each actor.
+ * @param seconds Time since the previous call.
+ * @return Actors that moved.
+ *
+ * The velocity is shared, so the rotation increment is computed once and each pose
+ * costs one quaternion product and one matrix product.
+ */
+// Integrates and writes all poses
+const QVector<vtkActor*>& PoseAnimator::advance(double seconds)
+{
+    moved.clear();
+
+    const double dt = std::min(seconds, MaxStepSeconds);
+    if (dt <= 0.0 || poses.empty() || !isMoving())
+        return moved;
+
+    // Rotation increment as a quaternion (body frame, like vtkProp3D::RotateX/Y/Z)
+    double axis[3] = { angularVelocity[0], angularVelocity[1], angularVelocity[2] };
+    const double rate = vtkMath::Normalize(axis);
+    const double half = 0.5 * vtkMath::RadiansFromDegrees(rate * dt);
+    const double step[4] = { std::cos(half), axis[0] * std::sin(half), axis[1] * std::sin(half), axis[2] * std::sin(half) };
+    const double drift[3] = { linearVelocity[0] * dt, linearVelocity[1] * dt, linearVelocity[2] * dt };
+
+    moved.reserve(int(poses.size()));
+
+    for (int i = int(poses.size()) - 1; i >= 0; --i) {
+        Binding& binding = bindings[i];
+        if (!binding.actor) {
+            removeAt(i);
+            continue;
+        }
+
+        Pose& pose = poses[i];
+        double q[4];
+        vtkMath::MultiplyQuaternion(pose.rotation, step, q);
+        const double norm = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+        for (int k = 0; k < 4; ++k)
+            pose.rotation[k] = q[k] / norm;     // Renormalise against drift
+        for (int k = 0; k < 3; ++k)
+            pose.translation[k] += drift[k];
+
+        rebase(binding);
+        write(i);
+        moved.append(binding.actor);
+    }
+
+    return moved;
+}
+
+/**
+ * @brief Composes an entry's base matrix with its pose and installs the result.
+ * @param index Entry to write.
+ */
+// Pushes one pose to its actor
+void PoseAnimator::write(int index)
+{
+    const Pose& pose = poses[index];
+    Binding& binding = bindings[index];
+
+    // Local pose matrix [R t; 0 1]
+    double r[3][3];
+    vtkMath::QuaternionToMatrix3x3(pose.rotation, r);
+    const double local[16] = {
+        r[0][0], r[0][1], r[0][2], pose.translation[0],
+        r[1][0], r[1][1], r[1][2], pose.translation[1],
+        r[2][0], r[2][1], r[2][2], pose.translation[2],
+        0.0,     0.0,     0.0,     1.0
+    };
+
+    double world[16];
+    vtkMatrix4x4::Multiply4x4(binding.base, local, world);
+    binding.matrix->DeepCopy(world);
+}
+
+/**
+ * @brief Takes over a user matrix that was replaced since the pose was last written.
+ * @param binding Entry to check.
+ */
+// Keeps the pose under a new model transform
+void PoseAnimator::rebase(Binding& binding)
+{
+    vtkMatrix4x4* current = binding.actor->GetUserMatrix();
+    if (current == binding.matrix)
+        return;
+
+    if (current)
+        vtkMatrix4x4::DeepCopy(binding.base, current);
+    else
+        vtkMatrix4x4::Identity(binding.base);
+    binding.actor->SetUserMatrix(binding.matrix);
+}
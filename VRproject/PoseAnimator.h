@@ -0,0 +1,152 @@
+/**
+ * @file PoseAnimator.h
+ * @brief Transform-only animation of part actors from frame-delta time.
+ *
+ * Every animated actor has a pose (rotation quaternion plus translation) in one
+ * contiguous array. Each frame all poses are advanced in a single pass by the time
+ * that actually elapsed, and only the resulting matrices are pushed to the actors;
+ * geometry, mappers and GPU buffers are never touched.
+ */
+
+#ifndef POSE_ANIMATOR_H
+#define POSE_ANIMATOR_H
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QHash>        // Actor -> pose index lookup
+#include <QVector>      // Actors moved by the last advance
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkSmartPointer.h>      // Smart pointer management for VTK
+#include <vtkWeakPointer.h>       // Entries do not keep actors alive
+#include <vtkActor.h>             // Animated actors
+#include <vtkMatrix4x4.h>         // Base and output matrices
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <vector>       // Contiguous pose storage
+
+// --------------------------------------- PoseAnimator Class ---------------------------------------
+/**
+ * @class PoseAnimator
+ * @brief Spins and moves registered actors with a shared velocity.
+ *
+ * The pose is applied in the part's own frame, under whatever user matrix the actor
+ * had when it was added (its assembly transform, or the VR placement). If someone
+ * else later replaces that user matrix, the new one becomes the base and the pose
+ * is kept, so model transforms and animation can be changed independently.
+ *
+ * One animator must only be used from the thread that renders its actors.
+ */
+class PoseAnimator {
+public:
+    /**
+     * @brief Constructs an empty, stationary animator.
+     */
+    // Constructor: zero velocity
+    PoseAnimator();
+
+    PoseAnimator(const PoseAnimator&) = delete;
+    PoseAnimator& operator=(const PoseAnimator&) = delete;
+
+    /**
+     * @brief Starts animating an actor from its current placement.
+     */
+    // Registers an actor with an identity pose
+    void add(vtkActor* actor);
+
+    /**
+     * @brief Stops animating an actor. It keeps the pose it has reached.
+     */
+    // Unregisters an actor
+    void remove(vtkActor* actor);
+
+    /**
+     * @brief Stops animating every actor.
+     */
+    // Unregisters all actors
+    void clear();
+
+    /**
+     * @brief Returns true if the actor is animated by this animator.
+     */
+    // Checks registration
+    bool contains(vtkActor* actor) const;
+
+    /**
+     * @brief Re-applies an actor's pose after its user matrix was replaced.
+     *
+     * advance() notices replaced matrices by itself; this is for changes made while
+     * nothing moves, so the part does not lose its pose until the next spin.
+     */
+    // Adopts a new base matrix and rewrites the pose
+    void reapply(vtkActor* actor);
+
+    /**
+     * @brief Sets the spin applied to every actor.
+     * @param x,y,z Degrees per second around the part's own X, Y and Z axes.
+     */
+    // Angular velocity in degrees per second
+    void setAngularVelocity(double x, double y, double z);
+
+    /**
+     * @brief Sets the drift applied to every actor.
+     * @param x,y,z Model units per second along the part's own axes.
+     */
+    // Linear velocity in model units per second
+    void setLinearVelocity(double x, double y, double z);
+
+    /**
+     * @brief Returns true if the velocity is non-zero, i.e. advance() would move anything.
+     */
+    // Checks whether the animator is moving
+    bool isMoving() const;
+
+    /**
+     * @brief Advances every pose and writes the actors' matrices.
+     * @param seconds Time since the previous call; long stalls are clamped.
+     * @return Actors whose matrix changed (valid until the next call), so callers
+     *         can refresh bounds and instance data.
+     */
+    // Integrates all poses in one pass
+    const QVector<vtkActor*>& advance(double seconds);
+
+private:
+    /**
+     * @brief Animated state of one actor, stored contiguously.
+     */
+    struct Pose {
+        double rotation[4];     // Unit quaternion (w, x, y, z)
+        double translation[3];  // Offset in the part's frame
+    };
+
+    /**
+     * @brief Where a pose is written to.
+     */
+    struct Binding {
+        vtkActor* key;                              // Index key (still valid after the actor is destroyed)
+        vtkWeakPointer<vtkActor> actor;             // Animated actor
+        double base[16];                            // User matrix the pose is applied under
+        vtkSmartPointer<vtkMatrix4x4> matrix;       // base * pose, installed as the actor's user matrix
+    };
+
+    // Adopts the actor's current user matrix as base if someone replaced it
+    static void rebase(Binding& binding);
+
+    // Writes base * pose into an entry's matrix
+    void write(int index);
+
+    // Removes the entry at an index by moving the last entry into its place
+    void removeAt(int index);
+
+    std::vector<Pose> poses;                // One pose per animated actor
+    std::vector<Binding> bindings;          // Parallel to poses
+    QHash<vtkActor*, int> indices;          // Actor -> index in poses
+    QVector<vtkActor*> moved;               // Result of the last advance
+
+    double angularVelocity[3];              // Degrees per second
+    double linearVelocity[3];               // Model units per second
+};
+
+#endif // POSE_ANIMATOR_H
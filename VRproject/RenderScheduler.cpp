@@ -0,0 +1,118 @@
+/**
+ * @file RenderScheduler.cpp
+ * @brief Implementation of coalesced desktop rendering.
+ */
+
+#include "RenderScheduler.h"
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <algorithm>
+#include <cmath>
+
+// --------------------------------------- Constructor & Destructor ---------------------------------------
+
+/**
+ * @brief Constructs the scheduler and observes the window's renders.
+ * @param window Render window to schedule.
+ * @param parent Optional QObject parent.
+ */
+// Sets up the timer and EndEvent observer
+RenderScheduler::RenderScheduler(vtkRenderWindow* window, QObject* parent)
+    : QObject(parent)
+    , window(window)
+    , observerTag(0)
+    , frameIntervalMs(16)
+    , dirty(false)
+{
+    timer.setSingleShot(true);
+    timer.setTimerType(Qt::PreciseTimer);
+    connect(&timer, &QTimer::timeout, this, &RenderScheduler::onTimeout);
+
+    callback = vtkSmartPointer<vtkCallbackCommand>::New();
+    callback->SetClientData(this);
+    callback->SetCallback(&RenderScheduler::onWindowRendered);
+    if (window)
+        observerTag = window->AddObserver(vtkCommand::EndEvent, callback);
+
+    sinceLastFrame.start();
+}
+
+/**
+ * @brief Detaches from the render window.
+ */
+// Removes the observer so the window no longer calls into a deleted scheduler
+RenderScheduler::~RenderScheduler()
+{
+    if (window && observerTag)
+        window->RemoveObserver(observerTag);
+}
+
+// --------------------------------------- Scheduling ---------------------------------------
+
+/**
+ * @brief Marks the view dirty and arms the timer for the next refresh slot.
+ */
+// Further requests before the timer fires are merged into the same frame
+void RenderScheduler::requestRender()
+{
+    dirty = true;
+    if (timer.isActive())
+        return;
+
+    const qint64 wait = frameIntervalMs - sinceLastFrame.elapsed();
+    timer.start(int(std::max<qint64>(0, wait)));
+}
+
+/**
+ * @brief Renders now if a request is pending.
+ */
+// Skips the wait for the next refresh slot
+void RenderScheduler::flush()
+{
+    if (dirty)
+        onTimeout();
+}
+
+/**
+ * @brief Returns true while a request is pending.
+ */
+// Returns the dirty flag
+bool RenderScheduler::isPending() const
+{
+    return dirty;
+}
+
+/**
+ * @brief Sets the display refresh rate used to space renders.
+ * @param hz Refresh rate in Hz.
+ */
+// Converts the refresh rate to a frame interval
+void RenderScheduler::setRefreshRate(double hz)
+{
+    if (hz <= 0.0)
+        hz = 60.0;
+    frameIntervalMs = std::max(1, int(std::floor(1000.0 / hz)));
+}
+
+// Draws the pending frame (the EndEvent observer clears the flag)
+void RenderScheduler::onTimeout()
+{
+    timer.stop();
+    if (!dirty || !window) {
+        dirty = false;
+        return;
+    }
+
+    window->Render();
+    dirty = false;
+}
+
+// Any completed render, scheduled or not, satisfies the pending request
+void RenderScheduler::onWindowRendered(vtkObject*, unsigned long, void* clientData, void*)
+{
+    RenderScheduler* self = static_cast<RenderScheduler*>(clientData);
+    self->dirty = false;
+    self->timer.stop();
+    self->sinceLastFrame.restart();
+}
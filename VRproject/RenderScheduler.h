@@ -0,0 +1,101 @@
+/**
+ * @file RenderScheduler.h
+ * @brief Coalesces render requests for the desktop view into at most one frame per display refresh.
+ *
+ * Slots mark the view dirty instead of rendering directly, so a slider drag that
+ * changes the scene dozens of times per frame still costs a single render, and a
+ * scene that does not change is not rendered at all.
+ */
+
+#ifndef RENDER_SCHEDULER_H
+#define RENDER_SCHEDULER_H
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QObject>          // Base class for signals/slots
+#include <QTimer>           // Deferred render
+#include <QElapsedTimer>    // Time since the last frame
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkSmartPointer.h>      // Smart pointer management for VTK
+#include <vtkWeakPointer.h>       // Scheduled window
+#include <vtkRenderWindow.h>      // Window being rendered
+#include <vtkCallbackCommand.h>   // EndEvent observer
+
+// --------------------------------------- RenderScheduler Class ---------------------------------------
+/**
+ * @class RenderScheduler
+ * @brief Defers and merges render requests for one render window.
+ *
+ * requestRender() only sets a dirty flag and arms a single-shot timer that fires
+ * no earlier than one refresh interval after the previous frame. Any render of the
+ * window, including those started by the interactor, clears the flag, so a pending
+ * request that was already satisfied is dropped. Must be used from the GUI thread.
+ */
+class RenderScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor.
+     * @param window Render window to schedule.
+     * @param parent Optional QObject parent.
+     */
+    // Constructor: observes the window's renders
+    explicit RenderScheduler(vtkRenderWindow* window, QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor: removes the render observer.
+     */
+    // Destructor: detaches from the window
+    ~RenderScheduler();
+
+    /**
+     * @brief Marks the view dirty; it is rendered once at the next refresh slot.
+     *
+     * Cheap enough to call from every slot that changes the scene.
+     */
+    // Requests a coalesced render
+    void requestRender();
+
+    /**
+     * @brief Renders immediately if a request is pending.
+     *
+     * For code that needs the frame on screen before returning (e.g. before a screenshot).
+     */
+    // Flushes a pending render
+    void flush();
+
+    /**
+     * @brief Returns true while a requested render has not happened yet.
+     */
+    // Returns the dirty flag
+    bool isPending() const;
+
+    /**
+     * @brief Sets the display refresh rate used to space renders.
+     * @param hz Refresh rate in Hz (values <= 0 fall back to 60).
+     */
+    // Sets the minimum interval between frames
+    void setRefreshRate(double hz);
+
+private slots:
+    // Renders the window if it is still dirty
+    void onTimeout();
+
+private:
+    // Window EndEvent trampoline; records that a frame was drawn
+    static void onWindowRendered(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+
+    vtkWeakPointer<vtkRenderWindow> window;         // Scheduled window
+    vtkSmartPointer<vtkCallbackCommand> callback;   // EndEvent observer
+    unsigned long observerTag;                      // Tag returned by AddObserver
+
+    QTimer timer;                   // Single-shot, armed while a request is pending
+    QElapsedTimer sinceLastFrame;   // Started at the end of each render
+    int frameIntervalMs;            // Minimum spacing between scheduled renders
+    bool dirty;                     // True while a request is pending
+};
+
+#endif // RENDER_SCHEDULER_H
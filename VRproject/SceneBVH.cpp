@@ -0,0 +1,761 @@
+/**
+ * @file SceneBVH.cpp
+ * @brief Implementation of the dynamic AABB tree and its VTK culler.
+ */
+
+#include "SceneBVH.h"
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkCamera.h>
+#include <vtkOpenGLCamera.h>
+#include <vtkMatrix3x3.h>
+#include <vtkMatrix4x4.h>
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// --------------------------------------- Box Helpers ---------------------------------------
+
+namespace {
+
+// Fraction of each extent added on every side of a leaf box
+const double FatMargin = 0.1;
+
+// A box is rebuilt once its extents exceed the tight extents by this factor
+const double MaxLooseness = 2.0;
+
+// Union of two boxes
+void unionBox(const double a[6], const double b[6], double out[6])
+{
+    for (int i = 0; i < 3; ++i) {
+        out[2 * i] = std::min(a[2 * i], b[2 * i]);
+        out[2 * i + 1] = std::max(a[2 * i + 1], b[2 * i + 1]);
+    }
+}
+
+// Surface area, the insertion cost metric
+double area(const double box[6])
+{
+    const double dx = box[1] - box[0];
+    const double dy = box[3] - box[2];
+    const double dz = box[5] - box[4];
+    return 2.0 * (dx * dy + dy * dz + dz * dx);
+}
+
+// Surface area of the union of two boxes
+double unionArea(const double a[6], const double b[6])
+{
+    double u[6];
+    unionBox(a, b, u);
+    return area(u);
+}
+
+// True if inner lies entirely within outer
+bool contains(const double outer[6], const double inner[6])
+{
+    for (int i = 0; i < 3; ++i) {
+        if (inner[2 * i] < outer[2 * i] || inner[2 * i + 1] > outer[2 * i + 1])
+            return false;
+    }
+    return true;
+}
+
+// Plane/box classification: -1 outside, 0 intersecting, 1 inside
+int classify(const double plane[4], const double box[6])
+{
+    // Corner furthest along the normal (p) and its opposite (n)
+    double p[3], n[3];
+    for (int i = 0; i < 3; ++i) {
+        p[i] = plane[i] >= 0.0 ? box[2 * i + 1] : box[2 * i];
+        n[i] = plane[i] >= 0.0 ? box[2 * i] : box[2 * i + 1];
+    }
+
+    if (plane[0] * p[0] + plane[1] * p[1] + plane[2] * p[2] + plane[3] < 0.0)
+        return -1;
+    if (plane[0] * n[0] + plane[1] * n[1] + plane[2] * n[2] + plane[3] >= 0.0)
+        return 1;
+    return 0;
+}
+
+// Slab test; returns the entry parameter in [0, 1] or -1 if the segment misses the box
+double intersectRay(const double origin[3], const double direction[3], const double box[6])
+{
+    double tmin = 0.0;
+    double tmax = 1.0;
+
+    for (int i = 0; i < 3; ++i) {
+        if (std::abs(direction[i]) < 1.0e-300) {
+            if (origin[i] < box[2 * i] || origin[i] > box[2 * i + 1])
+                return -1.0;
+            continue;
+        }
+
+        double t0 = (box[2 * i] - origin[i]) / direction[i];
+        double t1 = (box[2 * i + 1] - origin[i]) / direction[i];
+        if (t0 > t1)
+            std::swap(t0, t1);
+
+        tmin = std::max(tmin, t0);
+        tmax = std::min(tmax, t1);
+        if (tmin > tmax)
+            return -1.0;
+    }
+
+    return tmin;
+}
+
+} // namespace
+
+// --------------------------------------- Constructor ---------------------------------------
+
+/**
+ * @brief Constructs an empty tree.
+ */
+// Sets up the empty node pool and the picker
+SceneBVH::SceneBVH()
+    : root(-1)
+    , freeList(-1)
+    , frameStamp(0)
+{
+    picker = vtkSmartPointer<vtkCellPicker>::New();
+    picker->SetTolerance(0.0005);
+    picker->PickFromListOn();
+}
+
+// --------------------------------------- Public Interface ---------------------------------------
+
+/**
+ * @brief Adds a prop, or refreshes it if already present.
+ * @param prop     Prop to index.
+ * @param userData Caller data returned by userData().
+ */
+// Creates a leaf with the prop's fat bounds
+void SceneBVH::insert(vtkProp3D* prop, void* userData)
+{
+    if (!prop)
+        return;
+
+    auto existing = leaves.constFind(prop);
+    if (existing != leaves.constEnd()) {
+        const int leaf = existing.value();
+        if (nodes[leaf].prop == prop) {
+            nodes[leaf].userData = userData;
+            update(prop);
+            return;
+        }
+        // Stale leaf of a destroyed prop that had the same address
+        removeIndex(leaf);
+    }
+
+    double box[6];
+    if (!fatBounds(prop, box))
+        return;
+
+    const int leaf = allocateNode();
+    std::copy(box, box + 6, nodes[leaf].box);
+    nodes[leaf].prop = prop;
+    nodes[leaf].key = prop;
+    nodes[leaf].userData = userData;
+    nodes[leaf].height = 0;
+
+    insertLeaf(leaf);
+    leaves.insert(prop, leaf);
+}
+
+/**
+ * @brief Re-reads a prop's bounds.
+ * @param prop Indexed prop (props that are not indexed are ignored).
+ */
+// Reinserts the leaf only if the bounds left (or became much smaller than) its fat box
+void SceneBVH::update(vtkProp3D* prop)
+{
+    if (!prop)
+        return;
+
+    auto found = leaves.constFind(prop);
+    if (found == leaves.constEnd())
+        return;
+
+    const int leaf = found.value();
+    const double* bounds = prop->GetBounds();
+    if (!bounds || !vtkMath::AreBoundsInitialized(bounds)) {
+        removeIndex(leaf);
+        return;
+    }
+
+    const double* fat = nodes[leaf].box;
+    bool tooLoose = false;
+    for (int i = 0; i < 3 && !tooLoose; ++i) {
+        const double tight = bounds[2 * i + 1] - bounds[2 * i];
+        tooLoose = (fat[2 * i + 1] - fat[2 * i]) > MaxLooseness * (tight * (1.0 + 2.0 * FatMargin)) + 1.0e-9;
+    }
+    if (contains(fat, bounds) && !tooLoose)
+        return;
+
+    removeLeaf(leaf);
+    fatBounds(prop, nodes[leaf].box);
+    insertLeaf(leaf);
+}
+
+/**
+ * @brief Removes a prop.
+ */
+// Removes the prop's leaf
+void SceneBVH::remove(vtkProp3D* prop)
+{
+    auto found = leaves.constFind(prop);
+    if (found != leaves.constEnd())
+        removeIndex(found.value());
+}
+
+/**
+ * @brief Removes every prop.
+ */
+// Resets the node pool
+void SceneBVH::clear()
+{
+    nodes.clear();
+    leaves.clear();
+    root = -1;
+    freeList = -1;
+}
+
+/**
+ * @brief Returns the number of indexed props.
+ */
+// Returns the leaf count
+int SceneBVH::size() const
+{
+    return leaves.size();
+}
+
+/**
+ * @brief Returns the user data of a prop.
+ */
+// Looks up the leaf's user data
+void* SceneBVH::userData(vtkProp3D* prop) const
+{
+    auto found = leaves.constFind(prop);
+    return found != leaves.constEnd() ? nodes[found.value()].userData : nullptr;
+}
+
+// --------------------------------------- Queries ---------------------------------------
+
+// Depth-first traversal; subtrees fully inside a plane are not tested against it again
+template <typename Visitor>
+void SceneBVH::visitFrustum(const double planes[24], Visitor visit) const
+{
+    if (root < 0)
+        return;
+
+    // (node, mask of planes still to test)
+    std::vector<std::pair<int, int>> stack;
+    stack.reserve(64);
+    stack.emplace_back(root, 0x3f);
+
+    while (!stack.empty()) {
+        const int index = stack.back().first;
+        int mask = stack.back().second;
+        stack.pop_back();
+
+        const Node& node = nodes[index];
+        bool outside = false;
+        for (int p = 0; p < 6 && !outside; ++p) {
+            if (!(mask & (1 << p)))
+                continue;
+            const int side = classify(planes + 4 * p, node.box);
+            if (side < 0)
+                outside = true;
+            else if (side > 0)
+                mask &= ~(1 << p);
+        }
+        if (outside)
+            continue;
+
+        if (node.isLeaf()) {
+            visit(index);
+            continue;
+        }
+
+        stack.emplace_back(node.left, mask);
+        stack.emplace_back(node.right, mask);
+    }
+}
+
+/**
+ * @brief Collects the props inside a frustum.
+ * @param planes Six inward-facing planes.
+ * @param result Receives the props.
+ */
+// Frustum query
+void SceneBVH::queryFrustum(const double planes[24], QVector<vtkProp3D*>& result) const
+{
+    visitFrustum(planes, [&](int leaf) {
+        if (vtkProp3D* prop = nodes[leaf].prop)
+            result.append(prop);
+    });
+}
+
+/**
+ * @brief Collects the props whose boxes a ray segment crosses, nearest first.
+ * @param origin    Segment start.
+ * @param direction Segment vector (start to end).
+ * @return Entry parameters along the segment with their props.
+ */
+// Ray query
+QVector<SceneBVH::RayHit> SceneBVH::queryRay(const double origin[3], const double direction[3]) const
+{
+    QVector<RayHit> hits;
+    if (root < 0)
+        return hits;
+
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(root);
+
+    while (!stack.empty()) {
+        const int index = stack.back();
+        stack.pop_back();
+
+        const Node& node = nodes[index];
+        const double t = intersectRay(origin, direction, node.box);
+        if (t < 0.0)
+            continue;
+
+        if (node.isLeaf()) {
+            if (vtkProp3D* prop = node.prop)
+                hits.append(RayHit(t, prop));
+            continue;
+        }
+
+        stack.push_back(node.left);
+        stack.push_back(node.right);
+    }
+
+    std::sort(hits.begin(), hits.end(),
+        [](const RayHit& a, const RayHit& b) { return a.first < b.first; });
+    return hits;
+}
+
+/**
+ * @brief Stamps the leaves inside a frustum as visible for this frame.
+ * @param planes Six inward-facing planes.
+ * @return Number of visible leaves.
+ */
+// Used by the culler; isCulled() compares against the new stamp
+int SceneBVH::markVisible(const double planes[24])
+{
+    ++frameStamp;
+    int count = 0;
+
+    visitFrustum(planes, [&](int leaf) {
+        nodes[leaf].visibleStamp = frameStamp;
+        ++count;
+    });
+
+    return count;
+}
+
+/**
+ * @brief Returns true if a prop is indexed and was not stamped by the last markVisible().
+ */
+// Prop -> leaf lookup plus stamp comparison
+bool SceneBVH::isCulled(vtkProp* prop) const
+{
+    auto found = leaves.constFind(prop);
+    return found != leaves.constEnd() && nodes[found.value()].visibleStamp != frameStamp;
+}
+
+// --------------------------------------- Picking ---------------------------------------
+
+/**
+ * @brief Picks the indexed prop under a display position.
+ * @param renderer Renderer whose camera defines the ray.
+ * @param x,y      Display coordinates.
+ * @return Nearest prop hit, or nullptr.
+ */
+// Casts the near->far ray through the BVH, then cell-picks the candidates only
+vtkProp3D* SceneBVH::pick(vtkRenderer* renderer, int x, int y)
+{
+    if (!renderer || root < 0)
+        return nullptr;
+
+    double nearPoint[4], farPoint[4];
+    renderer->SetDisplayPoint(x, y, 0.0);
+    renderer->DisplayToWorld();
+    renderer->GetWorldPoint(nearPoint);
+    renderer->SetDisplayPoint(x, y, 1.0);
+    renderer->DisplayToWorld();
+    renderer->GetWorldPoint(farPoint);
+
+    if (nearPoint[3] == 0.0 || farPoint[3] == 0.0)
+        return nullptr;
+
+    double origin[3], direction[3];
+    for (int i = 0; i < 3; ++i) {
+        origin[i] = nearPoint[i] / nearPoint[3];
+        direction[i] = farPoint[i] / farPoint[3] - origin[i];
+    }
+
+    QVector<RayHit> candidates = queryRay(origin, direction);
+    if (candidates.isEmpty())
+        return nullptr;
+
+    picker->InitializePickList();
+    for (const RayHit& hit : candidates)
+        picker->AddPickList(hit.second);
+
+    if (!picker->Pick(x, y, 0.0, renderer))
+        return nullptr;
+    return picker->GetProp3D();
+}
+
+/**
+ * @brief Picks the indexed prop hit by a controller ray.
+ * @param renderer    Renderer containing the props.
+ * @param origin      Ray start.
+ * @param direction   Unit ray direction.
+ * @param orientation Controller orientation (angle, x, y, z).
+ * @return Nearest prop hit, or nullptr.
+ */
+// Same narrowing as pick(), with vtkPicker's 3D ray test for the candidates
+vtkProp3D* SceneBVH::pickRay(vtkRenderer* renderer, const double origin[3], const double direction[3], const double orientation[4])
+{
+    if (!renderer || root < 0)
+        return nullptr;
+
+    // Long enough to cross the whole scene
+    const double* rootBox = nodes[root].box;
+    const double reach = 2.0 * std::sqrt(
+        (rootBox[1] - rootBox[0]) * (rootBox[1] - rootBox[0]) +
+        (rootBox[3] - rootBox[2]) * (rootBox[3] - rootBox[2]) +
+        (rootBox[5] - rootBox[4]) * (rootBox[5] - rootBox[4])) +
+        std::sqrt(vtkMath::Distance2BetweenPoints(origin, rootBox));
+
+    const double segment[3] = { direction[0] * reach, direction[1] * reach, direction[2] * reach };
+    QVector<RayHit> candidates = queryRay(origin, segment);
+    if (candidates.isEmpty())
+        return nullptr;
+
+    picker->InitializePickList();
+    for (const RayHit& hit : candidates)
+        picker->AddPickList(hit.second);
+
+    double position[3] = { origin[0], origin[1], origin[2] };
+    double wxyz[4] = { orientation[0], orientation[1], orientation[2], orientation[3] };
+    if (!picker->Pick3DRay(position, wxyz, renderer))
+        return nullptr;
+    return picker->GetProp3D();
+}
+
+/**
+ * @brief Computes the world-space frustum planes of the renderer's active camera.
+ * @param renderer Renderer being drawn.
+ * @param planes   Receives left, right, bottom, top, near and far planes (inward normals).
+ *
+ * Uses the OpenGL camera's key matrices when available, because VR cameras override
+ * those per eye; other cameras fall back to vtkCamera::GetFrustumPlanes().
+ */
+// Gribb-Hartmann plane extraction from the world-to-clip matrix
+void SceneBVH::frustumPlanes(vtkRenderer* renderer, double planes[24])
+{
+    vtkCamera* camera = renderer->GetActiveCamera();
+    vtkOpenGLCamera* glCamera = vtkOpenGLCamera::SafeDownCast(camera);
+
+    if (!glCamera) {
+        camera->GetFrustumPlanes(renderer->GetTiledAspectRatio(), planes);
+        return;
+    }
+
+    vtkMatrix4x4* wcvc = nullptr;
+    vtkMatrix3x3* normals = nullptr;
+    vtkMatrix4x4* vcdc = nullptr;
+    vtkMatrix4x4* wcdc = nullptr;
+    glCamera->GetKeyMatrices(renderer, wcvc, normals, vcdc, wcdc);
+
+    // Key matrices are stored transposed for OpenGL: clip = M * world with M(i, j) = wcdc(j, i)
+    auto m = [wcdc](int row, int column) { return wcdc->GetElement(column, row); };
+
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int side = 0; side < 2; ++side) {
+            double* plane = planes + 4 * (2 * axis + side);
+            const double sign = side == 0 ? 1.0 : -1.0;
+            for (int j = 0; j < 4; ++j)
+                plane[j] = m(3, j) + sign * m(axis, j);
+
+            const double length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            if (length > 0.0) {
+                for (int j = 0; j < 4; ++j)
+                    plane[j] /= length;
+            }
+        }
+    }
+}
+
+// --------------------------------------- Tree Maintenance ---------------------------------------
+
+// Takes a node from the free list (or grows the pool)
+int SceneBVH::allocateNode()
+{
+    if (freeList < 0) {
+        nodes.emplace_back();
+        return int(nodes.size()) - 1;
+    }
+
+    const int index = freeList;
+    freeList = nodes[index].parent;
+    nodes[index] = Node();
+    return index;
+}
+
+// Returns a node to the free list
+void SceneBVH::freeNode(int index)
+{
+    nodes[index] = Node();
+    nodes[index].height = -1;
+    nodes[index].parent = freeList;
+    freeList = index;
+}
+
+// Grows a prop's world bounds by the fat margin
+bool SceneBVH::fatBounds(vtkProp3D* prop, double box[6])
+{
+    const double* bounds = prop->GetBounds();
+    if (!bounds || !vtkMath::AreBoundsInitialized(bounds))
+        return false;
+
+    for (int i = 0; i < 3; ++i) {
+        const double margin = std::max(1.0e-6, FatMargin * (bounds[2 * i + 1] - bounds[2 * i]));
+        box[2 * i] = bounds[2 * i] - margin;
+        box[2 * i + 1] = bounds[2 * i + 1] + margin;
+    }
+    return true;
+}
+
+// Inserts a leaf next to the sibling that increases the total surface area least
+void SceneBVH::insertLeaf(int leaf)
+{
+    if (root < 0) {
+        root = leaf;
+        nodes[root].parent = -1;
+        return;
+    }
+
+    double box[6];
+    std::copy(nodes[leaf].box, nodes[leaf].box + 6, box);
+
+    // Descend while splitting further down is cheaper than pairing with the current node
+    int index = root;
+    while (!nodes[index].isLeaf()) {
+        const int left = nodes[index].left;
+        const int right = nodes[index].right;
+
+        const double combinedArea = unionArea(nodes[index].box, box);
+        const double cost = 2.0 * combinedArea;
+        const double inheritance = 2.0 * (combinedArea - area(nodes[index].box));
+
+        auto childCost = [&](int child) {
+            const double grown = unionArea(nodes[child].box, box);
+            return (nodes[child].isLeaf() ? grown : grown - area(nodes[child].box)) + inheritance;
+        };
+        const double costLeft = childCost(left);
+        const double costRight = childCost(right);
+
+        if (cost < costLeft && cost < costRight)
+            break;
+        index = costLeft < costRight ? left : right;
+    }
+
+    const int sibling = index;
+    const int oldParent = nodes[sibling].parent;
+    const int newParent = allocateNode();
+
+    nodes[newParent].parent = oldParent;
+    unionBox(box, nodes[sibling].box, nodes[newParent].box);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].left = sibling;
+    nodes[newParent].right = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent >= 0) {
+        if (nodes[oldParent].left == sibling)
+            nodes[oldParent].left = newParent;
+        else
+            nodes[oldParent].right = newParent;
+    }
+    else {
+        root = newParent;
+    }
+
+    refitFrom(nodes[leaf].parent);
+}
+
+// Detaches a leaf (the node stays allocated so update() can reinsert it)
+void SceneBVH::removeLeaf(int leaf)
+{
+    if (leaf == root) {
+        root = -1;
+        return;
+    }
+
+    const int parent = nodes[leaf].parent;
+    const int grandParent = nodes[parent].parent;
+    const int sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+    if (grandParent >= 0) {
+        if (nodes[grandParent].left == parent)
+            nodes[grandParent].left = sibling;
+        else
+            nodes[grandParent].right = sibling;
+        nodes[sibling].parent = grandParent;
+        freeNode(parent);
+        refitFrom(grandParent);
+    }
+    else {
+        root = sibling;
+        nodes[sibling].parent = -1;
+        freeNode(parent);
+    }
+
+    nodes[leaf].parent = -1;
+}
+
+// Walks to the root, rebalancing and recomputing boxes and heights
+void SceneBVH::refitFrom(int index)
+{
+    while (index >= 0) {
+        index = balance(index);
+
+        const int left = nodes[index].left;
+        const int right = nodes[index].right;
+        nodes[index].height = 1 + std::max(nodes[left].height, nodes[right].height);
+        unionBox(nodes[left].box, nodes[right].box, nodes[index].box);
+
+        index = nodes[index].parent;
+    }
+}
+
+// Rotates the taller grandchild up if the subtree at index is unbalanced; returns the new subtree root
+int SceneBVH::balance(int a)
+{
+    if (nodes[a].isLeaf() || nodes[a].height < 2)
+        return a;
+
+    const int b = nodes[a].left;
+    const int c = nodes[a].right;
+    const int difference = nodes[c].height - nodes[b].height;
+
+    // Rotate the taller child (up) into a's place; keep the taller of its children
+    auto rotate = [this, a](int up, int other, bool upIsRight) {
+        const int f = nodes[up].left;
+        const int g = nodes[up].right;
+
+        nodes[up].left = a;
+        nodes[up].parent = nodes[a].parent;
+        nodes[a].parent = up;
+
+        const int parent = nodes[up].parent;
+        if (parent >= 0) {
+            if (nodes[parent].left == a)
+                nodes[parent].left = up;
+            else
+                nodes[parent].right = up;
+        }
+        else {
+            root = up;
+        }
+
+        const int keep = nodes[f].height > nodes[g].height ? f : g;
+        const int give = keep == f ? g : f;
+
+        nodes[up].right = keep;
+        if (upIsRight)
+            nodes[a].right = give;
+        else
+            nodes[a].left = give;
+        nodes[give].parent = a;
+
+        unionBox(nodes[other].box, nodes[give].box, nodes[a].box);
+        unionBox(nodes[a].box, nodes[keep].box, nodes[up].box);
+        nodes[a].height = 1 + std::max(nodes[other].height, nodes[give].height);
+        nodes[up].height = 1 + std::max(nodes[a].height, nodes[keep].height);
+        return up;
+    };
+
+    if (difference > 1)
+        return rotate(c, b, true);
+    if (difference < -1)
+        return rotate(b, c, false);
+    return a;
+}
+
+// Detaches and frees a leaf
+void SceneBVH::removeIndex(int leaf)
+{
+    leaves.remove(nodes[leaf].key);
+    removeLeaf(leaf);
+    freeNode(leaf);
+}
+
+// --------------------------------------- SceneBVHCuller ---------------------------------------
+
+vtkStandardNewMacro(SceneBVHCuller);
+
+// Constructor: no hierarchy until SetBVH()
+SceneBVHCuller::SceneBVHCuller()
+    : bvh(nullptr)
+{
+}
+
+/**
+ * @brief Sets the hierarchy used for culling.
+ */
+// Stores the (non-owned) BVH
+void SceneBVHCuller::SetBVH(SceneBVH* newBvh)
+{
+    bvh = newBvh;
+    Modified();
+}
+
+/**
+ * @brief Removes props outside the frustum from the renderer's prop list.
+ * @param renderer     Renderer being drawn.
+ * @param propList     Props to render this pass (compacted in place).
+ * @param listLength   Number of props (updated).
+ * @param initialized  Set to 1; multipliers of kept props are initialised to 1 if needed.
+ * @return Sum of the kept props' render-time multipliers.
+ */
+// One BVH traversal per pass, then an O(1) lookup per prop
+double SceneBVHCuller::Cull(vtkRenderer* renderer, vtkProp** propList, int& listLength, int& initialized)
+{
+    const bool cull = bvh && bvh->size() > 0;
+    if (cull) {
+        double planes[24];
+        SceneBVH::frustumPlanes(renderer, planes);
+        bvh->markVisible(planes);
+    }
+
+    double totalTime = 0.0;
+    int kept = 0;
+    for (int i = 0; i < listLength; ++i) {
+        vtkProp* prop = propList[i];
+        if (cull && bvh->isCulled(prop))
+            continue;
+
+        if (!initialized)
+            prop->SetRenderTimeMultiplier(1.0);
+        totalTime += prop->GetRenderTimeMultiplier();
+        propList[kept++] = prop;
+    }
+
+    listLength = kept;
+    initialized = 1;
+    return totalTime;
+}
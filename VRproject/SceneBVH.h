@@ -0,0 +1,245 @@
+/**
+ * @file SceneBVH.h
+ * @brief Bounding-volume hierarchy over part actors for frustum culling and picking.
+ *
+ * A dynamic AABB tree (incremental insert/remove with rotations, as used by physics
+ * broad-phases) keyed by prop. Queries visit only the branches whose boxes meet the
+ * frustum or ray, so their cost grows with log(parts) rather than with the part count.
+ */
+
+#ifndef SCENE_BVH_H
+#define SCENE_BVH_H
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QHash>        // Prop -> leaf lookup
+#include <QVector>      // Query results
+#include <QPair>        // (distance, prop) ray hits
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkSmartPointer.h>      // Smart pointer management for VTK
+#include <vtkWeakPointer.h>       // Leaves do not keep props alive
+#include <vtkProp3D.h>            // Indexed props
+#include <vtkRenderer.h>          // Camera and pick renderer
+#include <vtkCellPicker.h>        // Exact picking of BVH candidates
+#include <vtkCuller.h>            // Renderer culling hook
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <vector>       // Node pool
+
+// --------------------------------------- SceneBVH Class ---------------------------------------
+/**
+ * @class SceneBVH
+ * @brief Incrementally maintained AABB tree of prop bounds.
+ *
+ * Leaves store "fat" boxes (bounds grown by a margin), so a prop that moves or is
+ * re-filtered slightly only needs a containment check in update(). Props whose
+ * bounds are empty are not indexed and are therefore never culled.
+ *
+ * One SceneBVH belongs to one renderer and must be used from the thread that renders it.
+ */
+class SceneBVH {
+public:
+    /**
+     * @brief Ray hit: entry distance along the ray (in ray-direction units) and the prop.
+     */
+    using RayHit = QPair<double, vtkProp3D*>;
+
+    /**
+     * @brief Constructs an empty tree.
+     */
+    // Constructor: creates the exact-test picker
+    SceneBVH();
+
+    SceneBVH(const SceneBVH&) = delete;
+    SceneBVH& operator=(const SceneBVH&) = delete;
+
+    /**
+     * @brief Adds a prop, or refreshes its bounds if it is already indexed.
+     * @param prop     Prop to index (world-space bounds, including its user matrix).
+     * @param userData Opaque pointer returned by userData() (e.g. the owning ModelPart).
+     */
+    // Indexes a prop
+    void insert(vtkProp3D* prop, void* userData = nullptr);
+
+    /**
+     * @brief Re-reads a prop's bounds after it was moved, filtered or given new geometry.
+     *
+     * Cheap when the new bounds still fit the leaf's fat box. Props that are not
+     * indexed are ignored; a prop whose bounds became empty is dropped.
+     */
+    // Refreshes one prop's bounds
+    void update(vtkProp3D* prop);
+
+    /**
+     * @brief Removes a prop from the tree.
+     */
+    // Drops one prop
+    void remove(vtkProp3D* prop);
+
+    /**
+     * @brief Removes every prop.
+     */
+    // Empties the tree
+    void clear();
+
+    /**
+     * @brief Returns the number of indexed props.
+     */
+    // Returns the leaf count
+    int size() const;
+
+    /**
+     * @brief Returns the user data passed to insert(), or nullptr.
+     */
+    // Looks up a prop's user data
+    void* userData(vtkProp3D* prop) const;
+
+    /**
+     * @brief Appends the props whose boxes intersect the frustum.
+     * @param planes Six inward-facing planes (a, b, c, d), as from frustumPlanes().
+     * @param result Receives the visible props.
+     */
+    // Frustum query
+    void queryFrustum(const double planes[24], QVector<vtkProp3D*>& result) const;
+
+    /**
+     * @brief Returns the props whose boxes a ray passes through, nearest first.
+     * @param origin    Ray start.
+     * @param direction Ray direction; hits beyond origin + direction are ignored.
+     */
+    // Ray query
+    QVector<RayHit> queryRay(const double origin[3], const double direction[3]) const;
+
+    /**
+     * @brief Marks props inside the frustum as visible for the current frame.
+     * @return Number of visible indexed props.
+     */
+    // Stamps visible leaves (used by SceneBVHCuller)
+    int markVisible(const double planes[24]);
+
+    /**
+     * @brief Returns true if the prop is indexed and was outside the last markVisible() frustum.
+     */
+    // O(1) culling test
+    bool isCulled(vtkProp* prop) const;
+
+    /**
+     * @brief Picks the indexed prop under a display position.
+     * @param renderer Renderer whose camera defines the ray.
+     * @param x,y      Display coordinates (pixels, origin bottom-left).
+     * @return The nearest prop hit by the ray, or nullptr.
+     *
+     * The BVH narrows the candidates to the props whose boxes the ray crosses; only
+     * those are tested against their cells.
+     */
+    // Viewport click picking
+    vtkProp3D* pick(vtkRenderer* renderer, int x, int y);
+
+    /**
+     * @brief Picks the indexed prop hit by a 3D ray (e.g. a VR controller).
+     * @param renderer    Renderer containing the props.
+     * @param origin      Ray start in world coordinates.
+     * @param direction   Unit ray direction in world coordinates.
+     * @param orientation Controller orientation as (angle, x, y, z), as given by VTK 3D events.
+     * @return The nearest prop hit, or nullptr.
+     */
+    // Controller ray picking
+    vtkProp3D* pickRay(vtkRenderer* renderer, const double origin[3], const double direction[3], const double orientation[4]);
+
+    /**
+     * @brief Computes the active camera's view frustum for a renderer.
+     * @param renderer Renderer (for stereo, the planes are those of the eye being rendered).
+     * @param planes   Receives six inward-facing planes (a, b, c, d).
+     */
+    // Extracts world-space frustum planes
+    static void frustumPlanes(vtkRenderer* renderer, double planes[24]);
+
+private:
+    /**
+     * @brief Tree node; leaves hold a prop, internal nodes the union of their children.
+     */
+    struct Node {
+        double box[6];                      // (xmin, xmax, ymin, ymax, zmin, zmax)
+        int parent = -1;                    // Parent node, or next free node while unused
+        int left = -1;                      // First child (-1 for leaves)
+        int right = -1;                     // Second child
+        int height = 0;                     // 0 for leaves, -1 for free nodes
+        vtkWeakPointer<vtkProp3D> prop;     // Leaf prop
+        vtkProp* key = nullptr;             // Leaf key in the lookup table (valid after the prop dies)
+        void* userData = nullptr;           // Leaf user data
+        unsigned int visibleStamp = 0;      // Frame stamp from markVisible()
+
+        bool isLeaf() const { return left < 0; }
+    };
+
+    // Node pool management
+    int allocateNode();
+    void freeNode(int index);
+
+    // Tree maintenance
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int balance(int index);
+    void refitFrom(int index);
+
+    // Reads a prop's bounds grown by the fat margin; false if the bounds are empty
+    static bool fatBounds(vtkProp3D* prop, double box[6]);
+
+    // Visits every leaf inside the frustum
+    template <typename Visitor>
+    void visitFrustum(const double planes[24], Visitor visit) const;
+
+    // Drops a leaf whose prop was destroyed
+    void removeIndex(int leaf);
+
+    std::vector<Node> nodes;                // Node pool
+    int root;                               // Root node, or -1
+    int freeList;                           // First free node, or -1
+    QHash<vtkProp*, int> leaves;            // Prop -> leaf node
+    unsigned int frameStamp;                // Incremented by markVisible()
+
+    vtkSmartPointer<vtkCellPicker> picker;  // Exact test for the BVH candidates
+};
+
+// --------------------------------------- SceneBVHCuller Class ---------------------------------------
+/**
+ * @class SceneBVHCuller
+ * @brief vtkCuller that removes props outside the view frustum using a SceneBVH.
+ *
+ * Replaces the renderer's default per-prop vtkFrustumCoverageCuller. Props that are
+ * not in the BVH (skybox, overlays, sample geometry) are always kept. In stereo the
+ * culler runs once per eye with that eye's frustum.
+ */
+class SceneBVHCuller : public vtkCuller {
+public:
+    static SceneBVHCuller* New();
+    vtkTypeMacro(SceneBVHCuller, vtkCuller);
+
+    /**
+     * @brief Sets the hierarchy used for culling (not owned; may be nullptr to disable).
+     */
+    // Sets the BVH to query
+    void SetBVH(SceneBVH* bvh);
+
+    /**
+     * @brief Compacts the prop list to the props inside the frustum.
+     * @return Sum of the render-time multipliers of the kept props.
+     */
+    // vtkCuller interface
+    double Cull(vtkRenderer* renderer, vtkProp** propList, int& listLength, int& initialized) override;
+
+protected:
+    SceneBVHCuller();
+    ~SceneBVHCuller() override = default;
+
+private:
+    SceneBVHCuller(const SceneBVHCuller&) = delete;
+    void operator=(const SceneBVHCuller&) = delete;
+
+    SceneBVH* bvh;      // Queried hierarchy
+};
+
+#endif // SCENE_BVH_H
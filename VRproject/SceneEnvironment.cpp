@@ -0,0 +1,197 @@
+/**
+ * @file SceneEnvironment.cpp
+ * @brief Implementation of the per-renderer skybox and image-based lighting.
+ */
+
+#include "SceneEnvironment.h"
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkOpenGLRenderer.h>
+#include <vtkOpenGLRenderWindow.h>
+#include <vtkOpenGLTexture.h>
+#include <vtkProperty.h>
+
+// --------------------------------------- Material ---------------------------------------
+
+namespace {
+
+// PBR parameters for parts lit by the environment (painted/plastic CAD parts)
+const double PartMetallic = 0.1;
+const double PartRoughness = 0.4;
+
+} // namespace
+
+// --------------------------------------- Constructor ---------------------------------------
+
+/**
+ * @brief Constructs an empty environment.
+ */
+// Starts without renderer or source
+SceneEnvironment::SceneEnvironment()
+    : pending(false)
+{
+}
+
+// --------------------------------------- Renderer ---------------------------------------
+
+/**
+ * @brief Binds the environment to a renderer and shows the current source there.
+ * @param newRenderer Renderer to light.
+ */
+// Binds to a renderer
+void SceneEnvironment::attach(vtkRenderer* newRenderer)
+{
+    if (renderer == newRenderer)
+        return;
+
+    detach();
+    renderer = newRenderer;
+}
+
+/**
+ * @brief Removes the skybox and IBL and forgets the renderer.
+ */
+// Unbinds from the renderer
+void SceneEnvironment::detach()
+{
+    source.reset();
+    texture = nullptr;
+    pending = false;
+    apply();
+
+    renderer = nullptr;
+    skybox = nullptr;
+}
+
+// --------------------------------------- Source ---------------------------------------
+
+/**
+ * @brief Switches to another environment.
+ * @param newSource     Shared source, or nullptr for none.
+ * @param contextTexture Texture already built for this renderer, or nullptr.
+ */
+// Replaces the environment
+void SceneEnvironment::setSource(EnvironmentSourcePtr newSource, vtkTexture* contextTexture)
+{
+    source = std::move(newSource);
+    texture = contextTexture;
+    pending = source && !contextTexture;
+
+    if (!pending)
+        apply();
+}
+
+/**
+ * @brief Builds this renderer's texture from a pending source.
+ *
+ * Decoded faces are shallow-copied, so this renderer's texture pipeline is separate
+ * while the pixel buffers are shared. Compressed cubemaps need a live context and
+ * are skipped until the render window has been initialised.
+ */
+// Creates and applies a pending texture
+void SceneEnvironment::realize()
+{
+    if (!pending || !renderer)
+        return;
+
+    if (!source->faces.empty()) {
+        std::vector<vtkSmartPointer<vtkImageData>> faces;
+        for (const vtkSmartPointer<vtkImageData>& face : source->faces) {
+            auto copy = vtkSmartPointer<vtkImageData>::New();
+            if (face)
+                copy->ShallowCopy(face);
+            faces.push_back(copy);
+        }
+        texture = CreateCubemapTexture(faces);
+    }
+    else {
+        auto* window = vtkOpenGLRenderWindow::SafeDownCast(renderer->GetRenderWindow());
+        if (!window || !window->GetInitialized())
+            return;
+        texture = UploadCompressedCubemap(window, source->compressed);
+    }
+
+    pending = false;
+    apply();
+}
+
+/**
+ * @brief Checks whether the renderer is lit by an environment.
+ * @return True while a texture is applied.
+ */
+// True while IBL is on
+bool SceneEnvironment::isActive() const
+{
+    return renderer && texture;
+}
+
+/**
+ * @brief Returns the shown source.
+ * @return Shared source (may be nullptr).
+ */
+// Current source
+EnvironmentSourcePtr SceneEnvironment::getSource() const
+{
+    return source;
+}
+
+// --------------------------------------- Applying ---------------------------------------
+
+/**
+ * @brief Shows the texture as skybox and uses it for image-based lighting.
+ *
+ * Spherical harmonics are turned off: VTK would compute them on the CPU from the
+ * faces during the first frame (and cannot for compressed cubemaps). The GPU
+ * irradiance map is used instead.
+ */
+// Updates skybox and IBL
+void SceneEnvironment::apply()
+{
+    if (!renderer)
+        return;
+
+    if (!texture) {
+        if (skybox)
+            renderer->RemoveActor(skybox);
+        renderer->UseImageBasedLightingOff();
+        renderer->SetEnvironmentTexture(nullptr);
+        return;
+    }
+
+    if (!skybox)
+        skybox = AddSkyboxToRenderer(renderer, texture);
+    else {
+        skybox->SetTexture(texture);
+        if (!renderer->HasViewProp(skybox))
+            renderer->AddActor(skybox);
+    }
+
+    renderer->UseImageBasedLightingOn();
+    renderer->SetEnvironmentTexture(texture, true);
+    if (auto* openGLRenderer = vtkOpenGLRenderer::SafeDownCast(renderer))
+        openGLRenderer->SetUseSphericalHarmonics(false);
+}
+
+/**
+ * @brief Switches a part actor to PBR shading while an environment is active.
+ * @param actor Part actor.
+ */
+// PBR on with an environment, default shading without
+void SceneEnvironment::applyMaterial(vtkActor* actor) const
+{
+    if (!actor)
+        return;
+
+    vtkProperty* property = actor->GetProperty();
+    if (isActive()) {
+        if (property->GetInterpolation() != VTK_PBR) {
+            property->SetInterpolationToPBR();
+            property->SetMetallic(PartMetallic);
+            property->SetRoughness(PartRoughness);
+        }
+    }
+    else if (property->GetInterpolation() == VTK_PBR) {
+        property->SetInterpolationToGouraud();
+    }
+}
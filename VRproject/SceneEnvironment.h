@@ -0,0 +1,129 @@
+/**
+ * @file SceneEnvironment.h
+ * @brief Skybox and image-based lighting shared by the desktop and VR renderers.
+ *
+ * A loaded environment is described once by an immutable EnvironmentSource (the
+ * decoded faces or the compressed cubemap). Each renderer gets a SceneEnvironment
+ * that turns that source into a skybox and an IBL environment for its own GL
+ * context, so the headset and the preview show the same surroundings without
+ * decoding the images twice.
+ */
+
+#ifndef SCENE_ENVIRONMENT_H
+#define SCENE_ENVIRONMENT_H
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkSmartPointer.h>      // Smart pointer management for VTK
+#include <vtkWeakPointer.h>       // Renderer the environment belongs to
+#include <vtkRenderer.h>          // Skybox and IBL target
+#include <vtkTexture.h>           // Cubemap texture
+#include <vtkImageData.h>         // Decoded faces
+#include <vtkSkybox.h>            // Skybox actor
+#include <vtkActor.h>             // Part actors switched to PBR
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <memory>       // Shared, immutable sources
+#include <vector>       // Face lists
+
+#include "skyboxutils.h"          // CompressedCubemap and texture helpers
+
+// --------------------------------------- EnvironmentSource ---------------------------------------
+/**
+ * @brief The CPU-side data of one environment. Never modified once published.
+ *
+ * Exactly one of the two members is filled. The faces are shared with the desktop
+ * texture, so keeping the source costs no extra memory.
+ */
+struct EnvironmentSource {
+    std::vector<vtkSmartPointer<vtkImageData>> faces;   // Decoded faces in cubemap order
+    CompressedCubemap compressed;                       // BCn levels from a KTX2 file
+};
+
+using EnvironmentSourcePtr = std::shared_ptr<const EnvironmentSource>;
+
+// --------------------------------------- SceneEnvironment Class ---------------------------------------
+/**
+ * @class SceneEnvironment
+ * @brief Shows an environment as skybox and image-based lighting in one renderer.
+ *
+ * OpenGL objects cannot be used across the desktop and OpenVR contexts (VTK creates
+ * them unshared), so each renderer uploads the shared source once into its own
+ * texture. The irradiance and prefiltered specular maps are computed from that
+ * texture by VTK's GPU passes once per environment change, not per frame.
+ *
+ * One instance belongs to exactly one renderer and must only be used from the
+ * thread that renders it.
+ */
+class SceneEnvironment {
+public:
+    /**
+     * @brief Constructs an environment that is not attached to a renderer.
+     */
+    // Constructor: no environment
+    SceneEnvironment();
+
+    SceneEnvironment(const SceneEnvironment&) = delete;
+    SceneEnvironment& operator=(const SceneEnvironment&) = delete;
+
+    /**
+     * @brief Sets the renderer that shows the environment.
+     */
+    // Binds to a renderer
+    void attach(vtkRenderer* renderer);
+
+    /**
+     * @brief Removes the skybox and IBL from the renderer and drops the texture.
+     */
+    // Unbinds from the renderer
+    void detach();
+
+    /**
+     * @brief Switches to a new environment.
+     * @param source  Shared source, or nullptr to remove the environment.
+     * @param texture Texture already created for this renderer's context, or nullptr
+     *                to build one from the source in realize().
+     */
+    // Replaces the environment
+    void setSource(EnvironmentSourcePtr source, vtkTexture* texture = nullptr);
+
+    /**
+     * @brief Creates the texture of a pending source once the render window exists.
+     *
+     * Call after setSource() and again after the render window was initialised.
+     */
+    // Uploads and applies a pending source
+    void realize();
+
+    /**
+     * @brief Returns true while an environment lights the renderer.
+     */
+    // Checks whether IBL is on
+    bool isActive() const;
+
+    /**
+     * @brief Returns the shared source currently shown (may be nullptr).
+     */
+    // Current source
+    EnvironmentSourcePtr getSource() const;
+
+    /**
+     * @brief Gives a part actor physically based shading while an environment is active.
+     * @param actor Part actor; left as is (apart from leaving PBR) without an environment.
+     */
+    // Switches an actor between PBR and the default shading
+    void applyMaterial(vtkActor* actor) const;
+
+private:
+    // Puts the texture on the skybox and the renderer's IBL
+    void apply();
+
+    vtkWeakPointer<vtkRenderer> renderer;     // Target renderer
+    EnvironmentSourcePtr source;              // Shown environment
+    bool pending;                             // Source set, texture not yet created
+    vtkSmartPointer<vtkTexture> texture;      // Cubemap in this renderer's context
+    vtkSmartPointer<vtkSkybox> skybox;        // Background actor (created on first use)
+};
+
+#endif // SCENE_ENVIRONMENT_H
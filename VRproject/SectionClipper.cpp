@@ -0,0 +1,329 @@
+/**
+ * @file SectionClipper.cpp
+ * @brief Implementation of GPU section planes and back-face capping.
+ */
+
+#include "SectionClipper.h"
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkPlane.h>
+#include <vtkMath.h>
+
+// --------------------------------------- Cap Appearance ---------------------------------------
+
+namespace {
+
+// Caps are drawn in a darker shade of the part colour so the cut reads as a solid face
+const double CapShade = 0.6;
+
+// Priority of the StartEvent observer: below the LODSwitcher's, so the mapper it picks is clipped
+const float ObserverPriority = -1.0f;
+
+} // namespace
+
+// --------------------------------------- Constructor & Destructor ---------------------------------------
+
+/**
+ * @brief Constructs the clipper and its render observer.
+ */
+// Creates the StartEvent callback and the shared scene planes
+SectionClipper::SectionClipper()
+    : sceneLayout(0)
+    , observerTag(0)
+{
+    scenePlanes = vtkSmartPointer<vtkPlaneCollection>::New();
+
+    callback = vtkSmartPointer<vtkCallbackCommand>::New();
+    callback->SetClientData(this);
+    callback->SetCallback(&SectionClipper::onStartRender);
+}
+
+/**
+ * @brief Detaches from the renderer. Registered actors keep their current planes.
+ */
+// Removes the observer
+SectionClipper::~SectionClipper()
+{
+    detach();
+}
+
+// --------------------------------------- Renderer ---------------------------------------
+
+/**
+ * @brief Observes the renderer so planes are applied at the start of each frame.
+ * @param newRenderer Renderer to observe.
+ */
+// Adds the StartEvent observer to a renderer
+void SectionClipper::attach(vtkRenderer* newRenderer)
+{
+    detach();
+    renderer = newRenderer;
+    if (renderer)
+        observerTag = renderer->AddObserver(vtkCommand::StartEvent, callback, ObserverPriority);
+}
+
+/**
+ * @brief Removes the observer from the current renderer.
+ */
+// Stops per-frame updates
+void SectionClipper::detach()
+{
+    if (renderer && observerTag)
+        renderer->RemoveObserver(observerTag);
+    renderer = nullptr;
+    observerTag = 0;
+}
+
+// --------------------------------------- Planes ---------------------------------------
+
+/**
+ * @brief Replaces the scene planes.
+ * @param planes New scene planes.
+ */
+// Moves the shared planes; entries are recombined only when the count changes
+void SectionClipper::setScenePlanes(const SectionPlaneList& planes)
+{
+    if (planes.size() != sceneSpec.size())
+        ++sceneLayout;
+
+    sceneSpec = planes;
+    assign(scenePlanes, planes);
+}
+
+/**
+ * @brief Returns the scene planes.
+ */
+// Scene planes by value
+const SectionPlaneList& SectionClipper::getScenePlanes() const
+{
+    return sceneSpec;
+}
+
+/**
+ * @brief Registers an actor and replaces its own planes.
+ * @param actor  Part actor.
+ * @param planes The actor's planes.
+ */
+// Adds or updates an entry
+void SectionClipper::setPartPlanes(vtkActor* actor, const SectionPlaneList& planes)
+{
+    if (!actor)
+        return;
+
+    int index = find(actor);
+    if (index < 0) {
+        Entry entry;
+        entry.actor = actor;
+        entry.own = vtkSmartPointer<vtkPlaneCollection>::New();
+        entry.combined = vtkSmartPointer<vtkPlaneCollection>::New();
+        entry.cap = vtkSmartPointer<vtkProperty>::New();
+        entry.cap->SetAmbient(1.0);
+        entry.cap->SetDiffuse(0.0);
+        entry.cap->SetSpecular(0.0);
+        entries.append(entry);
+        index = entries.size() - 1;
+    }
+
+    Entry& entry = entries[index];
+    if (entry.own->GetNumberOfItems() != planes.size())
+        entry.layout = -1;
+    assign(entry.own, planes);
+}
+
+/**
+ * @brief Unregisters an actor.
+ */
+// Drops one entry
+void SectionClipper::remove(vtkActor* actor)
+{
+    const int index = find(actor);
+    if (index < 0)
+        return;
+
+    release(entries[index]);
+    entries.remove(index);
+}
+
+/**
+ * @brief Unregisters every actor.
+ */
+// Drops all entries, unclipping live actors
+void SectionClipper::clear()
+{
+    for (Entry& entry : entries)
+        release(entry);
+    entries.clear();
+}
+
+/**
+ * @brief Checks whether planes apply to an actor.
+ */
+// Own planes or scene planes
+bool SectionClipper::isClipped(vtkActor* actor) const
+{
+    const int index = find(actor);
+    return index >= 0 && (entries[index].own->GetNumberOfItems() > 0 || !sceneSpec.isEmpty());
+}
+
+// Returns the entry index for an actor
+int SectionClipper::find(vtkActor* actor) const
+{
+    for (int i = 0; i < entries.size(); ++i) {
+        if (entries[i].actor.Get() == actor)
+            return i;
+    }
+    return -1;
+}
+
+// --------------------------------------- Plane Helpers ---------------------------------------
+
+/**
+ * @brief Copies plane values into a collection.
+ * @param collection Target collection.
+ * @param planes     New planes.
+ *
+ * Existing vtkPlane objects are kept, so collections that share them (and the
+ * mappers using those) see the new values without being rebuilt.
+ */
+// Resizes the collection, then sets each plane
+void SectionClipper::assign(vtkPlaneCollection* collection, const SectionPlaneList& planes)
+{
+    if (!collection)
+        return;
+
+    while (collection->GetNumberOfItems() > planes.size())
+        collection->RemoveItem(collection->GetNumberOfItems() - 1);
+    while (collection->GetNumberOfItems() < planes.size())
+        collection->AddItem(vtkSmartPointer<vtkPlane>::New());
+
+    for (int i = 0; i < planes.size(); ++i) {
+        vtkPlane* plane = collection->GetItem(i);
+        plane->SetOrigin(planes[i].origin);
+        plane->SetNormal(planes[i].normal);
+    }
+}
+
+/**
+ * @brief Moves planes by an affine transform.
+ * @param planes Planes to move.
+ * @param matrix Transform; normals are moved by its inverse transpose.
+ * @return Transformed planes with unit normals.
+ */
+// Transforms a plane list between coordinate frames
+SectionPlaneList SectionClipper::transformed(const SectionPlaneList& planes, vtkMatrix4x4* matrix)
+{
+    if (!matrix)
+        return planes;
+
+    auto normalMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+    vtkMatrix4x4::Invert(matrix, normalMatrix);
+    normalMatrix->Transpose();
+
+    SectionPlaneList result;
+    result.reserve(planes.size());
+    for (const SectionPlane& plane : planes) {
+        const double origin[4] = { plane.origin[0], plane.origin[1], plane.origin[2], 1.0 };
+        const double normal[4] = { plane.normal[0], plane.normal[1], plane.normal[2], 0.0 };
+        double movedOrigin[4];
+        double movedNormal[4];
+        matrix->MultiplyPoint(origin, movedOrigin);
+        normalMatrix->MultiplyPoint(normal, movedNormal);
+        vtkMath::Normalize(movedNormal);
+
+        SectionPlane moved;
+        for (int k = 0; k < 3; ++k) {
+            moved.origin[k] = movedOrigin[k];
+            moved.normal[k] = movedNormal[k];
+        }
+        result << moved;
+    }
+    return result;
+}
+
+// --------------------------------------- Per-Frame Update ---------------------------------------
+
+/**
+ * @brief Rebuilds an entry's combined list from its own planes and the scene planes.
+ * @param entry Entry to rebuild.
+ */
+// Own planes first, so a part's planes are kept when the total exceeds MaxPlanes
+void SectionClipper::combine(Entry& entry)
+{
+    entry.combined->RemoveAllItems();
+
+    for (vtkPlaneCollection* source : { entry.own.Get(), scenePlanes.Get() }) {
+        for (int i = 0; i < source->GetNumberOfItems() && entry.combined->GetNumberOfItems() < MaxPlanes; ++i)
+            entry.combined->AddItem(source->GetItem(i));
+    }
+    entry.layout = sceneLayout;
+}
+
+/**
+ * @brief Takes the planes off every mapper an entry touched and removes its cap.
+ * @param entry Entry to release.
+ */
+// Unclips an actor
+void SectionClipper::release(Entry& entry)
+{
+    for (const vtkWeakPointer<vtkMapper>& mapper : entry.mappers) {
+        if (mapper && mapper->GetClippingPlanes() == entry.combined)
+            mapper->SetClippingPlanes(nullptr);
+    }
+    entry.mappers.clear();
+
+    if (entry.actor && entry.actor->GetBackfaceProperty() == entry.cap)
+        entry.actor->SetBackfaceProperty(nullptr);
+}
+
+/**
+ * @brief Puts each registered actor's planes on its current mapper for the coming frame.
+ *
+ * Only pointers are compared and set here; moving a plane has already updated the
+ * shared vtkPlane objects, which the mappers read when they draw.
+ */
+// Clips the current mappers and keeps the caps in the part colour; prunes deleted actors
+void SectionClipper::update()
+{
+    for (int i = entries.size() - 1; i >= 0; --i) {
+        Entry& entry = entries[i];
+        if (!entry.actor) {
+            release(entry);
+            entries.remove(i);
+            continue;
+        }
+
+        const bool clipped = entry.own->GetNumberOfItems() > 0 || !sceneSpec.isEmpty();
+        if (!clipped) {
+            if (!entry.mappers.isEmpty())
+                release(entry);
+            continue;
+        }
+
+        if (entry.layout != sceneLayout)
+            combine(entry);
+
+        vtkMapper* mapper = entry.actor->GetMapper();
+        if (mapper && mapper->GetClippingPlanes() != entry.combined) {
+            mapper->SetClippingPlanes(entry.combined);
+            if (!entry.mappers.contains(vtkWeakPointer<vtkMapper>(mapper)))
+                entry.mappers << vtkWeakPointer<vtkMapper>(mapper);
+        }
+
+        // The cap follows the part colour; SetColor is a no-op while it is unchanged
+        double color[3];
+        entry.actor->GetProperty()->GetColor(color);
+        entry.cap->SetColor(color[0] * CapShade, color[1] * CapShade, color[2] * CapShade);
+        if (entry.actor->GetBackfaceProperty() != entry.cap)
+            entry.actor->SetBackfaceProperty(entry.cap);
+    }
+}
+
+/**
+ * @brief StartEvent trampoline.
+ */
+// Forwards the renderer's StartEvent to update()
+void SectionClipper::onStartRender(vtkObject* /*caller*/, unsigned long /*eventId*/, void* clientData, void* /*callData*/)
+{
+    static_cast<SectionClipper*>(clientData)->update();
+}
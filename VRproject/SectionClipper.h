@@ -0,0 +1,189 @@
+/**
+ * @file SectionClipper.h
+ * @brief GPU section planes with screen-space capping for part actors.
+ *
+ * Section planes are handed to the mappers as OpenGL clip distances, so moving a
+ * plane only changes a shader uniform and no geometry is recomputed. The cut is
+ * capped by colouring the back faces seen through it, which for closed meshes
+ * fills exactly the section. ModelPart::bakeSectionPlanes() produces the same cut
+ * as real geometry when an exact mesh is needed.
+ */
+
+#ifndef SECTION_CLIPPER_H
+#define SECTION_CLIPPER_H
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QVector>      // Plane lists and registered actors
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkSmartPointer.h>      // Smart pointer management for VTK
+#include <vtkWeakPointer.h>       // Entries do not keep actors alive
+#include <vtkActor.h>             // Clipped actors
+#include <vtkMapper.h>            // Mappers receiving the planes
+#include <vtkProperty.h>          // Cap (back face) property
+#include <vtkPlaneCollection.h>   // Mapper clipping planes
+#include <vtkMatrix4x4.h>         // Moving planes between coordinate frames
+#include <vtkRenderer.h>          // Renderer the clipper observes
+#include <vtkCallbackCommand.h>   // StartEvent observer
+
+// --------------------------------------- SectionPlane ---------------------------------------
+/**
+ * @brief A clipping plane by value; geometry on the side the normal points to is kept.
+ *
+ * Plain data, so plane lists can be stored on parts and queued for the VR thread.
+ */
+struct SectionPlane {
+    double origin[3];   // Point on the plane (world coordinates)
+    double normal[3];   // Direction of the kept half-space
+};
+
+using SectionPlaneList = QVector<SectionPlane>;
+
+// --------------------------------------- SectionClipper Class ---------------------------------------
+/**
+ * @class SectionClipper
+ * @brief Applies scene-wide and per-actor section planes to the actors of one renderer.
+ *
+ * Every registered actor is clipped by its own planes followed by the scene planes,
+ * up to MaxPlanes in total. The planes are set on whichever mapper the actor uses at
+ * the start of a frame, so levels picked by an LODSwitcher are clipped as well.
+ * Instanced groups (InstanceBatcher) are not clipped: callers draw clipped actors
+ * individually.
+ *
+ * One clipper belongs to exactly one renderer and must only be used from the thread
+ * that renders it.
+ */
+class SectionClipper {
+public:
+    /**
+     * @brief Clip distances available to VTK's OpenGL mappers.
+     */
+    static const int MaxPlanes = 6;
+
+    /**
+     * @brief Constructs a clipper that is not yet attached to a renderer.
+     */
+    // Constructor: creates the render observer
+    SectionClipper();
+
+    /**
+     * @brief Destructor: detaches from the renderer.
+     */
+    // Destructor: removes the observer
+    ~SectionClipper();
+
+    SectionClipper(const SectionClipper&) = delete;
+    SectionClipper& operator=(const SectionClipper&) = delete;
+
+    /**
+     * @brief Starts updating the registered actors each time the renderer begins a frame.
+     * @param renderer Renderer to observe.
+     */
+    // Observes the renderer's StartEvent
+    void attach(vtkRenderer* renderer);
+
+    /**
+     * @brief Stops observing the renderer.
+     */
+    // Removes the StartEvent observer
+    void detach();
+
+    /**
+     * @brief Replaces the planes that clip every registered actor.
+     * @param planes Scene planes; an empty list removes them.
+     *
+     * Planes are moved in place while their number stays the same, which is all a
+     * dragged plane needs.
+     */
+    // Sets the scene-wide planes
+    void setScenePlanes(const SectionPlaneList& planes);
+
+    /**
+     * @brief Returns the scene-wide planes.
+     */
+    // Current scene planes
+    const SectionPlaneList& getScenePlanes() const;
+
+    /**
+     * @brief Registers an actor (if needed) and replaces its own planes.
+     * @param actor  Part actor.
+     * @param planes Planes of this actor only; may be empty, the scene planes still apply.
+     */
+    // Registers an actor and sets its planes
+    void setPartPlanes(vtkActor* actor, const SectionPlaneList& planes);
+
+    /**
+     * @brief Unregisters an actor and removes its clipping and caps.
+     */
+    // Removes one actor
+    void remove(vtkActor* actor);
+
+    /**
+     * @brief Unregisters all actors, removing their clipping and caps.
+     */
+    // Removes every actor
+    void clear();
+
+    /**
+     * @brief Checks whether any plane applies to an actor.
+     * @return True if the actor is registered and has its own planes, or scene planes exist.
+     */
+    // True if the actor is clipped
+    bool isClipped(vtkActor* actor) const;
+
+    /**
+     * @brief Makes a plane collection hold the given planes, reusing its plane objects.
+     * @param collection Target collection.
+     * @param planes     New planes.
+     */
+    // Copies plane values into a collection
+    static void assign(vtkPlaneCollection* collection, const SectionPlaneList& planes);
+
+    /**
+     * @brief Returns the planes moved by a transform.
+     * @param planes Planes to move.
+     * @param matrix Affine transform (nullptr returns the planes unchanged).
+     */
+    // Transforms origins and normals
+    static SectionPlaneList transformed(const SectionPlaneList& planes, vtkMatrix4x4* matrix);
+
+private:
+    /**
+     * @brief One registered actor.
+     */
+    struct Entry {
+        vtkWeakPointer<vtkActor> actor;                 // Dropped automatically when the part is deleted
+        vtkSmartPointer<vtkPlaneCollection> own;        // The actor's own planes
+        vtkSmartPointer<vtkPlaneCollection> combined;   // Own planes, then the scene planes
+        vtkSmartPointer<vtkProperty> cap;               // Back face property drawing the cap
+        QVector<vtkWeakPointer<vtkMapper>> mappers;     // Mappers given the planes (one per LOD level shown)
+        int layout = -1;                                // Scene layout combined was built for
+    };
+
+    // Applies the planes and caps of every registered actor (called before each render)
+    void update();
+
+    // Rebuilds an entry's combined collection after plane counts changed
+    void combine(Entry& entry);
+
+    // Removes clipping and caps from an actor
+    static void release(Entry& entry);
+
+    // VTK observer trampoline
+    static void onStartRender(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+
+    // Returns the index of the actor's entry, or -1
+    int find(vtkActor* actor) const;
+
+    QVector<Entry> entries;                         // Registered actors (tens to hundreds)
+    SectionPlaneList sceneSpec;                     // Scene planes by value
+    vtkSmartPointer<vtkPlaneCollection> scenePlanes; // The same planes, shared by every entry
+    int sceneLayout;                                // Bumped whenever an entry must be recombined
+    vtkWeakPointer<vtkRenderer> renderer;           // Observed renderer
+    vtkSmartPointer<vtkCallbackCommand> callback;   // StartEvent observer
+    unsigned long observerTag;                      // Tag returned by AddObserver
+};
+
+#endif // SECTION_CLIPPER_H
@@ -0,0 +1,231 @@
+/**
+ * @file SessionFile.cpp
+ * @brief Implementation of the binary session format.
+ *
+ * File layout:
+ *  - magic:   "VRSESS\0\0"
+ *  - version: quint32, little-endian (1: no source file stamps, 2: current)
+ *  - payload: qCompress()ed QDataStream (Qt 6.0 format) of the Session
+ */
+
+#include "SessionFile.h"
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QtEndian>
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <cstring>
+
+// --------------------------------------- Helpers ---------------------------------------
+
+namespace {
+
+const char    Magic[8] = { 'V', 'R', 'S', 'E', 'S', 'S', '\0', '\0' };
+const quint32 Version = 2;
+const quint32 UnstampedVersion = 1;   // Fingerprints without the source size and time
+
+// Sessions hold no meshes; anything bigger than this is not one of ours
+const qint64 MaxPayloadBytes = 256 * 1024 * 1024;
+
+// Writes a fixed-size double array
+void writeDoubles(QDataStream& out, const double* values, int count)
+{
+    for (int i = 0; i < count; ++i)
+        out << values[i];
+}
+
+// Reads a fixed-size double array
+void readDoubles(QDataStream& in, double* values, int count)
+{
+    for (int i = 0; i < count; ++i)
+        in >> values[i];
+}
+
+// Plane lists: count, then origin and normal of each plane
+void writePlanes(QDataStream& out, const SectionPlaneList& planes)
+{
+    out << qint32(planes.size());
+    for (const SectionPlane& plane : planes) {
+        writeDoubles(out, plane.origin, 3);
+        writeDoubles(out, plane.normal, 3);
+    }
+}
+
+// Reads a plane list; a negative or huge count marks the stream as corrupt
+void readPlanes(QDataStream& in, SectionPlaneList& planes)
+{
+    qint32 count = 0;
+    in >> count;
+    if (count < 0 || count > 1024) {
+        in.setStatus(QDataStream::ReadCorruptData);
+        return;
+    }
+
+    planes.resize(count);
+    for (SectionPlane& plane : planes) {
+        readDoubles(in, plane.origin, 3);
+        readDoubles(in, plane.normal, 3);
+    }
+}
+
+} // namespace
+
+// --------------------------------------- Writing ---------------------------------------
+
+/**
+ * @brief Writes a session, replacing the file atomically.
+ * @param fileName Session file.
+ * @param session  State to store.
+ * @return True if the file was written.
+ *
+ * The identity transform, missing bounds and empty plane lists cost a flag or a
+ * count each, so a plain part takes little more than its name and path.
+ */
+// Serialises the session into a buffer, compresses it and saves it
+bool SessionFile::write(const QString& fileName, const Session& session)
+{
+    const QDir base = QFileInfo(fileName).absoluteDir();
+
+    QByteArray payload;
+    {
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+
+        writeDoubles(out, session.cameraPosition, 3);
+        writeDoubles(out, session.cameraFocalPoint, 3);
+        writeDoubles(out, session.cameraViewUp, 3);
+        out << session.cameraViewAngle << qint32(session.lightIntensity);
+        out << (session.skyboxFolder.isEmpty() ? QString() : base.relativeFilePath(session.skyboxFolder));
+        writePlanes(out, session.scenePlanes);
+
+        out << qint32(session.parts.size());
+        for (const Part& part : session.parts) {
+            out << qint32(part.parent) << part.name;
+            out << (part.sourceFile.isEmpty() ? QString() : base.relativeFilePath(part.sourceFile));
+            out << part.fingerprint << part.sourceSize << part.sourceModified;
+            out << part.color << part.visible;
+            out << part.clipEnabled;
+            writePlanes(out, part.clipPlanes);
+            out << part.shrinkEnabled << part.shrinkFactor;
+            out << part.hasTransform;
+            if (part.hasTransform)
+                writeDoubles(out, part.transform, 16);
+            writePlanes(out, part.sectionPlanes);
+            out << part.hasBounds;
+            if (part.hasBounds)
+                writeDoubles(out, part.bounds, 6);
+        }
+
+        if (out.status() != QDataStream::Ok)
+            return false;
+    }
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    const QByteArray compressed = qCompress(payload);
+    char version[sizeof(quint32)];
+    qToLittleEndian<quint32>(Version, version);
+    file.write(Magic, sizeof(Magic));
+    file.write(version, sizeof(version));
+    file.write(compressed);
+    return file.commit();
+}
+
+// --------------------------------------- Reading ---------------------------------------
+
+/**
+ * @brief Reads a session.
+ * @param fileName Session file.
+ * @param session  Receives the state; left unchanged on failure.
+ * @return False if the file is missing, truncated or not a session of a known version.
+ *
+ * Version 1 sessions carry no source file stamps; their parts get a sourceSize of -1,
+ * so their fingerprints are computed again on restore.
+ */
+// Checks magic and version, then deserialises with full validation of the tree
+bool SessionFile::read(const QString& fileName, Session& session)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly) || file.size() > MaxPayloadBytes)
+        return false;
+
+    char magic[sizeof(Magic)];
+    char versionBytes[sizeof(quint32)];
+    if (file.read(magic, sizeof(magic)) != qint64(sizeof(magic))
+        || file.read(versionBytes, sizeof(versionBytes)) != qint64(sizeof(versionBytes))
+        || std::memcmp(magic, Magic, sizeof(Magic)) != 0)
+        return false;
+    const quint32 version = qFromLittleEndian<quint32>(versionBytes);
+    if (version != Version && version != UnstampedVersion)
+        return false;
+
+    const QByteArray payload = qUncompress(file.readAll());
+    if (payload.isEmpty())
+        return false;
+
+    const QDir base = QFileInfo(fileName).absoluteDir();
+    auto absolute = [&base](const QString& path) {
+        return path.isEmpty() ? QString() : QDir::cleanPath(base.absoluteFilePath(path));
+    };
+
+    QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    Session result;
+    qint32 light = 0;
+    QString skybox;
+    readDoubles(in, result.cameraPosition, 3);
+    readDoubles(in, result.cameraFocalPoint, 3);
+    readDoubles(in, result.cameraViewUp, 3);
+    in >> result.cameraViewAngle >> light >> skybox;
+    result.lightIntensity = light;
+    result.skyboxFolder = absolute(skybox);
+    readPlanes(in, result.scenePlanes);
+
+    qint32 count = 0;
+    in >> count;
+    if (in.status() != QDataStream::Ok || count < 0 || count > payload.size())
+        return false;
+
+    result.parts.resize(count);
+    for (int i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        Part& part = result.parts[i];
+        qint32 parent = -1;
+        QString source;
+        in >> parent >> part.name >> source >> part.fingerprint;
+        if (version != UnstampedVersion)
+            in >> part.sourceSize >> part.sourceModified;
+        in >> part.color >> part.visible;
+        in >> part.clipEnabled;
+        readPlanes(in, part.clipPlanes);
+        in >> part.shrinkEnabled >> part.shrinkFactor;
+        in >> part.hasTransform;
+        if (part.hasTransform)
+            readDoubles(in, part.transform, 16);
+        readPlanes(in, part.sectionPlanes);
+        in >> part.hasBounds;
+        if (part.hasBounds)
+            readDoubles(in, part.bounds, 6);
+
+        // Depth-first order: a parent is always an earlier node
+        if (parent < -1 || parent >= i)
+            return false;
+        part.parent = parent;
+        part.sourceFile = absolute(source);
+    }
+
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    session = result;
+    return true;
+}
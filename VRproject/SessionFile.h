@@ -0,0 +1,92 @@
+/**
+ * @file SessionFile.h
+ * @brief Compact binary session files: the part tree and view state, without geometry.
+ *
+ * A session stores what the user set up rather than what was loaded: the tree of
+ * assemblies and parts with each part's source file, colour, visibility, filter
+ * settings, transform and section planes, plus the camera, light and skybox. The
+ * meshes stay in their STL files (and mesh caches), so a session is a few bytes per
+ * part and opening one only has to rebuild the tree before geometry streams in.
+ */
+
+#ifndef SESSION_FILE_H
+#define SESSION_FILE_H
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QString>      // File paths and names
+#include <QByteArray>   // Content fingerprints
+#include <QColor>       // Part colours
+#include <QVector>      // Parts of a session
+
+#include "SectionClipper.h"     // SectionPlaneList
+
+// --------------------------------------- SessionFile Class ---------------------------------------
+/**
+ * @class SessionFile
+ * @brief Reads and writes session files.
+ *
+ * The file is a short header (magic and little-endian version) followed by a
+ * compressed QDataStream of the Session. Source paths are stored relative to the session
+ * file, so a session saved next to its parts still opens after the folder has been
+ * moved. All functions are static and do no GUI work.
+ */
+class SessionFile {
+public:
+    /**
+     * @brief One tree node, stored depth-first so parents always come before their children.
+     */
+    struct Part {
+        int parent = -1;                // Index of the parent node in Session::parts (-1: top level)
+        QString name;                   // Tree label
+        QString sourceFile;             // STL file (absolute when read back; empty for assemblies)
+        QByteArray fingerprint;         // Content fingerprint, so restore does not re-read the file
+        qint64 sourceSize = -1;         // Size of the source file the fingerprint belongs to (-1: unknown)
+        qint64 sourceModified = 0;      // Its modification time (ms since epoch)
+        QColor color;                   // Part colour
+        bool visible = true;            // Visibility flag
+        bool clipEnabled = false;       // Capped clip filter on
+        SectionPlaneList clipPlanes;    // Clip planes (model coordinates)
+        bool shrinkEnabled = false;     // Shrink filter on
+        double shrinkFactor = 0.8;      // Shrink factor
+        bool hasTransform = false;      // False for the identity
+        double transform[16] = {};      // Local transform, row major
+        SectionPlaneList sectionPlanes; // GPU section planes (world coordinates)
+        bool hasBounds = false;         // False if the part had no geometry when saved
+        double bounds[6] = {};          // World bounds when saved, used to order streaming
+    };
+
+    /**
+     * @brief Everything a session file holds.
+     */
+    struct Session {
+        double cameraPosition[3] = { 0.0, 0.0, 1.0 };
+        double cameraFocalPoint[3] = { 0.0, 0.0, 0.0 };
+        double cameraViewUp[3] = { 0.0, 1.0, 0.0 };
+        double cameraViewAngle = 30.0;
+        int lightIntensity = 50;        // Light slider value (0-100)
+        QString skyboxFolder;           // Skybox folder or KTX2 file (empty: none)
+        SectionPlaneList scenePlanes;   // Scene-wide section planes
+        QVector<Part> parts;            // Tree nodes, depth-first
+    };
+
+    /**
+     * @brief Writes a session, replacing the file atomically.
+     * @param fileName Session file.
+     * @param session  State to store.
+     * @return True if the file was written.
+     */
+    // Serialises and compresses the session
+    static bool write(const QString& fileName, const Session& session);
+
+    /**
+     * @brief Reads a session.
+     * @param fileName Session file.
+     * @param session  Receives the state; source paths are made absolute.
+     * @return False if the file is missing, truncated or not a session of a known version.
+     */
+    // Checks the header, decompresses and deserialises
+    static bool read(const QString& fileName, Session& session);
+};
+
+#endif // SESSION_FILE_H
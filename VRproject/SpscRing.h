@@ -0,0 +1,92 @@
+/**
+ * @file SpscRing.h
+ * @brief Fixed-capacity single-producer/single-consumer lock-free ring buffer.
+ *
+ * Used to pass scene commands from the GUI thread to the VR render thread
+ * without either side ever blocking on a mutex.
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <array>      // Slot storage
+#include <atomic>     // Head/tail indices
+#include <cstddef>    // size_t
+#include <utility>    // std::move
+
+// --------------------------------------- SpscRing Class ---------------------------------------
+/**
+ * @class SpscRing
+ * @brief Lock-free ring buffer for exactly one producer thread and one consumer thread.
+ *
+ * The producer only writes `tail` and the consumer only writes `head`, so a single
+ * acquire/release pair per operation is enough to publish a slot. Capacity must be a
+ * power of two; one slot is always left empty to tell "full" from "empty".
+ *
+ * @tparam T        Element type (must be default-constructible and movable).
+ * @tparam Capacity Number of slots (power of two).
+ */
+template <typename T, std::size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    /**
+     * @brief Constructs an empty ring.
+     */
+    SpscRing() : head(0), tail(0) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * @brief Appends an item (producer thread only).
+     * @param item Item to move into the ring.
+     * @return False if the ring is full; the item is left untouched.
+     */
+    bool push(T&& item)
+    {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        const std::size_t next = (t + 1) & (Capacity - 1);
+        if (next == head.load(std::memory_order_acquire))
+            return false;
+
+        slots[t] = std::move(item);
+        tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest item (consumer thread only).
+     * @param item Receives the removed item.
+     * @return False if the ring is empty.
+     */
+    bool pop(T& item)
+    {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire))
+            return false;
+
+        item = std::move(slots[h]);
+        slots[h] = T();     // Release any resources held by the slot
+        head.store((h + 1) & (Capacity - 1), std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Returns true if no items are waiting (approximate when called concurrently).
+     */
+    bool empty() const
+    {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+private:
+    std::array<T, Capacity> slots;                 // Item storage
+    alignas(64) std::atomic<std::size_t> head;     // Next slot to read (consumer-owned)
+    alignas(64) std::atomic<std::size_t> tail;     // Next slot to write (producer-owned)
+};
+
+#endif // SPSC_RING_H
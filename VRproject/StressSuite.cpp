@@ -0,0 +1,540 @@
+/**
+ * @file StressSuite.cpp
+ * @brief Implementation of the synthetic scene stress suite.
+ */
+
+#include "StressSuite.h"
+#include "ModelPart.h"
+#include "ModelPartList.h"
+#include "FilterRunner.h"
+#include "SceneBVH.h"
+#include "LODSwitcher.h"
+#include "InstanceBatcher.h"
+#include "FrameProfiler.h"
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+#include <QtConcurrent>
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkPolyData.h>
+#include <vtkPointData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkMath.h>
+#include <vtkActor.h>
+#include <vtkCamera.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkOpenGLRenderWindow.h>
+#include <vtkCullerCollection.h>
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+
+// --------------------------------------- Platform Includes ---------------------------------------
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// --------------------------------------- Helpers ---------------------------------------
+
+namespace {
+
+// Parts per assembly node, like a large sub-assembly of an imported folder
+const int PartsPerAssembly = 100;
+
+// Grid pitch of the parts, in sphere radii of the largest mesh
+const double GridSpacing = 2.5;
+const double MaxRadius = 0.5;
+
+// Closest the camera gets during the orbit, as a dolly factor; close-ups cull most parts
+const double MaxDolly = 4.0;
+
+// Shrink factor used by the filter stage (the application's default)
+const double ShrinkFactor = 0.8;
+
+/**
+ * @brief A checked metric and the absolute change it must exceed to count.
+ */
+struct CheckedMetric {
+    const char* group;  // Nested object ("desktop", "vr"), or nullptr for a top-level value
+    const char* name;   // Key of the value
+    double margin;      // Absolute slack on top of the relative threshold
+};
+
+// Metrics compared against the baseline: all of them get worse as they grow
+const CheckedMetric CheckedMetrics[] = {
+    { nullptr,   "load_ms",   1.0 },
+    { nullptr,   "shrink_ms", 1.0 },
+    { nullptr,   "clip_ms",   1.0 },
+    { "desktop", "p50_ms",    1.0 },
+    { "desktop", "p95_ms",    1.0 },
+    { "desktop", "p99_ms",    1.0 },
+    { "vr",      "p50_ms",    1.0 },
+    { "vr",      "p95_ms",    1.0 },
+    { "vr",      "p99_ms",    1.0 },
+    { nullptr,   "memory_mb", 16.0 },
+};
+
+/**
+ * @brief A unique mesh after the load stage.
+ */
+struct LoadedMesh {
+    vtkSmartPointer<vtkPolyData> mesh;                  // Mesh with normals and feature edges
+    QVector<vtkSmartPointer<vtkPolyData>> levels;       // LOD meshes (empty for small meshes)
+};
+
+// Returns the process's current resident memory in bytes
+qint64 residentMemoryBytes()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return qint64(counters.WorkingSetSize);
+    return 0;
+#elif defined(__linux__)
+    // Second field of statm: resident pages
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly))
+        return 0;
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    return fields.size() > 1 ? fields[1].toLongLong() * qint64(sysconf(_SC_PAGESIZE)) : 0;
+#else
+    // No cheap current value; the peak is the closest upper bound
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return qint64(usage.ru_maxrss);
+#endif
+}
+
+// Builds a sphere of about the requested triangle count, without normals (like a parsed STL)
+vtkSmartPointer<vtkPolyData> sphereMesh(qint64 triangles, double radius)
+{
+    // A sphere of resolution r has 2r(r - 2) triangles
+    const int resolution = std::max(3, int(std::lround(1.0 + std::sqrt(1.0 + double(triangles) / 2.0))));
+
+    auto sphere = vtkSmartPointer<vtkSphereSource>::New();
+    sphere->SetRadius(radius);
+    sphere->SetThetaResolution(resolution);
+    sphere->SetPhiResolution(resolution);
+    sphere->Update();
+
+    auto mesh = vtkSmartPointer<vtkPolyData>::New();
+    mesh->DeepCopy(sphere->GetOutput());
+    mesh->GetPointData()->SetNormals(nullptr);
+    return mesh;
+}
+
+// Load stage of one unique mesh, as PartLoader runs it for a file (thread-safe)
+LoadedMesh loadMesh(const vtkSmartPointer<vtkPolyData>& raw)
+{
+    LoadedMesh loaded;
+    loaded.mesh = ModelPart::computeNormals(raw);
+    loaded.levels = ModelPart::generateLODs(loaded.mesh);
+    return loaded;
+}
+
+// Nearest-rank percentile of sorted values
+double percentile(const QVector<double>& sorted, double fraction)
+{
+    if (sorted.isEmpty())
+        return 0.0;
+    const int rank = int(std::ceil(fraction * sorted.size())) - 1;
+    return sorted[std::clamp(rank, 0, int(sorted.size()) - 1)];
+}
+
+// Waits for the filter jobs to be delivered, then draws the frame that shows them
+void waitForFilters(FilterRunner& runner, vtkRenderWindow* window)
+{
+    while (!runner.isIdle())
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+
+    window->Render();
+    if (vtkOpenGLRenderWindow* glWindow = vtkOpenGLRenderWindow::SafeDownCast(window))
+        glWindow->WaitForCompletion();
+}
+
+// Times a batch of filter changes from the first schedule to the frame that shows them, in ms
+double timeFilters(FilterRunner& runner, vtkRenderWindow* window, const std::function<void()>& apply)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    runner.beginBatch();
+    apply();
+    runner.endBatch();
+    waitForFilters(runner, window);
+
+    return double(timer.nsecsElapsed()) * 1.0e-6;
+}
+
+// Orbits the camera once while dollying in and out, recording each frame's wall time
+QJsonObject measureFrames(vtkRenderWindow* window, vtkRenderer* renderer, int frames, int views)
+{
+    vtkOpenGLRenderWindow* glWindow = vtkOpenGLRenderWindow::SafeDownCast(window);
+    vtkCamera* camera = renderer->GetActiveCamera();
+    auto start = vtkSmartPointer<vtkCamera>::New();
+    start->DeepCopy(camera);
+
+    // Warm-up: shader compilation, buffer upload and the first instance/merge rebuild
+    window->Render();
+    if (glWindow)
+        glWindow->WaitForCompletion();
+
+    FrameProfiler profiler(frames);
+    QVector<double> wallMs;
+    wallMs.reserve(frames);
+    QElapsedTimer timer;
+
+    for (int i = 0; i < frames; ++i) {
+        const double phase = 2.0 * vtkMath::Pi() * i / frames;
+        camera->DeepCopy(start);
+        camera->Azimuth(360.0 * i / frames);
+        camera->Dolly(1.0 + (MaxDolly - 1.0) * 0.5 * (1.0 - std::cos(phase)));
+        renderer->ResetCameraClippingRange();
+
+        timer.start();
+        window->MakeCurrent();
+        profiler.beginFrame();
+        window->Render();
+        profiler.endFrame(renderer, views);
+        if (glWindow)
+            glWindow->WaitForCompletion();
+        wallMs << double(timer.nsecsElapsed()) * 1.0e-6;
+    }
+
+    const QVector<FrameProfiler::FrameRecord> trace = profiler.trace();
+    window->MakeCurrent();
+    profiler.releaseGraphicsResources();
+    camera->DeepCopy(start);
+
+    // GPU times arrive a few frames late; the last ones may be missing
+    QVector<double> gpuMs;
+    double drawCalls = 0.0, triangles = 0.0;
+    for (const FrameProfiler::FrameRecord& record : trace) {
+        if (record.gpuMs >= 0.0)
+            gpuMs << record.gpuMs;
+        drawCalls += record.drawCalls;
+        triangles += double(record.triangles);
+    }
+
+    double total = 0.0;
+    for (double ms : wallMs)
+        total += ms;
+    std::sort(wallMs.begin(), wallMs.end());
+    std::sort(gpuMs.begin(), gpuMs.end());
+
+    QJsonObject result;
+    result["frames"] = frames;
+    result["mean_ms"] = total / frames;
+    result["p50_ms"] = percentile(wallMs, 0.50);
+    result["p95_ms"] = percentile(wallMs, 0.95);
+    result["p99_ms"] = percentile(wallMs, 0.99);
+    result["max_ms"] = wallMs.last();
+    result["gpu_p50_ms"] = percentile(gpuMs, 0.50);
+    result["gpu_p95_ms"] = percentile(gpuMs, 0.95);
+    result["draw_calls"] = trace.isEmpty() ? 0.0 : drawCalls / trace.size();
+    result["triangles_per_frame"] = trace.isEmpty() ? 0.0 : triangles / trace.size();
+    return result;
+}
+
+// Creates an offscreen window whose renderer culls through the BVH
+vtkSmartPointer<vtkRenderWindow> createWindow(int width, int height, SceneBVH* bvh, vtkRenderer* renderer)
+{
+    auto window = vtkSmartPointer<vtkRenderWindow>::New();
+    window->SetOffScreenRendering(1);
+    window->SetSize(width, height);
+    window->AddRenderer(renderer);
+
+    auto culler = vtkSmartPointer<SceneBVHCuller>::New();
+    culler->SetBVH(bvh);
+    renderer->GetCullers()->RemoveAllItems();
+    renderer->AddCuller(culler);
+    return window;
+}
+
+// Returns a checked metric of a scene object, or -1 if it is missing
+double metricValue(const QJsonObject& scene, const CheckedMetric& metric)
+{
+    const QJsonValue value = metric.group ? scene[metric.group].toObject()[metric.name] : scene[metric.name];
+    return value.isDouble() ? value.toDouble() : -1.0;
+}
+
+} // namespace
+
+// --------------------------------------- Scenes ---------------------------------------
+
+/**
+ * @brief Returns the built-in scenes.
+ */
+// Presets from 10 parts / 1k triangles to 100k parts / 50M triangles
+QList<StressSuite::Scene> StressSuite::presets()
+{
+    return {
+        { "tiny",     10,     1000,     10 },
+        { "small",    100,    100000,   10 },
+        { "medium",   1000,   1000000,  50 },
+        { "detailed", 200,    10000000, 20 },
+        { "large",    10000,  10000000, 200 },
+        { "huge",     100000, 50000000, 1000 },
+    };
+}
+
+/**
+ * @brief Parses a comma-separated list of preset names and "parts:triangles[:unique]" entries.
+ * @param specs Scene list.
+ * @param error Receives a message for the first bad entry.
+ */
+// Presets by name, custom sizes by spec
+QList<StressSuite::Scene> StressSuite::parseScenes(const QString& specs, QString* error)
+{
+    const QList<Scene> known = presets();
+    QList<Scene> scenes;
+
+    for (const QString& entry : specs.split(',', Qt::SkipEmptyParts)) {
+        const QString spec = entry.trimmed();
+
+        auto preset = std::find_if(known.begin(), known.end(), [&](const Scene& scene) { return scene.name == spec; });
+        if (preset != known.end()) {
+            scenes << *preset;
+            continue;
+        }
+
+        const QStringList fields = spec.split(':');
+        Scene scene;
+        bool partsOk = false, trianglesOk = false, uniqueOk = true;
+        if (fields.size() == 2 || fields.size() == 3) {
+            scene.name = spec;
+            scene.parts = fields[0].toInt(&partsOk);
+            scene.triangles = fields[1].toLongLong(&trianglesOk);
+            scene.uniqueMeshes = fields.size() == 3 ? fields[2].toInt(&uniqueOk) : qMax(1, scene.parts / 100);
+        }
+        if (!partsOk || !trianglesOk || !uniqueOk || scene.parts < 1 || scene.triangles < scene.parts || scene.uniqueMeshes < 1) {
+            if (error)
+                *error = QString("Invalid scene \"%1\": expected a preset name or parts:triangles[:unique]").arg(spec);
+            return {};
+        }
+        scene.uniqueMeshes = qMin(scene.uniqueMeshes, scene.parts);
+        scenes << scene;
+    }
+
+    if (scenes.isEmpty() && error)
+        *error = "No scenes given";
+    return scenes;
+}
+
+// --------------------------------------- Run ---------------------------------------
+
+/**
+ * @brief Builds, filters and renders a scene.
+ * @param scene   Scene size.
+ * @param options Frame count and window sizes.
+ *
+ * Stages: load (normals, feature edges and LODs of the unique meshes on the thread
+ * pool, then the tree and the scene helpers), desktop frames, shrink and clip of
+ * every part through a FilterRunner batch, and stereo frames at headset resolution
+ * with merged batches like the VR thread while stationary.
+ */
+// Runs one scene and returns its metrics
+QJsonObject StressSuite::run(const Scene& scene, const Options& options)
+{
+    const qint64 residentBefore = residentMemoryBytes();
+    const int unique = qBound(1, scene.uniqueMeshes, scene.parts);
+    const qint64 perPart = qMax<qint64>(1, scene.triangles / scene.parts);
+
+    // Raw meshes stand in for parsed files; making them is not part of the load time
+    QVector<vtkSmartPointer<vtkPolyData>> raw;
+    raw.reserve(unique);
+    for (int i = 0; i < unique; ++i)
+        raw << sphereMesh(perPart, MaxRadius * (0.7 + 0.3 * double(i + 1) / unique));
+
+    auto list = std::make_unique<ModelPartList>("Stress");
+    QList<ModelPart*> parts;
+    SceneBVH bvh;
+    LODSwitcher lod;
+    InstanceBatcher instances;
+    QElapsedTimer timer;
+    instances.setBVH(&bvh);
+
+    // ---- Load: mesh preparation in parallel, then the tree and scene registration ----
+    timer.start();
+    const QVector<LoadedMesh> meshes = QtConcurrent::blockingMapped<QVector<LoadedMesh>>(raw, loadMesh);
+    raw.clear();
+
+    const int side = int(std::ceil(std::cbrt(double(scene.parts))));
+    const double pitch = GridSpacing * MaxRadius;
+    ModelPart* root = list->getRootItem();
+    ModelPart* assembly = nullptr;
+    qint64 triangles = 0;
+    auto matrix = vtkSmartPointer<vtkMatrix4x4>::New();
+
+    for (int i = 0; i < scene.parts; ++i) {
+        if (i % PartsPerAssembly == 0)
+            assembly = list->appendPart(root, QList<QVariant>{ QString("Assembly %1").arg(i / PartsPerAssembly + 1), "true" });
+
+        ModelPart* part = list->appendPart(assembly, QList<QVariant>{ QString("Part %1").arg(i + 1), "true" });
+        const LoadedMesh& loaded = meshes[i % unique];
+        part->setPolyData(loaded.mesh);
+        part->setLODs(loaded.levels);
+
+        matrix->SetElement(0, 3, pitch * (i % side));
+        matrix->SetElement(1, 3, pitch * ((i / side) % side));
+        matrix->SetElement(2, 3, pitch * (i / (side * side)));
+        part->setLocalTransform(matrix);
+
+        vtkActor* actor = part->getActor();
+        instances.add(actor, part->getSharedGeometry());
+        bvh.insert(actor, part);
+        lod.setLevels(actor, part->getLODMappers());
+
+        triangles += loaded.mesh->GetNumberOfPolys();
+        parts << part;
+    }
+    const double loadMs = double(timer.nsecsElapsed()) * 1.0e-6;
+    const qint64 residentLoaded = residentMemoryBytes();
+
+    QJsonObject result;
+    result["name"] = scene.name;
+    result["parts"] = scene.parts;
+    result["unique_meshes"] = unique;
+    result["triangles"] = double(triangles);
+    result["lod_levels"] = int(meshes.first().levels.size());
+    result["load_ms"] = loadMs;
+
+    // ---- Desktop: the application's renderer setup ----
+    {
+        auto renderer = vtkSmartPointer<vtkRenderer>::New();
+        vtkSmartPointer<vtkRenderWindow> window = createWindow(options.width, options.height, &bvh, renderer);
+        lod.attach(renderer);
+        instances.attach(renderer);
+        renderer->ResetCamera();
+
+        result["desktop"] = measureFrames(window, renderer, options.frames, 1);
+
+        // ---- Filters: every part through one FilterRunner batch, regrouped as in MainWindow ----
+        FilterRunner runner;
+        ModelPart::setFilterScheduler([&runner](ModelPart* part) { runner.schedule(part); });
+        QObject::connect(&runner, &FilterRunner::partFiltered, &runner, [&](ModelPart* part) {
+            vtkActor* actor = part->getActor();
+            instances.setSharedGeometry(actor, part->getSharedGeometry());
+            lod.setLevels(actor, part->getLODMappers());
+            bvh.update(actor);
+        });
+
+        double origin[3] = { 0.0, 0.0, 0.0 };
+        double normal[3] = { 0.0, -1.0, 0.0 };
+        result["shrink_ms"] = timeFilters(runner, window, [&]() {
+            for (ModelPart* part : parts)
+                part->applyShrinkFilter(true, ShrinkFactor);
+        });
+        timeFilters(runner, window, [&]() {
+            for (ModelPart* part : parts)
+                part->applyShrinkFilter(false, ShrinkFactor);
+        });
+        result["clip_ms"] = timeFilters(runner, window, [&]() {
+            for (ModelPart* part : parts)
+                part->applyClipFilter(true, origin, normal);
+        });
+        timeFilters(runner, window, [&]() {
+            for (ModelPart* part : parts)
+                part->applyClipFilter(false, origin, normal);
+        });
+        ModelPart::setFilterScheduler(nullptr);
+
+        instances.detach();
+        lod.detach();
+    }
+
+    // ---- VR: both eyes at headset resolution, merged static parts ----
+    {
+        auto renderer = vtkSmartPointer<vtkRenderer>::New();
+        vtkSmartPointer<vtkRenderWindow> window = createWindow(options.vrWidth, options.vrHeight, &bvh, renderer);
+        window->SetStereoTypeToSplitViewportHorizontal();
+        window->StereoRenderOn();
+
+        instances.setMerging(true);
+        for (ModelPart* part : parts)
+            instances.setMergeable(part->getActor(), part->getLODMappers().isEmpty());
+        lod.attach(renderer);
+        instances.attach(renderer);
+        renderer->ResetCamera();
+
+        result["vr"] = measureFrames(window, renderer, options.frames, 2);
+
+        instances.detach();
+        lod.detach();
+    }
+
+    const qint64 residentAfter = residentMemoryBytes();
+    result["resident_mb"] = double(residentAfter) / (1024.0 * 1024.0);
+    result["memory_mb"] = double(qMax<qint64>(0, qMax(residentLoaded, residentAfter) - residentBefore)) / (1024.0 * 1024.0);
+
+    // Helpers go before the parts whose actors they hold
+    instances.clear();
+    lod.clear();
+    bvh.clear();
+    list.reset();
+    return result;
+}
+
+// --------------------------------------- Baseline ---------------------------------------
+
+/**
+ * @brief Lists the metrics of a report that regressed against a baseline.
+ * @param report    Current report.
+ * @param baseline  Stored report.
+ * @param threshold Allowed relative increase.
+ */
+// Matches scenes by name and checks each metric in CheckedMetrics
+QJsonArray StressSuite::compare(const QJsonObject& report, const QJsonObject& baseline, double threshold)
+{
+    QHash<QString, QJsonObject> stored;
+    for (const QJsonValue& value : baseline["scenes"].toArray())
+        stored.insert(value.toObject()["name"].toString(), value.toObject());
+
+    QJsonArray regressions;
+    for (const QJsonValue& value : report["scenes"].toArray()) {
+        const QJsonObject scene = value.toObject();
+        auto it = stored.constFind(scene["name"].toString());
+        if (it == stored.constEnd())
+            continue;
+
+        for (const CheckedMetric& metric : CheckedMetrics) {
+            const double before = metricValue(*it, metric);
+            const double now = metricValue(scene, metric);
+            if (before < 0.0 || now < 0.0)
+                continue;
+            if (now <= before * (1.0 + threshold) || now - before <= metric.margin)
+                continue;
+
+            QJsonObject regression;
+            regression["scene"] = scene["name"];
+            regression["metric"] = metric.group ? QString("%1.%2").arg(metric.group, metric.name) : QString(metric.name);
+            regression["baseline"] = before;
+            regression["current"] = now;
+            regression["change"] = before > 0.0 ? now / before - 1.0 : 0.0;
+            regressions.append(regression);
+        }
+    }
+    return regressions;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file StressSuite.h
+ * @brief Synthetic scenes from tens to a hundred thousand parts, timed through the
+ *        desktop and an offscreen VR-style render path, with baseline comparison.
+ *
+ * Every scene is built, filtered and drawn with the same helpers the application
+ * uses (SceneBVH culling, LODSwitcher, InstanceBatcher, FilterRunner), so culling,
+ * LOD, instancing and scheduling costs show up in the numbers the way they do for
+ * a user, and a report can be stored and compared against later runs.
+ */
+
+#ifndef STRESS_SUITE_H
+#define STRESS_SUITE_H
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QString>      // Scene names and specs
+#include <QList>        // Scene lists
+#include <QJsonObject>  // Per-scene results and reports
+#include <QJsonArray>   // Regression lists
+
+// --------------------------------------- StressSuite Class ---------------------------------------
+/**
+ * @class StressSuite
+ * @brief Builds synthetic assemblies, measures them and compares reports.
+ *
+ * A scene is made of a few unique sphere meshes repeated over many parts, grouped
+ * into assemblies of up to a hundred parts laid out on a grid. Repeated meshes are
+ * instanced and meshes of 20k triangles or more get LOD levels, exactly as loaded
+ * STL files would. Must be used on the thread that owns the QCoreApplication.
+ */
+class StressSuite {
+public:
+    /**
+     * @brief Size of one synthetic scene.
+     */
+    struct Scene {
+        QString name;           // Key used to match baseline entries
+        int parts = 0;          // Leaf parts in the tree
+        qint64 triangles = 0;   // Requested triangles over all parts
+        int uniqueMeshes = 1;   // Distinct meshes the parts are shared between
+    };
+
+    /**
+     * @brief Render settings shared by all scenes.
+     */
+    struct Options {
+        int frames = 300;           // Measured frames per path
+        int width = 1920;           // Desktop window size
+        int height = 1080;
+        int vrWidth = 2880;         // VR window size, both eyes side by side
+        int vrHeight = 1600;
+    };
+
+    /**
+     * @brief Returns the built-in scenes, smallest first.
+     *
+     * They range from 10 parts with 1k triangles to 100k parts with 50M triangles;
+     * "detailed" has few heavy parts so LOD switching is exercised.
+     */
+    // Named scene presets
+    static QList<Scene> presets();
+
+    /**
+     * @brief Parses a comma-separated scene list.
+     * @param specs Preset names or "parts:triangles[:unique]" entries.
+     * @param error Set to a message for the first invalid entry.
+     * @return The scenes, or an empty list on error.
+     */
+    // Resolves --scenes into scene sizes
+    static QList<Scene> parseScenes(const QString& specs, QString* error);
+
+    /**
+     * @brief Builds, filters and renders one scene, then tears it down.
+     * @param scene   Scene to run.
+     * @param options Frame count and window sizes.
+     * @return Metrics of the scene (see compare() for the ones checked).
+     */
+    // Runs the load, filter, desktop and VR stages for a scene
+    static QJsonObject run(const Scene& scene, const Options& options);
+
+    /**
+     * @brief Compares a report's scenes with a baseline report.
+     * @param report    Report with a "scenes" array from this run.
+     * @param baseline  Stored report.
+     * @param threshold Allowed relative increase, e.g. 0.2 for 20%.
+     * @return One object per regressed metric; empty if none regressed.
+     *
+     * Times and memory are checked. A metric must exceed the baseline by the
+     * threshold and by a small absolute margin (1 ms, 16 MB), so timer noise on
+     * tiny scenes does not fail a run. Scenes missing from the baseline are skipped.
+     */
+    // Lists metrics that got worse than the baseline allows
+    static QJsonArray compare(const QJsonObject& report, const QJsonObject& baseline, double threshold);
+};
+
+#endif // STRESS_SUITE_H
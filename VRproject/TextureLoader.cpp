@@ -0,0 +1,277 @@
+/**
+ * @file TextureLoader.cpp
+ * @brief Implementation of background skybox and background-image loading.
+ */
+
+#include "TextureLoader.h"
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QtConcurrent>
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+
+// --------------------------------------- Cache Size ---------------------------------------
+
+namespace {
+
+// Textures kept after they were replaced; each one keeps its GPU copy
+const int CacheCapacity = 4;
+
+// Cubemap face names in GL order
+const char* const FaceNames[6] = { "px", "nx", "py", "ny", "pz", "nz" };
+
+} // namespace
+
+// --------------------------------------- Constructor & Destructor ---------------------------------------
+
+/**
+ * @brief Constructs a loader with an empty cache.
+ * @param parent Optional QObject parent.
+ */
+// Starts with no cached textures
+TextureLoader::TextureLoader(QObject* parent)
+    : QObject(parent)
+    , skyboxRequest(0)
+    , backgroundRequest(0)
+{
+}
+
+// --------------------------------------- Public Interface ---------------------------------------
+
+/**
+ * @brief Sets the window used for compressed cubemap uploads.
+ * @param newWindow Desktop render window.
+ */
+// Stores the render window
+void TextureLoader::setRenderWindow(vtkOpenGLRenderWindow* newWindow)
+{
+    window = newWindow;
+}
+
+/**
+ * @brief Loads a skybox folder, from the cache if it was used recently.
+ * @param directory Folder with a `.ktx2` cubemap or six face images.
+ */
+// Starts (or skips) a skybox decode
+void TextureLoader::loadSkybox(const QString& directory)
+{
+    const int request = ++skyboxRequest;
+
+    // A pre-compressed cubemap wins over loose faces
+    const QStringList compressed = QDir(directory).entryList({ "*.ktx2" }, QDir::Files, QDir::Name);
+    if (!compressed.isEmpty()) {
+        const QString fileName = QDir(directory).filePath(compressed.first());
+        const QString key = cacheKey("ktx2", fileName, { fileName });
+        CacheEntry hit = cached(key);
+        if (hit.texture) {
+            emit skyboxReady(hit.texture, hit.source);
+            return;
+        }
+
+        workers.watch(this, QtConcurrent::run(&TextureLoader::readCompressed, fileName),
+                      [this, request, key, directory](QFutureWatcher<CompressedResult>* watcher) {
+            CompressedResult result = watcher->result();
+
+            if (request != skyboxRequest)
+                return;
+            if (!result.error.isEmpty()) {
+                emit loadFailed(directory, result.error);
+                return;
+            }
+
+            // The upload is a straight copy of the blocks, so it is cheap on the GUI thread
+            vtkSmartPointer<vtkOpenGLTexture> texture = UploadCompressedCubemap(window, result.cubemap);
+            if (!texture) {
+                emit loadFailed(directory, tr("compressed cubemap could not be uploaded"));
+                return;
+            }
+            auto source = std::make_shared<EnvironmentSource>();
+            source->compressed = std::move(result.cubemap);
+            store(key, texture, source);
+            emit skyboxReady(texture, source);
+        });
+        return;
+    }
+
+    QStringList faces;
+    for (const char* name : FaceNames) {
+        const QString face = findFace(directory, QString::fromLatin1(name));
+        if (face.isEmpty()) {
+            emit loadFailed(directory, tr("missing face %1").arg(QString::fromLatin1(name)));
+            return;
+        }
+        faces << face;
+    }
+
+    const QString key = cacheKey("faces", directory, faces);
+    CacheEntry hit = cached(key);
+    if (hit.texture) {
+        emit skyboxReady(hit.texture, hit.source);
+        return;
+    }
+
+    // One worker per face, so six faces take about as long as the largest one
+    workers.watch(this, QtConcurrent::mapped(faces, &TextureLoader::decodeFace),
+                  [this, request, key, directory](QFutureWatcher<vtkSmartPointer<vtkImageData>>* watcher) {
+        const QList<vtkSmartPointer<vtkImageData>> decoded = watcher->future().results();
+
+        if (request != skyboxRequest)
+            return;
+        for (const vtkSmartPointer<vtkImageData>& face : decoded) {
+            if (!face) {
+                emit loadFailed(directory, tr("a face could not be decoded"));
+                return;
+            }
+        }
+
+        auto source = std::make_shared<EnvironmentSource>();
+        source->faces.assign(decoded.begin(), decoded.end());
+        vtkSmartPointer<vtkOpenGLTexture> texture = CreateCubemapTexture(source->faces);
+        store(key, texture, source);
+        emit skyboxReady(texture, source);
+    });
+}
+
+/**
+ * @brief Loads a background image, from the cache if it was used recently.
+ * @param fileName PNG or JPEG file.
+ */
+// Starts (or skips) a background decode
+void TextureLoader::loadBackground(const QString& fileName)
+{
+    const int request = ++backgroundRequest;
+    const QString key = cacheKey("background", fileName, { fileName });
+    CacheEntry hit = cached(key);
+    if (hit.texture) {
+        emit backgroundReady(hit.texture);
+        return;
+    }
+
+    workers.watch(this, QtConcurrent::run(&TextureLoader::decodeBackground, fileName),
+                  [this, request, key, fileName](QFutureWatcher<vtkSmartPointer<vtkImageData>>* watcher) {
+        vtkSmartPointer<vtkImageData> image = watcher->result();
+
+        if (request != backgroundRequest)
+            return;
+        if (!image) {
+            emit loadFailed(fileName, tr("image could not be decoded"));
+            return;
+        }
+
+        auto texture = vtkSmartPointer<vtkTexture>::New();
+        texture->SetInputData(image);
+        store(key, texture);
+        emit backgroundReady(texture);
+    });
+}
+
+// --------------------------------------- Worker Functions ---------------------------------------
+
+/**
+ * @brief Decodes one cubemap face (top row first). Runs on the thread pool.
+ * @param fileName Face image.
+ * @return Decoded face, or nullptr.
+ */
+// Face decode
+vtkSmartPointer<vtkImageData> TextureLoader::decodeFace(const QString& fileName)
+{
+    return DecodeTextureImage(fileName.toStdString(), true);
+}
+
+/**
+ * @brief Decodes a background image (bottom row first). Runs on the thread pool.
+ * @param fileName Image file.
+ * @return Decoded image, or nullptr.
+ */
+// Background decode
+vtkSmartPointer<vtkImageData> TextureLoader::decodeBackground(const QString& fileName)
+{
+    return DecodeTextureImage(fileName.toStdString(), false);
+}
+
+/**
+ * @brief Reads a KTX2 cubemap. Runs on the thread pool.
+ * @param fileName KTX2 file.
+ * @return Compressed levels or an error.
+ */
+// KTX2 parse
+TextureLoader::CompressedResult TextureLoader::readCompressed(const QString& fileName)
+{
+    CompressedResult result;
+    std::string error;
+    if (!ReadKTX2Cubemap(fileName.toStdString(), result.cubemap, error))
+        result.error = QString::fromStdString(error);
+    return result;
+}
+
+// --------------------------------------- Helpers ---------------------------------------
+
+/**
+ * @brief Finds a face image by name, trying the supported extensions.
+ * @param directory Skybox folder.
+ * @param face      Face name (px, nx, ...).
+ * @return Full path, or an empty string.
+ */
+// Resolves a face file
+QString TextureLoader::findFace(const QString& directory, const QString& face)
+{
+    for (const char* extension : { ".png", ".jpg", ".jpeg" }) {
+        const QString path = QDir(directory).filePath(face + QString::fromLatin1(extension));
+        if (QFileInfo::exists(path))
+            return path;
+    }
+    return QString();
+}
+
+/**
+ * @brief Builds a cache key that changes whenever one of the files is rewritten.
+ * @param kind  Texture kind, so a folder and a file never share a key.
+ * @param path  Requested path.
+ * @param files Files the texture is built from.
+ * @return Cache key.
+ */
+// Path + modification times
+QString TextureLoader::cacheKey(const QString& kind, const QString& path, const QStringList& files)
+{
+    QString key = kind + QLatin1Char('|') + QFileInfo(path).absoluteFilePath();
+    for (const QString& file : files)
+        key += QLatin1Char('|') + QString::number(QFileInfo(file).lastModified().toMSecsSinceEpoch());
+    return key;
+}
+
+/**
+ * @brief Returns a cached texture and moves it to the back of the eviction order.
+ * @param key Cache key.
+ * @return Cached entry, with a null texture on a miss.
+ */
+// Cache lookup
+TextureLoader::CacheEntry TextureLoader::cached(const QString& key)
+{
+    auto it = cache.constFind(key);
+    if (it == cache.constEnd())
+        return CacheEntry();
+
+    recent.removeOne(key);
+    recent << key;
+    return it.value();
+}
+
+/**
+ * @brief Caches a texture, evicting the least recently used entries beyond the capacity.
+ * @param key     Cache key.
+ * @param texture Finished texture.
+ * @param source  Skybox source, shared with other renderers.
+ */
+// Cache insert with LRU eviction
+void TextureLoader::store(const QString& key, vtkTexture* texture, EnvironmentSourcePtr source)
+{
+    cache.insert(key, CacheEntry{ texture, std::move(source) });
+    recent.removeOne(key);
+    recent << key;
+
+    // A texture still on screen stays alive through the renderer; only the cache lets go
+    while (recent.size() > CacheCapacity)
+        cache.remove(recent.takeFirst());
+}
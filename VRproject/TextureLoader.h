@@ -0,0 +1,138 @@
+/**
+ * @file TextureLoader.h
+ * @brief Background decoding and caching of skybox and background textures.
+ *
+ * Skybox faces are decoded in parallel on the global Qt thread pool and the
+ * finished texture is handed back to the GUI thread. Pre-compressed KTX2 cubemaps
+ * skip decoding altogether and are uploaded as BCn blocks. Recently used textures
+ * are kept, so switching back to a skybox is immediate.
+ */
+
+#ifndef TEXTURE_LOADER_H
+#define TEXTURE_LOADER_H
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QObject>          // Base class for signals/slots
+#include <QString>          // File and folder paths
+#include <QStringList>      // Cache order
+#include <QHash>            // Cached textures
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkSmartPointer.h>          // Smart pointer management for VTK
+#include <vtkWeakPointer.h>           // Render window used for compressed uploads
+#include <vtkTexture.h>               // Finished textures
+#include <vtkImageData.h>             // Decoded images
+#include <vtkOpenGLRenderWindow.h>    // Context for compressed uploads
+
+#include "skyboxutils.h"              // Decode, KTX2 and cubemap helpers
+#include "SceneEnvironment.h"         // Shared environment sources
+#include "TrackedWatchers.h"          // Tracks the worker decodes
+
+// --------------------------------------- TextureLoader Class ---------------------------------------
+/**
+ * @class TextureLoader
+ * @brief Loads skyboxes and background images without blocking the GUI thread.
+ *
+ * A skybox folder either holds a single `.ktx2` cubemap or six faces named px, nx,
+ * py, ny, pz and nz (`.png`, `.jpg` or `.jpeg`). Only the newest request of each kind
+ * is delivered; older ones still finishing are dropped. All signals are emitted on
+ * the thread that owns the loader (the GUI thread).
+ */
+class TextureLoader : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor.
+     * @param parent Optional QObject parent.
+     */
+    // Constructor: empty cache
+    explicit TextureLoader(QObject* parent = nullptr);
+
+    /**
+     * @brief Sets the render window whose context receives compressed cubemaps.
+     * @param window Desktop render window.
+     */
+    // Context for KTX2 uploads
+    void setRenderWindow(vtkOpenGLRenderWindow* window);
+
+    /**
+     * @brief Starts loading a skybox folder; skyboxReady() follows.
+     * @param directory Folder holding a `.ktx2` cubemap or six face images.
+     */
+    // Loads (or reuses) a skybox
+    void loadSkybox(const QString& directory);
+
+    /**
+     * @brief Starts loading a background image; backgroundReady() follows.
+     * @param fileName PNG or JPEG file.
+     */
+    // Loads (or reuses) a background image
+    void loadBackground(const QString& fileName);
+
+signals:
+    /**
+     * @brief Emitted when a skybox cubemap is ready to be shown.
+     * @param texture Cubemap texture for the desktop render window.
+     * @param source  Decoded data, for building the same environment in other contexts (VR).
+     */
+    void skyboxReady(vtkSmartPointer<vtkTexture> texture, EnvironmentSourcePtr source);
+
+    /**
+     * @brief Emitted when a background image is ready to be shown.
+     * @param texture Texture for vtkRenderer::SetBackgroundTexture().
+     */
+    void backgroundReady(vtkSmartPointer<vtkTexture> texture);
+
+    /**
+     * @brief Emitted when a skybox or background could not be loaded.
+     * @param path   Folder or file that was requested.
+     * @param reason Short description for the status bar.
+     */
+    void loadFailed(const QString& path, const QString& reason);
+
+private:
+    /**
+     * @brief Result of reading a KTX2 cubemap on a worker thread.
+     */
+    struct CompressedResult {
+        CompressedCubemap cubemap;  // Compressed levels
+        QString error;              // Empty on success
+    };
+
+    // Worker functions run on the thread pool
+    static vtkSmartPointer<vtkImageData> decodeFace(const QString& fileName);
+    static vtkSmartPointer<vtkImageData> decodeBackground(const QString& fileName);
+    static CompressedResult readCompressed(const QString& fileName);
+
+    // Returns the existing px.png/px.jpg/... face file, or an empty string
+    static QString findFace(const QString& directory, const QString& face);
+
+    // Builds the cache key from a path and the modification times of its files
+    static QString cacheKey(const QString& kind, const QString& path, const QStringList& files);
+
+    /**
+     * @brief A cached texture and, for skyboxes, the source it was built from.
+     */
+    struct CacheEntry {
+        vtkSmartPointer<vtkTexture> texture;    // Texture in the desktop context
+        EnvironmentSourcePtr source;            // Skybox source (nullptr for backgrounds)
+    };
+
+    // Looks up a cached texture and marks it as most recently used
+    CacheEntry cached(const QString& key);
+
+    // Stores a texture, dropping the least recently used one beyond the capacity
+    void store(const QString& key, vtkTexture* texture, EnvironmentSourcePtr source = nullptr);
+
+    QHash<QString, CacheEntry> cache;                   // Key -> texture (GPU copy kept while cached)
+    QStringList recent;                                 // Cache keys, most recently used last
+    TrackedWatchers workers;                            // Decodes still running (waited for on destruction)
+    vtkWeakPointer<vtkOpenGLRenderWindow> window;       // Receives compressed uploads
+    int skyboxRequest;                                  // Id of the newest skybox request
+    int backgroundRequest;                              // Id of the newest background request
+};
+
+#endif // TEXTURE_LOADER_H
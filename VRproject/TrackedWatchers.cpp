@@ -0,0 +1,29 @@
+/**
+ * @file TrackedWatchers.cpp
+ * @brief Implementation of the background job watcher owner.
+ */
+
+#include "TrackedWatchers.h"
+
+// --------------------------------------- Destructor ---------------------------------------
+
+/**
+ * @brief Waits for running jobs so no worker outlives the owner.
+ */
+// Waits for the workers
+TrackedWatchers::~TrackedWatchers()
+{
+    waitForAll();
+}
+
+// --------------------------------------- Waiting ---------------------------------------
+
+/**
+ * @brief Blocks until every tracked job has returned.
+ */
+// Waits on each watcher still in flight
+void TrackedWatchers::waitForAll()
+{
+    for (QFutureWatcherBase* watcher : running)
+        watcher->waitForFinished();
+}
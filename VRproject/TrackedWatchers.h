@@ -0,0 +1,75 @@
+/**
+ * @file TrackedWatchers.h
+ * @brief Owner of the future watchers of one object's background work.
+ *
+ * Loaders and runners start their workers through it, so each of them gets the same
+ * bookkeeping: a watcher per job, handed back once its result is in, and a wait
+ * for every job still running when the owner goes away.
+ */
+
+#ifndef TRACKED_WATCHERS_H
+#define TRACKED_WATCHERS_H
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QObject>          // Watcher parent and slot context
+#include <QList>            // Watchers still in flight
+#include <QFuture>          // Work being watched
+#include <QFutureWatcher>   // Delivers the result on the owner's thread
+
+// --------------------------------------- TrackedWatchers Class ---------------------------------------
+/**
+ * @class TrackedWatchers
+ * @brief Starts watchers for background jobs and waits for them on destruction.
+ *
+ * Kept as a member of the QObject that owns the jobs. The watchers are children of
+ * that object, so they outlive this member during its destruction and the wait in
+ * the destructor keeps any worker from outliving the owner.
+ */
+class TrackedWatchers {
+public:
+    TrackedWatchers() = default;
+    TrackedWatchers(const TrackedWatchers&) = delete;
+    TrackedWatchers& operator=(const TrackedWatchers&) = delete;
+
+    /**
+     * @brief Destructor: waits for the jobs still running.
+     */
+    // Destructor: waits for the workers
+    ~TrackedWatchers();
+
+    /**
+     * @brief Watches a job and calls a handler once it is done.
+     * @param owner      Parent of the watcher; the handler runs on its thread.
+     * @param future     Job to watch.
+     * @param onFinished Called with the finished watcher, which is deleted afterwards.
+     * @return The watcher, e.g. to recognise the job's latest run.
+     */
+    // Starts tracking a job
+    template <typename T, typename Handler>
+    QFutureWatcher<T>* watch(QObject* owner, const QFuture<T>& future, Handler onFinished)
+    {
+        auto* watcher = new QFutureWatcher<T>(owner);
+        QObject::connect(watcher, &QFutureWatcher<T>::finished, owner, [this, watcher, onFinished]() {
+            running.removeOne(watcher);
+            watcher->deleteLater();
+            onFinished(watcher);
+        });
+        running << watcher;
+        watcher->setFuture(future);
+        return watcher;
+    }
+
+    /**
+     * @brief Blocks until every tracked job has returned.
+     *
+     * Handlers are not called here; finished signals still arrive through the event loop.
+     */
+    // Waits for the workers
+    void waitForAll();
+
+private:
+    QList<QFutureWatcherBase*> running;     // Jobs still in flight
+};
+
+#endif // TRACKED_WATCHERS_H
@@ -6,6 +6,7 @@
  */
 
 #include "VRRenderThread.h"
+#include "GpuEffects.h"
 
 // --------------------------------------- VTK Includes ---------------------------------------
 
@@ -24,9 +25,22 @@
 #include <vtkSTLReader.h>
 #include <vtkDataSetMapper.h>
 #include <vtkCallbackCommand.h>
+#include <vtkCullerCollection.h>
+#include <vtkEventData.h>
 
 #include <QMutexLocker>
 
+#include <utility>
+
+// --------------------------------------- Frame Budget ---------------------------------------
+
+namespace {
+
+// Commands applied every frame even without slack, so a late frame still makes progress
+const int MinCommandsPerFrame = 4;
+
+} // namespace
+
 // --------------------------------------- Constructor ---------------------------------------
 
 /**
@@ -34,11 +48,29 @@
  * @param parent The QObject parent.
  */
 // Initializes the actor collection and rotation values
-VRRenderThread::VRRenderThread(QObject* parent) {
-    actors = vtkActorCollection::New();
+VRRenderThread::VRRenderThread(QObject* parent)
+    : QThread(parent)
+    , overflowPending(false)
+    , overflowNext(0)
+    , endRender(false)
+    , mergedBytes(0)
+{
+    actors = vtkSmartPointer<vtkActorCollection>::New();
     rotateX = 0.;
     rotateY = 0.;
     rotateZ = 0.;
+    mergeParts = false;
+
+    // Rotate models upright for the headset (applied under each actor's model transform)
+    placement = vtkSmartPointer<vtkMatrix4x4>::New();
+    placement->Identity();
+    placement->SetElement(1, 1, 0.0);
+    placement->SetElement(1, 2, 1.0);
+    placement->SetElement(2, 1, -1.0);
+    placement->SetElement(2, 2, 0.0);
+
+    // Picks cross to the GUI thread as queued signals
+    qRegisterMetaType<vtkActor*>("vtkActor*");
 }
 
 // --------------------------------------- Destructor ---------------------------------------
@@ -50,23 +82,229 @@ VRRenderThread::~VRRenderThread() {
     // Empty  smart pointers handle cleanup
 }
 
-// --------------------------------------- Add Actor Before Render Starts ---------------------------------------
+// --------------------------------------- Scene Commands (GUI thread) ---------------------------------------
 
 /**
- * @brief Adds a VTK actor to the scene before the VR thread starts.
+ * @brief Queues a VTK actor to be added to the VR scene.
  * @param actor The actor to add.
+ *
+ * Before the thread starts the command simply waits in the ring and is applied
+ * when run() begins, so this works the same whether or not VR is running.
  */
-// Adds an actor before the VR thread begins
-void VRRenderThread::addActorOffline(vtkActor* actor) {
-    if (!this->isRunning()) {
-        double* ac = actor->GetOrigin();
+// Queues an actor for the VR scene
+void VRRenderThread::addActorOffline(vtkActor* actor, vtkPolyData* sharedGeometry) {
+    if (!actor) return;
+    SceneCommand command;
+    command.type = ADD_ACTOR;
+    command.actor = actor;
+    command.sharedGeometry = sharedGeometry;
+    pushCommand(std::move(command));
+}
 
-        // Apply transform to place model in viewable position
-        actor->RotateX(-90);
-        actor->AddPosition(-ac[0]+0, -ac[1]+0, -ac[2]+0);
+/**
+ * @brief Queues removal of an actor from the VR scene.
+ * @param actor The actor to remove.
+ */
+// Queues removal of an actor
+void VRRenderThread::removeActor(vtkActor* actor) {
+    if (!actor) return;
+    SceneCommand command;
+    command.type = REMOVE_ACTOR;
+    command.actor = actor;
+    pushCommand(std::move(command));
+}
 
-        actors->AddItem(actor);
-    }
+/**
+ * @brief Queues a new model transform for an actor.
+ * @param actor The target actor.
+ * @param matrix Model matrix; copied so the caller keeps ownership.
+ */
+// Queues a transform update
+void VRRenderThread::setActorTransform(vtkActor* actor, vtkMatrix4x4* matrix) {
+    if (!actor) return;
+    SceneCommand command;
+    command.type = SET_TRANSFORM;
+    command.actor = actor;
+    command.matrix = vtkSmartPointer<vtkMatrix4x4>::New();
+    if (matrix)
+        command.matrix->DeepCopy(matrix);
+    pushCommand(std::move(command));
+}
+
+/**
+ * @brief Queues a visibility change for a single actor.
+ * @param actor The target actor.
+ * @param visible True to show.
+ */
+// Queues a visibility update
+void VRRenderThread::setActorVisibility(vtkActor* actor, bool visible) {
+    if (!actor) return;
+    SceneCommand command;
+    command.type = SET_VISIBILITY;
+    command.actor = actor;
+    command.value[0] = visible ? 1.0 : 0.0;
+    pushCommand(std::move(command));
+}
+
+/**
+ * @brief Queues a colour change for a single actor.
+ * @param actor The target actor.
+ * @param r Red in [0, 1].
+ * @param g Green in [0, 1].
+ * @param b Blue in [0, 1].
+ */
+// Queues a colour update
+void VRRenderThread::setActorColor(vtkActor* actor, double r, double g, double b) {
+    if (!actor) return;
+    SceneCommand command;
+    command.type = SET_COLOR;
+    command.actor = actor;
+    command.value[0] = r;
+    command.value[1] = g;
+    command.value[2] = b;
+    pushCommand(std::move(command));
+}
+
+/**
+ * @brief Queues new filtered geometry for an actor.
+ * @param actor The target actor.
+ * @param polyData Snapshot that the GUI thread will no longer modify.
+ * @param sharedGeometry Instancing mesh, or nullptr.
+ */
+// Queues a geometry swap
+void VRRenderThread::updateActorGeometry(vtkActor* actor, vtkPolyData* polyData, vtkPolyData* sharedGeometry) {
+    if (!actor || !polyData) return;
+    SceneCommand command;
+    command.type = UPDATE_GEOMETRY;
+    command.actor = actor;
+    command.polyData = polyData;
+    command.sharedGeometry = sharedGeometry;
+    pushCommand(std::move(command));
+}
+
+/**
+ * @brief Queues new LOD levels for an actor.
+ * @param actor The target actor.
+ * @param levels Meshes that the GUI thread will no longer modify.
+ */
+// Queues an LOD update; the VR thread builds its own mappers
+void VRRenderThread::setActorLODs(vtkActor* actor, const QVector<vtkSmartPointer<vtkPolyData>>& levels) {
+    if (!actor) return;
+    SceneCommand command;
+    command.type = SET_LOD;
+    command.actor = actor;
+    command.levels = levels;
+    pushCommand(std::move(command));
+}
+
+/**
+ * @brief Queues an environment (skybox + IBL) change.
+ * @param source Immutable source shared with the desktop environment.
+ */
+// Queues a skybox/IBL update; the VR thread builds its own texture
+void VRRenderThread::setEnvironment(EnvironmentSourcePtr source) {
+    SceneCommand command;
+    command.type = SET_ENVIRONMENT;
+    command.environment = std::move(source);
+    pushCommand(std::move(command));
+}
+
+/**
+ * @brief Queues new section planes for an actor.
+ * @param actor  The target actor.
+ * @param planes Planes in desktop world coordinates.
+ */
+// Queues a per-actor section update (sent on every drag step)
+void VRRenderThread::setActorSectionPlanes(vtkActor* actor, const SectionPlaneList& planes) {
+    if (!actor) return;
+    SceneCommand command;
+    command.type = SET_SECTION;
+    command.actor = actor;
+    command.planes = planes;
+    pushCommand(std::move(command));
+}
+
+/**
+ * @brief Queues a shader shrink factor for an actor.
+ * @param actor  The target actor.
+ * @param factor Shrink factor; 1 or more removes the shader.
+ */
+// Queues a per-actor shrink update
+void VRRenderThread::setActorShrink(vtkActor* actor, double factor) {
+    if (!actor) return;
+    SceneCommand command;
+    command.type = SET_SHRINK;
+    command.actor = actor;
+    command.value[0] = factor;
+    pushCommand(std::move(command));
+}
+
+/**
+ * @brief Queues new scene section planes.
+ * @param planes Planes in desktop world coordinates.
+ */
+// Queues a scene section update; one command however many actors it cuts
+void VRRenderThread::setSectionPlanes(const SectionPlaneList& planes) {
+    SceneCommand command;
+    command.type = SET_SCENE_SECTION;
+    command.planes = planes;
+    pushCommand(std::move(command));
+}
+
+/**
+ * @brief Queues a VR quality mode change.
+ * @param adaptive True for adaptive foveated shading.
+ */
+// Queues the quality mode; the level itself is chosen by the VR thread each frame
+void VRRenderThread::setAdaptiveQuality(bool adaptive) {
+    SceneCommand command;
+    command.type = SET_QUALITY;
+    command.value[0] = adaptive ? 1.0 : 0.0;
+    pushCommand(std::move(command));
+}
+
+/**
+ * @brief Queues a merged-batch mode change.
+ * @param merge True to merge static opaque parts.
+ */
+// Queues the mode; the VR thread decides which parts can merge
+void VRRenderThread::setMergeStaticParts(bool merge) {
+    SceneCommand command;
+    command.type = SET_MERGING;
+    command.value[0] = merge ? 1.0 : 0.0;
+    pushCommand(std::move(command));
+}
+
+/**
+ * @brief Returns the VR loop's frame profiler.
+ */
+// Gives the GUI read access to VR frame statistics
+const FrameProfiler& VRRenderThread::getProfiler() const {
+    return profiler;
+}
+
+/**
+ * @brief Returns the memory held by merged VR batches.
+ */
+// Published by the VR loop after every frame
+qint64 VRRenderThread::getMergedBytes() const {
+    return mergedBytes.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the VR loop's frame pacer.
+ */
+// Gives the GUI read access to the missed-frame counter and frame-time percentile
+const FramePacer& VRRenderThread::getPacer() const {
+    return pacer;
+}
+
+/**
+ * @brief Returns the VR renderer's foveated shading.
+ */
+// Gives the GUI read access to the quality level
+const FoveatedShading& VRRenderThread::getFoveation() const {
+    return foveation;
 }
 
 // --------------------------------------- Issue Command ---------------------------------------
@@ -78,28 +316,278 @@ void VRRenderThread::addActorOffline(vtkActor* actor) {
  */
 // Allows GUI to send commands to the VR thread (e.g., rotate or quit)
 void VRRenderThread::issueCommand(int cmd, double value) {
-    switch (cmd) {
-    case END_RENDER:
+    if (cmd == END_RENDER) {
+        // Checked directly by the render loop so shutdown never waits behind queued edits
         this->endRender = true;
-        break;
+        return;
+    }
+
+    SceneCommand command;
+    command.type = cmd;
+    command.value[0] = value;
+    pushCommand(std::move(command));
+}
+
+/**
+ * @brief Pushes a command into the lock-free ring.
+ * @param command The command to queue.
+ *
+ * If the ring is full (e.g. a very large scene queued before VR starts), the command goes to
+ * a mutex-protected overflow list instead. Once overflow is in use, later commands follow it
+ * there until the VR thread has drained it, so ordering is preserved.
+ */
+// Queues a command without blocking on the render thread
+void VRRenderThread::pushCommand(SceneCommand&& command) {
+    if (!overflowPending.load(std::memory_order_acquire) && commands.push(std::move(command)))
+        return;
+
+    QMutexLocker locker(&mutex);
+    overflowCommands.append(std::move(command));
+    overflowPending.store(true, std::memory_order_release);
+}
+
+// --------------------------------------- Scene Commands (VR thread) ---------------------------------------
+
+/**
+ * @brief Applies queued commands in the order they were pushed.
+ * @param budgeted If true, stops once the pacer's work deadline has passed (after at least
+ *                 MinCommandsPerFrame commands); the rest waits for the next frame.
+ *
+ * Ring commands are always older than overflow commands, because nothing enters the ring
+ * while overflow is in use. Overflow taken from the GUI side but not yet applied is kept in
+ * overflowBacklog, and overflowPending stays set until it is empty, so commands pushed in
+ * the meantime still queue behind it.
+ */
+// Drains the ring, then any overflow, on the VR thread
+void VRRenderThread::drainCommands(bool budgeted) {
+    int applied = 0;
+    auto mayContinue = [&]() {
+        return !budgeted || applied < MinCommandsPerFrame || pacer.hasSlack();
+    };
+
+    SceneCommand command;
+    while (mayContinue() && commands.pop(command)) {
+        applyCommand(command);
+        ++applied;
+    }
+
+    while (mayContinue() && overflowPending.load(std::memory_order_acquire)) {
+        if (overflowNext == overflowBacklog.size()) {
+            overflowBacklog.clear();
+            overflowNext = 0;
+
+            QMutexLocker locker(&mutex);
+            if (overflowCommands.isEmpty()) {
+                overflowPending.store(false, std::memory_order_release);
+                break;
+            }
+            overflowBacklog.swap(overflowCommands);
+        }
+
+        while (overflowNext < overflowBacklog.size() && mayContinue()) {
+            applyCommand(overflowBacklog[overflowNext++]);
+            ++applied;
+        }
+    }
+}
+
+/**
+ * @brief Applies one command to the VR scene.
+ * @param command The command to apply.
+ */
+// Applies a single scene edit (VR thread only)
+void VRRenderThread::applyCommand(SceneCommand& command) {
+    vtkActor* actor = command.actor;
+
+    switch (command.type) {
     case ROTATE_X:
-        this->rotateX = value;
+        this->rotateX = command.value[0];
+        animation.setAngularVelocity(rotateX, rotateY, rotateZ);
+        updateMerging();
         break;
     case ROTATE_Y:
-        this->rotateY = value;
+        this->rotateY = command.value[0];
+        animation.setAngularVelocity(rotateX, rotateY, rotateZ);
+        updateMerging();
         break;
     case ROTATE_Z:
-        this->rotateZ = value;
+        this->rotateZ = command.value[0];
+        animation.setAngularVelocity(rotateX, rotateY, rotateZ);
+        updateMerging();
         break;
-    case TOGGLE_VISIBILITY:
+    case TOGGLE_VISIBILITY: {
         // Toggle visibility for all actors
+        bool visible = command.value[0] > 0.5;
+        vtkActor* a = nullptr;
         actors->InitTraversal();
-        vtkActor* actor = nullptr;
-        while ((actor = actors->GetNextActor())) {
-            bool visible = value > 0.5;
-            actor->SetVisibility(visible ? 1 : 0);
+        while ((a = actors->GetNextActor())) {
+            a->SetVisibility(visible ? 1 : 0);
+            instances.updateInstance(a);
+        }
+        break;
+    }
+    case ADD_ACTOR:
+        if (!actors->IsItemPresent(actor)) {
+            // Apply transform to place model in viewable position
+            if (!actor->GetUserMatrix())
+                applyPlacement(actor, nullptr);
+            actors->AddItem(actor);
+            environment.applyMaterial(actor);
+            section.setPartPlanes(actor, SectionPlaneList());
+            animation.add(actor);
+            bvh.insert(actor);
+            instances.add(actor, command.sharedGeometry);
+            updateMergeable(actor);
         }
         break;
+    case REMOVE_ACTOR:
+        lod.remove(actor);
+        section.remove(actor);
+        animation.remove(actor);
+        bvh.remove(actor);
+        instances.remove(actor);
+        actors->RemoveItem(actor);
+        break;
+    case CLEAR_ACTORS: {
+        instances.clear();
+        // LOD entries stay: parts are usually re-added straight away, and entries of
+        // deleted parts drop out by themselves once their actor is destroyed
+        actors->RemoveAllItems();
+        section.clear();
+        animation.clear();
+        bvh.clear();
+        break;
+    }
+    case SET_TRANSFORM:
+        applyPlacement(actor, command.matrix);
+        animation.reapply(actor);       // Keep the spin reached so far
+        bvh.update(actor);
+        instances.updateInstance(actor);
+        break;
+    case SET_VISIBILITY:
+        actor->SetVisibility(command.value[0] > 0.5 ? 1 : 0);
+        instances.updateInstance(actor);
+        break;
+    case SET_COLOR:
+        actor->GetProperty()->SetColor(command.value[0], command.value[1], command.value[2]);
+        instances.updateInstance(actor);
+        break;
+    case UPDATE_GEOMETRY:
+        // The actor may currently show a coarse level, so update the full-resolution mapper
+        if (auto* mapper = vtkPolyDataMapper::SafeDownCast(lod.fullMapper(actor)))
+            mapper->SetInputData(command.polyData);
+        bvh.update(actor);
+        instances.setSharedGeometry(actor, command.sharedGeometry);
+        instances.updateInstance(actor);    // A merged copy follows the new mesh
+        break;
+    case SET_LOD: {
+        // Keep the existing mappers (and their GPU buffers) if the levels did not change
+        QVector<vtkSmartPointer<vtkMapper>> current = lod.levels(actor);
+        bool unchanged = current.size() == command.levels.size() + 1;
+        for (int i = 0; unchanged && i < command.levels.size(); ++i)
+            unchanged = current[i + 1]->GetInputDataObject(0, 0) == command.levels[i].Get();
+        if (unchanged)
+            break;
+
+        QVector<vtkSmartPointer<vtkMapper>> mappers;
+        if (!command.levels.isEmpty()) {
+            mappers << vtkSmartPointer<vtkMapper>(lod.fullMapper(actor));
+            for (const vtkSmartPointer<vtkPolyData>& level : command.levels) {
+                auto mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+                mapper->SetInputData(level);
+                mappers << vtkSmartPointer<vtkMapper>(mapper.Get());
+            }
+        }
+        lod.setLevels(actor, mappers);
+        updateMergeable(actor);
+        break;
+    }
+    case SET_ENVIRONMENT: {
+        // Compressed cubemaps wait for the window; run() realizes them after initialisation
+        environment.setSource(command.environment);
+        environment.realize();
+        applyEnvironmentMaterials();
+        break;
+    }
+    case SET_SECTION:
+        // Planes move with the models into the headset's viewable position
+        if (actors->IsItemPresent(actor)) {
+            section.setPartPlanes(actor, SectionClipper::transformed(command.planes, placement));
+            updateMergeable(actor);
+        }
+        break;
+    case SET_SHRINK:
+        // Merged batches bypass the actor's shader, so a shrunk actor is drawn on its own
+        GpuEffects::setShrink(actor, command.value[0]);
+        updateMergeable(actor);
+        break;
+    case SET_SCENE_SECTION: {
+        section.setScenePlanes(SectionClipper::transformed(command.planes, placement));
+        vtkActor* a = nullptr;
+        actors->InitTraversal();
+        while ((a = actors->GetNextActor()))
+            updateMergeable(a);
+        break;
+    }
+    case SET_QUALITY:
+        foveation.setAdaptive(command.value[0] != 0.0);
+        break;
+    case SET_MERGING:
+        mergeParts = command.value[0] != 0.0;
+        updateMerging();
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Enables merged batches while they are requested and the parts stand still.
+ *
+ * Spinning parts would have their merged copies rebuilt every frame, which costs
+ * more than drawing them individually.
+ */
+// Merging on only without auto-rotation
+void VRRenderThread::updateMerging() {
+    const bool stationary = rotateX == 0.0 && rotateY == 0.0 && rotateZ == 0.0;
+    instances.setMerging(mergeParts && stationary);
+}
+
+/**
+ * @brief Allows an actor to merge unless it needs its own mapper.
+ * @param actor The target actor.
+ */
+// LOD switching and section planes act on the actor's own mapper
+void VRRenderThread::updateMergeable(vtkActor* actor) {
+    instances.setMergeable(actor, lod.levels(actor).isEmpty() && !section.isClipped(actor)
+                                  && !GpuEffects::isShrunk(actor));
+}
+
+/**
+ * @brief Sets an actor's user matrix to the VR placement followed by its model transform.
+ * @param actor The target actor.
+ * @param model Model transform, or nullptr for identity.
+ */
+// Composes the viewable-position placement with the part's own transform
+void VRRenderThread::applyPlacement(vtkActor* actor, vtkMatrix4x4* model) {
+    auto matrix = vtkSmartPointer<vtkMatrix4x4>::New();
+    if (model)
+        vtkMatrix4x4::Multiply4x4(placement, model, matrix);
+    else
+        matrix->DeepCopy(placement);
+    actor->SetUserMatrix(matrix);
+}
+
+/**
+ * @brief Gives every part actor the shading that matches the current environment.
+ */
+// PBR with an environment, default shading without
+void VRRenderThread::applyEnvironmentMaterials() {
+    vtkActor* a = nullptr;
+    actors->InitTraversal();
+    while ((a = actors->GetNextActor())) {
+        environment.applyMaterial(a);
+        instances.updateInstance(a);
     }
 }
 
@@ -117,13 +605,23 @@ void VRRenderThread::run() {
     // Create renderer and apply background
     renderer = vtkOpenVRRenderer::New();
     renderer->SetBackground(colors->GetColor3d("BkgColor").GetData());
+    lod.attach(renderer);
 
-    // Add all actors to the renderer
-    vtkActor* a;
-    actors->InitTraversal();
-    while ((a = actors->GetNextActor())) {
-        renderer->AddActor(a);
-    }
+    // Replace the per-prop frustum coverage culler; runs once per eye with that eye's frustum
+    culler = vtkSmartPointer<SceneBVHCuller>::New();
+    culler->SetBVH(&bvh);
+    renderer->GetCullers()->RemoveAllItems();
+    renderer->AddCuller(culler);
+
+    // Part actors enter the renderer through the batcher, instanced where parts repeat
+    instances.setBVH(&bvh);
+    instances.attach(renderer);
+    environment.attach(renderer);
+    section.attach(renderer);
+    foveation.attach(renderer);
+
+    // Add actors queued before start; anything queued later is applied by the loop
+    drainCommands(false);
 
     // Setup render window
     window = vtkOpenVRRenderWindow::New();
@@ -138,64 +636,116 @@ void VRRenderThread::run() {
     interactor = vtkOpenVRRenderWindowInteractor::New();
     interactor->SetRenderWindow(window);
     interactor->Initialize();
+
+    // An environment queued before start may need the now-initialised context
+    environment.realize();
+    applyEnvironmentMaterials();
+
+    // Trigger presses pick the part under the controller ray
+    selectCallback = vtkSmartPointer<vtkCallbackCommand>::New();
+    selectCallback->SetCallback(&VRRenderThread::onSelect3D);
+    selectCallback->SetClientData(this);
+    interactor->AddObserver(vtkCommand::Select3DEvent, selectCallback);
     window->Render();
 
-    // Start VR render loop
-    endRender = false;
-    t_last = std::chrono::steady_clock::now();
+    // Start VR render loop; the compositor is up, so its refresh rate and statistics are available
+    pacer.start();
+    foveation.start();
 
     while (!interactor->GetDone() && !this->endRender) {
-        interactor->DoOneEvent(window, renderer);
-
-        // Check if 20ms have passed since last frame
-        if (std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::steady_clock::now() - t_last).count() > 20) {
+        // The previous render has submitted: everything until the compositor releases the
+        // next WaitGetPoses (inside DoOneEvent's render) runs in that frame's slack
+        profiler.beginFrame();
+        pacer.beginFrame();
 
-            // Rotate all actors on X axis
-            vtkActorCollection* actorList = renderer->GetActors();
-            actorList->InitTraversal();
-            while ((a = actorList->GetNextActor())) {
-                a->RotateX(rotateX);
+        // Simulation first, in whole display periods; only the actors' matrices change
+        const int steps = pacer.takeSteps();
+        if (steps > 0) {
+            // Keep the culling and picking bounds in step with the rotation
+            for (vtkActor* moved : animation.advance(steps * pacer.getStepSeconds())) {
+                bvh.update(moved);
+                instances.updateInstance(moved);
             }
+        }
 
-            // Rotate all actors on Y axis
-            actorList->InitTraversal();
-            while ((a = actorList->GetNextActor())) {
-                a->RotateY(rotateY);
-            }
+        // Scene edits from the GUI fill the rest of the slack; the remainder waits a frame
+        drainCommands(true);
 
-            // Rotate all actors on Z axis
-            actorList->InitTraversal();
-            while ((a = actorList->GetNextActor())) {
-                a->RotateZ(rotateZ);
-            }
+        interactor->DoOneEvent(window, renderer);
+        profiler.endFrame(renderer, 2);     // DoOneEvent renders both eyes
+        pacer.endFrame();
+        mergedBytes.store(instances.mergedBytes(), std::memory_order_relaxed);
 
-            // Reset last update time
-            t_last = std::chrono::steady_clock::now();
-        }
+        // Coarsen or restore the periphery for the next frame from this one's GPU time
+        foveation.update(pacer);
     }
+
+    // Restore full-detail mappers and release GL resources while the OpenVR context still exists
+    lod.clear();
+    lod.detach();
+    profiler.releaseGraphicsResources();
+    foveation.releaseGraphicsResources();
+    foveation.detach();
+    interactor->RemoveObserver(selectCallback);
+    instances.clear();
+    instances.detach();
+    mergedBytes.store(0, std::memory_order_relaxed);
+    animation.clear();
+    section.clear();
+    section.detach();
+    environment.detach();
+    window->Finalize();
+    renderer->RemoveAllViewProps();
+    bvh.clear();
+}
+
+// --------------------------------------- Controller Picking ---------------------------------------
+/**
+ * @brief Casts the controller ray through the BVH when the trigger is pressed.
+ * @param caller The VR interactor.
+ * @param eventId Select3DEvent.
+ * @param clientData The VRRenderThread.
+ * @param callData The vtkEventDataDevice3D describing the controller.
+ */
+// Emits partPicked() for the nearest actor hit by the ray
+void VRRenderThread::onSelect3D(vtkObject* /*caller*/, unsigned long /*eventId*/, void* clientData, void* callData) {
+    VRRenderThread* self = static_cast<VRRenderThread*>(clientData);
+    vtkEventData* eventData = static_cast<vtkEventData*>(callData);
+    vtkEventDataDevice3D* device = eventData ? eventData->GetAsEventDataDevice3D() : nullptr;
+    if (!self || !device || device->GetAction() != vtkEventDataAction::Press)
+        return;
+
+    double origin[3], direction[3], orientation[4];
+    device->GetWorldPosition(origin);
+    device->GetWorldDirection(direction);
+    device->GetWorldOrientation(orientation);
+
+    vtkActor* actor = vtkActor::SafeDownCast(self->bvh.pickRay(self->renderer, origin, direction, orientation));
+    if (actor)
+        emit self->partPicked(actor);
 }
 
 // --------------------------------------- Clear All Actors ---------------------------------------
 /**
- * @brief Clears all queued actors (thread-safe).
+ * @brief Removes every actor from the VR scene (thread-safe).
  */
-// Clears queued actors (thread-safe)
+// Queues removal of all actors
 void VRRenderThread::clearAllActors() {
-    QMutexLocker locker(&mutex);
-    queuedActors.clear();
+    SceneCommand command;
+    command.type = CLEAR_ACTORS;
+    pushCommand(std::move(command));
 }
 
 // --------------------------------------- Set Rotation ---------------------------------------
 /**
- * @brief Sets the per-frame rotation speeds along each axis.
- * @param x Rotation speed along X.
- * @param y Rotation speed along Y.
- * @param z Rotation speed along Z.
+ * @brief Sets the rotation speeds along each axis; applied with the real frame time.
+ * @param x Rotation speed along X (degrees per second).
+ * @param y Rotation speed along Y (degrees per second).
+ * @param z Rotation speed along Z (degrees per second).
  */
 // Sets new rotation values to apply to all actors
 void VRRenderThread::setRotation(double x, double y, double z) {
-    this->rotateX = x;
-    this->rotateY = y;
-    this->rotateZ = z;
+    issueCommand(ROTATE_X, x);
+    issueCommand(ROTATE_Y, y);
+    issueCommand(ROTATE_Z, z);
 }
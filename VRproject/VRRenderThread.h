@@ -11,9 +11,8 @@
 // --------------------------------------- Qt Includes ---------------------------------------
 
 #include <QThread>           // For running VR in a separate thread
-#include <QVector>           // Container for queued actors
-#include <QMutex>            // Thread synchronization
-#include <QWaitCondition>    // Thread wait signaling
+#include <QVector>           // Overflow storage for scene commands
+#include <QMutex>            // Protects the (rarely used) command overflow list
 
 // --------------------------------------- VTK Includes ---------------------------------------
 
@@ -25,8 +24,22 @@
 #include <vtkOpenVRRenderWindowInteractor.h> // VR interactor (event loop)
 #include <vtkOpenVRRenderer.h>               // VR renderer
 #include <vtkOpenVRCamera.h>                 // VR camera
+#include <vtkPolyData.h>                     // Geometry snapshots for filter updates
+#include <vtkMatrix4x4.h>                    // Per-actor transforms
+#include <vtkCallbackCommand.h>              // Controller trigger observer
 
-#include <chrono>                            // Used for animation timing
+#include <atomic>                            // Lock-free flags shared with the GUI thread
+
+#include "SpscRing.h"                        // GUI -> VR command ring
+#include "LODSwitcher.h"                     // Screen-coverage LOD selection
+#include "FrameProfiler.h"                   // Per-frame timing
+#include "FramePacer.h"                      // Compositor-timed work budgets and missed frames
+#include "FoveatedShading.h"                 // Frame-time driven peripheral shading rate
+#include "SceneBVH.h"                        // Per-eye frustum culling and controller picking
+#include "InstanceBatcher.h"                 // Instanced drawing of repeated parts
+#include "PoseAnimator.h"                    // Delta-time auto-rotation
+#include "SceneEnvironment.h"                // Skybox and image-based lighting shared with the desktop
+#include "SectionClipper.h"                  // GPU section planes and caps
 
 // --------------------------------------- VRRenderThread Class ---------------------------------------
 /**
@@ -46,9 +59,41 @@ public:
         ROTATE_X,           // Rotate actor(s) around X axis
         ROTATE_Y,           // Rotate actor(s) around Y axis
         ROTATE_Z,           // Rotate actor(s) around Z axis
-        TOGGLE_VISIBILITY   // Toggle visibility on/off
+        TOGGLE_VISIBILITY,  // Toggle visibility on/off
+        ADD_ACTOR,          // Add an actor to the VR scene
+        REMOVE_ACTOR,       // Remove an actor from the VR scene
+        CLEAR_ACTORS,       // Remove every actor from the VR scene
+        SET_TRANSFORM,      // Replace an actor's model transform
+        SET_VISIBILITY,     // Show/hide a single actor
+        SET_COLOR,          // Change a single actor's colour
+        UPDATE_GEOMETRY,    // Swap in new filtered geometry for an actor
+        SET_LOD,            // Replace an actor's decimated detail levels
+        SET_ENVIRONMENT,    // Show a skybox and light the parts with it
+        SET_SECTION,        // Replace a single actor's section planes
+        SET_SCENE_SECTION,  // Replace the section planes that cut every actor
+        SET_QUALITY,        // Turn adaptive foveated shading on/off
+        SET_MERGING,        // Turn merged batches of static parts on/off
+        SET_SHRINK          // Shrink a single actor's triangles in the shader
     } Command;
 
+    /**
+     * @brief A scene edit queued by the GUI thread and applied by the VR thread.
+     *
+     * Smart pointers keep the referenced VTK objects alive until the VR thread has
+     * consumed the command; VTK reference counting is atomic, so this is safe across threads.
+     */
+    struct SceneCommand {
+        int type = END_RENDER;                       // One of the command enum values
+        double value[3] = { 0.0, 0.0, 0.0 };         // Scalar/colour payload
+        vtkSmartPointer<vtkActor> actor;             // Target actor (per-actor commands)
+        vtkSmartPointer<vtkPolyData> polyData;       // New geometry (UPDATE_GEOMETRY)
+        vtkSmartPointer<vtkMatrix4x4> matrix;        // New transform (SET_TRANSFORM)
+        QVector<vtkSmartPointer<vtkPolyData>> levels; // Decimated meshes, finest first (SET_LOD)
+        vtkSmartPointer<vtkPolyData> sharedGeometry; // Instancing mesh (ADD_ACTOR, UPDATE_GEOMETRY)
+        EnvironmentSourcePtr environment;            // Shared skybox data (SET_ENVIRONMENT)
+        SectionPlaneList planes;                     // Desktop world planes (SET_SECTION, SET_SCENE_SECTION)
+    };
+
     /**
      * @brief Constructor: initializes member variables.
      * @param parent Optional QObject parent.
@@ -63,11 +108,113 @@ public:
     ~VRRenderThread();
 
     /**
-     * @brief Adds an actor to the scene before the VR thread starts.
+     * @brief Adds an actor to the VR scene.
      * @param actor Pointer to the vtkActor to add.
+     * @param sharedGeometry Mesh snapshot shared by identical parts, or nullptr; actors
+     *                       with the same one are drawn instanced.
+     *
+     * Works both before and while the thread is running. Once queued, the actor belongs
+     * to the VR thread and must only be changed through the commands below.
+     */
+    // Queues an actor to be added to the VR scene
+    void addActorOffline(vtkActor* actor, vtkPolyData* sharedGeometry = nullptr);
+
+    /**
+     * @brief Removes an actor from the VR scene.
+     * @param actor Actor previously passed to addActorOffline().
+     */
+    // Queues removal of an actor
+    void removeActor(vtkActor* actor);
+
+    /**
+     * @brief Replaces an actor's model transform (applied on top of the VR placement).
+     * @param actor  Target actor.
+     * @param matrix Model matrix; copied, so the caller may reuse it.
+     */
+    // Queues a transform update for an actor
+    void setActorTransform(vtkActor* actor, vtkMatrix4x4* matrix);
+
+    /**
+     * @brief Shows or hides a single actor.
+     * @param actor   Target actor.
+     * @param visible True to show.
+     */
+    // Queues a visibility change for an actor
+    void setActorVisibility(vtkActor* actor, bool visible);
+
+    /**
+     * @brief Changes a single actor's colour.
+     * @param actor Target actor.
+     * @param r,g,b Colour components in [0, 1].
+     */
+    // Queues a colour change for an actor
+    void setActorColor(vtkActor* actor, double r, double g, double b);
+
+    /**
+     * @brief Swaps in new geometry after a filter change.
+     * @param actor    Target actor.
+     * @param polyData Immutable snapshot of the filtered mesh (see ModelPart::getOutputSnapshot()).
+     * @param sharedGeometry Instancing mesh as for addActorOffline(); nullptr while a filter is active.
+     */
+    // Queues a geometry update for an actor
+    void updateActorGeometry(vtkActor* actor, vtkPolyData* polyData, vtkPolyData* sharedGeometry = nullptr);
+
+    /**
+     * @brief Replaces the decimated detail levels used for an actor.
+     * @param actor  Target actor.
+     * @param levels Immutable LOD meshes, finest first (see ModelPart::getLODData()).
+     *               An empty list turns LOD switching off for the actor.
+     */
+    // Queues new LOD levels for an actor
+    void setActorLODs(vtkActor* actor, const QVector<vtkSmartPointer<vtkPolyData>>& levels);
+
+    /**
+     * @brief Shows the desktop's environment in the headset.
+     * @param source Decoded skybox shared with the desktop, or nullptr to remove it.
+     *
+     * The VR thread uploads the source into its own context once and uses it for
+     * the skybox and for image-based lighting of the parts.
+     */
+    // Queues an environment change
+    void setEnvironment(EnvironmentSourcePtr source);
+
+    /**
+     * @brief Replaces the section planes of a single actor.
+     * @param actor  Target actor.
+     * @param planes Planes in desktop world coordinates; the VR placement is applied
+     *               by the VR thread. An empty list removes the actor's planes.
+     */
+    // Queues a per-actor section change
+    void setActorSectionPlanes(vtkActor* actor, const SectionPlaneList& planes);
+
+    /**
+     * @brief Shrinks a single actor's triangles in a geometry shader (see GpuEffects).
+     * @param actor  Target actor.
+     * @param factor Shrink factor; 1 or more removes the shader.
+     */
+    // Queues a per-actor shrink change (sent on every slider step)
+    void setActorShrink(vtkActor* actor, double factor);
+
+    /**
+     * @brief Replaces the section planes that clip every actor.
+     * @param planes Planes in desktop world coordinates, or an empty list.
+     */
+    // Queues a scene section change
+    void setSectionPlanes(const SectionPlaneList& planes);
+
+    /**
+     * @brief Switches the headset between full quality and adaptive foveated shading.
+     * @param adaptive True to coarsen the periphery whenever frames near the budget.
+     */
+    // Queues a VR quality mode change
+    void setAdaptiveQuality(bool adaptive);
+
+    /**
+     * @brief Draws static opaque parts through a few merged batches instead of one prop each.
+     * @param merge True to merge; parts are only merged while auto-rotation is stopped.
      */
-    // Adds an actor before the VR interactor starts
-    void addActorOffline(vtkActor* actor);
+    // Queues a merged-batch mode change
+    void setMergeStaticParts(bool merge);
 
     /**
      * @brief Issues a command to the VR rendering thread.
@@ -78,18 +225,58 @@ public:
     void issueCommand(int cmd, double value);
 
     /**
-     * @brief Sets the rotation speed per update on each axis.
-     * @param x Degrees per update around X.
-     * @param y Degrees per update around Y.
-     * @param z Degrees per update around Z.
+     * @brief Sets the auto-rotation speed on each axis.
+     * @param x Degrees per second around X.
+     * @param y Degrees per second around Y.
+     * @param z Degrees per second around Z.
      */
-    // Sets rotation speed (degrees per update) on each axis
+    // Sets rotation speed (degrees per second) on each axis
     void setRotation(double x, double y, double z);
 
-    
+    /**
+     * @brief Returns the VR loop's frame profiler.
+     *
+     * Only the thread-safe readers (trace(), summaryText()) may be used from other threads.
+     */
+    // Returns the VR frame statistics
+    const FrameProfiler& getProfiler() const;
+
+    /**
+     * @brief Returns the memory held by merged VR batches, as of the last frame.
+     *
+     * Safe to call from any thread; the memory budget charges it to the session.
+     */
+    // Bytes of the world-space copies in merged batches
+    qint64 getMergedBytes() const;
+
+    /**
+     * @brief Returns the VR loop's frame pacer.
+     *
+     * Only its getters (getMissedFrames(), getPercentileMs(), summaryText()) may be used
+     * from other threads.
+     */
+    // Returns the VR pacing statistics and missed-frame counter
+    const FramePacer& getPacer() const;
+
+    /**
+     * @brief Returns the VR renderer's foveated shading.
+     *
+     * Only getLevel() and summaryText() may be used from other threads.
+     */
+    // Returns the VR quality state
+    const FoveatedShading& getFoveation() const;
+
+signals:
+    /**
+     * @brief Emitted (from the VR thread) when the controller trigger ray hits an actor.
+     * @param actor The VR actor that was hit; only use it as a key on the GUI thread.
+     */
+    // Reports a controller pick
+    void partPicked(vtkActor* actor);
+
 public slots:
     /**
-     * @brief Clears all queued actors (thread-safe).
+     * @brief Removes every actor from the VR scene (thread-safe).
      */
     // Removes all actors from the VR renderer
     void clearAllActors();
@@ -103,6 +290,30 @@ protected:
     void run() override;
 
 private:
+    // Pushes a command for the VR thread; never blocks the GUI thread
+    void pushCommand(SceneCommand&& command);
+
+    // Applies queued commands in order; when budgeted, stops once the frame's slack is used (VR thread only)
+    void drainCommands(bool budgeted);
+
+    // Applies a single command to the scene (VR thread only)
+    void applyCommand(SceneCommand& command);
+
+    // Turns merged batches on while requested and nothing is animated (VR thread only)
+    void updateMerging();
+
+    // Lets an actor merge unless it switches LOD levels, is cut or is shrunk in the shader (VR thread only)
+    void updateMergeable(vtkActor* actor);
+
+    // Sets an actor's user matrix to placement * model (VR thread only)
+    void applyPlacement(vtkActor* actor, vtkMatrix4x4* model);
+
+    // Switches every part actor's shading to match the environment (VR thread only)
+    void applyEnvironmentMaterials();
+
+    // Interactor observer for the controller trigger; casts the pick ray (VR thread only)
+    static void onSelect3D(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+
     // --------------------------------------- VTK VR Components ---------------------------------------
 
     vtkSmartPointer<vtkOpenVRRenderWindow> window;            // OpenVR-compatible render window
@@ -112,22 +323,40 @@ private:
 
     // --------------------------------------- Thread Synchronization ---------------------------------------
 
-    QMutex mutex;                    // Protects shared resources from race conditions
-    QWaitCondition condition;        // Used to wake/sleep the thread safely
+    SpscRing<SceneCommand, 4096> commands;   // Lock-free GUI -> VR command queue
+    QMutex mutex;                            // Protects overflowCommands only
+    QVector<SceneCommand> overflowCommands;  // Used only while the ring is full
+    std::atomic<bool> overflowPending;       // True while overflow items are still to be applied
+    QVector<SceneCommand> overflowBacklog;   // Overflow taken by the VR thread, not yet applied (VR thread only)
+    int overflowNext;                        // Next overflowBacklog item to apply (VR thread only)
 
     // --------------------------------------- Actor Management ---------------------------------------
 
-    QVector<vtkSmartPointer<vtkActor>> queuedActors;  // Actors added before interactor starts
-    vtkSmartPointer<vtkActorCollection> actors;       // All actors currently in the VR scene
+    vtkSmartPointer<vtkActorCollection> actors;       // All actors currently in the VR scene (VR thread only)
+    vtkSmartPointer<vtkMatrix4x4> placement;          // Transform that puts models in a viewable position
+    LODSwitcher lod;                                  // Picks each actor's detail level per frame (VR thread only)
+    FrameProfiler profiler;                           // Times each loop iteration (records on the VR thread)
+    FramePacer pacer;                                 // Work deadlines and fixed steps from the compositor (VR thread only)
+    SceneBVH bvh;                                     // Bounds hierarchy of the VR actors (VR thread only)
+    InstanceBatcher instances;                        // Puts actors in the renderer, instancing repeats (VR thread only)
+    SceneEnvironment environment;                     // Headset skybox and IBL (VR thread only)
+    SectionClipper section;                           // Section planes of the VR actors (VR thread only)
+    FoveatedShading foveation;                        // Per-eye shading rate, adapted to the frame time (VR thread only)
+    vtkSmartPointer<SceneBVHCuller> culler;           // Culls each eye against bvh
+    vtkSmartPointer<vtkCallbackCommand> selectCallback; // Trigger -> pick observer
 
     // --------------------------------------- State & Animation ---------------------------------------
 
-    std::chrono::time_point<std::chrono::steady_clock> t_last;  // Used for animation timing
-    bool endRender;     // True when rendering should stop
+    std::atomic<bool> endRender;     // True when rendering should stop
+    std::atomic<qint64> mergedBytes; // instances.mergedBytes() after the last frame
 
-    double rotateX;     // Degrees per step around X axis
-    double rotateY;     // Degrees per step around Y axis
-    double rotateZ;     // Degrees per step around Z axis
+    PoseAnimator animation;          // Spins every part actor (VR thread only)
+    double rotateX;     // Degrees per second around X axis (VR thread only)
+    double rotateY;     // Degrees per second around Y axis (VR thread only)
+    double rotateZ;     // Degrees per second around Z axis (VR thread only)
+    bool mergeParts;    // Merged batches requested (VR thread only)
 };
 
+Q_DECLARE_METATYPE(vtkActor*)
+
 #endif // VR_RENDER_THREAD_H
@@ -0,0 +1,386 @@
+/**
+ * @file benchmain.cpp
+ * @brief Headless benchmark for STL loading, filtering and offscreen rendering.
+ *
+ * Usage: VRproject_bench <stl-directory> [--frames N] [--size WxH] [--output file.json]
+ *        VRproject_bench --stress [--scenes list] [--vr-size WxH] [--baseline file.json]
+ *                        [--threshold 0.2] [--frames N] [--size WxH] [--output file.json]
+ *
+ * Loads every STL in the directory through ModelPart/ModelPartList, times loadSTL,
+ * applyShrinkFilter and applyClipFilter, renders N offscreen frames through the
+ * parts' own actors and mappers, and prints the results as JSON.
+ *
+ * With --stress, synthetic scenes (see StressSuite) are run through the desktop and
+ * an offscreen VR-style path instead. Given a baseline report from an earlier run,
+ * the exit code is 2 if any checked metric regressed by more than the threshold.
+ */
+
+#include "ModelPart.h"
+#include "ModelPartList.h"
+#include "StressSuite.h"
+
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+
+// --------------------------------------- VTK Includes ---------------------------------------
+
+#include <vtkSmartPointer.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkOpenGLRenderWindow.h>
+#include <vtkCamera.h>
+#include <vtkMapper.h>
+#include <vtkPolyData.h>
+#include <vtkVersion.h>
+
+// --------------------------------------- Platform Includes ---------------------------------------
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// --------------------------------------- Helpers ---------------------------------------
+
+namespace {
+
+/**
+ * @brief Timing and size totals for one benchmark stage.
+ */
+struct StageTotals {
+    qint64 nanos = 0;       // Wall time spent in the stage
+    qint64 triangles = 0;   // Triangles fed into the stage
+    qint64 bytes = 0;       // Source bytes read by the stage (load only)
+};
+
+// Returns the process's peak resident memory in bytes
+qint64 peakMemoryBytes()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return qint64(counters.PeakWorkingSetSize);
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#if defined(__APPLE__)
+    return qint64(usage.ru_maxrss);             // Bytes on macOS
+#else
+    return qint64(usage.ru_maxrss) * 1024;      // Kilobytes on Linux
+#endif
+#endif
+}
+
+// Pulls the part's pipeline up to date so lazy filters are included in the timing
+qint64 updatePart(ModelPart* part)
+{
+    vtkMapper* mapper = part->getActor() ? part->getActor()->GetMapper() : nullptr;
+    if (!mapper)
+        return 0;
+
+    mapper->Update();
+    vtkPolyData* output = vtkPolyData::SafeDownCast(mapper->GetInputDataObject(0, 0));
+    return output ? output->GetNumberOfCells() : 0;
+}
+
+// Formats one stage as a JSON object with per-second throughput
+QJsonObject stageJson(const StageTotals& totals)
+{
+    const double seconds = double(totals.nanos) * 1.0e-9;
+
+    QJsonObject object;
+    object["seconds"] = seconds;
+    object["triangles"] = double(totals.triangles);
+    object["triangles_per_s"] = seconds > 0.0 ? double(totals.triangles) / seconds : 0.0;
+    if (totals.bytes > 0) {
+        object["megabytes"] = double(totals.bytes) / (1024.0 * 1024.0);
+        object["mb_per_s"] = seconds > 0.0 ? double(totals.bytes) / (1024.0 * 1024.0) / seconds : 0.0;
+    }
+    return object;
+}
+
+// Parses a "WxH" option value, falling back to the given size
+void parseSize(const QString& value, int& width, int& height)
+{
+    const QStringList size = value.split('x');
+    if (size.size() != 2)
+        return;
+    width = qMax(16, size[0].toInt());
+    height = qMax(16, size[1].toInt());
+}
+
+// Writes the report to the file, or to stdout if fileName is empty
+bool writeReport(const QJsonObject& report, const QString& fileName)
+{
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+
+    if (fileName.isEmpty()) {
+        QTextStream(stdout) << json;
+        return true;
+    }
+
+    QFile out(fileName);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QTextStream(stderr) << "Could not write " << out.fileName() << "\n";
+        return false;
+    }
+    out.write(json);
+    return true;
+}
+
+// Returns the common report header fields
+QJsonObject reportHeader()
+{
+    QJsonObject report;
+    report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["vtk_version"] = QString(vtkVersion::GetVTKVersion());
+    report["qt_version"] = QString(qVersion());
+    return report;
+}
+
+/**
+ * @brief Runs the synthetic scenes and checks them against an optional baseline.
+ * @return 0 on success, 1 on bad arguments, 2 if a metric regressed.
+ */
+int runStress(const QString& sceneList, const StressSuite::Options& options,
+              const QString& baselineFile, double threshold, const QString& outputFile)
+{
+    QString error;
+    const QList<StressSuite::Scene> scenes = StressSuite::parseScenes(sceneList, &error);
+    if (scenes.isEmpty()) {
+        QTextStream(stderr) << error << "\n";
+        return 1;
+    }
+
+    // Read the baseline first so a bad path fails before a long run
+    QJsonObject baseline;
+    if (!baselineFile.isEmpty()) {
+        QFile in(baselineFile);
+        if (!in.open(QIODevice::ReadOnly)) {
+            QTextStream(stderr) << "Could not read baseline " << baselineFile << "\n";
+            return 1;
+        }
+        baseline = QJsonDocument::fromJson(in.readAll()).object();
+        if (!baseline["scenes"].isArray()) {
+            QTextStream(stderr) << "Baseline " << baselineFile << " has no scenes\n";
+            return 1;
+        }
+    }
+
+    QJsonArray results;
+    for (const StressSuite::Scene& scene : scenes) {
+        QTextStream(stderr) << "Scene " << scene.name << ": " << scene.parts << " parts, "
+                            << scene.triangles << " triangles" << Qt::endl;
+        results.append(StressSuite::run(scene, options));
+    }
+
+    QJsonObject report = reportHeader();
+    report["mode"] = "stress";
+    report["frames"] = options.frames;
+    report["desktop_size"] = QString("%1x%2").arg(options.width).arg(options.height);
+    report["vr_size"] = QString("%1x%2").arg(options.vrWidth).arg(options.vrHeight);
+    report["scenes"] = results;
+    report["peak_memory_mb"] = double(peakMemoryBytes()) / (1024.0 * 1024.0);
+
+    QJsonArray regressions;
+    if (!baseline.isEmpty()) {
+        regressions = StressSuite::compare(report, baseline, threshold);
+        report["baseline"] = baselineFile;
+        report["threshold"] = threshold;
+        report["regressions"] = regressions;
+    }
+
+    if (!writeReport(report, outputFile))
+        return 1;
+
+    for (const QJsonValue& value : regressions) {
+        const QJsonObject regression = value.toObject();
+        QTextStream(stderr) << "Regression: " << regression["scene"].toString() << " "
+                            << regression["metric"].toString() << " "
+                            << regression["baseline"].toDouble() << " -> " << regression["current"].toDouble()
+                            << " (+" << qRound(regression["change"].toDouble() * 100.0) << "%)\n";
+    }
+    return regressions.isEmpty() ? 0 : 2;
+}
+
+} // namespace
+
+// --------------------------------------- Main ---------------------------------------
+
+/**
+ * @brief Runs the benchmark and writes the JSON report.
+ * @return 0 on success, 1 on bad arguments or if no part could be loaded, 2 if the
+ *         stress run regressed against its baseline.
+ */
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("VRproject_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless load/filter/render benchmark for VRproject.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("directory", "Directory containing the STL files to load (not used with --stress).");
+    QCommandLineOption framesOption("frames", "Number of offscreen frames to render.", "N", "300");
+    QCommandLineOption sizeOption("size", "Offscreen window size.", "WxH", "1920x1080");
+    QCommandLineOption outputOption("output", "Write the JSON report to a file instead of stdout.", "file");
+    QCommandLineOption stressOption("stress", "Run the synthetic scene suite instead of loading STL files.");
+    QCommandLineOption scenesOption("scenes", "Scenes to run: preset names (tiny, small, medium, detailed, "
+                                    "large, huge) or parts:triangles[:unique], comma-separated.",
+                                    "list", "tiny,small,medium,detailed");
+    QCommandLineOption vrSizeOption("vr-size", "Offscreen VR window size, both eyes side by side.", "WxH", "2880x1600");
+    QCommandLineOption baselineOption("baseline", "Stress report to compare against.", "file");
+    QCommandLineOption thresholdOption("threshold", "Allowed relative increase of a metric over the baseline.", "ratio", "0.2");
+    parser.addOption(framesOption);
+    parser.addOption(sizeOption);
+    parser.addOption(outputOption);
+    parser.addOption(stressOption);
+    parser.addOption(scenesOption);
+    parser.addOption(vrSizeOption);
+    parser.addOption(baselineOption);
+    parser.addOption(thresholdOption);
+    parser.process(app);
+
+    const int frames = qMax(1, parser.value(framesOption).toInt());
+    int width = 1920, height = 1080;
+    parseSize(parser.value(sizeOption), width, height);
+
+    if (parser.isSet(stressOption)) {
+        StressSuite::Options options;
+        options.frames = frames;
+        options.width = width;
+        options.height = height;
+        parseSize(parser.value(vrSizeOption), options.vrWidth, options.vrHeight);
+        return runStress(parser.value(scenesOption), options, parser.value(baselineOption),
+                         qMax(0.0, parser.value(thresholdOption).toDouble()), parser.value(outputOption));
+    }
+
+    if (parser.positionalArguments().size() != 1)
+        parser.showHelp(1);
+
+    const QDir directory(parser.positionalArguments().first());
+
+    const QFileInfoList files = directory.entryInfoList(
+        QStringList() << "*.stl" << "*.STL", QDir::Files, QDir::Name);
+    if (files.isEmpty()) {
+        QTextStream(stderr) << "No STL files in " << directory.absolutePath() << "\n";
+        return 1;
+    }
+
+    ModelPartList partList("Bench");
+    QList<ModelPart*> parts;
+    StageTotals load, shrink, clip, render;
+    QElapsedTimer timer;
+
+    // ---- Load: parse, build the pipeline and compute normals ----
+    for (const QFileInfo& file : files) {
+        QModelIndex index = partList.appendChild(QList<QVariant>{ file.fileName(), "true" });
+        ModelPart* part = static_cast<ModelPart*>(index.internalPointer());
+
+        timer.start();
+        part->loadSTL(file.absoluteFilePath());
+        const qint64 triangles = updatePart(part);
+        load.nanos += timer.nsecsElapsed();
+
+        if (triangles == 0)
+            continue;
+
+        load.triangles += triangles;
+        load.bytes += file.size();
+        parts.append(part);
+    }
+
+    if (parts.isEmpty()) {
+        QTextStream(stderr) << "No STL file could be loaded\n";
+        return 1;
+    }
+
+    // ---- Filters: each is switched on, executed, and switched off again ----
+    for (ModelPart* part : parts) {
+        const qint64 triangles = updatePart(part);
+
+        timer.start();
+        part->applyShrinkFilter(true, 0.8);
+        updatePart(part);
+        shrink.nanos += timer.nsecsElapsed();
+        shrink.triangles += triangles;
+        part->applyShrinkFilter(false, 0.8);
+
+        const double* bounds = part->getActor()->GetMapper()->GetBounds();
+        double origin[3] = { 0.5 * (bounds[0] + bounds[1]), 0.5 * (bounds[2] + bounds[3]), 0.5 * (bounds[4] + bounds[5]) };
+        double normal[3] = { 0.0, -1.0, 0.0 };
+
+        timer.start();
+        part->applyClipFilter(true, origin, normal);
+        updatePart(part);
+        clip.nanos += timer.nsecsElapsed();
+        clip.triangles += triangles;
+        part->applyClipFilter(false, origin, normal);
+        updatePart(part);
+    }
+
+    // ---- Render: orbit the camera around all parts offscreen ----
+    auto renderer = vtkSmartPointer<vtkRenderer>::New();
+    auto window = vtkSmartPointer<vtkRenderWindow>::New();
+    window->SetOffScreenRendering(1);
+    window->SetSize(width, height);
+    window->AddRenderer(renderer);
+
+    for (ModelPart* part : parts)
+        renderer->AddActor(part->getActor());
+    renderer->ResetCamera();
+
+    vtkOpenGLRenderWindow* glWindow = vtkOpenGLRenderWindow::SafeDownCast(window);
+    window->Render();                       // Warm-up: shader compilation and buffer upload
+    if (glWindow)
+        glWindow->WaitForCompletion();
+
+    timer.start();
+    for (int i = 0; i < frames; ++i) {
+        renderer->GetActiveCamera()->Azimuth(360.0 / frames);
+        window->Render();
+    }
+    if (glWindow)
+        glWindow->WaitForCompletion();
+    render.nanos = timer.nsecsElapsed();
+    render.triangles = load.triangles * frames;
+
+    const double renderSeconds = double(render.nanos) * 1.0e-9;
+    QJsonObject renderJson = stageJson(render);
+    renderJson["frames"] = frames;
+    renderJson["width"] = width;
+    renderJson["height"] = height;
+    renderJson["frames_per_s"] = renderSeconds > 0.0 ? frames / renderSeconds : 0.0;
+    renderJson["ms_per_frame"] = renderSeconds * 1000.0 / frames;
+
+    // ---- Report ----
+    QJsonArray fileNames;
+    for (ModelPart* part : parts)
+        fileNames.append(part->data(0).toString());
+
+    QJsonObject report = reportHeader();
+    report["directory"] = directory.absolutePath();
+    report["files"] = fileNames;
+    report["load"] = stageJson(load);
+    report["shrink"] = stageJson(shrink);
+    report["clip"] = stageJson(clip);
+    report["render"] = renderJson;
+    report["peak_memory_mb"] = double(peakMemoryBytes()) / (1024.0 * 1024.0);
+
+    return writeReport(report, parser.value(outputOption)) ? 0 : 1;
+}
@@ -18,6 +18,7 @@
 #include "Option_Dialog.h"
 #include "skyboxutils.h"
 #include "VRRenderThread.h"
+#include "SessionFile.h"
 
 // --------------------------------------- Qt Includes ---------------------------------------
 
@@ -31,8 +32,10 @@
 #include <QAction>
 #include <QPoint>
 #include <QTimer>
+#include <QScreen>
 #include <QSlider>
 #include <QCheckBox>
+#include <QSignalBlocker>
 #include <QtConcurrent>
 
 // --------------------------------------- VTK Includes ---------------------------------------
@@ -44,15 +47,33 @@
 #include <vtkActor.h>
 #include <vtkCamera.h>
 #include <vtkProperty.h>
+#include <vtkMath.h>
 #include <vtkTexture.h>
-#include <vtkJPEGReader.h>
-#include <vtkPNGReader.h>
 #include <vtkLight.h>
-#include <vtkImageReader2.h>
 #include <vtkClipDataSet.h>
 #include <vtkShrinkFilter.h>
 #include <vtkPlane.h>
 #include <vtkGeometryFilter.h>
+#include <vtkCullerCollection.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkMatrix4x4.h>
+#include <vtkBoundingBox.h>
+
+// --------------------------------------- Standard Includes ---------------------------------------
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+
+// --------------------------------------- Batch Constants ---------------------------------------
+
+namespace {
+
+// Names shown in the delete confirmation before the rest is summarised
+const int MaxListedNames = 20;
+
+} // namespace
 
 // --------------------------------------- Constructor & Setup ---------------------------------------
 /**
@@ -67,6 +88,15 @@ MainWindow::MainWindow(QWidget* parent)
     , rotationTimer(new QTimer(this))
     , rotationSpeed(0.0)
     , sceneLight(nullptr)
+    , partLoader(new PartLoader(this))
+    , textureLoader(new TextureLoader(this))
+    , filterRunner(new FilterRunner(this))
+    , memoryBudget(new MemoryBudget(&sceneBVH, this))
+    , memoryTimer(new QTimer(this))
+    , loadProgress(nullptr)
+    , sectionPart(nullptr)
+    , renderScheduler(nullptr)
+    , cameraFramed(false)
 {
     ui->setupUi(this);
 
@@ -78,6 +108,9 @@ MainWindow::MainWindow(QWidget* parent)
     connect(ui->pushButton, &QPushButton::clicked, this, &MainWindow::handleButton);
     connect(ui->treeView, &QTreeView::clicked, this, &MainWindow::handleTreeClicked);
     connect(ui->actionOpen_File, &QAction::triggered, this, &MainWindow::openFile);
+    connect(ui->actionOpen_Assembly, &QAction::triggered, this, &MainWindow::openAssemblyFolder);
+    connect(ui->actionOpen_Session, &QAction::triggered, this, &MainWindow::openSession);
+    connect(ui->actionSave_Session, &QAction::triggered, this, &MainWindow::saveSession);
     connect(ui->treeView, &QWidget::customContextMenuRequested, this, &MainWindow::showTreeContextMenu);
     connect(ui->deleteButton, &QPushButton::clicked, this, &MainWindow::deleteSelectedItem);
     connect(ui->toggleVR, &QPushButton::released, this, &MainWindow::handleStartVR);
@@ -85,10 +118,30 @@ MainWindow::MainWindow(QWidget* parent)
     connect(ui->loadSkyboxButton, &QPushButton::clicked, this, &MainWindow::onLoadSkyboxClicked);
     connect(this, &MainWindow::statusUpdateMessage, ui->statusbar, &QStatusBar::showMessage);
 
-    // Rotation timer and slider
+    // Background STL loading
+    connect(partLoader, &PartLoader::partLoaded, this, &MainWindow::onPartLoaded);
+    connect(partLoader, &PartLoader::partFailed, this, &MainWindow::onPartLoadFailed);
+    connect(partLoader, &PartLoader::lodsReady, this, &MainWindow::onLODsReady);
+    connect(partLoader, &PartLoader::progressChanged, this, &MainWindow::onLoadProgress);
+    connect(partLoader, &PartLoader::finished, this, &MainWindow::onLoadFinished);
+
+    // Background texture decoding
+    connect(textureLoader, &TextureLoader::skyboxReady, this, &MainWindow::onSkyboxReady);
+    connect(textureLoader, &TextureLoader::backgroundReady, this, &MainWindow::onBackgroundReady);
+    connect(textureLoader, &TextureLoader::loadFailed, this, &MainWindow::onTextureLoadFailed);
+
+    // Filter changes run in the background; the old geometry stays until the result is in
+    ModelPart::setFilterScheduler([this](ModelPart* part) { filterRunner->schedule(part); });
+
+    // Memory budget: off-screen geometry is evicted under pressure and reloaded when seen
+    connect(memoryTimer, &QTimer::timeout, this, &MainWindow::onMemoryCheck);
+    connect(memoryBudget, &MemoryBudget::geometryEvicted, this, &MainWindow::onGeometryEvicted);
+    memoryTimer->start(1000);
+
+    // Rotation timer and slider; the timer only runs while selected parts are spinning
     connect(rotationTimer, &QTimer::timeout, this, &MainWindow::onAutoRotate);
     connect(ui->rotationSpeedSlider, &QSlider::valueChanged, this, &MainWindow::onRotationSpeedChanged);
-    rotationTimer->start(16); // ~60 FPS
+    rotationTimer->setInterval(16); // ~60 FPS
 
     // Lighting intensity
     connect(ui->horizontalSlider, &QSlider::valueChanged, this, &MainWindow::onLightIntensityChanged);
@@ -96,21 +149,100 @@ MainWindow::MainWindow(QWidget* parent)
     // Filter toggles
     connect(ui->checkBox_Clip, &QCheckBox::toggled, this, &MainWindow::on_checkBox_Clip_toggled);
     connect(ui->checkBox_Shrink, &QCheckBox::toggled, this, &MainWindow::on_checkBox_Shrink_toggled);
+
+    // Shrink and explode sliders follow the drag on the GPU backend
+    ModelPart::setGpuEffects(ui->actionGPU_Effects->isChecked());
+    connect(ui->shrinkSlider, &QSlider::valueChanged, this, &MainWindow::onShrinkFactorChanged);
+    connect(ui->explodeSlider, &QSlider::valueChanged, this, &MainWindow::onExplodeChanged);
+    connect(ui->actionGPU_Effects, &QAction::toggled, this, &MainWindow::onGpuEffectsToggled);
     connect(ui->exitVRButton, &QPushButton::clicked, this, &MainWindow::onExitVRClicked);
+    connect(ui->actionAdaptive_VR_Quality, &QAction::toggled, this, &MainWindow::onAdaptiveVRQualityToggled);
+    connect(ui->actionMerge_VR_Parts, &QAction::toggled, this, &MainWindow::onMergeVRPartsToggled);
+
+    // Frame statistics
+    connect(ui->actionShow_Frame_Stats, &QAction::toggled, this, &MainWindow::onShowFrameStatsToggled);
+    connect(ui->actionShow_Feature_Edges, &QAction::toggled, this, &MainWindow::onShowFeatureEdgesToggled);
+    connect(ui->actionExport_Frame_Trace, &QAction::triggered, this, &MainWindow::onExportFrameTrace);
+
+    // Section views
+    connect(ui->actionScene_Section, &QAction::toggled, this, &MainWindow::onSceneSectionToggled);
 
     // Create model part list and link to tree view
     this->partList = new ModelPartList("PartsList");
+    memoryBudget->setPartList(partList);
     ui->treeView->setModel(this->partList);
     ui->treeView->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+    // Large trees: one row height for all rows, and column widths measured on the visible rows only
+    ui->treeView->setUniformRowHeights(true);
+    ui->treeView->header()->setResizeContentsPrecision(0);
     ui->treeView->setContextMenuPolicy(Qt::CustomContextMenu);
     ui->treeView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    connect(ui->treeView->selectionModel(), &QItemSelectionModel::selectionChanged, this, &MainWindow::updateRotationTimer);
+
+    // The scenes follow the model through its change signals instead of being rebuilt
+    connect(partList, &ModelPartList::partAdded, this, &MainWindow::onPartAdded);
+    connect(partList, &ModelPartList::partChanged, this, &MainWindow::onPartChanged);
+    connect(partList, &ModelPartList::partAboutToBeRemoved, this, &MainWindow::onPartAboutToBeRemoved);
+    connect(filterRunner, &FilterRunner::partFiltered, partList, &ModelPartList::notifyPartChanged);
+    connect(memoryBudget, &MemoryBudget::geometryRestored, partList, &ModelPartList::notifyPartChanged);
 
     // Setup VTK rendering
     renderWindow = vtkSmartPointer<vtkGenericOpenGLRenderWindow>::New();
     ui->vtkWidget->setRenderWindow(renderWindow);
+    textureLoader->setRenderWindow(renderWindow);
 
     renderer = vtkSmartPointer<vtkRenderer>::New();
     renderWindow->AddRenderer(renderer);
+    desktopLOD.attach(renderer);
+    desktopInstances.setBVH(&sceneBVH);
+    desktopInstances.attach(renderer);
+    desktopEnvironment.attach(renderer);
+    desktopSection.attach(renderer);
+    desktopEdges.attach(renderer);
+
+    // Cull part actors against the view frustum through the bounds hierarchy
+    sceneCuller = vtkSmartPointer<SceneBVHCuller>::New();
+    sceneCuller->SetBVH(&sceneBVH);
+    renderer->GetCullers()->RemoveAllItems();
+    renderer->AddCuller(sceneCuller);
+
+    // Left clicks in the viewport select the part under the cursor
+    pressPosition[0] = pressPosition[1] = 0;
+    clickCallback = vtkSmartPointer<vtkCallbackCommand>::New();
+    clickCallback->SetCallback(&MainWindow::onViewportClick);
+    clickCallback->SetClientData(this);
+    renderWindow->GetInteractor()->AddObserver(vtkCommand::LeftButtonPressEvent, clickCallback);
+    renderWindow->GetInteractor()->AddObserver(vtkCommand::LeftButtonReleaseEvent, clickCallback);
+
+    // Section planes are dragged with a plane widget; a drag only moves the GPU clip planes
+    sectionRepresentation = vtkSmartPointer<vtkImplicitPlaneRepresentation>::New();
+    sectionRepresentation->SetPlaceFactor(1.1);
+    sectionRepresentation->OutlineTranslationOff();
+    sectionRepresentation->ScaleEnabledOff();
+    sectionRepresentation->GetPlaneProperty()->SetOpacity(0.15);
+    sectionWidget = vtkSmartPointer<vtkImplicitPlaneWidget2>::New();
+    sectionWidget->SetInteractor(renderWindow->GetInteractor());
+    sectionWidget->SetRepresentation(sectionRepresentation);
+    sectionCallback = vtkSmartPointer<vtkCallbackCommand>::New();
+    sectionCallback->SetCallback(&MainWindow::onSectionWidgetMoved);
+    sectionCallback->SetClientData(this);
+    sectionWidget->AddObserver(vtkCommand::InteractionEvent, sectionCallback);
+
+    // Slots request renders instead of drawing directly; requests are merged per display refresh
+    renderScheduler = new RenderScheduler(renderWindow, this);
+    if (screen())
+        renderScheduler->setRefreshRate(screen()->refreshRate());
+
+    // Time every desktop render; the overlay also shows the VR loop while it runs
+    desktopProfiler.attach(renderer);
+    desktopProfiler.setOverlayExtra([this]() {
+        QString text = memoryBudget->summaryText();
+        if (vrThread && vrThread->isRunning())
+            text += "\n" + vrThread->getProfiler().summaryText("VR") + "\n" + vrThread->getPacer().summaryText()
+                  + "\n" + vrThread->getFoveation().summaryText();
+        return text;
+    });
 
     // Add a sample cylinder model
     vtkNew<vtkCylinderSource> cylinder;
@@ -119,12 +251,12 @@ MainWindow::MainWindow(QWidget* parent)
     vtkNew<vtkPolyDataMapper> cylinderMapper;
     cylinderMapper->SetInputConnection(cylinder->GetOutputPort());
 
-    vtkNew<vtkActor> cylinderActor;
-    cylinderActor->SetMapper(cylinderMapper);
-    cylinderActor->GetProperty()->SetColor(1.0, 0.0, 0.35);
-    cylinderActor->RotateX(30.0);
-    cylinderActor->RotateY(-45.0);
-    renderer->AddActor(cylinderActor);
+    sampleActor = vtkSmartPointer<vtkActor>::New();
+    sampleActor->SetMapper(cylinderMapper);
+    sampleActor->GetProperty()->SetColor(1.0, 0.0, 0.35);
+    sampleActor->RotateX(30.0);
+    sampleActor->RotateY(-45.0);
+    renderer->AddActor(sampleActor);
 
     renderer->ResetCamera();
     renderer->GetActiveCamera()->Azimuth(30);
@@ -144,6 +276,7 @@ MainWindow::MainWindow(QWidget* parent)
 
     // Initialize VR thread
     vrThread = new VRRenderThread(this);
+    connect(vrThread, &VRRenderThread::partPicked, this, &MainWindow::onVRPartPicked);
 }
 /**
  * @brief Destructor: cleans up UI resources.
@@ -152,6 +285,15 @@ MainWindow::MainWindow(QWidget* parent)
 // Destructor: cleans up UI
 MainWindow::~MainWindow()
 {
+    // GPU timer queries belong to the desktop GL context
+    renderWindow->MakeCurrent();
+    desktopProfiler.releaseGraphicsResources();
+    desktopProfiler.detach();
+    sceneCuller->SetBVH(nullptr);
+
+    // Parts deleted after the window filter synchronously
+    ModelPart::setFilterScheduler(nullptr);
+
     delete ui;
 }
 
@@ -204,49 +346,553 @@ void MainWindow::on_actionOpen_File_triggered()
 }
 
 /**
- * @brief Opens one or more STL files and adds them to the model tree.
+ * @brief Opens one or more STL files and queues them for background loading.
+ *
+ * Duplicate names are rejected up front; parsing happens on the thread pool and
+ * each part is added to the tree by onPartLoaded() as soon as it is ready.
  */
 
-// Opens STL files and adds them to the tree
+// Opens STL files and hands them to the background loader
 void MainWindow::openFile()
 {
     QStringList fileNames = QFileDialog::getOpenFileNames(
         this, tr("Open File"), QDir::homePath(), tr("STL Files (*.stl);;All Files (*)"));
 
-    if (!fileNames.isEmpty()) {
-        QModelIndex index = ui->treeView->currentIndex();
-        ModelPart* selectedPart = index.isValid()
-            ? static_cast<ModelPart*>(index.internalPointer())
-            : partList->getRootItem();
-
-        for (const QString& fileName : fileNames) {
-            QString shortName = QFileInfo(fileName).fileName();
-
-            bool alreadyExists = false;
-            int rows = partList->rowCount(QModelIndex());
-            for (int i = 0; i < rows; ++i) {
-                QModelIndex existingIndex = partList->index(i, 0, QModelIndex());
-                ModelPart* existingPart = static_cast<ModelPart*>(existingIndex.internalPointer());
-                if (existingPart && existingPart->data(0).toString() == shortName) {
-                    alreadyExists = true;
-                    break;
-                }
-            }
+    if (fileNames.isEmpty())
+        return;
 
-            if (alreadyExists) {
-                QMessageBox::information(this, "Duplicate File", "The file \"" + shortName + "\" is already loaded.");
-                continue;
-            }
+    QStringList toLoad;
+    for (const QString& fileName : fileNames) {
+        QString shortName = QFileInfo(fileName).fileName();
+
+        // Both checks are O(1): the model keeps name and content indexes
+        if (pendingNames.contains(shortName) || partList->findTopLevelByName(shortName)) {
+            QMessageBox::information(this, "Duplicate File", "The file \"" + shortName + "\" is already loaded.");
+            continue;
+        }
+
+        // Same file under another name (copied or renamed)
+        QByteArray content = ModelPartList::fingerprint(fileName);
+        ModelPart* sameContent = partList->findByFingerprint(content);
+        if (sameContent || (!content.isEmpty() && pendingContent.contains(content))) {
+            QString other = sameContent ? sameContent->data(0).toString() : tr("a file being loaded");
+            QMessageBox::information(this, "Duplicate File",
+                "The file \"" + shortName + "\" has the same contents as \"" + other + "\".");
+            continue;
+        }
+
+        pendingNames.insert(shortName, content);
+        if (!content.isEmpty())
+            pendingContent.insert(content);
+        toLoad << fileName;
+    }
+
+    partLoader->load(toLoad);
+}
+
+/**
+ * @brief Opens a folder hierarchy as a sub-assembly.
+ *
+ * Every folder becomes an assembly node and every STL a placeholder part, so the
+ * full tree is available at once; the parts receive their geometry as the
+ * background loader finishes each file.
+ */
+
+// Builds the assembly tree for a folder and queues its STL files
+void MainWindow::openAssemblyFolder()
+{
+    QString folder = QFileDialog::getExistingDirectory(this, tr("Open Assembly Folder"), QDir::homePath());
+    if (folder.isEmpty())
+        return;
+
+    QStringList fileNames;
+    addAssemblyFolder(partList->getRootItem(), folder, fileNames);
+
+    if (fileNames.isEmpty()) {
+        emit statusUpdateMessage("No STL files in: " + folder, 0);
+        return;
+    }
+
+    partLoader->load(fileNames);
+}
+
+/**
+ * @brief Adds an assembly node for a folder and placeholders for its STL files.
+ * @param parent     Node that receives the assembly.
+ * @param folder     Folder to scan.
+ * @param fileNames  STL files to queue for loading (appended to).
+ */
+
+// Recursively mirrors a folder tree into the model
+void MainWindow::addAssemblyFolder(ModelPart* parent, const QString& folder, QStringList& fileNames)
+{
+    QDir dir(folder);
+    ModelPart* assembly = partList->appendPart(parent, { dir.dirName(), "true" });
+
+    const QFileInfoList subFolders = dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    for (const QFileInfo& subFolder : subFolders)
+        addAssemblyFolder(assembly, subFolder.absoluteFilePath(), fileNames);
+
+    const QFileInfoList files = dir.entryInfoList(QStringList() << "*.stl" << "*.STL", QDir::Files, QDir::Name);
+    for (const QFileInfo& file : files) {
+        ModelPart* part = partList->appendPart(assembly, { file.fileName(), "true" });
+
+        // Repeated files (bolts, cells) are parsed once and share one mesh
+        QByteArray content = ModelPartList::fingerprint(file.absoluteFilePath());
+        ModelPart* twin = partList->findByFingerprint(content);
+        partList->setPartFile(part, file.absoluteFilePath(), content);
+
+        if (twin && twin->getPolyData()) {
+            part->setPolyData(twin->getPolyData());
+            part->setLODs(twin->getLODData());
+            partList->notifyPartChanged(part);
+        }
+        else if (!twin || !pendingParts.contains(twin->getSourceFile())) {
+            pendingParts.insert(file.absoluteFilePath(), part);
+            fileNames << file.absoluteFilePath();
+        }
+        // else: filled by onPartLoaded() when the twin's file arrives
+    }
+}
+
+/**
+ * @brief Adds a freshly loaded part to the tree and the scene.
+ * @param fileName  Full path of the loaded file.
+ * @param polyData  Geometry parsed on the worker thread.
+ */
+
+// Creates the tree row and actors for a part finished by the loader
+void MainWindow::onPartLoaded(const QString& fileName, vtkSmartPointer<vtkPolyData> polyData)
+{
+    // Parts of an assembly already have a (placeholder) node in the tree
+    const QString path = QFileInfo(fileName).absoluteFilePath();
+    ModelPart* newPart = pendingParts.take(path);
+
+    // A placeholder deleted while loading gets no new row; copies still waiting keep the mesh
+    if (!newPart && forgottenFiles.contains(path)) {
+        fillWaitingCopies(forgottenFiles.take(path), polyData);
+        return;
+    }
+
+    if (!newPart) {
+        QString shortName = QFileInfo(fileName).fileName();
+        if (!pendingNames.contains(shortName))
+            return;
+        QByteArray content = pendingNames.take(shortName);
+        pendingContent.remove(content);
+
+        QList<QVariant> data = { shortName, "true" };
+        QModelIndex newIndex = partList->appendChild(data);
+        newPart = static_cast<ModelPart*>(newIndex.internalPointer());
+        partList->setPartFile(newPart, fileName, content);
+    }
+
+    newPart->setPolyData(polyData);
+    partList->notifyPartChanged(newPart);
+    fillWaitingCopies(partList->fingerprintOf(newPart), polyData);
+}
+
+/**
+ * @brief Gives a loaded mesh to the parts still waiting for the same content.
+ * @param content   Fingerprint of the loaded file.
+ * @param polyData  Geometry parsed on the worker thread.
+ */
+
+// Copies of the same file waiting in the tree get the same mesh
+void MainWindow::fillWaitingCopies(const QByteArray& content, vtkSmartPointer<vtkPolyData> polyData)
+{
+    if (content.isEmpty())
+        return;
+
+    for (ModelPart* copy : partList->findAllByFingerprint(content)) {
+        if (!copy->getPolyData() && !copy->isGeometryEvicted()) {
+            copy->setPolyData(polyData);
+            partList->notifyPartChanged(copy);
+        }
+    }
+}
+
+/**
+ * @brief Reports a file the loader could not parse.
+ * @param fileName  Full path of the failed file.
+ */
+
+// Shows a status message for a failed load
+void MainWindow::onPartLoadFailed(const QString& fileName)
+{
+    QString shortName = QFileInfo(fileName).fileName();
+    const QString path = QFileInfo(fileName).absoluteFilePath();
+    if (!pendingParts.remove(path) && !forgottenFiles.remove(path))
+        pendingContent.remove(pendingNames.take(shortName));
+    emit statusUpdateMessage("Failed to load: " + shortName, 0);
+}
+
+/**
+ * @brief Applies decimated levels to the part loaded from a file.
+ * @param fileName  Full path of the part's file.
+ * @param levels    Decimated meshes from the cache or the background rebuild.
+ */
+
+// Finds the part by its source file and enables LOD switching on it
+void MainWindow::onLODsReady(const QString& fileName, const PartLoader::Levels& levels)
+{
+    ModelPart* part = findPartByFile(partList->getRootItem(), fileName);
+    if (!part)
+        return;
+
+    // Copies sharing the mesh share its levels too
+    QList<ModelPart*> copies = partList->findAllByFingerprint(partList->fingerprintOf(part));
+    if (copies.isEmpty())
+        copies << part;
+
+    for (ModelPart* copy : copies) {
+        if (copy->getPolyData() != part->getPolyData())
+            continue;
+        copy->setLODs(levels);
+        syncLOD(copy);
+    }
+}
+
+/**
+ * @brief Finds the part loaded from a file.
+ * @param node      Subtree to search.
+ * @param fileName  Full path of the source file.
+ * @return The part, or nullptr if it is not in the subtree.
+ */
+
+// Depth-first search by source file
+ModelPart* MainWindow::findPartByFile(ModelPart* node, const QString& fileName) const
+{
+    if (!node)
+        return nullptr;
+
+    if (!node->getSourceFile().isEmpty() && node->getSourceFile() == fileName)
+        return node;
+
+    for (int i = 0; i < node->childCount(); ++i) {
+        if (ModelPart* found = findPartByFile(node->child(i), fileName))
+            return found;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Shows per-file loading progress with a cancel button.
+ * @param done      Files finished in the current batch.
+ * @param total     Files in the current batch.
+ * @param fileName  Most recently finished file (empty at batch start).
+ */
+
+// Creates/updates the loading progress dialog
+void MainWindow::onLoadProgress(int done, int total, const QString& fileName)
+{
+    if (!loadProgress) {
+        loadProgress = new QProgressDialog(tr("Loading parts..."), tr("Cancel"), 0, total, this);
+        loadProgress->setWindowTitle(tr("Open File"));
+        loadProgress->setMinimumDuration(0);
+        loadProgress->setAutoClose(false);
+        loadProgress->setAutoReset(false);
+        connect(loadProgress, &QProgressDialog::canceled, partLoader, &PartLoader::cancel);
+    }
+
+    loadProgress->setMaximum(total);
+    loadProgress->setValue(done);
+    if (!fileName.isEmpty())
+        loadProgress->setLabelText(tr("Loaded %1 (%2 of %3)").arg(fileName).arg(done).arg(total));
+}
+
+/**
+ * @brief Closes the progress dialog and refreshes the scene once loading stops.
+ * @param cancelled  True if the user cancelled the batch.
+ */
+
+// Cleans up after a load batch and resets the camera
+void MainWindow::onLoadFinished(bool cancelled)
+{
+    pendingNames.clear();
+    pendingContent.clear();
+    pendingParts.clear();
+    forgottenFiles.clear();
+
+    if (loadProgress) {
+        loadProgress->deleteLater();
+        loadProgress = nullptr;
+    }
+
+    emit statusUpdateMessage(cancelled ? QString("Loading cancelled") : QString("Loading complete"), 0);
+
+    // Frame the parts once; after that the user's camera is left alone
+    if (!cameraFramed && sceneBVH.size() > 0) {
+        renderer->ResetCamera();
+        cameraFramed = true;
+    }
+    else {
+        renderer->ResetCameraClippingRange();
+    }
+    renderScheduler->requestRender();
+
+    // Only the top level: expanding everything would fetch every batch of a huge assembly
+    ui->treeView->expandToDepth(0);
+}
+
+// --------------------------------------- Sessions ---------------------------------------
+/**
+ * @brief Saves the part tree and view state to a session file.
+ *
+ * Only settings and file references are written, so saving is instant even for
+ * assemblies with thousands of parts.
+ */
+
+// Captures the session and writes it to a user-chosen file
+void MainWindow::saveSession()
+{
+    QString fileName = QFileDialog::getSaveFileName(
+        this, tr("Save Session"), QDir::homePath() + "/session.vrsession", tr("VR Sessions (*.vrsession)"));
+
+    if (fileName.isEmpty())
+        return;
 
-            QList<QVariant> data = { shortName, "true" };
-            QModelIndex newIndex = partList->appendChild(data);
-            ModelPart* newPart = static_cast<ModelPart*>(newIndex.internalPointer());
-            newPart->loadSTL(fileName);
+    SessionFile::Session session;
+    vtkCamera* camera = renderer->GetActiveCamera();
+    camera->GetPosition(session.cameraPosition);
+    camera->GetFocalPoint(session.cameraFocalPoint);
+    camera->GetViewUp(session.cameraViewUp);
+    session.cameraViewAngle = camera->GetViewAngle();
+    session.lightIntensity = ui->horizontalSlider->value();
+    session.skyboxFolder = skyboxPath;
+    session.scenePlanes = desktopSection.getScenePlanes();
+
+    ModelPart* root = partList->getRootItem();
+    for (int i = 0; i < root->childCount(); ++i)
+        captureSessionPart(root->child(i), -1, session.parts);
+
+    if (SessionFile::write(fileName, session))
+        emit statusUpdateMessage("Session saved: " + fileName, 0);
+    else
+        emit statusUpdateMessage("Could not write: " + fileName, 0);
+}
+
+/**
+ * @brief Appends a subtree to a session, parents first.
+ * @param part    Root of the subtree.
+ * @param parent  Session index of the node's parent (-1 for a top-level node).
+ * @param parts   Session nodes, appended to.
+ */
+
+// Depth-first copy of one node's settings
+void MainWindow::captureSessionPart(ModelPart* part, int parent, QVector<SessionFile::Part>& parts) const
+{
+    if (!part) return;
+
+    SessionFile::Part node;
+    node.parent = parent;
+    node.name = part->data(0).toString();
+    node.sourceFile = part->getSourceFile();
+    node.fingerprint = partList->fingerprintOf(part);
+    if (!node.sourceFile.isEmpty()) {
+        const QFileInfo source(node.sourceFile);
+        node.sourceSize = source.exists() ? source.size() : -1;
+        node.sourceModified = source.lastModified().toMSecsSinceEpoch();
+    }
+    node.color = part->getColor();
+    node.visible = part->visible();
+    node.clipEnabled = part->isClipFilterEnabled();
+    node.clipPlanes = part->getClipPlanes();
+    node.shrinkEnabled = part->isShrinkFilterEnabled();
+    node.shrinkFactor = part->getShrinkFactor();
+    node.sectionPlanes = part->getSectionPlanes();
+
+    if (vtkMatrix4x4* local = part->getLocalTransform()) {
+        node.hasTransform = true;
+        for (int i = 0; i < 16; ++i)
+            node.transform[i] = local->GetElement(i / 4, i % 4);
+    }
+
+    // Bounds let a restore stream the parts that fill the view first
+    if (part->getActor() && part->getPolyData()) {
+        part->getActor()->GetBounds(node.bounds);
+        node.hasBounds = vtkMath::AreBoundsInitialized(node.bounds);
+    }
+
+    const int index = parts.size();
+    parts << node;
+    for (int i = 0; i < part->childCount(); ++i)
+        captureSessionPart(part->child(i), index, parts);
+}
+
+/**
+ * @brief Replaces the scene with a saved session.
+ *
+ * The tree, settings and view come back at once; geometry then streams in through
+ * the background loader, see restoreSession().
+ */
+
+// Reads a user-chosen session file and restores it
+void MainWindow::openSession()
+{
+    QString fileName = QFileDialog::getOpenFileName(
+        this, tr("Open Session"), QDir::homePath(), tr("VR Sessions (*.vrsession);;All Files (*)"));
+
+    if (fileName.isEmpty())
+        return;
+
+    // The loader's finish clears the placeholder table the restore fills
+    if (partLoader->isLoading()) {
+        emit statusUpdateMessage("Wait for loading to finish before opening a session", 0);
+        return;
+    }
+
+    SessionFile::Session session;
+    if (!SessionFile::read(fileName, session)) {
+        QMessageBox::warning(this, "Open Session", "\"" + QFileInfo(fileName).fileName() + "\" is not a readable session file.");
+        return;
+    }
+
+    restoreSession(session);
+}
+
+/**
+ * @brief Rebuilds the tree and view from a session and queues the geometry by priority.
+ * @param session  Session read from disk.
+ *
+ * Every node is created as a placeholder with its saved settings, which the parts
+ * pick up when their mesh arrives. Files are queued visible parts first, largest
+ * on screen (by their saved bounds, seen from the restored camera) first, so the
+ * view fills in front to back while hidden parts load last. Repeated files are
+ * queued once; the copies get the shared mesh in onPartLoaded().
+ */
+
+// Skeleton tree now, meshes streamed in visibility order
+void MainWindow::restoreSession(const SessionFile::Session& session)
+{
+    hideSectionWidget();
+    ModelPart* root = partList->getRootItem();
+    if (root->childCount() > 0)
+        partList->removeRows(0, root->childCount());
+
+    // View state: the saved camera is kept when the parts arrive
+    vtkCamera* camera = renderer->GetActiveCamera();
+    camera->SetPosition(session.cameraPosition);
+    camera->SetFocalPoint(session.cameraFocalPoint);
+    camera->SetViewUp(session.cameraViewUp);
+    camera->SetViewAngle(session.cameraViewAngle);
+    cameraFramed = true;
+
+    {
+        const QSignalBlocker blocker(ui->horizontalSlider);
+        ui->horizontalSlider->setValue(session.lightIntensity);
+    }
+    onLightIntensityChanged(ui->horizontalSlider->value());
+
+    if (!session.skyboxFolder.isEmpty() && session.skyboxFolder != skyboxPath) {
+        requestedSkybox = session.skyboxFolder;
+        textureLoader->loadSkybox(requestedSkybox);
+    }
+
+    // Direction the restored camera looks in, for the streaming order
+    double viewDirection[3];
+    for (int k = 0; k < 3; ++k)
+        viewDirection[k] = session.cameraFocalPoint[k] - session.cameraPosition[k];
+    vtkMath::Normalize(viewDirection);
+
+    QVector<ModelPart*> nodes;
+    nodes.reserve(session.parts.size());
+    QVector<QPair<double, QString>> queue;
+    QSet<QByteArray> queuedContent;
+    vtkBoundingBox sceneBox;
+    int missing = 0;
+
+    for (const SessionFile::Part& saved : session.parts) {
+        ModelPart* parent = saved.parent < 0 ? root : nodes[saved.parent];
+        ModelPart* part = partList->appendPart(parent, { saved.name, saved.visible ? "true" : "false" });
+        nodes << part;
+
+        part->setColor(saved.color);
+        part->setVisible(saved.visible);
+        part->setFilterSettings(saved.clipEnabled, saved.clipPlanes, saved.shrinkEnabled, saved.shrinkFactor);
+        part->setSectionPlanes(saved.sectionPlanes);
+        if (saved.hasTransform) {
+            auto local = vtkSmartPointer<vtkMatrix4x4>::New();
+            local->DeepCopy(saved.transform);
+            part->setLocalTransform(local);
         }
 
-        updateRender();
-        ui->treeView->expandAll();
+        if (saved.hasBounds)
+            sceneBox.AddBounds(saved.bounds);
+
+        if (saved.sourceFile.isEmpty())
+            continue;
+        if (!QFileInfo::exists(saved.sourceFile)) {
+            ++missing;
+            continue;
+        }
+
+        // A file edited since the save is fingerprinted again, so it cannot pass as a twin of stale content
+        const QFileInfo source(saved.sourceFile);
+        const bool unchanged = saved.sourceSize == source.size()
+                            && saved.sourceModified == source.lastModified().toMSecsSinceEpoch();
+        partList->setPartFile(part, saved.sourceFile, unchanged ? saved.fingerprint : QByteArray());
+        const QByteArray content = partList->fingerprintOf(part);
+        if (pendingParts.contains(saved.sourceFile) || (!content.isEmpty() && queuedContent.contains(content)))
+            continue;
+        pendingParts.insert(saved.sourceFile, part);
+        if (!content.isEmpty())
+            queuedContent.insert(content);
+
+        // Apparent size from the saved camera; parts behind it (or never loaded) come after
+        double priority = 0.0;
+        if (saved.hasBounds) {
+            double centre[3], offset[3];
+            double radius = 0.0;
+            for (int k = 0; k < 3; ++k) {
+                centre[k] = 0.5 * (saved.bounds[2 * k] + saved.bounds[2 * k + 1]);
+                offset[k] = centre[k] - session.cameraPosition[k];
+                radius += 0.25 * (saved.bounds[2 * k + 1] - saved.bounds[2 * k]) * (saved.bounds[2 * k + 1] - saved.bounds[2 * k]);
+            }
+            radius = std::sqrt(radius);
+            const double depth = vtkMath::Dot(offset, viewDirection);
+            if (depth + radius > 0.0)
+                priority = 1.0 + radius / std::max(depth, radius);
+        }
+        if (saved.visible)
+            priority += 10.0;
+        queue << qMakePair(priority, saved.sourceFile);
+    }
+
+    std::stable_sort(queue.begin(), queue.end(),
+        [](const QPair<double, QString>& a, const QPair<double, QString>& b) {
+            return a.first > b.first;
+        });
+
+    QStringList fileNames;
+    for (const QPair<double, QString>& entry : queue)
+        fileNames << entry.second;
+
+    // Scene section, with the widget around the saved extent of the parts
+    desktopSection.setScenePlanes(session.scenePlanes);
+    if (vrThread)
+        vrThread->setSectionPlanes(session.scenePlanes);
+    {
+        const QSignalBlocker blocker(ui->actionScene_Section);
+        ui->actionScene_Section->setChecked(!session.scenePlanes.isEmpty());
+    }
+    if (!session.scenePlanes.isEmpty() && sceneBox.IsValid()) {
+        double sceneBounds[6];
+        sceneBox.GetBounds(sceneBounds);
+        showSectionWidget(session.scenePlanes.first(), sceneBounds, nullptr);
     }
+
+    renderer->ResetCameraClippingRange();
+    renderScheduler->requestRender();
+    ui->treeView->expandToDepth(0);
+
+    if (!fileNames.isEmpty())
+        partLoader->load(fileNames);
+
+    QString message = QString("Session opened: %1 parts, loading %2 files").arg(session.parts.size()).arg(fileNames.size());
+    if (missing > 0)
+        message += QString(" (%1 missing)").arg(missing);
+    emit statusUpdateMessage(message, 0);
 }
 
 // --------------------------------------- Dialogs & Tree Context ---------------------------------------
@@ -272,6 +918,13 @@ void MainWindow::showTreeContextMenu(const QPoint& pos)
     QAction* itemOptions = new QAction("Item Options", this);
     connect(itemOptions, &QAction::triggered, this, &MainWindow::on_actionItemOptions_triggered);
     contextMenu.addAction(itemOptions);
+
+    // Baking needs a section to bake
+    ModelPart* part = static_cast<ModelPart*>(ui->treeView->currentIndex().internalPointer());
+    QAction* bakeSection = new QAction("Bake Section", this);
+    connect(bakeSection, &QAction::triggered, this, &MainWindow::onBakeSectionTriggered);
+    contextMenu.addAction(bakeSection);
+    bakeSection->setEnabled(part && part->getActor() && (part->hasSectionPlanes() || !desktopSection.getScenePlanes().isEmpty()));
     contextMenu.exec(ui->treeView->mapToGlobal(pos));
 }
 
@@ -297,14 +950,19 @@ void MainWindow::on_actionItemOptions_triggered()
         int r, g, b;
         bool visible;
         dialog.getModelPartData(name, r, g, b, visible);
-        selectedPart->setName(name);
-        selectedPart->setColor(QColor(r, g, b));
-        selectedPart->setVisible(visible);
+        partList->setPartName(selectedPart, name);
+
+        // Colour and visibility go to the whole selection; only the current part is renamed
+        QList<ModelPart*> parts = selectedParts(true);
+        if (!parts.contains(selectedPart))
+            parts << selectedPart;
+        for (ModelPart* part : parts) {
+            part->setColor(QColor(r, g, b));
+            part->setVisible(visible);
+            partList->notifyPartChanged(part);
+        }
 
-        emit ui->treeView->model()->dataChanged(index, index, { Qt::DisplayRole, Qt::BackgroundRole });
-        ui->treeView->update();
-        renderWindow->Render();
-        emit statusUpdateMessage("Updated: " + name, 0);
+        emit statusUpdateMessage(parts.size() > 1 ? QString("Updated %1 parts").arg(parts.size()) : "Updated: " + name, 0);
     }
 }
 
@@ -330,35 +988,70 @@ void MainWindow::openOptionDialog()
     dialog.setModelPart(selectedPart);
 
     if (dialog.exec() == QDialog::Accepted) {
+        // The dialog renames the part itself; re-index it under the new name
+        partList->setPartName(selectedPart, selectedPart->data(0).toString());
         emit statusUpdateMessage("Updated: " + selectedPart->data(0).toString(), 0);
-        ui->treeView->model()->dataChanged(index, index);
-        renderWindow->Render();
+        partList->notifyPartChanged(selectedPart);
     }
 }
 
 // --------------------------------------- Rendering ---------------------------------------
 /**
- * @brief Clears the scene and re-renders all visible parts.
+ * @brief Adds a new part to the scenes; the start-up sample goes once real parts arrive.
+ * @param part  Part appended to the model.
  */
 
-// Updates the scene with current model parts
-void MainWindow::updateRender()
+// Applies an "added" delta
+void MainWindow::onPartAdded(ModelPart* part)
 {
-    renderer->RemoveAllViewProps();
+    if (sampleActor) {
+        renderer->RemoveActor(sampleActor);
+        sampleActor = nullptr;
+    }
 
-    // If VR is running, clear old actors
-    if (vrThread && vrThread->isRunning())
-        vrThread->clearAllActors();  // Must be implemented in VRRenderThread
+    // Parts usually get their geometry later, which arrives as a change
+    addPartToScene(part);
+    renderScheduler->requestRender();
+}
+
+/**
+ * @brief Mirrors a changed part into both scenes.
+ * @param part  The changed part.
+ */
+
+// Applies a "changed" delta: adds the actors on first geometry, then syncs state
+void MainWindow::onPartChanged(ModelPart* part)
+{
+    if (!part) return;
+
+    addPartToScene(part);
+    syncVRPart(part);
+    renderScheduler->requestRender();
+}
+
+/**
+ * @brief Removes a subtree's actors before the model deletes it.
+ * @param part  Root of the removed subtree.
+ */
 
-    // Loop through each top-level item and recursively render
-    int rows = partList->rowCount();
-    for (int i = 0; i < rows; ++i) {
-        QModelIndex index = partList->index(i, 0, QModelIndex());
-        updateRenderFromTree(index);
+// Applies a "removed" delta
+void MainWindow::onPartAboutToBeRemoved(ModelPart* part)
+{
+    removePartFromScene(part);
+    forgetPendingParts(part);
+
+    // The widget must not keep moving the plane of a deleted part
+    for (ModelPart* node = sectionPart; node; node = node->parentItem()) {
+        if (node == part) {
+            hideSectionWidget();
+            break;
+        }
     }
 
-    renderer->ResetCamera();
-    renderer->Render();
+    // An empty scene is framed again by the next load
+    if (sceneBVH.size() == 0)
+        cameraFramed = false;
+    renderScheduler->requestRender();
 }
 
 /**
@@ -371,31 +1064,145 @@ void MainWindow::updateRenderFromTree(const QModelIndex& index)
 {
     if (!index.isValid()) return;
 
-    ModelPart* part = static_cast<ModelPart*>(index.internalPointer());
+    updateRenderFromPart(static_cast<ModelPart*>(index.internalPointer()));
+}
+
+/**
+ * @brief Recursively adds on-screen and VR actors for a part and its children.
+ * @param part  Node to process.
+ */
+
+// Walks the part tree directly so children the view has not fetched are rendered too
+void MainWindow::updateRenderFromPart(ModelPart* part)
+{
+    if (!part) return;
+
+    addPartToScene(part);
+    syncLOD(part);
+
+    // Recurse into children
+    for (int i = 0; i < part->childCount(); ++i)
+        updateRenderFromPart(part->child(i));
+}
+
+/**
+ * @brief Adds a part's actors to the desktop renderer, the BVH and (once) the VR thread.
+ * @param part  The part to show.
+ *
+ * Hidden parts are added too; their actors are switched off, so toggling visibility
+ * never has to touch the scenes.
+ */
+
+// Adds one part without touching the rest of the scene
+void MainWindow::addPartToScene(ModelPart* part)
+{
     if (!part) return;
 
-    // Add on-screen actor if visible
     vtkSmartPointer<vtkActor> onscreen = part->getActor();
-    if (onscreen && part->visible()) {
-        renderer->AddActor(onscreen);
-    }
+    if (!onscreen) return;      // Assembly nodes and placeholders have no geometry yet
+
+    // All are no-ops (apart from a refresh) for actors already in the scene
+    memoryBudget->track(part);
+    desktopEnvironment.applyMaterial(onscreen);
+    desktopSection.setPartPlanes(onscreen, part->getSectionPlanes());
+    desktopEdges.setPartEdges(onscreen, part->getPolyData());
+    desktopInstances.add(onscreen, instancingGeometry(part));
+    sceneBVH.insert(onscreen, part);
 
-    // Add VR actor if running
-    if (vrThread && part->visible()) {
+    // Queue the VR actor the first time only; later changes go through syncVRPart()
+    if (vrThread) {
         vtkSmartPointer<vtkActor> vrActor = part->getVRActor();
-        if (vrActor)
-            vrThread->addActorOffline(vrActor);
+        if (vrActor && !vrActorParts.contains(vrActor)) {
+            vrThread->addActorOffline(vrActor, vrSharedGeometry(part));
+            vrActorParts.insert(vrActor, part);
+            vrThread->setActorVisibility(vrActor, part->visible());
+            if (part->hasSectionPlanes())
+                vrThread->setActorSectionPlanes(vrActor, part->getSectionPlanes());
+
+            // Sub-assembly transforms (and explode offsets) go on top of the VR placement
+            if (vtkSmartPointer<vtkMatrix4x4> world = part->getDisplayTransform())
+                vrThread->setActorTransform(vrActor, world);
+            if (part->isShrinkOnGpu())
+                vrThread->setActorShrink(vrActor, part->getShrinkFactor());
+        }
     }
+}
 
-    // Recurse into children
-    if (!partList->hasChildren(index) ||
-        (index.flags() & Qt::ItemNeverHasChildren)) {
-        return;
+/**
+ * @brief Removes a subtree's actors from the desktop renderer, the BVH, LOD switching and VR.
+ * @param part  Root of the subtree.
+ */
+
+// Per-part removal; the VR command keeps the actor alive until the VR thread drops it
+void MainWindow::removePartFromScene(ModelPart* part)
+{
+    if (!part) return;
+
+    if (vtkSmartPointer<vtkActor> onscreen = part->getActor()) {
+        desktopInstances.remove(onscreen);
+        desktopAnimation.remove(onscreen);
+        desktopSection.remove(onscreen);
+        desktopEdges.remove(onscreen);
+        sceneBVH.remove(onscreen);
+        desktopLOD.remove(onscreen);
+    }
+    filterRunner->forget(part);
+    memoryBudget->forget(part);
+
+    if (part->hasVRActor()) {
+        vtkSmartPointer<vtkActor> vrActor = part->getVRActor();
+        if (vrThread && vrActorParts.remove(vrActor))
+            vrThread->removeActor(vrActor);
     }
 
-    int rows = partList->rowCount(index);
-    for (int i = 0; i < rows; ++i) {
-        updateRenderFromTree(partList->index(i, 0, index));
+    for (int i = 0; i < part->childCount(); ++i)
+        removePartFromScene(part->child(i));
+}
+
+/**
+ * @brief Returns the VR snapshot of the part's shared mesh.
+ * @param part  The part.
+ * @return Shared snapshot, or nullptr if the part is filtered or not loaded.
+ *
+ * The VR thread must not read the desktop mesh, so each shared mesh gets one shallow
+ * snapshot that all of its VR copies are grouped by.
+ */
+
+// Looks up (or creates) the VR snapshot for a desktop mesh
+vtkPolyData* MainWindow::vrSharedGeometry(ModelPart* part)
+{
+    vtkPolyData* shared = instancingGeometry(part);
+    if (!shared)
+        return nullptr;
+
+    auto found = vrSharedMeshes.find(shared);
+    if (found != vrSharedMeshes.end() && found.value().first.Get() == shared)
+        return found.value().second;
+
+    // Drop entries of meshes that no longer exist before adding a new one
+    pruneVRSharedMeshes();
+
+    auto snapshot = vtkSmartPointer<vtkPolyData>::New();
+    snapshot->ShallowCopy(shared);
+    vrSharedMeshes.insert(shared, qMakePair(vtkWeakPointer<vtkPolyData>(shared), snapshot));
+    return snapshot;
+}
+
+/**
+ * @brief Removes VR snapshots whose desktop mesh has been destroyed.
+ *
+ * The snapshots share the mesh arrays, so an entry left behind would keep an evicted
+ * mesh in memory.
+ */
+
+// Erases dead entries of vrSharedMeshes
+void MainWindow::pruneVRSharedMeshes()
+{
+    for (auto it = vrSharedMeshes.begin(); it != vrSharedMeshes.end();) {
+        if (!it.value().first)
+            it = vrSharedMeshes.erase(it);
+        else
+            ++it;
     }
 }
 
@@ -422,23 +1229,55 @@ void MainWindow::deleteSelectedItem()
             partNames << part->data(0).toString();
     }
 
+    // Large selections list the first names only
+    QStringList listed = partNames.mid(0, MaxListedNames);
+    if (partNames.size() > MaxListedNames)
+        listed << QString("... and %1 more").arg(partNames.size() - MaxListedNames);
+
     QString message = "Are you sure you want to delete the following " +
-        QString::number(partNames.size()) + " items?\n\n" + partNames.join("\n");
+        QString::number(partNames.size()) + " items?\n\n" + listed.join("\n");
 
     if (QMessageBox::question(this, "Confirm Delete", message) != QMessageBox::Yes)
         return;
 
-    std::sort(selectedIndexes.begin(), selectedIndexes.end(),
-        [](const QModelIndex& a, const QModelIndex& b) {
-            return a.row() > b.row();
-        });
-
-    for (const QModelIndex& index : selectedIndexes) {
-        partList->removeRow(index.row(), index.parent());
-    }
+    // One row range per run of adjacent siblings; selected children of selected
+    // assemblies go with their assembly. Each subtree leaves the scenes through
+    // onPartAboutToBeRemoved(), and the renders it requests are merged into one.
+    partList->removeParts(selectedParts(false));
 
-    emit statusUpdateMessage("Deleted: " + partNames.join(", "), 0);
-    updateRender();
+    emit statusUpdateMessage(partNames.size() > MaxListedNames
+        ? QString("Deleted %1 items").arg(partNames.size())
+        : "Deleted: " + partNames.join(", "), 0);
+}
+
+/**
+ * @brief Returns the parts of the selected rows, in selection order.
+ * @param expandAssemblies  True to return the parts inside selected assemblies instead of the
+ *                          assembly nodes, so a batch operation reaches every part they hold.
+ */
+
+// Selected parts, optionally with assemblies replaced by their descendants
+QList<ModelPart*> MainWindow::selectedParts(bool expandAssemblies) const
+{
+    QList<ModelPart*> parts;
+    QSet<ModelPart*> seen;
+
+    std::function<void(ModelPart*)> collect = [&](ModelPart* part) {
+        if (!part || seen.contains(part))
+            return;
+        seen.insert(part);
+
+        if (!expandAssemblies || part->childCount() == 0) {
+            parts << part;
+            return;
+        }
+        for (int i = 0; i < part->childCount(); ++i)
+            collect(part->child(i));
+    };
+
+    for (const QModelIndex& index : ui->treeView->selectionModel()->selectedRows())
+        collect(static_cast<ModelPart*>(index.internalPointer()));
+    return parts;
 }
 
 // --------------------------------------- Background & Skybox ---------------------------------------
@@ -452,26 +1291,21 @@ void MainWindow::onLoadBackgroundClicked()
     QString fileName = QFileDialog::getOpenFileName(this, tr("Open Background Image"), "", tr("Images (*.png *.jpg *.jpeg)"));
     if (fileName.isEmpty()) return;
 
-    vtkSmartPointer<vtkImageReader2> reader;
-    if (fileName.endsWith(".jpg", Qt::CaseInsensitive) || fileName.endsWith(".jpeg", Qt::CaseInsensitive)) {
-        reader = vtkSmartPointer<vtkJPEGReader>::New();
-    }
-    else if (fileName.endsWith(".png", Qt::CaseInsensitive)) {
-        reader = vtkSmartPointer<vtkPNGReader>::New();
-    }
-    else {
-        return;
-    }
-
-    reader->SetFileName(fileName.toStdString().c_str());
-    reader->Update();
+    // Decoded on the thread pool; onBackgroundReady() applies it
+    textureLoader->loadBackground(fileName);
+}
 
-    vtkSmartPointer<vtkTexture> backgroundTexture = vtkSmartPointer<vtkTexture>::New();
-    backgroundTexture->SetInputConnection(reader->GetOutputPort());
+/**
+ * @brief Applies a decoded background texture.
+ * @param texture  Background texture.
+ */
 
+// Shows the new background
+void MainWindow::onBackgroundReady(vtkSmartPointer<vtkTexture> texture)
+{
     renderer->TexturedBackgroundOn();
-    renderer->SetBackgroundTexture(backgroundTexture);
-    renderWindow->Render();
+    renderer->SetBackgroundTexture(texture);
+    renderScheduler->requestRender();
 }
 
 /**
@@ -484,18 +1318,65 @@ void MainWindow::onLoadSkyboxClicked()
     QString dirPath = QFileDialog::getExistingDirectory(this, "Select Skybox Folder");
     if (dirPath.isEmpty()) return;
 
-    std::vector<std::string> faceFilenames = {
-        (dirPath + "/px.png").toStdString(),
-        (dirPath + "/nx.png").toStdString(),
-        (dirPath + "/py.png").toStdString(),
-        (dirPath + "/ny.png").toStdString(),
-        (dirPath + "/pz.png").toStdString(),
-        (dirPath + "/nz.png").toStdString()
-    };
+    // Faces decode in parallel off the GUI thread (or a KTX2 cubemap is read as-is)
+    emit statusUpdateMessage(QString("Loading skybox..."), 0);
+    requestedSkybox = dirPath;
+    textureLoader->loadSkybox(dirPath);
+}
+
+/**
+ * @brief Applies a decoded skybox as background and image-based lighting, on the desktop and in VR.
+ * @param texture  Cubemap texture for the desktop context.
+ * @param source   Shared decoded data.
+ */
+
+// Shows the new environment
+void MainWindow::onSkyboxReady(vtkSmartPointer<vtkTexture> texture, EnvironmentSourcePtr source)
+{
+    desktopEnvironment.setSource(source, texture);
+    skyboxPath = requestedSkybox;     // Saved with the session from now on
 
-    auto cubemapTexture = LoadCubemapTexture(faceFilenames);
-    AddSkyboxToRenderer(renderer, cubemapTexture);
-    renderWindow->Render();
+    ModelPart* root = partList->getRootItem();
+    for (int i = 0; i < root->childCount(); ++i)
+        applyEnvironmentMaterials(root->child(i));
+
+    // The headset uploads the same decoded faces once into its own context
+    if (vrThread)
+        vrThread->setEnvironment(source);
+
+    emit statusUpdateMessage(QString("Skybox loaded"), 2000);
+    renderScheduler->requestRender();
+}
+
+/**
+ * @brief Switches a subtree's desktop actors to the shading of the current environment.
+ * @param part  Root of the subtree.
+ */
+
+// PBR on/off after an environment change
+void MainWindow::applyEnvironmentMaterials(ModelPart* part)
+{
+    if (!part) return;
+
+    if (vtkSmartPointer<vtkActor> actor = part->getActor()) {
+        desktopEnvironment.applyMaterial(actor);
+        desktopInstances.updateInstance(actor);
+    }
+
+    for (int i = 0; i < part->childCount(); ++i)
+        applyEnvironmentMaterials(part->child(i));
+}
+
+/**
+ * @brief Reports a texture that could not be loaded; the current one stays.
+ * @param path    Requested folder or file.
+ * @param reason  Failure description.
+ */
+
+// Shows the failure in the status bar
+void MainWindow::onTextureLoadFailed(const QString& path, const QString& reason)
+{
+    emit statusUpdateMessage(QString("Could not load %1: %2").arg(QFileInfo(path).fileName(), reason), 5000);
 }
 
 // --------------------------------------- Lighting & Rotation ---------------------------------------
@@ -511,110 +1392,440 @@ void MainWindow::onLightIntensityChanged(int value)
 
     double intensity = static_cast<double>(value) / 100.0;
     sceneLight->SetIntensity(intensity);
-    renderWindow->Render();
+    renderScheduler->requestRender();
 }
 
 /**
  * @brief Adjusts the rotation speed for auto-rotate and VR.
- * @param value  Slider value (multiplied by 0.1 for degrees per tick).
+ * @param value  Slider value; times 6 gives degrees per second (0.1 degrees per 60 Hz frame).
  */
 
 // Updates rotation speed and optionally starts VR thread
 void MainWindow::onRotationSpeedChanged(int value)
 {
-    rotationSpeed = static_cast<double>(value) * 0.1;
+    rotationSpeed = static_cast<double>(value) * 6.0;  // Each slider step is 0.1 degrees per 60 Hz frame
+    desktopAnimation.setAngularVelocity(0.0, rotationSpeed, 0.0);
+    updateRotationTimer();
 
-    if (vrThread) {
-        if (rotationSpeed == 0.0) {
-            vrThread->setRotation(0.0, 0.0, 0.0);
+    // A speed of 0 stops the VR spin as well
+    if (vrThread)
+        vrThread->setRotation(0.0, rotationSpeed, 0.0);
+}
+
+/**
+ * @brief Called periodically (~60 FPS) to auto-rotate selected actors; the render is coalesced.
+ *
+ * The angle follows the real time since the previous tick, so late timer events do not
+ * slow the spin down. Only the actors' matrices change.
+ */
+
+// Automatically rotates selected actors in the scene
+void MainWindow::onAutoRotate()
+{
+    const double seconds = rotationClock.nsecsElapsed() * 1e-9;
+    rotationClock.restart();
+
+    // VR actors are rotated by the VR thread itself, so nothing is sent to it here
+    const QVector<vtkActor*>& moved = desktopAnimation.advance(seconds);
+    for (vtkActor* actor : moved) {
+        sceneBVH.update(actor);         // Usually just a containment check
+        desktopInstances.updateInstance(actor);
+    }
+
+    if (!moved.isEmpty())
+        renderScheduler->requestRender();
+}
+
+/**
+ * @brief Re-registers the selected parts for auto-rotation and starts the rotation timer
+ *        when parts are selected and the speed is non-zero, otherwise stops it.
+ */
+
+// Keeps the desktop idle (no timer, no renders) when nothing rotates
+void MainWindow::updateRotationTimer()
+{
+    const bool spinning = rotationSpeed != 0.0 && ui->treeView->selectionModel()->hasSelection();
+
+    // Deselected parts keep the pose they reached
+    desktopAnimation.clear();
+    if (spinning) {
+        for (const QModelIndex& index : ui->treeView->selectionModel()->selectedRows()) {
+            ModelPart* part = static_cast<ModelPart*>(index.internalPointer());
+            if (part && part->getActor())
+                desktopAnimation.add(part->getActor());
+        }
+    }
+
+    if (spinning && !rotationTimer->isActive()) {
+        rotationClock.start();
+        rotationTimer->start();
+    }
+    else if (!spinning && rotationTimer->isActive())
+        rotationTimer->stop();
+}
+
+
+// --------------------------------------- Filter Toggles ---------------------------------------
+/**
+ * @brief Toggles a draggable section plane on the selected model part.
+ * @param checked  True to cut the part, false to remove its plane.
+ *
+ * The plane starts through the centre of the part and is clipped on the GPU, so
+ * dragging it never re-runs the filter pipeline. "Bake Section" in the tree's
+ * context menu turns it into clipped geometry.
+ */
+
+// Adds/removes the selected part's section plane
+void MainWindow::on_checkBox_Clip_toggled(bool checked)
+{
+    ModelPart* current = static_cast<ModelPart*>(ui->treeView->currentIndex().internalPointer());
+
+    for (ModelPart* selectedPart : selectedParts(true)) {
+        if (!selectedPart->getActor())
+            continue;
+
+        if (checked) {
+            const double* bounds = selectedPart->getActor()->GetBounds();
+            SectionPlane plane = {
+                { 0.5 * (bounds[0] + bounds[1]), 0.5 * (bounds[2] + bounds[3]), 0.5 * (bounds[4] + bounds[5]) },
+                { 0.0, -1.0, 0.0 }
+            };
+            selectedPart->setSectionPlanes(SectionPlaneList{ plane });
+
+            // The widget drags one plane: the current part's, or the first one cut
+            if (selectedPart == current || !sectionPart)
+                showSectionWidget(plane, bounds, selectedPart);
         }
         else {
-            vrThread->setRotation(0.0, rotationSpeed, 0.0);
-            if (vrThread && vrThread->isRunning()) {
-                vrThread->setRotation(0.0, rotationSpeed, 0.0);
-            }
+            selectedPart->setSectionPlanes(SectionPlaneList());
+            if (sectionPart == selectedPart)
+                hideSectionWidget();
+        }
+        partList->notifyPartChanged(selectedPart);
+    }
+}
 
+/**
+ * @brief Toggles a shrink filter on the selected model part.
+ * @param checked  True to apply shrink, false to remove.
+ */
+
+// Applies/removes shrink filter from selected model
+void MainWindow::on_checkBox_Shrink_toggled(bool checked)
+{
+    const double factor = shrinkSliderFactor();
+
+    // On the GPU only the shader changes, so the scenes are told directly
+    if (ModelPart::gpuEffectsEnabled()) {
+        for (ModelPart* selectedPart : selectedParts(true)) {
+            selectedPart->applyShrinkFilter(checked, factor);
+            partList->notifyPartChanged(selectedPart);
         }
+        renderScheduler->requestRender();
+        return;
     }
+
+    // The jobs run side by side on the thread pool; the batch makes the scenes switch
+    // over together once the last one is done (FilterRunner::partFiltered)
+    filterRunner->beginBatch();
+    for (ModelPart* selectedPart : selectedParts(true))
+        selectedPart->applyShrinkFilter(checked, factor);
+    filterRunner->endBatch();
 }
 
 /**
- * @brief Called periodically (~60 FPS) to auto-rotate selected actors.
+ * @brief Applies the shrink slider to the selected parts that are shrunk.
+ * @param value  Slider position, in percent of the original triangle size.
+ *
+ * With GPU effects this only sets a shader uniform per part, so the parts follow
+ * the slider while it is dragged; otherwise each change queues a filter job.
  */
 
-// Automatically rotates selected actors in the scene
-void MainWindow::onAutoRotate()
+// New shrink factor for the shrunk parts of the selection
+void MainWindow::onShrinkFactorChanged(int value)
 {
-    if (rotationSpeed == 0.0)
+    Q_UNUSED(value);
+    const double factor = shrinkSliderFactor();
+
+    if (ModelPart::gpuEffectsEnabled()) {
+        for (ModelPart* selectedPart : selectedParts(true)) {
+            if (!selectedPart->isShrinkFilterEnabled())
+                continue;
+            selectedPart->applyShrinkFilter(true, factor);
+            if (vrThread && selectedPart->hasVRActor())
+                vrThread->setActorShrink(selectedPart->getVRActor(), factor);
+        }
+        renderScheduler->requestRender();
         return;
+    }
 
-    QItemSelectionModel* selectionModel = ui->treeView->selectionModel();
-    QModelIndexList selectedIndexes = selectionModel->selectedRows();
+    filterRunner->beginBatch();
+    for (ModelPart* selectedPart : selectedParts(true)) {
+        if (selectedPart->isShrinkFilterEnabled())
+            selectedPart->applyShrinkFilter(true, factor);
+    }
+    filterRunner->endBatch();
+}
 
-    for (const QModelIndex& index : selectedIndexes) {
-        if (!index.isValid()) continue;
+/**
+ * @brief Returns the shrink factor the slider is set to.
+ */
 
-        ModelPart* part = static_cast<ModelPart*>(index.internalPointer());
-        if (!part) continue;
+// Slider percent as a factor in (0, 1]
+double MainWindow::shrinkSliderFactor() const
+{
+    return ui->shrinkSlider->value() / 100.0;
+}
 
-        vtkSmartPointer<vtkActor> actor = part->getActor();
-        if (actor) {
-            actor->RotateY(rotationSpeed);  // Apply rotation
+/**
+ * @brief Spreads the parts of the selected assemblies away from their centres.
+ * @param value  Slider position; 100 moves each part by its own distance from the centre.
+ *
+ * Parts are moved through their actor position (ModelPart::setExplodeOffset()), so
+ * no geometry is touched and the slider can be dragged on any assembly size. A
+ * selected part explodes the assembly it belongs to.
+ */
+
+// Offsets every leaf part of the selected assemblies along its direction from the assembly centre
+void MainWindow::onExplodeChanged(int value)
+{
+    const double spread = value / 100.0;
+
+    // Assemblies to explode: selected assembly nodes, or the parent of a selected part
+    QList<ModelPart*> assemblies;
+    for (const QModelIndex& index : ui->treeView->selectionModel()->selectedRows()) {
+        ModelPart* node = static_cast<ModelPart*>(index.internalPointer());
+        if (node && node->childCount() == 0)
+            node = node->parentItem();
+        if (node && node != partList->getRootItem() && !assemblies.contains(node))
+            assemblies << node;
+    }
+
+    for (ModelPart* assembly : assemblies) {
+        // Leaf parts and their unexploded centres (actor bounds include the current offset)
+        QList<ModelPart*> parts;
+        QVector<std::array<double, 3>> centres;
+        std::function<void(ModelPart*)> collect = [&](ModelPart* node) {
+            if (node->childCount() == 0) {
+                vtkActor* actor = node->getActor();
+                if (!actor)
+                    return;
+                double bounds[6], offset[3];
+                actor->GetBounds(bounds);
+                if (!vtkMath::AreBoundsInitialized(bounds))
+                    return;
+                node->getExplodeOffset(offset);
+                parts << node;
+                centres.append({ 0.5 * (bounds[0] + bounds[1]) - offset[0],
+                                 0.5 * (bounds[2] + bounds[3]) - offset[1],
+                                 0.5 * (bounds[4] + bounds[5]) - offset[2] });
+                return;
+            }
+            for (int i = 0; i < node->childCount(); ++i)
+                collect(node->child(i));
+        };
+        collect(assembly);
+        if (parts.isEmpty())
+            continue;
+
+        double centre[3] = { 0.0, 0.0, 0.0 };
+        for (const std::array<double, 3>& partCentre : centres) {
+            for (int k = 0; k < 3; ++k)
+                centre[k] += partCentre[k] / centres.size();
         }
 
-        // Only call VR update if the thread exists and is running
-        if (vrThread && vrThread->isRunning()) {
-            updateRenderFromTree(index);
+        for (int i = 0; i < parts.size(); ++i) {
+            ModelPart* part = parts[i];
+            const double offset[3] = { spread * (centres[i][0] - centre[0]),
+                                       spread * (centres[i][1] - centre[1]),
+                                       spread * (centres[i][2] - centre[2]) };
+            part->setExplodeOffset(offset);
+
+            // Moved bounds: refresh the culling hierarchy and the instance matrix
+            desktopInstances.updateInstance(part->getActor());
+            sceneBVH.update(part->getActor());
+            if (vrThread && part->hasVRActor())
+                vrThread->setActorTransform(part->getVRActor(), part->getDisplayTransform());
         }
     }
+    renderScheduler->requestRender();
+}
 
-    renderWindow->Render();
+/**
+ * @brief Switches shrinking between the geometry shader and the filter pipeline.
+ * @param checked  True to shrink on the GPU.
+ */
+
+// Moves every shrunk part to the chosen backend
+void MainWindow::onGpuEffectsToggled(bool checked)
+{
+    ModelPart::setGpuEffects(checked);
+
+    std::function<void(ModelPart*)> refresh = [&](ModelPart* part) {
+        if (part->isShrinkFilterEnabled())
+            part->updateFilters();
+        for (int i = 0; i < part->childCount(); ++i)
+            refresh(part->child(i));
+    };
+
+    filterRunner->beginBatch();
+    refresh(partList->getRootItem());
+    filterRunner->endBatch();
 }
 
+// --------------------------------------- Section Views ---------------------------------------
+/**
+ * @brief Adds or removes the scene-wide section plane.
+ * @param checked  True to cut every part.
+ */
+
+// Cuts the whole scene with one draggable plane
+void MainWindow::onSceneSectionToggled(bool checked)
+{
+    SectionPlaneList planes;
+    if (checked) {
+        double bounds[6];
+        renderer->ComputeVisiblePropBounds(bounds);
+        if (!vtkMath::AreBoundsInitialized(bounds)) {
+            const QSignalBlocker blocker(ui->actionScene_Section);
+            ui->actionScene_Section->setChecked(false);
+            return;
+        }
+
+        SectionPlane plane = {
+            { 0.5 * (bounds[0] + bounds[1]), 0.5 * (bounds[2] + bounds[3]), 0.5 * (bounds[4] + bounds[5]) },
+            { 0.0, -1.0, 0.0 }
+        };
+        planes << plane;
+        showSectionWidget(plane, bounds, nullptr);
+    }
+    else if (!sectionPart) {
+        hideSectionWidget();
+    }
+
+    desktopSection.setScenePlanes(planes);
+    if (vrThread)
+        vrThread->setSectionPlanes(planes);
+
+    // Cut parts leave their instanced groups, and rejoin them once the scene is whole again
+    syncSectionSubtree(partList->getRootItem());
+    renderScheduler->requestRender();
+}
 
-// --------------------------------------- Filter Toggles ---------------------------------------
 /**
- * @brief Toggles a clipping filter on the selected model part.
- * @param checked  True to apply clip, false to remove.
+ * @brief Bakes the selected part's section (its own and the scene planes) into its mesh.
  */
 
-// Applies/removes clip filter from selected model
-void MainWindow::on_checkBox_Clip_toggled(bool checked)
+// Exact capped clip of the current section
+void MainWindow::onBakeSectionTriggered()
 {
-    QModelIndex index = ui->treeView->currentIndex();
-    if (!index.isValid()) return;
+    ModelPart* part = static_cast<ModelPart*>(ui->treeView->currentIndex().internalPointer());
+    if (!part) return;
 
-    ModelPart* selectedPart = static_cast<ModelPart*>(index.internalPointer());
-    if (!selectedPart) return;
+    part->bakeSectionPlanes(desktopSection.getScenePlanes());
+    if (sectionPart == part)
+        hideSectionWidget();
 
-    double origin[3] = { 0.0, 0.0, 0.0 };
-    double normal[3] = { 0.0, -1.0, 0.0 };
-    selectedPart->applyClipFilter(checked, origin, normal);
+    // The part no longer has a plane of its own
+    const QSignalBlocker blocker(ui->checkBox_Clip);
+    ui->checkBox_Clip->setChecked(false);
+}
 
-    renderWindow->Render();
-    if (vrThread && vrThread->isRunning())
-        updateRenderFromTree(index);
+/**
+ * @brief Returns the instancing mesh of a part, or nullptr while it is clipped.
+ * @param part  The part.
+ */
+
+// Shared geometry unless a section plane cuts the part
+vtkPolyData* MainWindow::instancingGeometry(ModelPart* part) const
+{
+    if (!part || !part->getActor() || desktopSection.isClipped(part->getActor()))
+        return nullptr;
+    return part->getSharedGeometry();
 }
 
 /**
- * @brief Toggles a shrink filter on the selected model part.
- * @param checked  True to apply shrink, false to remove.
+ * @brief Re-syncs every part in a subtree with the current section planes.
+ * @param part  Root of the subtree.
  */
 
-// Applies/removes shrink filter from selected model
-void MainWindow::on_checkBox_Shrink_toggled(bool checked)
+// Recursive syncVRPart() for scene section changes
+void MainWindow::syncSectionSubtree(ModelPart* part)
 {
-    QModelIndex index = ui->treeView->currentIndex();
-    if (!index.isValid()) return;
+    if (!part) return;
 
-    ModelPart* selectedPart = static_cast<ModelPart*>(index.internalPointer());
-    if (!selectedPart) return;
+    if (part->getActor())
+        syncVRPart(part);
 
-    selectedPart->applyShrinkFilter(checked, 0.8);
-    renderWindow->Render();
+    for (int i = 0; i < part->childCount(); ++i)
+        syncSectionSubtree(part->child(i));
+}
 
-    if (vrThread && vrThread->isRunning())
-        updateRenderFromTree(index);
+/**
+ * @brief Places the plane widget around a box and enables it.
+ * @param plane   Starting plane.
+ * @param bounds  Box to place the widget around.
+ * @param part    Part whose plane is dragged, or nullptr for the scene plane.
+ */
+
+// Shows the widget for a part or the scene
+void MainWindow::showSectionWidget(const SectionPlane& plane, const double bounds[6], ModelPart* part)
+{
+    double box[6] = { bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5] };
+    double origin[3] = { plane.origin[0], plane.origin[1], plane.origin[2] };
+    double normal[3] = { plane.normal[0], plane.normal[1], plane.normal[2] };
+
+    sectionPart = part;
+    sectionRepresentation->PlaceWidget(box);
+    sectionRepresentation->SetOrigin(origin);
+    sectionRepresentation->SetNormal(normal);
+    sectionWidget->On();
+}
+
+/**
+ * @brief Disables the plane widget.
+ */
+
+// Hides the widget; the planes stay where they are
+void MainWindow::hideSectionWidget()
+{
+    sectionPart = nullptr;
+    sectionWidget->Off();
+}
+
+/**
+ * @brief Moves the dragged plane to the widget's plane.
+ * @param caller      The plane widget.
+ * @param eventId     InteractionEvent.
+ * @param clientData  The MainWindow.
+ *
+ * The scene plane is a single VR command however many parts it cuts; a part plane
+ * updates that part only.
+ */
+
+// Copies the widget plane to the desktop clipper and the VR thread
+void MainWindow::onSectionWidgetMoved(vtkObject* /*caller*/, unsigned long /*eventId*/, void* clientData, void* /*callData*/)
+{
+    MainWindow* self = static_cast<MainWindow*>(clientData);
+    if (!self) return;
+
+    SectionPlane plane;
+    self->sectionRepresentation->GetOrigin(plane.origin);
+    self->sectionRepresentation->GetNormal(plane.normal);
+    const SectionPlaneList planes{ plane };
+
+    if (ModelPart* part = self->sectionPart) {
+        part->setSectionPlanes(planes);
+        self->desktopSection.setPartPlanes(part->getActor(), planes);
+        if (self->vrThread && part->hasVRActor())
+            self->vrThread->setActorSectionPlanes(part->getVRActor(), planes);
+    }
+    else {
+        self->desktopSection.setScenePlanes(planes);
+        if (self->vrThread)
+            self->vrThread->setSectionPlanes(planes);
+    }
+    self->renderScheduler->requestRender();
 }
 
 // --------------------------------------- VR Thread Management ---------------------------------------
@@ -626,8 +1837,25 @@ void MainWindow::on_checkBox_Shrink_toggled(bool checked)
 // Starts the VR rendering thread
 void MainWindow::handleStartVR()
 {
+    if (!vrThread) {
+        vrThread = new VRRenderThread(this);
+        connect(vrThread, &VRRenderThread::partPicked, this, &MainWindow::onVRPartPicked);
+    }
+
     if (!vrThread->isRunning()) {
-        updateRenderFromTree(partList->index(0, 0, QModelIndex()));
+        // Queue the whole tree; the thread applies the commands once it starts
+        vrThread->clearAllActors();
+        vrActorParts.clear();
+        ModelPart* root = partList->getRootItem();
+        for (int i = 0; i < root->childCount(); ++i)
+            updateRenderFromPart(root->child(i));
+        vrThread->setRotation(0.0, rotationSpeed, 0.0);
+        if (EnvironmentSourcePtr environment = desktopEnvironment.getSource())
+            vrThread->setEnvironment(environment);
+        if (!desktopSection.getScenePlanes().isEmpty())
+            vrThread->setSectionPlanes(desktopSection.getScenePlanes());
+        vrThread->setAdaptiveQuality(ui->actionAdaptive_VR_Quality->isChecked());
+        vrThread->setMergeStaticParts(ui->actionMerge_VR_Parts->isChecked());
         vrThread->start();
         emit statusUpdateMessage(QString("VR LOADING.."), 0);
     }
@@ -651,6 +1879,30 @@ void MainWindow::onExitVRClicked()
     }
 }
 
+/**
+ * @brief Sends the VR quality mode to a running headset; a later start picks up the action's state.
+ * @param checked  True for adaptive foveated shading.
+ */
+
+// Switches the VR quality mode
+void MainWindow::onAdaptiveVRQualityToggled(bool checked)
+{
+    if (vrThread && vrThread->isRunning())
+        vrThread->setAdaptiveQuality(checked);
+}
+
+/**
+ * @brief Sends the merging mode to a running headset; a later start picks up the action's state.
+ * @param checked  True to merge static opaque parts.
+ */
+
+// Switches the VR merging mode
+void MainWindow::onMergeVRPartsToggled(bool checked)
+{
+    if (vrThread && vrThread->isRunning())
+        vrThread->setMergeStaticParts(checked);
+}
+
 /**
  * @brief Responds to visibility change signal from the option dialog.
  * @param visible  True to show in VR, false to hide.
@@ -659,10 +1911,235 @@ void MainWindow::onExitVRClicked()
 // Called when visibility checkbox in dialog is changed
 void MainWindow::onVisibilityChanged(bool visible)
 {
-    double visibilityValue = visible ? 1.0 : 0.0;
-    if (vrThread && vrThread->isRunning()) {
-        vrThread->issueCommand(VRRenderThread::TOGGLE_VISIBILITY, visibilityValue);
+    Option_Dialog* dialog = qobject_cast<Option_Dialog*>(sender());
+    ModelPart* part = dialog ? dialog->getModelPart() : nullptr;
+    if (!vrThread || !part || !part->getVRActor())
+        return;
+
+    vrThread->setActorVisibility(part->getVRActor(), visible);
+}
+
+/**
+ * @brief Pushes a part's current geometry, visibility and colour to the VR thread.
+ * @param part  The part whose VR actor should be updated.
+ */
+
+// Queues VR updates for a part after it changed on the desktop
+void MainWindow::syncVRPart(ModelPart* part)
+{
+    // Filter changes turn LOD switching on or off, on the desktop as well
+    syncLOD(part);
+    if (part && part->getActor()) {
+        desktopSection.setPartPlanes(part->getActor(), part->getSectionPlanes());
+        desktopInstances.setSharedGeometry(part->getActor(), instancingGeometry(part));
+        desktopInstances.updateInstance(part->getActor());
+        sceneBVH.update(part->getActor());
     }
+
+    if (!vrThread || !part) return;
+
+    vtkSmartPointer<vtkActor> vrActor = part->getVRActor();
+    if (!vrActor) return;
+
+    QColor color = part->getColor();
+    vrThread->updateActorGeometry(vrActor, part->getOutputSnapshot(), vrSharedGeometry(part));
+    vrThread->setActorVisibility(vrActor, part->visible());
+    vrThread->setActorColor(vrActor, color.redF(), color.greenF(), color.blueF());
+    vrThread->setActorSectionPlanes(vrActor, part->getSectionPlanes());
+    vrThread->setActorShrink(vrActor, part->isShrinkOnGpu() ? part->getShrinkFactor() : 1.0);
+}
+
+/**
+ * @brief Registers the part's LOD mappers with the desktop switcher and queues its LOD meshes for VR.
+ * @param part  The part to update.
+ *
+ * Both lists are empty while a filter is active, which switches LOD off so the
+ * filtered geometry is always shown at full detail.
+ */
+
+// Keeps desktop and VR LOD switching in step with the part
+void MainWindow::syncLOD(ModelPart* part)
+{
+    if (!part || !part->getActor()) return;
+
+    desktopLOD.setLevels(part->getActor(), part->getLODMappers());
+
+    if (vrThread && part->getVRActor())
+        vrThread->setActorLODs(part->getVRActor(), part->getLODData());
+}
+
+/**
+ * @brief Removes placeholders in a subtree from the pending list.
+ * @param node  Root of the subtree being deleted.
+ *
+ * Their files are remembered, so onPartLoaded() neither fills the deleted node
+ * nor mistakes the result for a new top-level file.
+ */
+
+// Stops onPartLoaded() from filling parts that are no longer in the tree
+void MainWindow::forgetPendingParts(ModelPart* node)
+{
+    if (!node) return;
+
+    if (!node->getSourceFile().isEmpty() && pendingParts.value(node->getSourceFile()) == node) {
+        pendingParts.remove(node->getSourceFile());
+        forgottenFiles.insert(node->getSourceFile(), partList->fingerprintOf(node));
+    }
+
+    for (int i = 0; i < node->childCount(); ++i)
+        forgetPendingParts(node->child(i));
+}
+
+// --------------------------------------- Picking ---------------------------------------
+/**
+ * @brief Selects a part in the tree view.
+ * @param part  Part to select (may be below rows the view has not fetched yet).
+ */
+
+// Fetches each ancestor level down to the part, then selects and reveals it
+void MainWindow::selectPart(ModelPart* part)
+{
+    if (!part) return;
+
+    QList<ModelPart*> chain;
+    for (ModelPart* node = part; node && node != partList->getRootItem(); node = node->parentItem())
+        chain.prepend(node);
+
+    ModelPart* parent = partList->getRootItem();
+    for (ModelPart* node : chain) {
+        QModelIndex parentIndex = partList->indexOf(parent);
+        while (node->row() >= parent->fetchedChildCount() && partList->canFetchMore(parentIndex))
+            partList->fetchMore(parentIndex);
+        if (parentIndex.isValid())
+            ui->treeView->expand(parentIndex);
+        parent = node;
+    }
+
+    QModelIndex index = partList->indexOf(part);
+    if (!index.isValid()) return;
+
+    ui->treeView->selectionModel()->setCurrentIndex(index, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+    ui->treeView->scrollTo(index);
+    emit statusUpdateMessage("Selected: " + part->data(0).toString(), 0);
+}
+
+/**
+ * @brief Picks the part under a left click in the viewport.
+ * @param caller      The render window interactor.
+ * @param eventId     LeftButtonPressEvent or LeftButtonReleaseEvent.
+ * @param clientData  The MainWindow.
+ */
+
+// Remembers the press position; a release close to it is treated as a click
+void MainWindow::onViewportClick(vtkObject* caller, unsigned long eventId, void* clientData, void* /*callData*/)
+{
+    MainWindow* self = static_cast<MainWindow*>(clientData);
+    vtkRenderWindowInteractor* interactor = vtkRenderWindowInteractor::SafeDownCast(caller);
+    if (!self || !interactor) return;
+
+    const int* position = interactor->GetEventPosition();
+    if (eventId == vtkCommand::LeftButtonPressEvent) {
+        self->pressPosition[0] = position[0];
+        self->pressPosition[1] = position[1];
+        return;
+    }
+
+    // Drags rotate the camera; only near-stationary clicks pick
+    const int dx = position[0] - self->pressPosition[0];
+    const int dy = position[1] - self->pressPosition[1];
+    if (dx * dx + dy * dy > 9) return;
+
+    vtkProp3D* prop = self->sceneBVH.pick(self->renderer, position[0], position[1]);
+    if (prop)
+        self->selectPart(static_cast<ModelPart*>(self->sceneBVH.userData(prop)));
+}
+
+/**
+ * @brief Selects the part whose VR actor was hit by the controller ray.
+ * @param vrActor  Actor reported by the VR thread.
+ */
+
+// Maps the VR actor back to its part
+void MainWindow::onVRPartPicked(vtkActor* vrActor)
+{
+    selectPart(vrActorParts.value(vrActor));
+}
+
+// --------------------------------------- Frame Statistics ---------------------------------------
+/**
+ * @brief Shows or hides the frame statistics overlay.
+ * @param checked  True to show.
+ */
+
+// Toggles the overlay and redraws so it appears immediately
+void MainWindow::onShowFrameStatsToggled(bool checked)
+{
+    desktopProfiler.setOverlayVisible(checked);
+    renderScheduler->requestRender();
+}
+
+/**
+ * @brief Shows or hides the feature edge overlay.
+ * @param checked  True to show.
+ *
+ * The edges were extracted when the parts were loaded, so this only flips the
+ * visibility of the prepared line actors.
+ */
+
+// Toggles the edge overlay and redraws
+void MainWindow::onShowFeatureEdgesToggled(bool checked)
+{
+    desktopEdges.setEnabled(checked);
+    renderScheduler->requestRender();
+}
+
+/**
+ * @brief Saves the rolling frame traces to a CSV file.
+ */
+
+// Writes desktop and VR traces to a user-chosen CSV file
+void MainWindow::onExportFrameTrace()
+{
+    QString fileName = QFileDialog::getSaveFileName(
+        this, tr("Export Frame Trace"), QDir::homePath() + "/frame_trace.csv", tr("CSV Files (*.csv)"));
+
+    if (fileName.isEmpty())
+        return;
+
+    QList<QPair<QString, QVector<FrameProfiler::FrameRecord>>> sources;
+    sources << qMakePair(QString("desktop"), desktopProfiler.trace());
+    if (vrThread)
+        sources << qMakePair(QString("vr"), vrThread->getProfiler().trace());
+
+    if (FrameProfiler::exportCsv(fileName, sources))
+        emit statusUpdateMessage("Frame trace saved: " + fileName, 0);
+    else
+        emit statusUpdateMessage("Could not write: " + fileName, 0);
+}
+
+// --------------------------------------- Memory Budget ---------------------------------------
+/**
+ * @brief Runs the budget check once a second.
+ */
+
+// Evicts off-screen parts over budget and reloads parts back in view
+void MainWindow::onMemoryCheck()
+{
+    // Merged VR batches hold a world-space copy of each static part
+    const bool vrRunning = vrThread && vrThread->isRunning();
+    memoryBudget->update(!vrRunning, vrRunning ? vrThread->getMergedBytes() : 0);
+}
+
+/**
+ * @brief Updates the scenes after a part's geometry was evicted.
+ * @param part  The evicted part, now showing an empty placeholder.
+ */
+
+// Hands the placeholder to both scenes so they let go of the mesh
+void MainWindow::onGeometryEvicted(ModelPart* part)
+{
+    partList->notifyPartChanged(part);
+    pruneVRSharedMeshes();
 }
 
 // --------------------------------------- Actor Refresh ---------------------------------------
@@ -682,8 +2159,8 @@ void MainWindow::refreshSelectedActor()
     vtkSmartPointer<vtkActor> actor = selectedPart->getActor();
     if (!actor) return;
 
-    renderer->RemoveActor(actor);
-    renderer->AddActor(actor);
-    renderWindow->Render();
+    desktopInstances.remove(actor);
+    desktopInstances.add(actor, instancingGeometry(selectedPart));
+    renderScheduler->requestRender();
 }
 
@@ -19,14 +19,31 @@
 #include "ModelPartList.h"      // Custom tree model for parts
 #include "ModelPart.h"          // Individual STL part container
 #include "VRRenderThread.h"     // Background thread for VR rendering
+#include "PartLoader.h"         // Background STL loading
+#include "LODSwitcher.h"        // Screen-coverage LOD selection
+#include "FrameProfiler.h"      // Frame-time overlay and CSV traces
+#include "RenderScheduler.h"    // Coalesced desktop renders
+#include "SceneBVH.h"           // Frustum culling and picking hierarchy
+#include "InstanceBatcher.h"    // Instanced drawing of repeated parts
+#include "PoseAnimator.h"       // Delta-time auto-rotation
+#include "TextureLoader.h"      // Background skybox/background decoding
+#include "FilterRunner.h"       // Background shrink/clip jobs
+#include "MemoryBudget.h"       // Geometry eviction for huge sessions
+#include "SectionClipper.h"     // GPU section planes with caps
+#include "SessionFile.h"        // Binary session save/restore
+#include "EdgeOverlay.h"        // Feature edge lines over the parts
 
 // --------------------------------------- Qt Includes ---------------------------------------
 
 #include <QMainWindow>          // Base class for main application window
 #include <QTreeView>            // For model hierarchy view
 #include <QTimer>               // Used for auto-rotation
+#include <QElapsedTimer>        // Frame time for auto-rotation
 #include <QSlider>              // For light and rotation controls
 #include <QCheckBox>            // For filter toggles
+#include <QProgressDialog>      // Progress/cancel for background loading
+#include <QSet>                 // Names of parts currently being loaded
+#include <QHash>                // Placeholder parts waiting for geometry
 #include <QVTKOpenGLNativeWidget.h> // VTK-Qt render widget
 #include <QVTKInteractor.h>     // VTK event interactor
 
@@ -41,6 +58,9 @@
 #include <vtkShrinkFilter.h>                 // For shrinking geometry
 #include <vtkPlane.h>                        // For defining clip planes
 #include <vtkGeometryFilter.h>               // Converts datasets to polygonal data
+#include <vtkCallbackCommand.h>              // Viewport click picking
+#include <vtkImplicitPlaneWidget2.h>         // Draggable section plane
+#include <vtkImplicitPlaneRepresentation.h>  // Plane handle drawn by the widget
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -119,6 +139,76 @@ public slots:
     // Opens one or more STL files and adds to tree
     void openFile();
 
+    /**
+    * @brief Opens a folder as a sub-assembly: sub-folders become nested assemblies, STLs become parts.
+    *
+    * The whole tree is created immediately with empty parts; geometry is filled in
+    * by the background loader as each file finishes.
+    */
+
+    // Opens a folder hierarchy of STL files as an assembly
+    void openAssemblyFolder();
+
+    /**
+    * @brief Saves the part tree, part settings, camera, light and skybox to a session file.
+    */
+
+    // Writes a binary session file
+    void saveSession();
+
+    /**
+    * @brief Replaces the scene with a saved session.
+    *
+    * The tree is shown at once; geometry streams in afterwards, visible parts first.
+    */
+
+    // Restores a binary session file
+    void openSession();
+
+    /**
+    * @brief Adds a part to the tree and scene once its file has been parsed.
+    * @param fileName  Full path of the loaded file.
+    * @param polyData  Geometry produced by the background loader.
+    */
+
+    // Adds a loaded part to the tree and renderer
+    void onPartLoaded(const QString& fileName, vtkSmartPointer<vtkPolyData> polyData);
+
+    /**
+    * @brief Reports a file that could not be parsed.
+    * @param fileName  Full path of the failed file.
+    */
+
+    // Reports a failed file load
+    void onPartLoadFailed(const QString& fileName);
+
+    /**
+    * @brief Hands a part its decimated levels and enables LOD switching for it.
+    * @param fileName  Full path of the part's file.
+    * @param levels    Decimated meshes, finest first.
+    */
+
+    // Applies LOD levels delivered by the loader
+    void onLODsReady(const QString& fileName, const PartLoader::Levels& levels);
+
+    /**
+    * @brief Updates the loading progress dialog.
+    * @param done      Files finished in the current batch.
+    * @param total     Files in the current batch.
+    * @param fileName  Most recently finished file.
+    */
+
+    // Updates the per-file progress dialog
+    void onLoadProgress(int done, int total, const QString& fileName);
+
+    /**
+    * @brief Closes the progress dialog and frames the camera after the first batch.
+    * @param cancelled  True if the user cancelled the batch.
+    */
+
+    // Finalises the scene after background loading
+    void onLoadFinished(bool cancelled);
+
     /**
     * @brief Opens the options dialog for the currently selected tree item.
     */
@@ -141,12 +231,30 @@ public slots:
     // Opens item options from context menu
 
     void on_actionItemOptions_triggered();
+
+    /**
+     * @brief Adds a newly appended part's actors (if it has geometry) to the scenes.
+     * @param part  Part appended to the model.
+     */
+
+    // Scene delta: part added
+    void onPartAdded(ModelPart* part);
+
+    /**
+     * @brief Mirrors a changed part into the desktop and VR scenes.
+     * @param part  Part whose geometry, filters, colour or visibility changed.
+     */
+
+    // Scene delta: part changed
+    void onPartChanged(ModelPart* part);
+
     /**
-     * @brief Clears and rebuilds the 3D scene from the tree model.
+     * @brief Removes the actors of a subtree that is about to be deleted.
+     * @param part  Root of the subtree.
      */
 
-    // Rebuilds the 3D scene from tree structure
-    void updateRender();
+    // Scene delta: part removed
+    void onPartAboutToBeRemoved(ModelPart* part);
 
     /**
     * @brief Recursively adds actors from the model tree into the renderer (and VR thread).
@@ -156,6 +264,14 @@ public slots:
     // Recursively adds actors from a given tree index
     void updateRenderFromTree(const QModelIndex&);
 
+    /**
+    * @brief Recursively adds actors for a part and all its children, fetched by the view or not.
+    * @param part  Node to process.
+    */
+
+    // Recursively adds actors from a given part
+    void updateRenderFromPart(ModelPart* part);
+
     // --------------------------------------- Background & Skybox ---------------------------------------
     /**
      * @brief Opens a file dialog to select and load a static background image.
@@ -171,22 +287,55 @@ public slots:
     // Loads a cubemap skybox from 6 images
     void onLoadSkyboxClicked();
 
+    /**
+     * @brief Shows a skybox once it has been decoded (or taken from the cache), on the desktop and in VR.
+     * @param texture  Cubemap texture for the desktop context.
+     * @param source   Decoded data the VR thread builds its own texture from.
+     */
+
+    // Swaps the environment
+    void onSkyboxReady(vtkSmartPointer<vtkTexture> texture, EnvironmentSourcePtr source);
+
+    /**
+     * @brief Shows a background image once it has been decoded (or taken from the cache).
+     * @param texture  Background texture.
+     */
+
+    // Swaps the background texture
+    void onBackgroundReady(vtkSmartPointer<vtkTexture> texture);
+
+    /**
+     * @brief Reports a skybox or background that could not be loaded.
+     * @param path    Requested folder or file.
+     * @param reason  Short failure description.
+     */
+
+    // Shows a texture load error in the status bar
+    void onTextureLoadFailed(const QString& path, const QString& reason);
+
     // --------------------------------------- Rotation ---------------------------------------
      /**
      * @brief Sets the auto-rotation speed from the UI slider.
-     * @param value  Slider value (mapped internally to degrees per frame).
+     * @param value  Slider value (mapped internally to degrees per second).
      */
 
     // Sets the auto-rotation speed from UI
     void onRotationSpeedChanged(int value);
 
     /**
-     * @brief Called periodically to rotate all selected parts by the current speed.
+     * @brief Called periodically to rotate all selected parts by the time elapsed since the last tick.
      */
 
     // Rotates all selected parts at regular intervals
     void onAutoRotate();
 
+    /**
+     * @brief Runs the rotation timer only while there is something to rotate.
+     */
+
+    // Starts/stops the rotation timer from speed and selection
+    void updateRotationTimer();
+
     // --------------------------------------- Lighting ---------------------------------------
     /**
      * @brief Updates the global scene light intensity based on the slider.
@@ -253,6 +402,30 @@ private slots:
 
     void on_checkBox_Shrink_toggled(bool checked);
 
+    /**
+     * @brief Applies the shrink slider to the shrunk parts of the selection.
+     * @param value  Slider position in percent.
+     */
+
+    // Updates the shrink factor of selected parts
+    void onShrinkFactorChanged(int value);
+
+    /**
+     * @brief Explodes the selected assemblies by the slider amount.
+     * @param value  Slider position in percent of each part's distance from the centre.
+     */
+
+    // Moves assembly parts apart
+    void onExplodeChanged(int value);
+
+    /**
+     * @brief Switches shrinking between the geometry shader and vtkShrinkPolyData.
+     * @param checked  True for the GPU backend.
+     */
+
+    // Applies the shrink backend to all shrunk parts
+    void onGpuEffectsToggled(bool checked);
+
     /**
      * @brief Stops and cleans up the VR rendering thread.
      */
@@ -260,6 +433,271 @@ private slots:
     // Shuts down the VR thread
     void onExitVRClicked();
 
+    /**
+     * @brief Switches the headset between full quality and adaptive foveated shading.
+     * @param checked  True for adaptive quality.
+     */
+
+    // Applies the VR quality mode
+    void onAdaptiveVRQualityToggled(bool checked);
+
+    /**
+     * @brief Switches merged batches of static parts in the headset.
+     * @param checked  True to merge.
+     */
+
+    // Applies the VR merging mode
+    void onMergeVRPartsToggled(bool checked);
+
+    /**
+     * @brief Shows or hides the frame statistics overlay.
+     * @param checked  True to show.
+     */
+
+    // Toggles the frame-time overlay
+    void onShowFrameStatsToggled(bool checked);
+
+    /**
+     * @brief Shows or hides the feature edges found when the parts were loaded.
+     * @param checked  True to show.
+     */
+
+    // Toggles the edge overlay
+    void onShowFeatureEdgesToggled(bool checked);
+
+    /**
+     * @brief Saves the desktop (and VR, if used) frame traces as CSV.
+     */
+
+    // Exports frame traces to a CSV file
+    void onExportFrameTrace();
+
+    /**
+     * @brief Selects the part whose VR actor was hit by the controller ray.
+     * @param vrActor  Actor picked by the VR thread.
+     */
+
+    // Handles VR controller picks
+    void onVRPartPicked(vtkActor* vrActor);
+
+    /**
+     * @brief Adds or removes the draggable plane that cuts every part.
+     * @param checked  True to cut the scene.
+     */
+
+    // Toggles the scene section plane
+    void onSceneSectionToggled(bool checked);
+
+    /**
+     * @brief Replaces the selected part's section with an exact, capped clip of its mesh.
+     */
+
+    // Bakes the GPU section of the selected part
+    void onBakeSectionTriggered();
+
+    /**
+     * @brief Runs the periodic memory budget check.
+     *
+     * Off-screen parts only count as out of sight while VR is not running, as the
+     * headset may be looking at them.
+     */
+
+    // Evicts and reloads geometry (memory timer)
+    void onMemoryCheck();
+
+    /**
+     * @brief Mirrors an evicted part into both scenes and releases its VR snapshot.
+     * @param part  The evicted part.
+     */
+
+    // Applies an eviction
+    void onGeometryEvicted(ModelPart* part);
+
+private:
+    /**
+     * @brief Queues the part's current geometry, visibility and colour for the VR thread.
+     * @param part  The part that changed.
+     */
+
+    // Mirrors a part's desktop state to its VR actor
+    void syncVRPart(ModelPart* part);
+
+    /**
+     * @brief Adds one part's desktop actor and, the first time, its VR actor to the scenes.
+     * @param part  The part (parts without geometry are skipped).
+     */
+
+    // Adds a single part to both scenes; safe to call again for parts already shown
+    void addPartToScene(ModelPart* part);
+
+    /**
+     * @brief Removes the desktop and VR actors of a part and all of its children.
+     * @param part  Root of the subtree.
+     */
+
+    // Takes a subtree out of both scenes
+    void removePartFromScene(ModelPart* part);
+
+    /**
+     * @brief Matches the shading of a subtree's desktop actors to the current environment.
+     * @param part  Root of the subtree.
+     */
+
+    // PBR on/off after an environment change
+    void applyEnvironmentMaterials(ModelPart* part);
+
+    /**
+     * @brief Returns the VR-side snapshot of a part's shared mesh, creating it once per mesh.
+     * @param part  The part.
+     * @return Snapshot used as the VR instancing key and glyph source, or nullptr if the part
+     *         cannot be instanced.
+     */
+
+    // One immutable VR copy per shared mesh, so identical VR actors group together
+    vtkPolyData* vrSharedGeometry(ModelPart* part);
+
+    /**
+     * @brief Drops the VR snapshots of desktop meshes that no longer exist.
+     */
+
+    // Lets evicted or deleted meshes free their VR copies
+    void pruneVRSharedMeshes();
+
+    /**
+     * @brief Registers the part's current LOD levels with the desktop and VR switchers.
+     * @param part  The part whose levels or filters changed.
+     */
+
+    // Updates LOD switching for a part (off while filters are active)
+    void syncLOD(ModelPart* part);
+
+    /**
+     * @brief Returns the mesh a part is instanced by, or nullptr if it must be drawn on its own.
+     * @param part  The part.
+     *
+     * Instanced groups cannot be clipped, so parts cut by a section plane are drawn individually.
+     */
+
+    // Instancing key that also accounts for section planes
+    vtkPolyData* instancingGeometry(ModelPart* part) const;
+
+    /**
+     * @brief Returns the shrink factor set on the shrink slider.
+     */
+
+    // Shrink slider value as a factor
+    double shrinkSliderFactor() const;
+
+    /**
+     * @brief Re-syncs a subtree after the scene planes were added or removed.
+     * @param part  Root of the subtree.
+     */
+
+    // Moves parts in and out of instanced groups for a scene section change
+    void syncSectionSubtree(ModelPart* part);
+
+    /**
+     * @brief Shows the plane widget on a plane.
+     * @param plane   Plane to start from (world coordinates).
+     * @param bounds  Box the widget is placed around.
+     * @param part    Part whose plane is dragged, or nullptr for the scene plane.
+     */
+
+    // Places the section widget
+    void showSectionWidget(const SectionPlane& plane, const double bounds[6], ModelPart* part);
+
+    /**
+     * @brief Hides the plane widget.
+     */
+
+    // Removes the section widget
+    void hideSectionWidget();
+
+    /**
+     * @brief Widget observer that moves the dragged plane.
+     *
+     * Only the plane values change, so each step costs a few uniforms per clipped part.
+     */
+
+    // VTK callback for section widget drags
+    static void onSectionWidgetMoved(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+
+    /**
+     * @brief Creates assembly and placeholder part nodes for a folder, recursively.
+     * @param parent     Tree node to add the folder's contents to.
+     * @param folder     Folder to scan.
+     * @param fileNames  Receives the STL files to load.
+     */
+
+    // Builds the skeleton tree of an assembly folder
+    void addAssemblyFolder(ModelPart* parent, const QString& folder, QStringList& fileNames);
+
+    /**
+     * @brief Appends a subtree's nodes to a session, each after its parent.
+     * @param part    Root of the subtree.
+     * @param parent  Session index of the parent node (-1 for the top level).
+     * @param parts   Receives the nodes.
+     */
+
+    // Records one node and its children
+    void captureSessionPart(ModelPart* part, int parent, QVector<SessionFile::Part>& parts) const;
+
+    /**
+     * @brief Rebuilds the tree and view from a session and starts streaming its geometry.
+     * @param session  Session read from disk.
+     */
+
+    // Placeholder tree plus loads ordered by visibility and screen size
+    void restoreSession(const SessionFile::Session& session);
+
+    /**
+     * @brief Finds the part loaded from a file anywhere in the tree.
+     * @return The part, or nullptr.
+     */
+
+    // Recursive lookup by source file
+    ModelPart* findPartByFile(ModelPart* node, const QString& fileName) const;
+
+    /**
+     * @brief Drops pending placeholder entries for a subtree that is being deleted.
+     */
+
+    // Forgets placeholders under a removed node
+    void forgetPendingParts(ModelPart* node);
+
+    /**
+     * @brief Gives a loaded mesh to the parts still waiting for the same content.
+     */
+
+    // Fills empty copies of a loaded file
+    void fillWaitingCopies(const QByteArray& content, vtkSmartPointer<vtkPolyData> polyData);
+
+    /**
+     * @brief Returns the parts of the selected tree rows.
+     * @param expandAssemblies  True to replace selected assemblies by the parts inside them.
+     */
+
+    // Targets of batch operations
+    QList<ModelPart*> selectedParts(bool expandAssemblies) const;
+
+    /**
+     * @brief Selects a part in the tree view, fetching and expanding its ancestors first.
+     * @param part  Part to select.
+     */
+
+    // Makes a picked part current in the tree
+    void selectPart(ModelPart* part);
+
+    /**
+     * @brief Interactor observer that picks the part under a left click.
+     *
+     * A press followed by a release within a few pixels is a click; drags are left
+     * to the camera interactor style.
+     */
+
+    // VTK callback for viewport clicks
+    static void onViewportClick(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+
 private:
 
     // --------------------------------------- UI & Tree Model ---------------------------------------
@@ -267,20 +705,56 @@ private:
     Ui::MainWindow* ui;           // Pointer to Qt-generated UI class
     ModelPartList* partList;      // Custom tree model managing ModelPart items
 
+    // --------------------------------------- Background Loading ---------------------------------------
+
+    PartLoader* partLoader;           // Parses STL files on the thread pool
+    TextureLoader* textureLoader;     // Decodes skyboxes and backgrounds on the thread pool
+    FilterRunner* filterRunner;       // Runs part filter pipelines on the thread pool
+    MemoryBudget* memoryBudget;       // Evicts off-screen geometry over budget
+    QTimer* memoryTimer;              // Runs the budget check
+    QProgressDialog* loadProgress;    // Per-file progress with cancel
+    QHash<QString, QByteArray> pendingNames;  // Names queued for loading -> content fingerprint
+    QSet<QByteArray> pendingContent;          // Fingerprints queued for loading (duplicate check)
+    QHash<QString, ModelPart*> pendingParts;  // Assembly and session placeholders waiting for their file
+    QHash<QString, QByteArray> forgottenFiles; // Files of placeholders deleted while loading -> fingerprint
+    QString skyboxPath;               // Skybox currently shown (saved with sessions)
+    QString requestedSkybox;          // Skybox being decoded
+
     // --------------------------------------- VTK Rendering ---------------------------------------
 
     vtkSmartPointer<vtkRenderer> renderer;                        // Scene renderer
     vtkSmartPointer<vtkGenericOpenGLRenderWindow> renderWindow;  // Render window for 3D view
     vtkSmartPointer<vtkLight> sceneLight;                        // Global lighting object
+    SceneEnvironment desktopEnvironment;                         // Skybox and IBL, shared with the VR thread
+    LODSwitcher desktopLOD;                                      // Picks detail levels for on-screen actors
+    InstanceBatcher desktopInstances;                            // Adds part actors, instancing repeated meshes
+    SectionClipper desktopSection;                               // Section planes of the on-screen actors
+    EdgeOverlay desktopEdges;                                    // Feature edges of the on-screen actors
+    vtkSmartPointer<vtkImplicitPlaneWidget2> sectionWidget;      // Drags the active section plane
+    vtkSmartPointer<vtkImplicitPlaneRepresentation> sectionRepresentation; // Plane handle of sectionWidget
+    vtkSmartPointer<vtkCallbackCommand> sectionCallback;         // Widget drag observer
+    ModelPart* sectionPart;                                      // Part whose plane the widget moves (nullptr: scene plane)
+    FrameProfiler desktopProfiler;                               // Times on-screen renders
+    RenderScheduler* renderScheduler;                            // Merges render requests into one frame per refresh
+    SceneBVH sceneBVH;                                           // Bounds hierarchy of on-screen part actors
+    vtkSmartPointer<SceneBVHCuller> sceneCuller;                 // Frustum culling through sceneBVH
+    vtkSmartPointer<vtkCallbackCommand> clickCallback;           // Left-click picking observer
+    int pressPosition[2];                                        // Display position of the last left press
+    vtkSmartPointer<vtkActor> sampleActor;                       // Start-up cylinder, removed when parts arrive
+    bool cameraFramed;                                           // Camera was reset to the parts (kept after that)
 
     // --------------------------------------- Rotation ---------------------------------------
 
-    QTimer* rotationTimer;    // Timer used for rotation animation
-    double rotationSpeed;     // Speed of auto-rotation
+    QTimer* rotationTimer;    // Timer used for rotation animation (stopped when idle)
+    QElapsedTimer rotationClock;  // Time since the previous rotation tick
+    double rotationSpeed;     // Speed of auto-rotation (degrees per second)
+    PoseAnimator desktopAnimation;  // Spins the selected part actors
 
     // --------------------------------------- VR Support ---------------------------------------
 
     VRRenderThread* vrThread; // Background thread for VR rendering
+    QHash<vtkActor*, ModelPart*> vrActorParts;  // VR actor -> part, for controller picks
+    QHash<vtkPolyData*, QPair<vtkWeakPointer<vtkPolyData>, vtkSmartPointer<vtkPolyData>>> vrSharedMeshes;  // Desktop mesh -> VR snapshot
 };
 
 #endif // MAINWINDOW_H
@@ -9,22 +9,96 @@
 
 #include "skyboxutils.h"
 
+// --------------------------------------- Qt Includes ---------------------------------------
+
+#include <QImage>                       // Thread-safe PNG/JPEG decoding
+#include <QString>                      // Qt file paths
+#include <QtConcurrent>                 // Parallel face decoding
+
 // --------------------------------------- VTK Includes ---------------------------------------
 
 #include <vtkSkybox.h>                  // Actor representing the skybox
-#include <vtkImageReader2Factory.h>     // Factory to detect image format
-#include <vtkImageReader2.h>            // Base class for image readers
-#include <vtkImageFlip.h>               // Used to vertically flip textures
 #include <vtkOpenGLTexture.h>           // For cubemap texture support
+#include <vtkTextureObject.h>           // GL texture holding compressed faces
 #include <vtkRenderer.h>                // VTK scene renderer
+#include <vtk_glad.h>                   // Compressed texture upload
+#include <algorithm>                    // std::max
+#include <cstring>                      // Row and header copies
+#include <fstream>                      // KTX2 file reading
+#include <iterator>                     // Whole-file reads
 #include <iostream>                     // For error logging
 
+// --------------------------------------- KTX2 Constants ---------------------------------------
+
+namespace {
+
+// File identifier: 0xAB "KTX 20" 0xBB "\r\n\x1A\n"
+const std::uint8_t KTX2Identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+// Header (48 bytes) plus index (32 bytes); the level index follows
+const std::size_t KTX2LevelIndexOffset = 80;
+
+// Largest face edge accepted; keeps the sizes in int and well above any GPU limit
+const std::uint32_t KTX2MaxSize = 65536;
+
+// GL compressed formats (EXT_texture_compression_s3tc, EXT_texture_sRGB, ARB_texture_compression_bptc)
+const unsigned int GLCompressedRGB_S3TC_DXT1 = 0x83F0;
+const unsigned int GLCompressedRGBA_S3TC_DXT1 = 0x83F1;
+const unsigned int GLCompressedRGBA_S3TC_DXT5 = 0x83F3;
+const unsigned int GLCompressedSRGB_S3TC_DXT1 = 0x8C4C;
+const unsigned int GLCompressedSRGBAlpha_S3TC_DXT1 = 0x8C4D;
+const unsigned int GLCompressedSRGBAlpha_S3TC_DXT5 = 0x8C4F;
+const unsigned int GLCompressedRGBA_BPTC = 0x8E8C;
+const unsigned int GLCompressedSRGBAlpha_BPTC = 0x8E8D;
+const unsigned int GLCompressedRGB_BPTC_SignedFloat = 0x8E8E;
+const unsigned int GLCompressedRGB_BPTC_UnsignedFloat = 0x8E8F;
+
+/**
+ * @brief Maps a Vulkan BCn format (as stored in KTX2) to its GL format and block size.
+ * @return False for formats that are not supported.
+ */
+// vkFormat -> GL internal format
+bool glFormatFor(std::uint32_t vkFormat, unsigned int& glFormat, int& blockBytes)
+{
+    switch (vkFormat) {
+    case 131: glFormat = GLCompressedRGB_S3TC_DXT1; blockBytes = 8; return true;           // BC1_RGB_UNORM
+    case 132: glFormat = GLCompressedSRGB_S3TC_DXT1; blockBytes = 8; return true;          // BC1_RGB_SRGB
+    case 133: glFormat = GLCompressedRGBA_S3TC_DXT1; blockBytes = 8; return true;          // BC1_RGBA_UNORM
+    case 134: glFormat = GLCompressedSRGBAlpha_S3TC_DXT1; blockBytes = 8; return true;     // BC1_RGBA_SRGB
+    case 137: glFormat = GLCompressedRGBA_S3TC_DXT5; blockBytes = 16; return true;         // BC3_UNORM
+    case 138: glFormat = GLCompressedSRGBAlpha_S3TC_DXT5; blockBytes = 16; return true;    // BC3_SRGB
+    case 143: glFormat = GLCompressedRGB_BPTC_UnsignedFloat; blockBytes = 16; return true; // BC6H_UFLOAT
+    case 144: glFormat = GLCompressedRGB_BPTC_SignedFloat; blockBytes = 16; return true;   // BC6H_SFLOAT
+    case 145: glFormat = GLCompressedRGBA_BPTC; blockBytes = 16; return true;              // BC7_UNORM
+    case 146: glFormat = GLCompressedSRGBAlpha_BPTC; blockBytes = 16; return true;         // BC7_SRGB
+    default: return false;
+    }
+}
+
+// Little-endian field readers (KTX2 is always little-endian)
+std::uint32_t readU32(const std::uint8_t* data)
+{
+    std::uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+std::uint64_t readU64(const std::uint8_t* data)
+{
+    std::uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+} // namespace
+
 // --------------------------------------- LoadCubemapTexture ---------------------------------------
 /**
  * @brief Loads six images into a cubemap texture used for skybox rendering.
  *
  * The images must be ordered as: +X, -X, +Y, -Y, +Z, -Z (i.e., px, nx, py, ny, pz, nz).
- * Each image is read, flipped along the Y-axis if needed, and assigned to the appropriate face.
+ * The faces are decoded in parallel on the Qt thread pool; this call blocks until all
+ * six are done. Use TextureLoader to keep the GUI responsive.
  *
  * @param faceFilenames A vector of six image file paths.
  * @return vtkSmartPointer<vtkOpenGLTexture> A cubemap texture with all six faces assigned.
@@ -32,6 +106,65 @@
 // Loads six images as cubemap texture faces (px, nx, py, ny, pz, nz)
 vtkSmartPointer<vtkOpenGLTexture> LoadCubemapTexture(const std::vector<std::string>& faceFilenames) {
 
+    std::vector<vtkSmartPointer<vtkImageData>> faces =
+        QtConcurrent::blockingMapped<std::vector<vtkSmartPointer<vtkImageData>>>(faceFilenames,
+            [](const std::string& fileName) { return DecodeTextureImage(fileName, true); });
+
+    for (std::size_t i = 0; i < faces.size(); ++i) {
+        if (!faces[i])
+            std::cerr << "Failed to load cubemap face: " << faceFilenames[i] << std::endl;
+    }
+
+    return CreateCubemapTexture(faces);
+}
+
+// --------------------------------------- DecodeTextureImage ---------------------------------------
+/**
+ * @brief Decodes an image into VTK image data, writing rows in texture order.
+ *
+ * VTK's readers produce bottom-up rows, which the skybox then had to flip again with
+ * vtkImageFlip. QImage decodes top-down, so cubemap faces are copied straight through
+ * and 2D textures are copied in reverse row order, in the same pass.
+ *
+ * @param fileName    Image file path.
+ * @param topRowFirst True to keep the top row at y = 0.
+ * @return Decoded image, or nullptr on failure.
+ */
+// Decodes and orients an image in a single pass
+vtkSmartPointer<vtkImageData> DecodeTextureImage(const std::string& fileName, bool topRowFirst) {
+
+    QImage image;
+    if (!image.load(QString::fromStdString(fileName)))
+        return nullptr;
+
+    // RGB uses a quarter less memory (and VRAM) when there is nothing in the alpha channel
+    const bool alpha = image.hasAlphaChannel();
+    image.convertTo(alpha ? QImage::Format_RGBA8888 : QImage::Format_RGB888);
+    const int components = alpha ? 4 : 3;
+
+    auto data = vtkSmartPointer<vtkImageData>::New();
+    data->SetDimensions(image.width(), image.height(), 1);
+    data->AllocateScalars(VTK_UNSIGNED_CHAR, components);
+
+    auto* pixels = static_cast<unsigned char*>(data->GetScalarPointer());
+    const std::size_t rowBytes = std::size_t(image.width()) * components;
+    for (int y = 0; y < image.height(); ++y) {
+        const int source = topRowFirst ? y : image.height() - 1 - y;
+        std::memcpy(pixels + rowBytes * y, image.constScanLine(source), rowBytes);
+    }
+
+    return data;
+}
+
+// --------------------------------------- CreateCubemapTexture ---------------------------------------
+/**
+ * @brief Wraps six decoded faces in an sRGB cubemap texture.
+ * @param faces Faces in cubemap order.
+ * @return Cubemap texture.
+ */
+// Assigns decoded faces to a cubemap
+vtkSmartPointer<vtkOpenGLTexture> CreateCubemapTexture(const std::vector<vtkSmartPointer<vtkImageData>>& faces) {
+
     auto texture = vtkSmartPointer<vtkOpenGLTexture>::New();
     texture->CubeMapOn();                     // Enable cubemap mode
     texture->SetUseSRGBColorSpace(true);      // Use sRGB color for correct brightness
@@ -39,29 +172,153 @@ vtkSmartPointer<vtkOpenGLTexture> LoadCubemapTexture(const std::vector<std::stri
     texture->RepeatOff();                     // Prevent edge wrapping artifacts
     texture->MipmapOff();                     // Disable mipmaps (not needed for skybox)
 
-    // Load and assign all six faces
-    for (int i = 0; i < 6; ++i) {
-        vtkSmartPointer<vtkImageReader2Factory> readerFactory = vtkSmartPointer<vtkImageReader2Factory>::New();
-        vtkImageReader2* reader = readerFactory->CreateImageReader2(faceFilenames[i].c_str());
+    for (int i = 0; i < 6 && i < int(faces.size()); ++i) {
+        if (faces[i])
+            texture->SetInputDataObject(i, faces[i]);
+    }
 
-        if (!reader) {
-            std::cerr << "Failed to load cubemap face: " << faceFilenames[i] << std::endl;
-            continue;
+    return texture;
+}
+
+// --------------------------------------- ReadKTX2Cubemap ---------------------------------------
+/**
+ * @brief Parses a KTX2 cubemap and copies its compressed mip levels.
+ * @param fileName KTX2 file path.
+ * @param cubemap  Output data.
+ * @param error    Failure reason.
+ * @return True on success.
+ */
+// Reads a BCn cubemap from a KTX2 container
+bool ReadKTX2Cubemap(const std::string& fileName, CompressedCubemap& cubemap, std::string& error) {
+
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file) {
+        error = "cannot open file";
+        return false;
+    }
+    std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (bytes.size() < KTX2LevelIndexOffset || std::memcmp(bytes.data(), KTX2Identifier, sizeof(KTX2Identifier)) != 0) {
+        error = "not a KTX2 file";
+        return false;
+    }
+
+    const std::uint8_t* header = bytes.data() + sizeof(KTX2Identifier);
+    const std::uint32_t vkFormat = readU32(header);
+    const std::uint32_t width = readU32(header + 8);
+    const std::uint32_t height = readU32(header + 12);
+    const std::uint32_t depth = readU32(header + 16);
+    const std::uint32_t layers = readU32(header + 20);
+    const std::uint32_t faces = readU32(header + 24);
+    const std::uint32_t levelCount = std::max<std::uint32_t>(1, readU32(header + 28));
+    const std::uint32_t supercompression = readU32(header + 32);
+
+    int blockBytes = 0;
+    if (!glFormatFor(vkFormat, cubemap.glFormat, blockBytes)) {
+        error = "unsupported format (expected BC1, BC3, BC6H or BC7)";
+        return false;
+    }
+    if (faces != 6 || depth > 1 || layers > 1) {
+        error = "not a single cubemap";
+        return false;
+    }
+    if (supercompression != 0) {
+        error = "supercompressed payloads are not supported";
+        return false;
+    }
+    if (width == 0 || height == 0 || width > KTX2MaxSize || height > KTX2MaxSize) {
+        error = "invalid dimensions";
+        return false;
+    }
+
+    // A full mip chain ends at 1x1, so there are at most floor(log2(max(w, h))) + 1 levels
+    std::uint32_t maxLevels = 1;
+    while ((std::max(width, height) >> maxLevels) != 0)
+        ++maxLevels;
+    if (levelCount > maxLevels) {
+        error = "too many mip levels";
+        return false;
+    }
+    if (bytes.size() < KTX2LevelIndexOffset + std::size_t(levelCount) * 24) {
+        error = "truncated level index";
+        return false;
+    }
+
+    cubemap.width = int(width);
+    cubemap.height = int(height);
+    cubemap.levels.clear();
+    cubemap.levels.reserve(levelCount);
+
+    for (std::uint32_t level = 0; level < levelCount; ++level) {
+        const std::uint8_t* entry = bytes.data() + KTX2LevelIndexOffset + std::size_t(level) * 24;
+        const std::uint64_t offset = readU64(entry);
+        const std::uint64_t length = readU64(entry + 8);
+
+        const std::uint64_t blocksX = (std::max<std::uint32_t>(1, width >> level) + 3) / 4;
+        const std::uint64_t blocksY = (std::max<std::uint32_t>(1, height >> level) + 3) / 4;
+        if (length != blocksX * blocksY * blockBytes * 6 || offset > bytes.size() || length > bytes.size() - offset) {
+            error = "corrupt mip level";
+            return false;
         }
 
-        reader->SetFileName(faceFilenames[i].c_str());
-        reader->Update();
+        cubemap.levels.emplace_back(bytes.begin() + std::ptrdiff_t(offset), bytes.begin() + std::ptrdiff_t(offset + length));
+    }
+
+    return true;
+}
+
+// --------------------------------------- UploadCompressedCubemap ---------------------------------------
+/**
+ * @brief Uploads compressed faces straight into a GL cubemap; nothing is decoded on the CPU or GPU.
+ * @param window  Render window that owns the context.
+ * @param cubemap Data from ReadKTX2Cubemap().
+ * @return Cubemap texture wrapping the uploaded texture object.
+ */
+// Creates a cubemap texture from BCn data
+vtkSmartPointer<vtkOpenGLTexture> UploadCompressedCubemap(vtkOpenGLRenderWindow* window, const CompressedCubemap& cubemap) {
+
+    if (!window || cubemap.levels.empty())
+        return nullptr;
 
-        // Flip image vertically if needed (some formats are upside down)
-        auto flipY = vtkSmartPointer<vtkImageFlip>::New();
-        flipY->SetInputConnection(reader->GetOutputPort());
-        flipY->SetFilteredAxis(1);  // 1 = Y-axis
-        flipY->Update();
+    window->MakeCurrent();
+    while (glGetError() != GL_NO_ERROR) {}
 
-        texture->SetInputConnection(i, flipY->GetOutputPort());
-        reader->Delete();  // Manually delete because CreateImageReader2 returns raw pointer
+    // Let vtkTextureObject own the GL handle, then redefine its images as compressed
+    auto object = vtkSmartPointer<vtkTextureObject>::New();
+    object->SetContext(window);
+    void* empty[6] = { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
+    object->CreateCubeFromRaw(cubemap.width, cubemap.height, 4, VTK_UNSIGNED_CHAR, empty);
+
+    object->Activate();
+    for (std::size_t level = 0; level < cubemap.levels.size(); ++level) {
+        const int w = std::max(1, cubemap.width >> level);
+        const int h = std::max(1, cubemap.height >> level);
+        const std::size_t faceBytes = cubemap.levels[level].size() / 6;
+        for (int face = 0; face < 6; ++face) {
+            glCompressedTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, GLint(level), cubemap.glFormat,
+                w, h, 0, GLsizei(faceBytes), cubemap.levels[level].data() + faceBytes * face);
+        }
     }
+    object->Deactivate();
 
+    if (glGetError() != GL_NO_ERROR) {
+        std::cerr << "GPU rejected the compressed cubemap" << std::endl;
+        object->ReleaseGraphicsResources(window);
+        return nullptr;
+    }
+
+    const bool mipmapped = cubemap.levels.size() > 1;
+    object->SetWrapS(vtkTextureObject::ClampToEdge);
+    object->SetWrapT(vtkTextureObject::ClampToEdge);
+    object->SetWrapR(vtkTextureObject::ClampToEdge);
+    object->SetMinificationFilter(mipmapped ? vtkTextureObject::LinearMipmapLinear : vtkTextureObject::Linear);
+    object->SetMagnificationFilter(vtkTextureObject::Linear);
+    object->SetBaseLevel(0);
+    object->SetMaxLevel(int(cubemap.levels.size()) - 1);
+
+    auto texture = vtkSmartPointer<vtkOpenGLTexture>::New();
+    texture->CubeMapOn();
+    texture->SetTextureObject(object);
     return texture;
 }
 
@@ -73,13 +330,15 @@ vtkSmartPointer<vtkOpenGLTexture> LoadCubemapTexture(const std::vector<std::stri
  *
  * @param renderer Pointer to the VTK renderer.
  * @param cubemapTexture The cubemap texture returned by LoadCubemapTexture().
+ * @return The skybox actor, for switching textures later.
  */
 // Adds a skybox actor to the renderer using the given cubemap texture
-void AddSkyboxToRenderer(vtkRenderer* renderer, vtkTexture* cubemapTexture) {
+vtkSmartPointer<vtkSkybox> AddSkyboxToRenderer(vtkRenderer* renderer, vtkTexture* cubemapTexture) {
     auto skybox = vtkSmartPointer<vtkSkybox>::New();
     skybox->SetTexture(cubemapTexture);      // Assign cubemap texture
     skybox->SetProjectionToCube();           // Use cube projection mode
     skybox->GammaCorrectOn();                // Enable gamma correction
 
     renderer->AddActor(skybox);              // Add skybox to the scene
+    return skybox;
 }
@@ -4,7 +4,10 @@
  *
  * This header provides functions to load six images as a cubemap texture and apply
  * it as a skybox to a VTK renderer. It supports `.png`, `.jpg`, and other formats
- * recognized by VTK's image reader factory.
+ * recognized by Qt's image readers, plus pre-compressed BCn cubemaps in KTX2 files.
+ *
+ * The decode and parse functions are thread-safe; everything that creates or
+ * uploads a texture must run on the thread that owns the render window.
  *
  */
 
@@ -14,12 +17,31 @@
 
 #include <vector>     // Used for passing six image paths (px, nx, py, ny, pz, nz)
 #include <string>     // For image file path strings
+#include <cstdint>    // Fixed-size KTX2 header fields
 
 // --------------------------------------- VTK Includes ---------------------------------------
 
 #include <vtkSmartPointer.h>        // Smart pointer management for VTK
 #include <vtkRenderer.h>            // For rendering scene
 #include <vtkOpenGLTexture.h>       // OpenGL-compatible texture (for cubemap)
+#include <vtkImageData.h>           // Decoded images
+#include <vtkSkybox.h>              // Skybox actor
+#include <vtkOpenGLRenderWindow.h>  // Context for compressed uploads
+
+// --------------------------------------- Compressed Cubemaps ---------------------------------------
+
+/**
+ * @brief A block-compressed cubemap read from a KTX2 file, ready for upload.
+ *
+ * Faces are stored in cubemap order (+X, -X, +Y, -Y, +Z, -Z) for each mip level,
+ * finest level first, exactly as the GPU expects them.
+ */
+struct CompressedCubemap {
+    unsigned int glFormat = 0;                      // GL compressed internal format
+    int width = 0;                                  // Level 0 face width in pixels
+    int height = 0;                                 // Level 0 face height in pixels
+    std::vector<std::vector<std::uint8_t>> levels;  // Per level: six faces back to back
+};
 
 // --------------------------------------- Function Declarations ---------------------------------------
 
@@ -39,12 +61,58 @@
  */
 vtkSmartPointer<vtkOpenGLTexture> LoadCubemapTexture(const std::vector<std::string>& faceFilenames);
 
+/**
+ * @brief Decodes an image file into VTK image data. Thread-safe.
+ *
+ * Rows are written in the order the texture needs while decoding, so no separate
+ * flip pass is required. Images without alpha are kept as RGB to save memory.
+ *
+ * @param fileName    Image file path.
+ * @param topRowFirst True for cubemap faces (top row at y = 0), false for 2D textures (VTK's bottom-up order).
+ * @return Decoded image, or nullptr if the file could not be read.
+ */
+vtkSmartPointer<vtkImageData> DecodeTextureImage(const std::string& fileName, bool topRowFirst);
+
+/**
+ * @brief Creates a cubemap texture from six decoded faces (see DecodeTextureImage()).
+ * @param faces Faces in cubemap order; missing faces are skipped.
+ * @return Cubemap texture, uploaded on its first render.
+ */
+vtkSmartPointer<vtkOpenGLTexture> CreateCubemapTexture(const std::vector<vtkSmartPointer<vtkImageData>>& faces);
+
+/**
+ * @brief Reads a BCn-compressed cubemap from a KTX2 file. Thread-safe.
+ *
+ * Supports BC1, BC3, BC6H and BC7 (UNORM, sRGB and HDR variants) without
+ * supercompression; Basis/zstd payloads must be transcoded beforehand.
+ *
+ * @param fileName KTX2 file path.
+ * @param cubemap  Receives the compressed levels.
+ * @param error    Receives a reason on failure.
+ * @return True on success.
+ */
+bool ReadKTX2Cubemap(const std::string& fileName, CompressedCubemap& cubemap, std::string& error);
+
+/**
+ * @brief Uploads a compressed cubemap and wraps it in a texture.
+ *
+ * Makes the window's context current, so call it on the GUI thread outside of a render.
+ *
+ * @param window  Render window whose context receives the texture.
+ * @param cubemap Data returned from ReadKTX2Cubemap().
+ * @return Cubemap texture, or nullptr if the GPU rejected the data.
+ */
+vtkSmartPointer<vtkOpenGLTexture> UploadCompressedCubemap(vtkOpenGLRenderWindow* window, const CompressedCubemap& cubemap);
+
 /**
  * @brief Adds a cubemap-based skybox to the given VTK renderer.
  *
- * The cubemap texture is rendered as the background of the 3D scene.
+ * The cubemap texture is rendered as the background of the 3D scene. Keep the
+ * returned actor and call SetTexture() on it to switch skyboxes, instead of
+ * adding a second one.
  *
  * @param renderer The VTK renderer to which the skybox will be added.
  * @param cubemapTexture The texture returned from LoadCubemapTexture().
+ * @return The skybox actor.
  */
-void AddSkyboxToRenderer(vtkRenderer* renderer, vtkTexture* cubemapTexture);
+vtkSmartPointer<vtkSkybox> AddSkyboxToRenderer(vtkRenderer* renderer, vtkTexture* cubemapTexture);